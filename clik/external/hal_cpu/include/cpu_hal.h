@@ -17,10 +17,12 @@
 #ifndef _CLIK_RUNTIME_CPU_HAL_H
 #define _CLIK_RUNTIME_CPU_HAL_H
 
-#include <condition_variable>
+#include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 #include "hal.h"
@@ -28,14 +30,40 @@
 using elf_program = void *;
 struct exec_state;
 
+// Generation-counted barrier. Waiting threads spin on the generation counter
+// for a short while before going to sleep on it.
 struct cpu_barrier {
-  std::mutex mutex;
-  std::condition_variable entry;
-  int threads_entered = 0;
-  std::condition_variable exit;
-  int sequence_id = 0;
+  std::atomic<uint32_t> entered{0};
+  std::atomic<uint32_t> generation{0};
 
-  void wait(int num_threads);
+  void wait(uint32_t num_threads);
+};
+
+// Set of threads which persist across kernel launches. Work is handed to the
+// workers by bumping a generation counter rather than by creating threads.
+class cpu_worker_pool {
+ public:
+  using job_fn = std::function<void(uint32_t worker_id)>;
+
+  explicit cpu_worker_pool(uint32_t num_workers);
+  ~cpu_worker_pool();
+
+  uint32_t size() const { return num_workers; }
+
+  // Run `job` on the first `num_active` workers and wait for it to complete.
+  // The calling thread acts as worker zero.
+  void run(uint32_t num_active, const job_fn &job);
+
+ private:
+  void worker_main(uint32_t worker_id);
+
+  uint32_t num_workers;
+  std::vector<std::thread> threads;
+  std::atomic<uint32_t> start_generation{0};
+  std::atomic<uint32_t> pending{0};
+  std::atomic<bool> shutdown{false};
+  uint32_t active_workers = 0;
+  const job_fn *current_job = nullptr;
 };
 
 class cpu_hal : public hal::hal_device_t {
@@ -102,6 +130,9 @@ class cpu_hal : public hal::hal_device_t {
                        size_t align = 0);
 
   void kernel_entry(exec_state *state);
+  void run_work_items(exec_state *items, uint32_t num_items);
+  void work_item_barrier();
+  bool alloc_fiber_stacks(size_t num_items);
 
   bool hal_debug() const { return debug; }
 
@@ -111,7 +142,17 @@ class cpu_hal : public hal::hal_device_t {
   uint32_t local_mem_size = 8 << 20;
   uint8_t *local_mem = nullptr;
   cpu_barrier barrier;
+  uint32_t num_active_workers = 0;
+  std::unique_ptr<cpu_worker_pool> workers;
+  // Stacks used to multiplex work-items onto workers, indexed by work-item.
+  std::vector<void *> fiber_stacks;
   std::map<hal::hal_program_t, std::string> binary_files;
+
+  // Launch statistics, collected when CA_HAL_STATS is set.
+  bool stats = false;
+  uint64_t stats_launches = 0;
+  uint64_t stats_work_items = 0;
+  double stats_seconds = 0.0;
 };
 
 #endif
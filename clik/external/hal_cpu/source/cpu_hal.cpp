@@ -21,9 +21,19 @@
 #if defined(_WIN32)
 #include <process.h>
 #else
+#include <sys/mman.h>
+#include <ucontext.h>
 #include <unistd.h>
 #endif
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
 #include <cstring>
 #include <iomanip>
 #include <sstream>
@@ -32,12 +42,168 @@
 
 #include "device/device_if.h"
 
+namespace {
+// Number of times a waiting thread polls a counter before sleeping on it.
+constexpr int spin_count = 4096;
+
+// Size of the stack given to each work-item multiplexed onto a worker. The
+// stack is preceded by a guard page so that overflows fault.
+constexpr size_t fiber_stack_size = 1 << 20;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+// Block until `word` no longer holds `value`.
+void wait_for_change(std::atomic<uint32_t> &word, uint32_t value) {
+  for (int i = 0; i < spin_count; i++) {
+    if (word.load(std::memory_order_acquire) != value) {
+      return;
+    }
+    cpu_relax();
+  }
+  while (word.load(std::memory_order_acquire) == value) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE,
+            value, nullptr, nullptr, 0);
+#else
+    std::this_thread::yield();
+#endif
+  }
+}
+
+// Wake up all threads sleeping in `wait_for_change` on `word`.
+void wake_all(std::atomic<uint32_t> &word) {
+#if defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE,
+          INT_MAX, nullptr, nullptr, 0);
+#else
+  (void)word;
+#endif
+}
+
+// Work-item running on its own stack, switched to and from by the worker that
+// owns it.
+struct cpu_fiber {
+  ucontext_t context;
+  exec_state_t *exec = nullptr;
+  bool done = false;
+};
+
+struct cpu_worker {
+  ucontext_t scheduler;
+  // Work-item currently running on the worker, or null when the worker runs
+  // a single work-item directly on its own stack.
+  cpu_fiber *current = nullptr;
+};
+
+thread_local cpu_worker *this_worker = nullptr;
+
+void fiber_main() {
+  cpu_fiber *fiber = this_worker->current;
+  exec_state_t *exec = fiber->exec;
+  direct_kernel_fn kernel = (direct_kernel_fn)exec->kernel_entry;
+  kernel((void *)exec->packed_args, exec);
+  // Returning resumes the scheduler through `uc_link`.
+  fiber->done = true;
+}
+
+size_t guard_size() { return (size_t)sysconf(_SC_PAGESIZE); }
+
+void *map_fiber_stack() {
+  size_t guard = guard_size();
+  void *base = mmap(nullptr, fiber_stack_size + guard, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (base == MAP_FAILED) {
+    return nullptr;
+  }
+  mprotect(base, guard, PROT_NONE);
+  return (uint8_t *)base + guard;
+}
+
+void unmap_fiber_stack(void *stack) {
+  size_t guard = guard_size();
+  munmap((uint8_t *)stack - guard, fiber_stack_size + guard);
+}
+}  // namespace
+
 cpu_hal::cpu_hal(hal::hal_device_info_t *info, std::mutex &hal_lock)
     : hal::hal_device_t(info), hal_lock(hal_lock) {
   local_mem = (uint8_t *)malloc(local_mem_size);
+  stats = getenv("CA_HAL_STATS") != nullptr;
 }
 
-cpu_hal::~cpu_hal() { free(local_mem); }
+cpu_hal::~cpu_hal() {
+  workers.reset();
+  for (void *stack : fiber_stacks) {
+    unmap_fiber_stack(stack);
+  }
+  free(local_mem);
+  if (stats && stats_launches) {
+    double exec_time_us = stats_seconds * 1e6 / stats_launches;
+    double work_items_per_s =
+        stats_seconds > 0.0 ? stats_work_items / stats_seconds : 0.0;
+    fprintf(stderr,
+            "cpu_hal: launches=%llu exec_time_us=%.2f work_items_per_s=%.0f\n",
+            (unsigned long long)stats_launches, exec_time_us, work_items_per_s);
+  }
+}
+
+cpu_worker_pool::cpu_worker_pool(uint32_t num_workers)
+    : num_workers(std::max(num_workers, 1u)) {
+  for (uint32_t i = 1; i < this->num_workers; i++) {
+    threads.emplace_back(&cpu_worker_pool::worker_main, this, i);
+  }
+}
+
+cpu_worker_pool::~cpu_worker_pool() {
+  shutdown.store(true, std::memory_order_relaxed);
+  start_generation.fetch_add(1, std::memory_order_release);
+  wake_all(start_generation);
+  for (std::thread &t : threads) {
+    t.join();
+  }
+}
+
+void cpu_worker_pool::run(uint32_t num_active, const job_fn &job) {
+  num_active = std::min(num_active, num_workers);
+  if (num_active <= 1) {
+    job(0);
+    return;
+  }
+  // Every worker thread acknowledges each generation, even when it has no
+  // work to do. This guarantees that no thread is still looking at the
+  // previous job once the next one is published.
+  current_job = &job;
+  active_workers = num_active;
+  pending.store(num_workers - 1, std::memory_order_relaxed);
+  start_generation.fetch_add(1, std::memory_order_release);
+  wake_all(start_generation);
+  job(0);
+  uint32_t left;
+  while ((left = pending.load(std::memory_order_acquire)) != 0) {
+    wait_for_change(pending, left);
+  }
+}
+
+void cpu_worker_pool::worker_main(uint32_t worker_id) {
+  uint32_t seen = 0;
+  for (;;) {
+    wait_for_change(start_generation, seen);
+    seen++;
+    if (shutdown.load(std::memory_order_relaxed)) {
+      return;
+    }
+    if (worker_id < active_workers) {
+      (*current_job)(worker_id);
+    }
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      wake_all(pending);
+    }
+  }
+}
 
 hal::hal_kernel_t cpu_hal::program_find_kernel(hal::hal_program_t program,
                                                const char *name) {
@@ -119,31 +285,20 @@ bool cpu_hal::program_free(hal::hal_program_t program) {
 }
 
 // Pauses the current thread until all threads have encountered the barrier.
-void cpu_barrier::wait(int num_threads) {
-  std::unique_lock<std::mutex> locker(mutex);
-  // Each barrier event in the execution of the kernel is given a sequence
-  // number, which is used to determine when it has been passed.
-  int current_id = sequence_id;
-  if (threads_entered == 0) {
-    // The first thread is responsible for waiting until all other threads have
-    // entered the barrier. The barrier is 'closed'.
-    threads_entered++;
-    while (threads_entered < num_threads) {
-      entry.wait(locker);
-    }
-    // Once all threads have entered the barrier, update the sequence to 'open'
-    // the barrier and wake up the other threads.
-    sequence_id = current_id + 1;
-    threads_entered = 0;
-    exit.notify_all();
+void cpu_barrier::wait(uint32_t num_threads) {
+  if (num_threads <= 1) {
+    return;
+  }
+  // A thread can only reach the next barrier once the generation has moved
+  // on, so the value loaded here identifies the current barrier event.
+  uint32_t current = generation.load(std::memory_order_acquire);
+  if (entered.fetch_add(1, std::memory_order_acq_rel) + 1 == num_threads) {
+    // The last thread to arrive resets the count and opens the barrier.
+    entered.store(0, std::memory_order_relaxed);
+    generation.store(current + 1, std::memory_order_release);
+    wake_all(generation);
   } else {
-    // Notify the first thread that one more thread has entered the barrier.
-    threads_entered++;
-    entry.notify_one();
-    // Wait for the barrier to be opened.
-    while (current_id == sequence_id) {
-      exit.wait(locker);
-    }
+    wait_for_change(generation, current);
   }
 }
 
@@ -152,11 +307,80 @@ void cpu_hal::kernel_entry(exec_state *exec) {
   kernel((void *)exec->packed_args, exec);
 }
 
+bool cpu_hal::alloc_fiber_stacks(size_t num_items) {
+  while (fiber_stacks.size() < num_items) {
+    void *stack = map_fiber_stack();
+    if (!stack) {
+      return false;
+    }
+    fiber_stacks.push_back(stack);
+  }
+  return true;
+}
+
+// Execute a contiguous range of work-items on the current worker. When there
+// is more than one work-item, each one runs on its own stack and yields back
+// to this function when it reaches a barrier.
+void cpu_hal::run_work_items(exec_state *items, uint32_t num_items) {
+  cpu_worker worker;
+  this_worker = &worker;
+  if (num_items == 1) {
+    kernel_entry(&items[0]);
+    this_worker = nullptr;
+    return;
+  }
+
+  std::vector<cpu_fiber> fibers(num_items);
+  for (uint32_t i = 0; i < num_items; i++) {
+    cpu_fiber &fiber(fibers[i]);
+    fiber.exec = &items[i];
+    getcontext(&fiber.context);
+    fiber.context.uc_stack.ss_sp = fiber_stacks[items[i].thread_id];
+    fiber.context.uc_stack.ss_size = fiber_stack_size;
+    fiber.context.uc_link = &worker.scheduler;
+    makecontext(&fiber.context, fiber_main, 0);
+  }
+
+  uint32_t live = num_items;
+  while (live > 0) {
+    // Run every work-item until it either finishes or reaches a barrier.
+    for (cpu_fiber &fiber : fibers) {
+      if (fiber.done) {
+        continue;
+      }
+      worker.current = &fiber;
+      swapcontext(&worker.scheduler, &fiber.context);
+      if (fiber.done) {
+        live--;
+      }
+    }
+    worker.current = nullptr;
+    // All of this worker's work-items are waiting at the barrier. Wait for
+    // the other workers to reach it too.
+    if (live > 0) {
+      barrier.wait(num_active_workers);
+    }
+  }
+  this_worker = nullptr;
+}
+
+void cpu_hal::work_item_barrier() {
+  cpu_worker *worker = this_worker;
+  if (worker && worker->current) {
+    // Hand control back to the worker, which resumes this work-item once all
+    // work-items have reached the barrier.
+    swapcontext(&worker->current->context, &worker->scheduler);
+  } else {
+    barrier.wait(num_active_workers);
+  }
+}
+
 bool cpu_hal::kernel_exec(hal::hal_program_t program, hal::hal_kernel_t kernel,
                           const hal::hal_ndrange_t *nd_range,
                           const hal::hal_arg_t *args, uint32_t num_args,
                           uint32_t work_dim) {
   std::lock_guard<std::mutex> locker(hal_lock);
+  auto start_time = std::chrono::steady_clock::now();
   if (hal_debug()) {
     fprintf(stderr,
             "cpu_hal::kernel_exec(kernel=0x%08lx, num_args=%d, "
@@ -190,9 +414,7 @@ bool cpu_hal::kernel_exec(hal::hal_program_t program, hal::hal_kernel_t kernel,
   }
   exec.kernel_entry = (entry_point_fn)kernel;
   exec.flags = flags;
-  exec.barrier = [](exec_state *exec) {
-    exec->hal->barrier.wait(exec->num_threads);
-  };
+  exec.barrier = [](exec_state *exec) { exec->hal->work_item_barrier(); };
   exec.hal = this;
 
   // Pack arguments.
@@ -213,19 +435,33 @@ bool cpu_hal::kernel_exec(hal::hal_program_t program, hal::hal_kernel_t kernel,
     thread_exec.thread_id = thread_id;
   }
 
-  // Execute the kernel on all threads.
-  if (num_threads > 1) {
-    std::vector<std::thread *> threads(num_threads);
-    for (unsigned i = 0; i < num_threads; i++) {
-      threads[i] =
-          new std::thread(&cpu_hal::kernel_entry, this, &exec_for_thread[i]);
-    }
-    for (std::thread *t : threads) {
-      t->join();
-      delete t;
-    }
-  } else {
-    kernel_entry(&exec_for_thread[0]);
+  // Distribute the work-items between the workers. When there are more
+  // work-items than workers, some workers have to multiplex several
+  // work-items, which requires a separate stack for each of them.
+  if (!workers) {
+    workers.reset(new cpu_worker_pool(std::thread::hardware_concurrency()));
+  }
+  uint32_t num_workers =
+      (uint32_t)std::min<size_t>(workers->size(), num_threads);
+  if ((num_threads > num_workers) && !alloc_fiber_stacks(num_threads)) {
+    return false;
+  }
+  num_active_workers = num_workers;
+
+  // Execute the kernel on all workers.
+  workers->run(num_workers, [&](uint32_t worker_id) {
+    size_t begin = worker_id * num_threads / num_workers;
+    size_t end = (worker_id + 1) * num_threads / num_workers;
+    run_work_items(&exec_for_thread[begin], (uint32_t)(end - begin));
+  });
+
+  if (stats) {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start_time;
+    stats_launches++;
+    stats_seconds += elapsed.count();
+    stats_work_items +=
+        nd_range->global[0] * nd_range->global[1] * nd_range->global[2];
   }
 
   return true;
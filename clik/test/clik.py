@@ -14,6 +14,7 @@
 #
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+import json
 import os
 import re
 
@@ -67,6 +68,38 @@ class ClikProfile(Profile):
     This profile can be used to run locally or on a remote device through ssh.
     """
 
+    def add_options(self, parser):
+        super(ClikProfile, self).add_options(parser)
+        parser.add_argument(
+            "--launch-stats",
+            default=False,
+            action="store_true",
+            help="Report the kernel execution time and throughput of the CPU "
+            "HAL for each test")
+        parser.add_argument(
+            "--save-launch-stats",
+            type=str,
+            help="File to write launch statistics to, in JSON format. "
+            "Implies --launch-stats")
+        parser.add_argument(
+            "--launch-baseline",
+            type=str,
+            help="File containing launch statistics saved by a previous run, "
+            "to compare against. Implies --launch-stats")
+
+    def parse_options(self, argv):
+        args = super(ClikProfile, self).parse_options(argv)
+        if args.save_launch_stats or args.launch_baseline:
+            args.launch_stats = True
+        return args
+
+    def build_environment_vars(self):
+        env = super(ClikProfile, self).build_environment_vars()
+        if self.args.launch_stats:
+            # Ask the CPU HAL to print launch statistics on exit.
+            env["CA_HAL_STATS"] = "1"
+        return env
+
     def create_run(self, test, worker_state=None):
         """ Create a new test run from a test description.  """
         return ClikRun(self, test)
@@ -87,6 +120,58 @@ class ClikProfile(Profile):
 
         return TestList(tests=parsed_tests).filter(self.args.patterns)
 
+    def report_results(self, results, ui):
+        """ Print and save launch statistics, if requested. """
+        if not self.args.launch_stats:
+            return
+        stats = {}
+        for name in sorted(results.runs.keys()):
+            run_stats = getattr(results.runs[name], "launch_stats", None)
+            if run_stats:
+                stats[name] = run_stats
+        if self.args.save_launch_stats:
+            with open(self.args.save_launch_stats, "w") as f:
+                json.dump(stats, f, indent=2, sort_keys=True)
+        baseline = {}
+        if self.args.launch_baseline:
+            with open(self.args.launch_baseline, "r") as f:
+                baseline = json.load(f)
+
+        out = ui.out
+        out.write("\nLaunch statistics:\n")
+        if baseline:
+            out.write("  %-28s %12s %12s %8s %14s %14s %8s\n" % (
+                "Test", "Exec(us)", "Before", "Speedup", "Items/s",
+                "Before", "Speedup"))
+        else:
+            out.write("  %-28s %9s %12s %14s\n" % (
+                "Test", "Launches", "Exec(us)", "Items/s"))
+        for name, run_stats in stats.items():
+            exec_time = run_stats["exec_time_us"]
+            throughput = run_stats["work_items_per_s"]
+            before = baseline.get(name)
+            if before:
+                out.write("  %-28s %12.2f %12.2f %7.2fx %14.0f %14.0f %7.2fx\n"
+                          % (name, exec_time, before["exec_time_us"],
+                             ratio(before["exec_time_us"], exec_time),
+                             throughput, before["work_items_per_s"],
+                             ratio(throughput, before["work_items_per_s"])))
+            elif baseline:
+                out.write("  %-28s %12.2f %12s %8s %14.0f %14s %8s\n" % (
+                    name, exec_time, "-", "-", throughput, "-", "-"))
+            else:
+                out.write("  %-28s %9d %12.2f %14.0f\n" % (
+                    name, run_stats["launches"], exec_time, throughput))
+        out.flush()
+
+
+def ratio(numerator, denominator):
+    """ Divide two statistics, treating a zero denominator as no change. """
+    if not denominator:
+        return 1.0
+    return float(numerator) / denominator
+
+
 class ValidationError(Exception):
     pass
 
@@ -97,11 +182,14 @@ class ClikRun(TestRunBase):
 
     def __init__(self, profile, test):
         super(ClikRun, self).__init__(profile, test)
+        self.launch_stats = None
 
     def analyze_process_output(self):
         """
         Determine whether the test passed or failed from the return code.
         """
+        if self.profile.args.launch_stats:
+            self.parse_launch_stats()
         if self.test.validation_id:
             # Some tests require special validation of their output.
             func_name = "analyze_{0}".format(self.test.validation_id)
@@ -137,6 +225,21 @@ class ClikRun(TestRunBase):
         # Parse test output
         self.analyze_process_output()
     
+    def parse_launch_stats(self):
+        """ Extract the launch statistics printed by the CPU HAL on exit. """
+        stats_expr = re.compile(rb"^cpu_hal: launches=(\d+) "
+            rb"exec_time_us=([0-9.]+) work_items_per_s=([0-9.]+)$")
+        if not self.output:
+            return
+        for line in self.output.split(b"\n"):
+            m = stats_expr.match(line.strip())
+            if m:
+                self.launch_stats = {
+                    "launches": int(m.group(1)),
+                    "exec_time_us": float(m.group(2)),
+                    "work_items_per_s": float(m.group(3))
+                }
+
     def analyze_hello(self):
         banner_expr = re.compile(rb"^Running hello[a-zA-Z0-9_]* example "
             rb"\(Global size: (\d+), local size: (\d+)\)$")
@@ -162,6 +162,13 @@ class Profile(object):
         """ Create the list of tests to run from a CSV. """
         raise NotImplementedError()
 
+    def report_results(self, results, ui):
+        """
+        Entry point for profile specific reporting, called once the results
+        have been printed.
+        """
+        pass
+
     def build_environment_vars(self):
         """
         Builds and returns dictionary of environment variables to be passed to
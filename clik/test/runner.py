@@ -193,6 +193,7 @@ class TestRunner(object):
         """
         # Print the results.
         self.ui.print_results(self.results)
+        self.profile.report_results(self.results, self.ui)
         if self.log:
             self.log.print_results(self.results)
         # Write the list of failures.
@@ -94,6 +94,23 @@ class refsi_command_buffer {
   /// @param locker Mutex for the HAL device.
   refsi_result run(refsi_hal_device &hal_device, refsi_locker &locker);
 
+  /// @brief Write the commands that have been added to the buffer to device
+  /// memory, so that they can be executed several times.
+  /// @param hal_device Device to write the command buffer to.
+  /// @param locker Mutex for the HAL device.
+  /// @param size On success, set to the size of the command buffer in bytes.
+  /// @return Device address of the command buffer or zero on failure.
+  hal::hal_addr_t upload(refsi_hal_device &hal_device, refsi_locker &locker,
+                         size_t &size);
+
+  /// @brief Execute a command buffer that is already in device memory and wait
+  /// for it to complete.
+  /// @param hal_device Device to execute the command buffer.
+  /// @param cb_addr Device address of the command buffer.
+  /// @param cb_size Size of the command buffer in bytes.
+  static refsi_result execute(refsi_hal_device &hal_device,
+                              hal::hal_addr_t cb_addr, size_t cb_size);
+
 private:
   std::vector<uint64_t> chunks;
 };
@@ -24,6 +24,30 @@
 class refsi_command_buffer;
 class riscv_encoder;
 
+/// @brief Kernel launch whose command buffer has been encoded and written to
+/// device memory ahead of time. Replaying the launch only requires the kernel
+/// arguments at the start of the KUB to be rewritten.
+struct refsi_m1_launch {
+  refsi_hal_program *program = nullptr;
+  refsi_hal_kernel *kernel = nullptr;
+  uint32_t work_dim = 0;
+  uint64_t num_instances = 0;
+  uint64_t num_slices = 0;
+
+  // Kernel Uniform Block, made of the packed arguments followed by the
+  // execution state.
+  hal::hal_addr_t kub_addr = 0;
+  hal::hal_size_t args_size = 0;
+  uint32_t exec_offset = 0;
+
+  // Encoded command buffer and the counter buffer it writes to. These are
+  // encoded again when counters are enabled or disabled between launches.
+  hal::hal_addr_t cb_addr = 0;
+  size_t cb_size = 0;
+  bool counters_enabled = false;
+  hal::hal_addr_t counters_buffer_addr = 0;
+};
+
 class refsi_m1_hal_device : public refsi_hal_device {
  public:
   refsi_m1_hal_device(refsi_device_t device,
@@ -39,6 +63,21 @@ class refsi_m1_hal_device : public refsi_hal_device {
                    const hal::hal_arg_t *args, uint32_t num_args,
                    uint32_t work_dim) override;
 
+  // prepare a kernel launch that can be executed several times
+  hal::hal_launch_t launch_prepare(hal::hal_program_t program,
+                                   hal::hal_kernel_t kernel,
+                                   const hal::hal_ndrange_t *nd_range,
+                                   const hal::hal_arg_t *args,
+                                   uint32_t num_args,
+                                   uint32_t work_dim) override;
+
+  // execute a prepared kernel launch on the target
+  bool launch_exec(hal::hal_launch_t launch, const hal::hal_arg_t *args,
+                   uint32_t num_args) override;
+
+  // release a prepared kernel launch
+  bool launch_free(hal::hal_launch_t launch) override;
+
   // copy memory between target buffers
   bool mem_copy(hal::hal_addr_t dst, hal::hal_addr_t src,
                 hal::hal_size_t size) override;
@@ -52,6 +91,18 @@ class refsi_m1_hal_device : public refsi_hal_device {
   void encodeKernelExit(riscv_encoder &enc);
   void encodeLaunchKernel(riscv_encoder &enc, unsigned num_dims);
 
+  refsi_m1_launch *prepareLaunch(hal::hal_program_t program,
+                                 hal::hal_kernel_t kernel,
+                                 const hal::hal_ndrange_t *nd_range,
+                                 const hal::hal_arg_t *args, uint32_t num_args,
+                                 uint32_t work_dim, refsi_locker &locker);
+  bool encodeLaunch(refsi_m1_launch &launch, refsi_locker &locker);
+  bool writeLaunchArgs(refsi_m1_launch &launch, const hal::hal_arg_t *args,
+                       uint32_t num_args, refsi_locker &locker);
+  bool runLaunch(refsi_m1_launch &launch, refsi_locker &locker);
+  void releaseLaunchCommands(refsi_m1_launch &launch, refsi_locker &locker);
+  void freeLaunch(refsi_m1_launch *launch, refsi_locker &locker);
+
   unsigned num_harts_per_core = 0;
   unsigned num_cores = 0;
 
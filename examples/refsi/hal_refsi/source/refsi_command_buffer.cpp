@@ -20,23 +20,43 @@
 
 refsi_result refsi_command_buffer::run(refsi_hal_device &hal_device,
                                        refsi_locker &locker) {
+  size_t cb_size = 0;
+  hal::hal_addr_t cb_addr = upload(hal_device, locker, cb_size);
+  if (!cb_addr) {
+    return refsi_failure;
+  }
+  refsi_result result = execute(hal_device, cb_addr, cb_size);
+  hal_device.mem_free(cb_addr, locker);
+  return result;
+}
+
+hal::hal_addr_t refsi_command_buffer::upload(refsi_hal_device &hal_device,
+                                             refsi_locker &locker,
+                                             size_t &size) {
   // Write the command buffer to device memory.
   size_t cb_size = chunks.size() * sizeof(uint64_t);
   hal::hal_addr_t cb_addr = hal_device.mem_alloc(cb_size, sizeof(uint64_t),
                                                  locker);
-  if (!cb_addr || !hal_device.mem_write(cb_addr, chunks.data(), cb_size,
-                                        locker)) {
-    return refsi_failure;
+  if (!cb_addr) {
+    return hal::hal_nullptr;
   }
+  if (!hal_device.mem_write(cb_addr, chunks.data(), cb_size, locker)) {
+    hal_device.mem_free(cb_addr, locker);
+    return hal::hal_nullptr;
+  }
+  size = cb_size;
+  return cb_addr;
+}
 
+refsi_result refsi_command_buffer::execute(refsi_hal_device &hal_device,
+                                           hal::hal_addr_t cb_addr,
+                                           size_t cb_size) {
   // Execute the command buffer and wait for its completion.
   if (refsi_result result = refsiExecuteCommandBuffer(hal_device.get_device(),
                                                       cb_addr, cb_size)) {
-    hal_device.mem_free(cb_addr, locker);
     return result;
   }
   refsiWaitForDeviceIdle(hal_device.get_device());
-  hal_device.mem_free(cb_addr, locker);
   return refsi_success;
 }
 
@@ -236,10 +236,62 @@ bool refsi_m1_hal_device::kernel_exec(hal::hal_program_t program,
                                       const hal::hal_arg_t *args,
                                       uint32_t num_args, uint32_t work_dim) {
   refsi_locker locker(hal_lock);
+  refsi_m1_launch *launch = prepareLaunch(program, kernel, nd_range, args,
+                                          num_args, work_dim, locker);
+  if (!launch) {
+    return false;
+  }
+  bool success = runLaunch(*launch, locker);
+  freeLaunch(launch, locker);
+  return success;
+}
+
+hal::hal_launch_t refsi_m1_hal_device::launch_prepare(
+    hal::hal_program_t program, hal::hal_kernel_t kernel,
+    const hal::hal_ndrange_t *nd_range, const hal::hal_arg_t *args,
+    uint32_t num_args, uint32_t work_dim) {
+  refsi_locker locker(hal_lock);
+  refsi_m1_launch *launch = prepareLaunch(program, kernel, nd_range, args,
+                                          num_args, work_dim, locker);
+  return (hal::hal_launch_t)launch;
+}
+
+bool refsi_m1_hal_device::launch_exec(hal::hal_launch_t launch,
+                                      const hal::hal_arg_t *args,
+                                      uint32_t num_args) {
+  refsi_locker locker(hal_lock);
+  if ((launch == hal::hal_invalid_launch) || ((num_args > 0) && !args)) {
+    return false;
+  }
+  auto *m1_launch = reinterpret_cast<refsi_m1_launch *>(launch);
+  if (hal_debug()) {
+    fprintf(stderr,
+            "refsi_hal_device::launch_exec(kernel=0x%08lx, num_args=%d)\n",
+            m1_launch->kernel->symbol, num_args);
+  }
+  if (!writeLaunchArgs(*m1_launch, args, num_args, locker)) {
+    return false;
+  }
+  return runLaunch(*m1_launch, locker);
+}
+
+bool refsi_m1_hal_device::launch_free(hal::hal_launch_t launch) {
+  refsi_locker locker(hal_lock);
+  if (launch == hal::hal_invalid_launch) {
+    return false;
+  }
+  freeLaunch(reinterpret_cast<refsi_m1_launch *>(launch), locker);
+  return true;
+}
+
+refsi_m1_launch *refsi_m1_hal_device::prepareLaunch(
+    hal::hal_program_t program, hal::hal_kernel_t kernel,
+    const hal::hal_ndrange_t *nd_range, const hal::hal_arg_t *args,
+    uint32_t num_args, uint32_t work_dim, refsi_locker &locker) {
   if ((program == hal::hal_invalid_program) ||
       (kernel == hal::hal_invalid_kernel) || !nd_range ||
       (num_args > 0) && !args) {
-    return false;
+    return nullptr;
   }
   refsi_hal_program *refsi_program = (refsi_hal_program *)program;
   ELFProgram *elf = refsi_program->elf.get();
@@ -263,14 +315,13 @@ bool refsi_m1_hal_device::kernel_exec(hal::hal_program_t program,
 
   // Prepare N-D range dimensions.
   uint64_t work_group_size = 1;
-  uint32_t max_harts = num_harts_per_core;
   wg.num_dim = work_dim;
   for (int i = 0; i < DIMS; i++) {
     wg.local_size[i] =  nd_range->local[i];
     work_group_size *= wg.local_size[i];
     wg.num_groups[i] = (nd_range->global[i] / wg.local_size[i]);
     if ((wg.num_groups[i] * wg.local_size[i]) != nd_range->global[i]) {
-      return false;
+      return nullptr;
     }
     wg.global_offset[i] = nd_range->offset[i];
   }
@@ -280,20 +331,13 @@ bool refsi_m1_hal_device::kernel_exec(hal::hal_program_t program,
   hal::hal_addr_t text_end_addr = elf_mem_base + elf_mem_size;
   for (const elf_segment &segment : elf->get_segments()) {
     if ((segment.address < elf_mem_base) || (segment.address >= text_end_addr)) {
-      return false;
+      return nullptr;
     }
     hal::hal_addr_t segment_end = segment.address + segment.memory_size;
     if ((segment_end < elf_mem_base) || (segment_end > text_end_addr)) {
-      return false;
+      return nullptr;
     }
   }
-
-  // Load ELF into Spike's memory.
-  RefSiMemoryWrapper mem_device(device);
-  MemoryController loader_if(&mem_device);
-  if (!elf->load(loader_if)) {
-    return false;
-  }
   exec.kernel_entry = kernel_wrapper->symbol;
 
   auto alignBuffer = [](std::vector<uint8_t> &buffer, uint64_t align) {
@@ -302,11 +346,10 @@ bool refsi_m1_hal_device::kernel_exec(hal::hal_program_t program,
   };
 
   // Pack arguments.
-  uint32_t kargs_offset = 0;
   std::vector<uint8_t> packed_args;
   hal::util::hal_argpack_t packer(64);
   if (!packer.build(args, num_args)) {
-    return false;
+    return nullptr;
   }
   packed_args.resize(packer.size());
   memcpy(packed_args.data(), packer.data(), packer.size());
@@ -325,23 +368,47 @@ bool refsi_m1_hal_device::kernel_exec(hal::hal_program_t program,
   hal::hal_addr_t kub_size = packed_args.size();
   hal::hal_addr_t kub_addr = mem_alloc(kub_size, kub_align, locker);
   if (!kub_addr || !mem_write(kub_addr, packed_args.data(), kub_size, locker)) {
-    return false;
+    mem_free(kub_addr, locker);
+    return nullptr;
   }
 
+  std::unique_ptr<refsi_m1_launch> launch(new refsi_m1_launch());
+  launch->program = refsi_program;
+  launch->kernel = kernel_wrapper;
+  launch->work_dim = work_dim;
+  launch->num_instances = wg.num_groups[0];
+  launch->num_slices = (work_dim == 2) ? wg.num_groups[1] : 1;
+  launch->num_slices = (work_dim == 3) ? wg.num_groups[1] * wg.num_groups[2]
+                                       : launch->num_slices;
+  launch->kub_addr = kub_addr;
+  launch->args_size = packer.size();
+  launch->exec_offset = exec_offset;
+  if (!encodeLaunch(*launch, locker)) {
+    freeLaunch(launch.release(), locker);
+    return nullptr;
+  }
+  return launch.release();
+}
+
+bool refsi_m1_hal_device::encodeLaunch(refsi_m1_launch &launch,
+                                       refsi_locker &locker) {
+  uint32_t max_harts = num_harts_per_core;
+  uint32_t exec_size = sizeof(exec_state_t);
+
   // Allocate memory for performance counters. We need to allocate two sets of
   // performance counter registers, one captured before executing the kernel
   // and one after. The reported values for the counters will be the difference
   // between the two sets of values.
-  hal::hal_addr_t counters_buffer_addr = hal::hal_nullptr;
   hal::hal_addr_t counters_io_addr = hal::hal_nullptr;
   uint32_t num_counters = REFSI_NUM_PER_HART_PERF_COUNTERS;
   uint32_t counters_set_size = num_counters * sizeof(uint64_t) * max_harts;
   uint32_t counters_buffer_size = counters_set_size * 2;
+  launch.counters_enabled = counters_enabled;
   if (counters_enabled) {
     counters_io_addr = mem_map[PERF_COUNTERS].start_addr;
-    counters_buffer_addr = mem_alloc(counters_buffer_size, sizeof(uint64_t),
-                                     locker);
-    if (!counters_buffer_addr) {
+    launch.counters_buffer_addr = mem_alloc(counters_buffer_size,
+                                            sizeof(uint64_t), locker);
+    if (!launch.counters_buffer_addr) {
       return false;
     }
   }
@@ -350,7 +417,7 @@ bool refsi_m1_hal_device::kernel_exec(hal::hal_program_t program,
 
   // Start a 2D DMA transfer to copy scheduling info to all harts.
   uint64_t config = REFSI_DMA_2D | REFSI_DMA_STRIDE_BOTH;
-  cb.addWriteDMAReg(REFSI_REG_DMASRCADDR, kub_addr + exec_offset);
+  cb.addWriteDMAReg(REFSI_REG_DMASRCADDR, launch.kub_addr + launch.exec_offset);
   cb.addWriteDMAReg(REFSI_REG_DMADSTADDR, tcdm_hart_target);
   cb.addWriteDMAReg(REFSI_REG_DMAXFERSIZE0 + 0, exec_size);
   cb.addWriteDMAReg(REFSI_REG_DMAXFERSIZE0 + 1, num_harts_per_core);
@@ -377,12 +444,13 @@ bool refsi_m1_hal_device::kernel_exec(hal::hal_program_t program,
   if (!return_addr) {
     return false;
   }
-  cb.addWRITE_REG64(CMP_REG_ENTRY_PT_FN, launch_kernel_addrs[work_dim - 1]);
+  cb.addWRITE_REG64(CMP_REG_ENTRY_PT_FN,
+                    launch_kernel_addrs[launch.work_dim - 1]);
   cb.addWRITE_REG64(CMP_REG_STACK_TOP, stack_top);
   cb.addWRITE_REG64(CMP_REG_RETURN_ADDR, return_addr);
   if (counters_enabled) {
     // Read values from performance counters before executing the kernel.
-    hal::hal_addr_t dest_addr = counters_buffer_addr;
+    hal::hal_addr_t dest_addr = launch.counters_buffer_addr;
     for (uint32_t i = 0; i < max_harts; i++) {
       uint32_t unit = REFSI_UNIT_ID(REFSI_UNIT_KIND_ACC_HART, i);
       cb.addCOPY_MEM64(counters_io_addr, dest_addr, num_counters, unit);
@@ -390,22 +458,17 @@ bool refsi_m1_hal_device::kernel_exec(hal::hal_program_t program,
     }
   }
   std::vector<uint64_t> extra_args;
-  extra_args.push_back(0);                        // slice_id
-  extra_args.push_back(kub_addr + kargs_offset);  // kernel arguments
-  extra_args.push_back(tcdm_hart_base);           // execution state
-  uint64_t num_instances = wg.num_groups[0];
-  uint64_t num_slices = 0;
-  num_slices = (work_dim == 2) ? wg.num_groups[1] : 1;
-  num_slices = (work_dim == 3) ? wg.num_groups[1] * wg.num_groups[2]
-                               : num_slices;
-  for (uint64_t i = 0; i < num_slices; i++) {
+  extra_args.push_back(0);                // slice_id
+  extra_args.push_back(launch.kub_addr);  // kernel arguments
+  extra_args.push_back(tcdm_hart_base);   // execution state
+  for (uint64_t i = 0; i < launch.num_slices; i++) {
     extra_args[0] = i;
-    cb.addRUN_INSTANCES(max_harts, num_instances, extra_args);
+    cb.addRUN_INSTANCES(max_harts, launch.num_instances, extra_args);
   }
   cb.addSYNC_CACHE(cache_flags);
   if (counters_enabled) {
     // Read values from performance counters after the kernel has finished.
-    hal::hal_addr_t dest_addr = counters_buffer_addr + counters_set_size;
+    hal::hal_addr_t dest_addr = launch.counters_buffer_addr + counters_set_size;
     for (uint32_t i = 0; i < max_harts; i++) {
       uint32_t unit = REFSI_UNIT_ID(REFSI_UNIT_KIND_ACC_HART, i);
       cb.addCOPY_MEM64(counters_io_addr, dest_addr, num_counters, unit);
@@ -414,17 +477,58 @@ bool refsi_m1_hal_device::kernel_exec(hal::hal_program_t program,
   }
   cb.addFINISH();
 
+  // Write the command buffer to device memory so that it can be replayed.
+  launch.cb_addr = cb.upload(*this, locker, launch.cb_size);
+  return launch.cb_addr != hal::hal_nullptr;
+}
+
+bool refsi_m1_hal_device::writeLaunchArgs(refsi_m1_launch &launch,
+                                          const hal::hal_arg_t *args,
+                                          uint32_t num_args,
+                                          refsi_locker &locker) {
+  // Only the kernel arguments can change between launches. The execution
+  // state that follows them in the KUB is left untouched.
+  hal::util::hal_argpack_t packer(64);
+  if (!packer.build(args, num_args) || (packer.size() != launch.args_size)) {
+    return false;
+  }
+  return mem_write(launch.kub_addr, packer.data(), packer.size(), locker);
+}
+
+bool refsi_m1_hal_device::runLaunch(refsi_m1_launch &launch,
+                                    refsi_locker &locker) {
+  // Encode the command buffer again if counters have been enabled or disabled
+  // since the launch was prepared.
+  if (launch.counters_enabled != counters_enabled) {
+    releaseLaunchCommands(launch, locker);
+    if (!encodeLaunch(launch, locker)) {
+      return false;
+    }
+  }
+
+  // Load ELF into Spike's memory. This needs to be done for every launch,
+  // since other kernels may have been loaded in the meantime.
+  RefSiMemoryWrapper mem_device(device);
+  MemoryController loader_if(&mem_device);
+  if (!launch.program->elf->load(loader_if)) {
+    return false;
+  }
 
   // Execute the command buffer.
-  if (refsi_success != cb.run(*this, locker)) {
+  if (refsi_success !=
+      refsi_command_buffer::execute(*this, launch.cb_addr, launch.cb_size)) {
     return false;
   }
 
   // Compute the difference between the 'before' and 'after' performance counter
   // values.
-  if (counters_enabled) {
+  if (launch.counters_enabled) {
+    uint32_t max_harts = num_harts_per_core;
+    uint32_t num_counters = REFSI_NUM_PER_HART_PERF_COUNTERS;
+    uint32_t counters_buffer_size =
+        num_counters * sizeof(uint64_t) * max_harts * 2;
     uint64_t *counters_before =
-        (uint64_t *)refsiGetMappedAddress(device, counters_buffer_addr,
+        (uint64_t *)refsiGetMappedAddress(device, launch.counters_buffer_addr,
                                           counters_buffer_size);
     if (counters_before) {
       uint64_t *counters_after = &counters_before[num_counters * max_harts];
@@ -438,12 +542,25 @@ bool refsi_m1_hal_device::kernel_exec(hal::hal_program_t program,
       }
     }
   }
-
-  mem_free(kub_addr, locker);
-  mem_free(counters_buffer_addr, locker);
   return true;
 }
 
+void refsi_m1_hal_device::releaseLaunchCommands(refsi_m1_launch &launch,
+                                                refsi_locker &locker) {
+  mem_free(launch.cb_addr, locker);
+  mem_free(launch.counters_buffer_addr, locker);
+  launch.cb_addr = 0;
+  launch.cb_size = 0;
+  launch.counters_buffer_addr = 0;
+}
+
+void refsi_m1_hal_device::freeLaunch(refsi_m1_launch *launch,
+                                     refsi_locker &locker) {
+  releaseLaunchCommands(*launch, locker);
+  mem_free(launch->kub_addr, locker);
+  delete launch;
+}
+
 bool refsi_m1_hal_device::mem_copy(hal::hal_addr_t dst, hal::hal_addr_t src,
                                    hal::hal_size_t size) {
   refsi_locker locker(hal_lock);
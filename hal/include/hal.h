@@ -73,6 +73,62 @@ struct hal_device_t {
                            const hal_ndrange_t *nd_range, const hal_arg_t *args,
                            uint32_t num_args, uint32_t work_dim) = 0;
 
+  /// @brief Prepare a kernel launch that can be executed several times.
+  ///
+  /// Devices which translate each kernel execution into a command stream can
+  /// encode that stream once here and replay it in `launch_exec`. The program
+  /// must remain loaded until the launch has been freed.
+  ///
+  /// @param program is a handle to a previously loaded program.
+  /// @param kernel is a handle to a previously found kernel.
+  /// @param nd_range contains the work range to execute.
+  /// @param args is a list of argument descriptors for the kernel.
+  /// @param num_args is the number of argument descriptors provided.
+  /// @param work_dim specifies the work dimension for execution (1, 2 or 3).
+  ///
+  /// @return Returns `hal_invalid_launch` if the device does not support
+  /// prepared launches or if the operation fails, otherwise a launch handle.
+  virtual hal_launch_t launch_prepare(hal_program_t program,
+                                      hal_kernel_t kernel,
+                                      const hal_ndrange_t *nd_range,
+                                      const hal_arg_t *args, uint32_t num_args,
+                                      uint32_t work_dim) {
+    (void)program;
+    (void)kernel;
+    (void)nd_range;
+    (void)args;
+    (void)num_args;
+    (void)work_dim;
+    return hal_invalid_launch;
+  }
+
+  /// @brief Execute a prepared kernel launch on the target.
+  ///
+  /// @param launch is a handle to a previously prepared launch.
+  /// @param args is a list of argument descriptors for the kernel. Argument
+  /// values may differ from the ones the launch was prepared with, but the
+  /// kind and size of each argument must be the same.
+  /// @param num_args is the number of argument descriptors provided.
+  ///
+  /// @return returns `false` if the operation fails otherwise `true`.
+  virtual bool launch_exec(hal_launch_t launch, const hal_arg_t *args,
+                           uint32_t num_args) {
+    (void)launch;
+    (void)args;
+    (void)num_args;
+    return false;
+  }
+
+  /// @brief Release a prepared kernel launch.
+  ///
+  /// @param launch is a handle to a previously prepared launch.
+  ///
+  /// @return returns `false` if the operation fails otherwise `true`.
+  virtual bool launch_free(hal_launch_t launch) {
+    (void)launch;
+    return false;
+  }
+
   /// @brief Unload a program from the target.
   ///
   /// @param program is a handle to a previously loaded program.
@@ -218,7 +274,7 @@ struct hal_device_t {
 struct hal_t {
   /// @brief Current version of the HAL API. The version number needs to be
   /// bumped any time the interface is changed.
-  static constexpr uint32_t api_version = 6;
+  static constexpr uint32_t api_version = 7;
 
   /// @brief Return generic platform information.
   ///
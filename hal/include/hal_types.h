@@ -38,11 +38,14 @@ typedef uint64_t hal_word_t;
 typedef uint64_t hal_program_t;
 /// @brief A unique handle identifying a kernel.
 typedef uint64_t hal_kernel_t;
+/// @brief A unique handle identifying a prepared kernel launch.
+typedef uint64_t hal_launch_t;
 
 enum {
   hal_nullptr = 0,
   hal_invalid_program = 0,
   hal_invalid_kernel = 0,
+  hal_invalid_launch = 0,
 };
 
 enum hal_arg_kind_t {
@@ -0,0 +1,200 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief BenchCargo, micro-benchmarks of `cargo::flat_hash_map` against
+/// `std::unordered_map`.
+
+#include <benchmark/benchmark.h>
+#include <cargo/flat_hash_map.h>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+/// @brief Key type mirroring the handle keyed maps in the runtime.
+using key_t = const void *;
+
+/// @brief Uniform interface over the maps being compared.
+template <class Map>
+struct map_traits;
+
+template <>
+struct map_traits<std::unordered_map<key_t, uint64_t>> {
+  using map_type = std::unordered_map<key_t, uint64_t>;
+  static bool insert(map_type &map, key_t key, uint64_t value) {
+    map.emplace(key, value);
+    return true;
+  }
+};
+
+template <>
+struct map_traits<cargo::flat_hash_map<key_t, uint64_t>> {
+  using map_type = cargo::flat_hash_map<key_t, uint64_t>;
+  static bool insert(map_type &map, key_t key, uint64_t value) {
+    return bool(map.try_emplace(key, value));
+  }
+};
+
+/// @brief Benchmark arguments for the number of elements in the map.
+void elementCountArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->RangeMultiplier(8)->Range(8, 1 << 15);
+}
+
+/// @brief Heap allocated objects whose addresses are used as keys, matching
+/// the distribution of handle keys.
+struct keys {
+  explicit keys(size_t count) {
+    for (size_t index = 0; index < count; index++) {
+      objects.emplace_back(new uint64_t(index));
+    }
+  }
+
+  key_t operator[](size_t index) const { return objects[index].get(); }
+  size_t size() const { return objects.size(); }
+
+  std::vector<std::unique_ptr<uint64_t>> objects;
+};
+
+/// @brief Build a map of `state.range(0)` elements from scratch.
+template <class Map>
+void Insert(benchmark::State &state) {
+  const keys keys(state.range(0));
+  for (auto _ : state) {
+    (void)_;
+    Map map;
+    for (size_t index = 0; index < keys.size(); index++) {
+      if (!map_traits<Map>::insert(map, keys[index], index)) {
+        state.SkipWithError("Insertion failed");
+        return;
+      }
+    }
+    benchmark::DoNotOptimize(map);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/// @brief Look up keys which are present in the map.
+template <class Map>
+void FindHit(benchmark::State &state) {
+  const keys keys(state.range(0));
+  Map map;
+  for (size_t index = 0; index < keys.size(); index++) {
+    if (!map_traits<Map>::insert(map, keys[index], index)) {
+      state.SkipWithError("Insertion failed");
+      return;
+    }
+  }
+  size_t next = 0;
+  for (auto _ : state) {
+    (void)_;
+    auto found = map.find(keys[next]);
+    benchmark::DoNotOptimize(found->second);
+    next = next + 1 == keys.size() ? 0 : next + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief Look up keys which are absent from the map.
+template <class Map>
+void FindMiss(benchmark::State &state) {
+  const keys keys(state.range(0) * 2);
+  Map map;
+  for (size_t index = 0; index < keys.size() / 2; index++) {
+    if (!map_traits<Map>::insert(map, keys[index], index)) {
+      state.SkipWithError("Insertion failed");
+      return;
+    }
+  }
+  size_t next = keys.size() / 2;
+  for (auto _ : state) {
+    (void)_;
+    auto found = map.find(keys[next]);
+    benchmark::DoNotOptimize(found == map.end());
+    next = next + 1 == keys.size() ? keys.size() / 2 : next + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief Insert a key, look it up and erase the oldest key, keeping
+/// `state.range(0)` elements live. This is the pattern of the command queue's
+/// pending dispatch and fence maps across flushes and completions.
+template <class Map>
+void Churn(benchmark::State &state) {
+  const size_t live = state.range(0);
+  const keys keys(live * 4);
+  Map map;
+  for (size_t index = 0; index < live; index++) {
+    if (!map_traits<Map>::insert(map, keys[index], index)) {
+      state.SkipWithError("Insertion failed");
+      return;
+    }
+  }
+  size_t oldest = 0;
+  size_t next = live;
+  for (auto _ : state) {
+    (void)_;
+    if (!map_traits<Map>::insert(map, keys[next], next)) {
+      state.SkipWithError("Insertion failed");
+      return;
+    }
+    benchmark::DoNotOptimize(map.find(keys[next])->second);
+    map.erase(keys[oldest]);
+    oldest = oldest + 1 == keys.size() ? 0 : oldest + 1;
+    next = next + 1 == keys.size() ? 0 : next + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief Visit every element of the map.
+template <class Map>
+void Iterate(benchmark::State &state) {
+  const keys keys(state.range(0));
+  Map map;
+  for (size_t index = 0; index < keys.size(); index++) {
+    if (!map_traits<Map>::insert(map, keys[index], index)) {
+      state.SkipWithError("Insertion failed");
+      return;
+    }
+  }
+  for (auto _ : state) {
+    (void)_;
+    uint64_t sum = 0;
+    for (auto &pair : map) {
+      sum += pair.second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+using std_map = std::unordered_map<key_t, uint64_t>;
+using flat_map = cargo::flat_hash_map<key_t, uint64_t>;
+}  // namespace
+
+BENCHMARK_TEMPLATE(Insert, std_map)->Apply(elementCountArguments);
+BENCHMARK_TEMPLATE(Insert, flat_map)->Apply(elementCountArguments);
+BENCHMARK_TEMPLATE(FindHit, std_map)->Apply(elementCountArguments);
+BENCHMARK_TEMPLATE(FindHit, flat_map)->Apply(elementCountArguments);
+BENCHMARK_TEMPLATE(FindMiss, std_map)->Apply(elementCountArguments);
+BENCHMARK_TEMPLATE(FindMiss, flat_map)->Apply(elementCountArguments);
+BENCHMARK_TEMPLATE(Churn, std_map)->Apply(elementCountArguments);
+BENCHMARK_TEMPLATE(Churn, flat_map)->Apply(elementCountArguments);
+BENCHMARK_TEMPLATE(Iterate, std_map)->Apply(elementCountArguments);
+BENCHMARK_TEMPLATE(Iterate, flat_map)->Apply(elementCountArguments);
@@ -0,0 +1,129 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief BenchCargo, micro-benchmarks of `cargo::spsc_queue` and
+/// `cargo::mpmc_queue` against a mutex guarded `cargo::ring_buffer`.
+
+#include <benchmark/benchmark.h>
+#include <cargo/mpmc_queue.h>
+#include <cargo/ring_buffer.h>
+#include <cargo/spsc_queue.h>
+
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace {
+/// @brief Number of elements each queue can hold.
+constexpr uint32_t queue_capacity = 1024;
+
+/// @brief A mutex guarding a container, the pattern the lock-free queues
+/// replace.
+template <class T>
+class locked_queue {
+ public:
+  cargo::result alloc(size_t) { return cargo::success; }
+
+  cargo::result enqueue(const T &value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return buffer.enqueue(value);
+  }
+
+  cargo::error_or<T> dequeue() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return buffer.dequeue();
+  }
+
+ private:
+  std::mutex mutex;
+  cargo::ring_buffer<T, queue_capacity> buffer;
+};
+
+/// @brief The queue shared by the threads of a benchmark.
+template <class Queue>
+Queue &sharedQueue() {
+  static Queue queue;
+  return queue;
+}
+
+/// @brief Enqueue and then dequeue an element on a single thread, measuring
+/// the uncontended cost of a handoff.
+template <class Queue>
+void RoundTrip(benchmark::State &state) {
+  Queue queue;
+  if (queue.alloc(queue_capacity)) {
+    state.SkipWithError("Allocation failed");
+    return;
+  }
+  uint64_t value = 0;
+  for (auto _ : state) {
+    (void)_;
+    if (queue.enqueue(value++)) {
+      state.SkipWithError("Enqueue failed");
+      return;
+    }
+    benchmark::DoNotOptimize(queue.dequeue());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief Pass elements from producer threads to consumer threads. Even
+/// numbered threads produce and odd numbered threads consume, so every
+/// enqueued element is dequeued by the end of the benchmark. Threads yield
+/// while the queue is full or empty.
+template <class Queue>
+void Handoff(benchmark::State &state) {
+  auto &queue = sharedQueue<Queue>();
+  if (0 == state.thread_index) {
+    if (queue.alloc(queue_capacity)) {
+      state.SkipWithError("Allocation failed");
+      return;
+    }
+  }
+  const bool producer = 0 == state.thread_index % 2;
+  uint64_t value = 0;
+  for (auto _ : state) {
+    (void)_;
+    if (producer) {
+      while (queue.enqueue(value)) {
+        std::this_thread::yield();
+      }
+      value++;
+    } else {
+      auto dequeued = queue.dequeue();
+      while (!dequeued) {
+        std::this_thread::yield();
+        dequeued = queue.dequeue();
+      }
+      benchmark::DoNotOptimize(*dequeued);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+using locked = locked_queue<uint64_t>;
+using spsc = cargo::spsc_queue<uint64_t>;
+using mpmc = cargo::mpmc_queue<uint64_t>;
+}  // namespace
+
+BENCHMARK_TEMPLATE(RoundTrip, locked);
+BENCHMARK_TEMPLATE(RoundTrip, spsc);
+BENCHMARK_TEMPLATE(RoundTrip, mpmc);
+BENCHMARK_TEMPLATE(Handoff, locked)->ThreadRange(2, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(Handoff, spsc)->Threads(2)->UseRealTime();
+BENCHMARK_TEMPLATE(Handoff, mpmc)->ThreadRange(2, 8)->UseRealTime();
@@ -0,0 +1,723 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Open addressing hash table shared by `cargo::flat_hash_map` and
+/// `cargo::flat_hash_set`.
+
+#ifndef CARGO_DETAIL_FLAT_HASH_TABLE_H_INCLUDED
+#define CARGO_DETAIL_FLAT_HASH_TABLE_H_INCLUDED
+
+#include <cargo/attributes.h>
+#include <cargo/error.h>
+#include <cargo/utility.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CARGO_FLAT_HASH_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace cargo {
+namespace detail {
+
+/// @brief Control byte values of slots which do not hold an element.
+///
+/// A full slot has a control byte in the range [0, 127] holding the low seven
+/// bits of its element's hash. The sentinel marks the end of the control bytes
+/// so iteration can stop without checking the capacity.
+enum flat_hash_ctrl : int8_t {
+  flat_hash_ctrl_empty = -128,
+  flat_hash_ctrl_deleted = -2,
+  flat_hash_ctrl_sentinel = -1,
+};
+
+/// @brief Index of the lowest set bit of a non-zero value.
+inline uint32_t flatHashLowestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint32_t>(__builtin_ctzll(value));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return static_cast<uint32_t>(index);
+#else
+  uint32_t index = 0;
+  while (!(value & 1)) {
+    value >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+/// @brief Index of the highest set bit of a non-zero value.
+inline uint32_t flatHashHighestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return static_cast<uint32_t>(index);
+#else
+  uint32_t index = 0;
+  while (value >>= 1) {
+    index++;
+  }
+  return index;
+#endif
+}
+
+/// @brief Set of slots in a group which matched a query.
+///
+/// Each matching slot is represented by one set bit. `Shift` converts a bit
+/// index to a slot index, so the same type serves groups using one bit or one
+/// byte per slot.
+template <uint32_t Shift>
+class flat_hash_bitmask {
+ public:
+  explicit flat_hash_bitmask(uint64_t mask) : Mask(mask) {}
+
+  /// @brief Determine if any slot matched.
+  explicit operator bool() const { return Mask != 0; }
+
+  /// @brief Index of the first matching slot, requires a match.
+  uint32_t lowest() const { return flatHashLowestBit(Mask) >> Shift; }
+
+  /// @brief Index of the last matching slot, requires a match.
+  uint32_t highest() const { return flatHashHighestBit(Mask) >> Shift; }
+
+  /// @brief Iterator over the indices of the matching slots.
+  class bit_iterator {
+   public:
+    explicit bit_iterator(uint64_t mask) : Mask(mask) {}
+    uint32_t operator*() const { return flatHashLowestBit(Mask) >> Shift; }
+    bit_iterator &operator++() {
+      Mask &= Mask - 1;
+      return *this;
+    }
+    bool operator!=(const bit_iterator &other) const {
+      return Mask != other.Mask;
+    }
+
+   private:
+    uint64_t Mask;
+  };
+
+  bit_iterator begin() const { return bit_iterator(Mask); }
+  bit_iterator end() const { return bit_iterator(0); }
+
+ private:
+  uint64_t Mask;
+};
+
+#ifdef CARGO_FLAT_HASH_SSE2
+/// @brief A group of 16 control bytes compared with SSE2 instructions.
+class flat_hash_group {
+ public:
+  static constexpr size_t width = 16;
+  using bitmask = flat_hash_bitmask<0>;
+
+  explicit flat_hash_group(const int8_t *ctrl)
+      : Ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))) {}
+
+  /// @brief Find the full slots whose hash bits equal @p h2.
+  bitmask match(int8_t h2) const {
+    return bitmask(static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), Ctrl))));
+  }
+
+  /// @brief Find the empty slots.
+  bitmask matchEmpty() const { return match(flat_hash_ctrl_empty); }
+
+  /// @brief Find the empty and deleted slots.
+  bitmask matchEmptyOrDeleted() const {
+    return bitmask(static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_cmpgt_epi8(_mm_set1_epi8(flat_hash_ctrl_sentinel), Ctrl))));
+  }
+
+  /// @brief Count the empty and deleted slots at the start of the group.
+  uint32_t countLeadingEmptyOrDeleted() const {
+    const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_cmpgt_epi8(_mm_set1_epi8(flat_hash_ctrl_sentinel), Ctrl)));
+    return flatHashLowestBit(~uint64_t(mask));
+  }
+
+ private:
+  __m128i Ctrl;
+};
+#else
+/// @brief A group of 8 control bytes compared as a 64-bit integer.
+///
+/// Byte `i` of the group is held in bits `[8 * i, 8 * i + 8)` regardless of
+/// the endianness of the host.
+class flat_hash_group {
+ public:
+  static constexpr size_t width = 8;
+  using bitmask = flat_hash_bitmask<3>;
+
+  explicit flat_hash_group(const int8_t *ctrl) : Ctrl(0) {
+    for (size_t index = 0; index < width; index++) {
+      Ctrl |= uint64_t(static_cast<uint8_t>(ctrl[index])) << (8 * index);
+    }
+  }
+
+  /// @brief Find the full slots whose hash bits equal @p h2.
+  ///
+  /// This may report a false positive for a full slot following a true match.
+  /// The caller compares keys so this does not affect correctness.
+  bitmask match(int8_t h2) const {
+    const uint64_t x = Ctrl ^ (lsbs * static_cast<uint8_t>(h2));
+    return bitmask((x - lsbs) & ~x & msbs);
+  }
+
+  /// @brief Find the empty slots, which have bit 7 set and bit 1 clear.
+  bitmask matchEmpty() const { return bitmask(Ctrl & (~Ctrl << 6) & msbs); }
+
+  /// @brief Find the empty and deleted slots, which have bit 7 set and bit 0
+  /// clear.
+  bitmask matchEmptyOrDeleted() const {
+    return bitmask(Ctrl & (~Ctrl << 7) & msbs);
+  }
+
+  /// @brief Count the empty and deleted slots at the start of the group.
+  uint32_t countLeadingEmptyOrDeleted() const {
+    const uint64_t other = ~(Ctrl & (~Ctrl << 7)) & msbs;
+    return other ? flatHashLowestBit(other) >> 3 : uint32_t(width);
+  }
+
+ private:
+  static constexpr uint64_t lsbs = 0x0101010101010101ULL;
+  static constexpr uint64_t msbs = 0x8080808080808080ULL;
+  uint64_t Ctrl;
+};
+#endif
+
+/// @brief Open addressing hash table with group probing.
+///
+/// Each slot has a control byte stored in a separate array. Lookups probe a
+/// group of control bytes at a time, comparing seven bits of the hash of every
+/// slot in the group at once. Only slots whose bits match have their keys
+/// compared. The control bytes and the slots share one allocation made with
+/// the table's allocator.
+///
+/// @tparam Policy Describes the stored element, see `cargo::flat_hash_map`.
+/// @tparam Hash Hash function object type.
+/// @tparam KeyEqual Key equality function object type.
+/// @tparam A Allocator of `Policy::value_type`.
+template <class Policy, class Hash, class KeyEqual, class A>
+class flat_hash_table {
+ public:
+  using key_type = typename Policy::key_type;
+  using value_type = typename Policy::value_type;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = A;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+
+  /// @brief Iterator over the full slots of the table.
+  template <bool Const>
+  class basic_iterator {
+    friend class flat_hash_table;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename Policy::value_type;
+    using difference_type = ptrdiff_t;
+    using reference =
+        typename std::conditional<Const, const value_type &,
+                                  value_type &>::type;
+    using pointer = typename std::conditional<Const, const value_type *,
+                                              value_type *>::type;
+
+    basic_iterator() : Ctrl(nullptr), Slot(nullptr) {}
+
+    /// @brief Conversion from a mutable iterator to a const iterator.
+    template <bool OtherConst,
+              class = typename std::enable_if<Const && !OtherConst>::type>
+    basic_iterator(const basic_iterator<OtherConst> &other)
+        : Ctrl(other.Ctrl), Slot(other.Slot) {}
+
+    reference operator*() const { return *Slot; }
+    pointer operator->() const { return Slot; }
+
+    basic_iterator &operator++() {
+      ++Ctrl;
+      ++Slot;
+      skipEmptyOrDeleted();
+      return *this;
+    }
+
+    basic_iterator operator++(int) {
+      basic_iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    friend bool operator==(const basic_iterator &lhs,
+                           const basic_iterator &rhs) {
+      return lhs.Ctrl == rhs.Ctrl;
+    }
+
+    friend bool operator!=(const basic_iterator &lhs,
+                           const basic_iterator &rhs) {
+      return lhs.Ctrl != rhs.Ctrl;
+    }
+
+   private:
+    template <bool>
+    friend class basic_iterator;
+
+    basic_iterator(const int8_t *ctrl, value_type *slot)
+        : Ctrl(ctrl), Slot(slot) {}
+
+    /// @brief Advance to the next full slot or the sentinel, skipping over
+    /// runs of empty and deleted slots a group at a time.
+    void skipEmptyOrDeleted() {
+      while (*Ctrl < flat_hash_ctrl_sentinel) {
+        const uint32_t shift =
+            flat_hash_group(Ctrl).countLeadingEmptyOrDeleted();
+        Ctrl += shift;
+        Slot += shift;
+      }
+    }
+
+    const int8_t *Ctrl;
+    value_type *Slot;
+  };
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  flat_hash_table(const hasher &hash = hasher(),
+                  const key_equal &equal = key_equal(),
+                  allocator_type allocator = allocator_type())
+      : Hasher(hash),
+        Equal(equal),
+        Allocator(allocator),
+        Ctrl(nullptr),
+        Slots(nullptr),
+        Capacity(0),
+        Size(0),
+        GrowthLeft(0) {}
+
+  flat_hash_table(const flat_hash_table &) = delete;
+  flat_hash_table &operator=(const flat_hash_table &) = delete;
+
+  flat_hash_table(flat_hash_table &&other)
+      : Hasher(std::move(other.Hasher)),
+        Equal(std::move(other.Equal)),
+        Allocator(other.Allocator),
+        // explicit namespace due to MSVC ADL finding std::exchange
+        Ctrl(cargo::exchange(other.Ctrl, nullptr)),
+        Slots(cargo::exchange(other.Slots, nullptr)),
+        Capacity(cargo::exchange(other.Capacity, size_type(0))),
+        Size(cargo::exchange(other.Size, size_type(0))),
+        GrowthLeft(cargo::exchange(other.GrowthLeft, size_type(0))) {}
+
+  flat_hash_table &operator=(flat_hash_table &&other) {
+    if (this != &other) {
+      destroyAndFree();
+      Hasher = std::move(other.Hasher);
+      Equal = std::move(other.Equal);
+      Allocator = other.Allocator;
+      Ctrl = cargo::exchange(other.Ctrl, nullptr);
+      Slots = cargo::exchange(other.Slots, nullptr);
+      Capacity = cargo::exchange(other.Capacity, size_type(0));
+      Size = cargo::exchange(other.Size, size_type(0));
+      GrowthLeft = cargo::exchange(other.GrowthLeft, size_type(0));
+    }
+    return *this;
+  }
+
+  ~flat_hash_table() { destroyAndFree(); }
+
+  iterator begin() {
+    if (!Ctrl) {
+      return end();
+    }
+    iterator it(Ctrl, Slots);
+    it.skipEmptyOrDeleted();
+    return it;
+  }
+  const_iterator begin() const {
+    return const_cast<flat_hash_table *>(this)->begin();
+  }
+  const_iterator cbegin() const { return begin(); }
+
+  iterator end() {
+    return Ctrl ? iterator(Ctrl + Capacity, Slots + Capacity) : iterator();
+  }
+  const_iterator end() const {
+    return const_cast<flat_hash_table *>(this)->end();
+  }
+  const_iterator cend() const { return end(); }
+
+  bool empty() const { return Size == 0; }
+  size_type size() const { return Size; }
+
+  /// @brief Number of slots. The table grows before all of them are full.
+  size_type capacity() const { return Capacity; }
+
+  /// @brief Destroy all elements, keeping the allocated storage.
+  void clear() {
+    if (!Ctrl) {
+      return;
+    }
+    for (size_type index = 0; index < Capacity; index++) {
+      if (isFull(Ctrl[index])) {
+        Slots[index].~value_type();
+      }
+    }
+    resetCtrl();
+    Size = 0;
+    GrowthLeft = growthFor(Capacity);
+  }
+
+  /// @brief Ensure @p count elements can be held without growing.
+  ///
+  /// @return Returns `cargo::bad_alloc` on allocation failure,
+  /// `cargo::success` otherwise.
+  CARGO_NODISCARD cargo::result reserve(size_type count) {
+    if (count <= Size + GrowthLeft) {
+      return cargo::success;
+    }
+    size_type capacity = minimumCapacity;
+    while (growthFor(capacity) < count) {
+      capacity = capacity * 2 + 1;
+    }
+    return resize(capacity);
+  }
+
+  iterator find(const key_type &key) {
+    if (!Ctrl) {
+      return end();
+    }
+    const size_type index = findIndex(key, hashOf(key));
+    return index == Capacity ? end() : iteratorAt(index);
+  }
+  const_iterator find(const key_type &key) const {
+    return const_cast<flat_hash_table *>(this)->find(key);
+  }
+
+  size_type count(const key_type &key) const {
+    return find(key) == end() ? 0 : 1;
+  }
+
+  bool contains(const key_type &key) const { return find(key) != end(); }
+
+  /// @brief Insert an element constructed from @p key and @p args if @p key
+  /// is absent.
+  ///
+  /// @return Returns an iterator to the element with the key and whether it
+  /// was inserted, or `cargo::bad_alloc` if the table failed to grow.
+  template <class... Args>
+  CARGO_NODISCARD error_or<std::pair<iterator, bool>> try_emplace(
+      const key_type &key, Args &&...args) {
+    return tryEmplaceImpl(key, std::forward<Args>(args)...);
+  }
+
+  /// @copydoc try_emplace
+  template <class... Args>
+  CARGO_NODISCARD error_or<std::pair<iterator, bool>> try_emplace(
+      key_type &&key, Args &&...args) {
+    return tryEmplaceImpl(std::move(key), std::forward<Args>(args)...);
+  }
+
+  /// @brief Erase the element at @p pos.
+  ///
+  /// @return Returns an iterator to the element following @p pos.
+  iterator erase(const_iterator pos) {
+    const size_type index = static_cast<size_type>(pos.Ctrl - Ctrl);
+    eraseAt(index);
+    iterator next(Ctrl + index, Slots + index);
+    ++next;
+    return next;
+  }
+
+  /// @brief Erase the element with @p key, if present.
+  ///
+  /// @return Returns the number of elements erased.
+  size_type erase(const key_type &key) {
+    if (!Ctrl) {
+      return 0;
+    }
+    const size_type index = findIndex(key, hashOf(key));
+    if (index == Capacity) {
+      return 0;
+    }
+    eraseAt(index);
+    return 1;
+  }
+
+  void swap(flat_hash_table &other) {
+    using std::swap;
+    swap(Hasher, other.Hasher);
+    swap(Equal, other.Equal);
+    swap(Allocator, other.Allocator);
+    swap(Ctrl, other.Ctrl);
+    swap(Slots, other.Slots);
+    swap(Capacity, other.Capacity);
+    swap(Size, other.Size);
+    swap(GrowthLeft, other.GrowthLeft);
+  }
+
+  hasher hash_function() const { return Hasher; }
+  key_equal key_eq() const { return Equal; }
+  allocator_type get_allocator() const { return Allocator; }
+
+ private:
+  using group = flat_hash_group;
+
+  template <class K, class... Args>
+  error_or<std::pair<iterator, bool>> tryEmplaceImpl(K &&key,
+                                                     Args &&...args) {
+    const uint64_t hash = hashOf(key);
+    if (Ctrl) {
+      const size_type found = findIndex(key, hash);
+      if (found != Capacity) {
+        return std::make_pair(iteratorAt(found), false);
+      }
+    }
+    size_type index = Ctrl ? findFirstNonFull(hash) : Capacity;
+    if (!Ctrl || (GrowthLeft == 0 && Ctrl[index] == flat_hash_ctrl_empty)) {
+      if (auto error = grow()) {
+        return error;
+      }
+      index = findFirstNonFull(hash);
+    }
+    Policy::construct(&Slots[index], std::forward<K>(key),
+                      std::forward<Args>(args)...);
+    Size++;
+    if (Ctrl[index] == flat_hash_ctrl_empty) {
+      GrowthLeft--;
+    }
+    setCtrl(index, h2Of(hash));
+    return std::make_pair(iteratorAt(index), true);
+  }
+
+  /// @brief Smallest capacity. Holding a whole group of real slots avoids
+  /// special cases when probing tables smaller than a group.
+  static constexpr size_type minimumCapacity = group::width - 1;
+
+  static bool isFull(int8_t ctrl) { return ctrl >= 0; }
+
+  /// @brief Maximum number of elements for a capacity, keeping at least one
+  /// slot empty so every probe terminates.
+  static size_type growthFor(size_type capacity) {
+    return capacity - (capacity + 1) / 8;
+  }
+
+  /// @brief Hash a key, mixing the bits so that identity hashes of aligned
+  /// pointers spread across the table.
+  uint64_t hashOf(const key_type &key) const {
+    uint64_t hash = static_cast<uint64_t>(Hasher(key));
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  /// @brief Hash bits selecting the first group to probe.
+  static size_type h1Of(uint64_t hash) {
+    return static_cast<size_type>(hash >> 7);
+  }
+
+  /// @brief Hash bits stored in the control byte.
+  static int8_t h2Of(uint64_t hash) { return static_cast<int8_t>(hash & 0x7F); }
+
+  iterator iteratorAt(size_type index) {
+    return iterator(Ctrl + index, Slots + index);
+  }
+
+  /// @brief Number of control bytes. The sentinel is followed by copies of
+  /// the first `group::width - 1` bytes so a group can be loaded at any slot.
+  static size_type ctrlBytesFor(size_type capacity) {
+    return capacity + group::width;
+  }
+
+  /// @brief Number of `value_type` sized units holding the control bytes at
+  /// the start of the allocation.
+  static size_type ctrlUnitsFor(size_type capacity) {
+    return (ctrlBytesFor(capacity) + sizeof(value_type) - 1) /
+           sizeof(value_type);
+  }
+
+  /// @brief Set the control byte of a slot and its copy past the sentinel.
+  void setCtrl(size_type index, int8_t ctrl) {
+    Ctrl[index] = ctrl;
+    Ctrl[((index - (group::width - 1)) & Capacity) + (group::width - 1)] = ctrl;
+  }
+
+  /// @brief Mark every slot empty and write the sentinel.
+  void resetCtrl() {
+    std::memset(Ctrl, flat_hash_ctrl_empty, ctrlBytesFor(Capacity));
+    Ctrl[Capacity] = flat_hash_ctrl_sentinel;
+  }
+
+  /// @brief Find the slot holding @p key.
+  ///
+  /// @return Returns the index of the slot, or `Capacity` if there is none.
+  size_type findIndex(const key_type &key, uint64_t hash) const {
+    const int8_t h2 = h2Of(hash);
+    size_type offset = h1Of(hash) & Capacity;
+    for (size_type step = group::width;; step += group::width) {
+      const group g(Ctrl + offset);
+      for (uint32_t slot : g.match(h2)) {
+        const size_type index = (offset + slot) & Capacity;
+        if (Equal(Policy::key(Slots[index]), key)) {
+          return index;
+        }
+      }
+      if (g.matchEmpty()) {
+        return Capacity;
+      }
+      offset = (offset + step) & Capacity;
+    }
+  }
+
+  /// @brief Find the first empty or deleted slot on the probe sequence.
+  size_type findFirstNonFull(uint64_t hash) const {
+    size_type offset = h1Of(hash) & Capacity;
+    for (size_type step = group::width;; step += group::width) {
+      const auto mask = group(Ctrl + offset).matchEmptyOrDeleted();
+      if (mask) {
+        return (offset + mask.lowest()) & Capacity;
+      }
+      offset = (offset + step) & Capacity;
+    }
+  }
+
+  /// @brief Destroy the element at @p index.
+  ///
+  /// The slot is marked empty if no probe sequence can have passed over it,
+  /// which is the case if fewer than a group's worth of consecutive slots
+  /// around it are non-empty. Otherwise it is marked deleted so probes
+  /// continue past it.
+  void eraseAt(size_type index) {
+    Slots[index].~value_type();
+    Size--;
+    const size_type before = (index - group::width) & Capacity;
+    const auto empty_after = group(Ctrl + index).matchEmpty();
+    const auto empty_before = group(Ctrl + before).matchEmpty();
+    const bool was_never_full =
+        empty_before && empty_after &&
+        (group::width - 1 - empty_before.highest()) + empty_after.lowest() <
+            group::width;
+    if (was_never_full) {
+      setCtrl(index, flat_hash_ctrl_empty);
+      GrowthLeft++;
+    } else {
+      setCtrl(index, flat_hash_ctrl_deleted);
+    }
+  }
+
+  /// @brief Make room for one more element.
+  ///
+  /// Rehashes at the same capacity if deleted slots make up much of the table,
+  /// otherwise doubles the capacity.
+  cargo::result grow() {
+    if (!Ctrl) {
+      return resize(minimumCapacity);
+    }
+    if (Size <= growthFor(Capacity) / 2) {
+      return resize(Capacity);
+    }
+    return resize(Capacity * 2 + 1);
+  }
+
+  /// @brief Move all elements to new storage with @p capacity slots.
+  cargo::result resize(size_type capacity) {
+    const size_type ctrl_units = ctrlUnitsFor(capacity);
+    value_type *storage = Allocator.alloc(ctrl_units + capacity);
+    if (nullptr == storage) {
+      return cargo::bad_alloc;
+    }
+    int8_t *old_ctrl = Ctrl;
+    value_type *old_slots = Slots;
+    const size_type old_capacity = Capacity;
+
+    Ctrl = reinterpret_cast<int8_t *>(storage);
+    Slots = storage + ctrl_units;
+    Capacity = capacity;
+    resetCtrl();
+
+    if (old_ctrl) {
+      for (size_type index = 0; index < old_capacity; index++) {
+        if (isFull(old_ctrl[index])) {
+          const uint64_t hash = hashOf(Policy::key(old_slots[index]));
+          const size_type new_index = findFirstNonFull(hash);
+          new (&Slots[new_index]) value_type(std::move(old_slots[index]));
+          old_slots[index].~value_type();
+          setCtrl(new_index, h2Of(hash));
+        }
+      }
+      Allocator.free(reinterpret_cast<value_type *>(old_ctrl));
+    }
+    GrowthLeft = growthFor(Capacity) - Size;
+    return cargo::success;
+  }
+
+  void destroyAndFree() {
+    if (!Ctrl) {
+      return;
+    }
+    for (size_type index = 0; index < Capacity; index++) {
+      if (isFull(Ctrl[index])) {
+        Slots[index].~value_type();
+      }
+    }
+    Allocator.free(reinterpret_cast<value_type *>(Ctrl));
+    Ctrl = nullptr;
+    Slots = nullptr;
+    Capacity = 0;
+    Size = 0;
+    GrowthLeft = 0;
+  }
+
+  hasher Hasher;
+  key_equal Equal;
+  allocator_type Allocator;
+  /// @brief Control bytes, `nullptr` until the first insertion.
+  int8_t *Ctrl;
+  /// @brief Element storage, following the control bytes.
+  value_type *Slots;
+  /// @brief Number of slots, zero or one less than a power of two.
+  size_type Capacity;
+  size_type Size;
+  /// @brief Number of empty slots which may be filled before growing.
+  size_type GrowthLeft;
+};
+
+}  // namespace detail
+}  // namespace cargo
+
+#endif  // CARGO_DETAIL_FLAT_HASH_TABLE_H_INCLUDED
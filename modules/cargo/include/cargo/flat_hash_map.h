@@ -0,0 +1,133 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Open addressing hash map.
+
+#ifndef CARGO_FLAT_HASH_MAP_H_INCLUDED
+#define CARGO_FLAT_HASH_MAP_H_INCLUDED
+
+#include <cargo/allocator.h>
+#include <cargo/detail/flat_hash_table.h>
+
+#include <functional>
+#include <tuple>
+#include <utility>
+
+namespace cargo {
+/// @addtogroup cargo
+/// @{
+
+namespace detail {
+/// @brief Describes the elements of a `cargo::flat_hash_map`.
+template <class Key, class T>
+struct flat_hash_map_policy {
+  using key_type = Key;
+  using value_type = std::pair<const Key, T>;
+
+  static const key_type &key(const value_type &value) { return value.first; }
+
+  template <class K, class... Args>
+  static void construct(value_type *slot, K &&key, Args &&...args) {
+    new (slot) value_type(std::piecewise_construct,
+                          std::forward_as_tuple(std::forward<K>(key)),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+};
+}  // namespace detail
+
+/// @brief Open addressing hash map.
+///
+/// The `::cargo::flat_hash_map` is a `std::unordered_map` like container which
+/// stores its elements in a single array rather than in individually allocated
+/// nodes. Lookups probe a group of slots at a time, using SSE2 instructions
+/// where available, and only compare keys whose hash bits match. This avoids
+/// the pointer chasing of node based maps on hot paths.
+///
+/// Member functions which may perform a dynamic allocation return a
+/// `::cargo::bad_alloc` when an allocation failure occurs, so unlike
+/// `std::unordered_map` there is no `operator[]`. Use `try_emplace` to insert
+/// an element or find the existing one.
+///
+/// Iterators, pointers and references to elements are invalidated when the
+/// map grows, which only happens during an insertion. Erasing an element only
+/// invalidates iterators, pointers and references to that element. Keys are
+/// copied rather than moved when the map grows since they are stored as
+/// `const`.
+///
+/// @tparam Key Type of the keys.
+/// @tparam T Type of the mapped values.
+/// @tparam Hash Hash function object type.
+/// @tparam KeyEqual Key equality function object type.
+/// @tparam A Allocator of `std::pair<const Key, T>`.
+template <class Key, class T, class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key>,
+          class A = mallocator<std::pair<const Key, T>>>
+class flat_hash_map
+    : public detail::flat_hash_table<detail::flat_hash_map_policy<Key, T>,
+                                     Hash, KeyEqual, A> {
+  using base_type =
+      detail::flat_hash_table<detail::flat_hash_map_policy<Key, T>, Hash,
+                              KeyEqual, A>;
+
+ public:
+  using mapped_type = T;
+  using typename base_type::const_iterator;
+  using typename base_type::iterator;
+  using typename base_type::key_type;
+  using typename base_type::value_type;
+
+  using base_type::base_type;
+
+  /// @brief Insert a copy of @p value if its key is absent.
+  ///
+  /// @return Returns an iterator to the element with the key and whether it
+  /// was inserted, or `cargo::bad_alloc` if the map failed to grow.
+  CARGO_NODISCARD error_or<std::pair<iterator, bool>> insert(
+      const value_type &value) {
+    return this->try_emplace(value.first, value.second);
+  }
+
+  /// @brief Insert @p value if its key is absent.
+  ///
+  /// @return Returns an iterator to the element with the key and whether it
+  /// was inserted, or `cargo::bad_alloc` if the map failed to grow.
+  CARGO_NODISCARD error_or<std::pair<iterator, bool>> insert(
+      value_type &&value) {
+    return this->try_emplace(value.first, std::move(value.second));
+  }
+
+  /// @brief Insert @p value under @p key, or assign it to the existing
+  /// element.
+  ///
+  /// @return Returns an iterator to the element with the key and whether it
+  /// was inserted, or `cargo::bad_alloc` if the map failed to grow.
+  template <class M>
+  CARGO_NODISCARD error_or<std::pair<iterator, bool>> insert_or_assign(
+      const key_type &key, M &&value) {
+    auto result = this->try_emplace(key, std::forward<M>(value));
+    if (result && !result->second) {
+      result->first->second = std::forward<M>(value);
+    }
+    return result;
+  }
+};
+
+/// @}
+}  // namespace cargo
+
+#endif  // CARGO_FLAT_HASH_MAP_H_INCLUDED
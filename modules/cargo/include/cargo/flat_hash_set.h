@@ -0,0 +1,144 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Open addressing hash set.
+
+#ifndef CARGO_FLAT_HASH_SET_H_INCLUDED
+#define CARGO_FLAT_HASH_SET_H_INCLUDED
+
+#include <cargo/allocator.h>
+#include <cargo/detail/flat_hash_table.h>
+
+#include <functional>
+#include <utility>
+
+namespace cargo {
+/// @addtogroup cargo
+/// @{
+
+namespace detail {
+/// @brief Describes the elements of a `cargo::flat_hash_set`.
+template <class Key>
+struct flat_hash_set_policy {
+  using key_type = Key;
+  using value_type = Key;
+
+  static const key_type &key(const value_type &value) { return value; }
+
+  template <class K>
+  static void construct(value_type *slot, K &&key) {
+    new (slot) value_type(std::forward<K>(key));
+  }
+};
+}  // namespace detail
+
+/// @brief Open addressing hash set.
+///
+/// The `::cargo::flat_hash_set` is the set counterpart of
+/// `::cargo::flat_hash_map` and shares its storage, error handling and
+/// invalidation rules. Elements can not be modified through its iterators.
+///
+/// @tparam Key Type of the elements.
+/// @tparam Hash Hash function object type.
+/// @tparam KeyEqual Key equality function object type.
+/// @tparam A Allocator of `Key`.
+template <class Key, class Hash = std::hash<Key>,
+          class KeyEqual = std::equal_to<Key>, class A = mallocator<Key>>
+class flat_hash_set
+    : private detail::flat_hash_table<detail::flat_hash_set_policy<Key>, Hash,
+                                      KeyEqual, A> {
+  using base_type =
+      detail::flat_hash_table<detail::flat_hash_set_policy<Key>, Hash,
+                              KeyEqual, A>;
+
+ public:
+  using typename base_type::allocator_type;
+  using typename base_type::const_reference;
+  using typename base_type::difference_type;
+  using typename base_type::hasher;
+  using typename base_type::key_equal;
+  using typename base_type::key_type;
+  using typename base_type::size_type;
+  using typename base_type::value_type;
+  using reference = const_reference;
+  using const_iterator = typename base_type::const_iterator;
+  using iterator = const_iterator;
+
+  using base_type::base_type;
+
+  using base_type::capacity;
+  using base_type::clear;
+  using base_type::contains;
+  using base_type::count;
+  using base_type::empty;
+  using base_type::get_allocator;
+  using base_type::hash_function;
+  using base_type::key_eq;
+  using base_type::reserve;
+  using base_type::size;
+
+  iterator begin() const { return base_type::begin(); }
+  iterator cbegin() const { return base_type::begin(); }
+  iterator end() const { return base_type::end(); }
+  iterator cend() const { return base_type::end(); }
+
+  iterator find(const key_type &key) const { return base_type::find(key); }
+
+  /// @brief Insert a copy of @p key if it is absent.
+  ///
+  /// @return Returns an iterator to the element and whether it was inserted,
+  /// or `cargo::bad_alloc` if the set failed to grow.
+  CARGO_NODISCARD error_or<std::pair<iterator, bool>> insert(
+      const key_type &key) {
+    return convert(base_type::try_emplace(key));
+  }
+
+  /// @brief Insert @p key if it is absent.
+  ///
+  /// @return Returns an iterator to the element and whether it was inserted,
+  /// or `cargo::bad_alloc` if the set failed to grow.
+  CARGO_NODISCARD error_or<std::pair<iterator, bool>> insert(key_type &&key) {
+    return convert(base_type::try_emplace(std::move(key)));
+  }
+
+  /// @brief Erase the element at @p pos.
+  ///
+  /// @return Returns an iterator to the element following @p pos.
+  iterator erase(iterator pos) { return base_type::erase(pos); }
+
+  /// @brief Erase @p key, if present.
+  ///
+  /// @return Returns the number of elements erased.
+  size_type erase(const key_type &key) { return base_type::erase(key); }
+
+  void swap(flat_hash_set &other) { base_type::swap(other); }
+
+ private:
+  static error_or<std::pair<iterator, bool>> convert(
+      error_or<std::pair<typename base_type::iterator, bool>> result) {
+    if (!result) {
+      return result.error();
+    }
+    return std::make_pair(iterator(result->first), result->second);
+  }
+};
+
+/// @}
+}  // namespace cargo
+
+#endif  // CARGO_FLAT_HASH_SET_H_INCLUDED
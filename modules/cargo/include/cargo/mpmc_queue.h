@@ -0,0 +1,230 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Bounded lock-free multiple producer multiple consumer queue.
+
+#ifndef CARGO_MPMC_QUEUE_H_INCLUDED
+#define CARGO_MPMC_QUEUE_H_INCLUDED
+
+#include <cargo/allocator.h>
+#include <cargo/attributes.h>
+#include <cargo/error.h>
+#include <cargo/platform_defines.h>
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace cargo {
+/// @addtogroup cargo
+/// @{
+
+namespace detail {
+/// @brief Storage for one element of a `cargo::mpmc_queue`.
+///
+/// @tparam T Element type of the queue.
+template <class T>
+struct mpmc_queue_cell {
+  /// @brief Position in the queue this cell is ready for. It equals the
+  /// enqueue position when the cell is free and one past it once the element
+  /// has been written.
+  std::atomic<size_t> Sequence;
+  /// @brief Uninitialized storage for the element.
+  alignas(T) unsigned char Storage[sizeof(T)];
+
+  T *get() { return reinterpret_cast<T *>(Storage); }
+};
+}  // namespace detail
+
+/// @brief Bounded lock-free multiple producer multiple consumer queue.
+///
+/// Any number of threads may call `enqueue` and `dequeue` concurrently. Each
+/// cell carries a sequence number which tells producers and consumers whether
+/// it is ready to be written or read. This means that a thread claims a cell
+/// with a single compare and swap of the enqueue or dequeue position, which
+/// live on separate cache lines. Neither operation blocks. `enqueue` fails
+/// when the queue is full and `dequeue` fails when it is empty.
+///
+/// Storage is allocated by `alloc`, which must be called before the queue is
+/// shared between threads.
+///
+/// @tparam T Element type of the queue, must be move constructible.
+/// @tparam A Allocator of `cargo::detail::mpmc_queue_cell<T>` used for the
+/// queue's storage.
+template <class T, class A = cargo::mallocator<detail::mpmc_queue_cell<T>>>
+class mpmc_queue final {
+ public:
+  using value_type = T;
+  using allocator_type = A;
+  using size_type = size_t;
+  using const_reference = const value_type &;
+
+  /// @brief Default constructor, does not allocate.
+  ///
+  /// @param allocator Allocator to use for the queue's storage.
+  mpmc_queue(allocator_type allocator = allocator_type())
+      : Allocator(allocator) {}
+
+  mpmc_queue(const mpmc_queue &) = delete;
+  mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+  /// @brief Destructor, destroys any elements which were not dequeued.
+  ~mpmc_queue() { clear(); }
+
+  /// @brief Allocate storage for the queue.
+  ///
+  /// Any elements already in the queue are destroyed. This member function is
+  /// not thread-safe.
+  ///
+  /// @param capacity Maximum number of elements in the queue, must be a power
+  /// of two greater than one.
+  ///
+  /// @return Returns `cargo::bad_argument` if @p capacity is not a power of
+  /// two greater than one, `cargo::bad_alloc` on allocation failure,
+  /// `cargo::success` otherwise.
+  CARGO_NODISCARD cargo::result alloc(size_type capacity) {
+    if (capacity < 2 || 0 != (capacity & (capacity - 1))) {
+      return cargo::bad_argument;
+    }
+    clear();
+    Cells = Allocator.alloc(capacity);
+    if (nullptr == Cells) {
+      return cargo::bad_alloc;
+    }
+    for (size_type index = 0; index < capacity; index++) {
+      new (&Cells[index].Sequence) std::atomic<size_type>(index);
+    }
+    Mask = capacity - 1;
+    return cargo::success;
+  }
+
+  /// @brief Get the maximum number of elements in the queue.
+  size_type capacity() const { return Cells ? Mask + 1 : 0; }
+
+  /// @brief Add an element to the back of the queue.
+  ///
+  /// @param value The element to add.
+  ///
+  /// @return Returns `cargo::overflow` if the queue is full, `cargo::success`
+  /// otherwise.
+  CARGO_NODISCARD cargo::result enqueue(value_type &&value) {
+    return emplace(std::move(value));
+  }
+
+  /// @brief Add an element to the back of the queue.
+  ///
+  /// @param value The element to add.
+  ///
+  /// @return Returns `cargo::overflow` if the queue is full, `cargo::success`
+  /// otherwise.
+  CARGO_NODISCARD cargo::result enqueue(const_reference value) {
+    return emplace(value);
+  }
+
+  /// @brief Remove the element at the front of the queue.
+  ///
+  /// @return Returns the element, or `cargo::out_of_bounds` if the queue is
+  /// empty.
+  CARGO_NODISCARD cargo::error_or<value_type> dequeue() {
+    size_type position = DequeuePosition.load(std::memory_order_relaxed);
+    cell_type *cell;
+    for (;;) {
+      cell = &Cells[position & Mask];
+      const size_type sequence = cell->Sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::intptr_t>(sequence) -
+                              static_cast<std::intptr_t>(position + 1);
+      if (0 == difference) {
+        if (DequeuePosition.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return cargo::out_of_bounds;
+      } else {
+        position = DequeuePosition.load(std::memory_order_relaxed);
+      }
+    }
+    value_type value(std::move(*cell->get()));
+    cell->get()->~value_type();
+    cell->Sequence.store(position + Mask + 1, std::memory_order_release);
+    return {std::move(value)};
+  }
+
+ private:
+  using cell_type = detail::mpmc_queue_cell<T>;
+
+  template <class U>
+  cargo::result emplace(U &&value) {
+    size_type position = EnqueuePosition.load(std::memory_order_relaxed);
+    cell_type *cell;
+    for (;;) {
+      cell = &Cells[position & Mask];
+      const size_type sequence = cell->Sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::intptr_t>(sequence) -
+                              static_cast<std::intptr_t>(position);
+      if (0 == difference) {
+        if (EnqueuePosition.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return cargo::overflow;
+      } else {
+        position = EnqueuePosition.load(std::memory_order_relaxed);
+      }
+    }
+    new (cell->get()) value_type(std::forward<U>(value));
+    cell->Sequence.store(position + 1, std::memory_order_release);
+    return cargo::success;
+  }
+
+  void clear() {
+    if (nullptr == Cells) {
+      return;
+    }
+    const size_type end = EnqueuePosition.load(std::memory_order_relaxed);
+    for (size_type position = DequeuePosition.load(std::memory_order_relaxed);
+         position != end; position++) {
+      Cells[position & Mask].get()->~value_type();
+    }
+    for (size_type index = 0; index <= Mask; index++) {
+      Cells[index].Sequence.~atomic();
+    }
+    Allocator.free(Cells);
+    Cells = nullptr;
+    Mask = 0;
+    EnqueuePosition.store(0, std::memory_order_relaxed);
+    DequeuePosition.store(0, std::memory_order_relaxed);
+  }
+
+  allocator_type Allocator;
+  cell_type *Cells = nullptr;
+  size_type Mask = 0;
+  /// @brief Position of the next element to enqueue, on its own cache line
+  /// since every producer writes it.
+  alignas(CARGO_CACHE_LINE_SIZE) std::atomic<size_type> EnqueuePosition{0};
+  /// @brief Position of the next element to dequeue, on its own cache line
+  /// since every consumer writes it.
+  alignas(CARGO_CACHE_LINE_SIZE) std::atomic<size_type> DequeuePosition{0};
+};
+
+/// @}
+}  // namespace cargo
+
+#endif  // CARGO_MPMC_QUEUE_H_INCLUDED
@@ -62,4 +62,12 @@
 #define CARGO_CXX14_CONSTEXPR constexpr
 #endif
 
+// Size in bytes used to keep data written by different threads on separate
+// cache lines. std::hardware_destructive_interference_size is not used since
+// its value may differ between translation units compiled with different
+// flags.
+#ifndef CARGO_CACHE_LINE_SIZE
+#define CARGO_CACHE_LINE_SIZE 64
+#endif
+
 #endif  // CARGO_PLATFORM_DEFINES_H_INCLUDED
@@ -0,0 +1,198 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Bounded lock-free single producer single consumer queue.
+
+#ifndef CARGO_SPSC_QUEUE_H_INCLUDED
+#define CARGO_SPSC_QUEUE_H_INCLUDED
+
+#include <cargo/allocator.h>
+#include <cargo/attributes.h>
+#include <cargo/error.h>
+#include <cargo/platform_defines.h>
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace cargo {
+/// @addtogroup cargo
+/// @{
+
+/// @brief Bounded lock-free single producer single consumer queue.
+///
+/// One thread may call `enqueue` while another thread calls `dequeue`. Neither
+/// of them blocks. The producer and consumer indices are kept on separate cache
+/// lines. Each side caches the last index it read from the other so that it
+/// only touches the other side's cache line when the queue appears full or
+/// empty.
+///
+/// Storage is allocated by `alloc`, which must be called before the queue is
+/// shared between threads.
+///
+/// @tparam T Element type of the queue, must be move constructible.
+/// @tparam A Allocator of `T` used for the queue's storage.
+template <class T, class A = cargo::mallocator<T>>
+class spsc_queue final {
+ public:
+  using value_type = T;
+  using allocator_type = A;
+  using size_type = size_t;
+  using const_reference = const value_type &;
+
+  /// @brief Default constructor, does not allocate.
+  ///
+  /// @param allocator Allocator to use for the queue's storage.
+  spsc_queue(allocator_type allocator = allocator_type())
+      : Allocator(allocator) {}
+
+  spsc_queue(const spsc_queue &) = delete;
+  spsc_queue &operator=(const spsc_queue &) = delete;
+
+  /// @brief Destructor, destroys any elements which were not dequeued.
+  ~spsc_queue() { clear(); }
+
+  /// @brief Allocate storage for the queue.
+  ///
+  /// Any elements already in the queue are destroyed. This member function is
+  /// not thread-safe.
+  ///
+  /// @param capacity Maximum number of elements in the queue, must be a power
+  /// of two.
+  ///
+  /// @return Returns `cargo::bad_argument` if @p capacity is not a power of
+  /// two, `cargo::bad_alloc` on allocation failure, `cargo::success`
+  /// otherwise.
+  CARGO_NODISCARD cargo::result alloc(size_type capacity) {
+    if (0 == capacity || 0 != (capacity & (capacity - 1))) {
+      return cargo::bad_argument;
+    }
+    clear();
+    Slots = Allocator.alloc(capacity);
+    if (nullptr == Slots) {
+      return cargo::bad_alloc;
+    }
+    Mask = capacity - 1;
+    return cargo::success;
+  }
+
+  /// @brief Get the maximum number of elements in the queue.
+  size_type capacity() const { return Slots ? Mask + 1 : 0; }
+
+  /// @brief Add an element to the back of the queue, only called by the
+  /// producer thread.
+  ///
+  /// @param value The element to add.
+  ///
+  /// @return Returns `cargo::overflow` if the queue is full, `cargo::success`
+  /// otherwise.
+  CARGO_NODISCARD cargo::result enqueue(value_type &&value) {
+    return emplace(std::move(value));
+  }
+
+  /// @brief Add an element to the back of the queue, only called by the
+  /// producer thread.
+  ///
+  /// @param value The element to add.
+  ///
+  /// @return Returns `cargo::overflow` if the queue is full, `cargo::success`
+  /// otherwise.
+  CARGO_NODISCARD cargo::result enqueue(const_reference value) {
+    return emplace(value);
+  }
+
+  /// @brief Remove the element at the front of the queue, only called by the
+  /// consumer thread.
+  ///
+  /// @return Returns the element, or `cargo::out_of_bounds` if the queue is
+  /// empty.
+  CARGO_NODISCARD cargo::error_or<value_type> dequeue() {
+    const size_type head = Consumer.Head.load(std::memory_order_relaxed);
+    if (head == Consumer.CachedTail) {
+      Consumer.CachedTail = Producer.Tail.load(std::memory_order_acquire);
+      if (head == Consumer.CachedTail) {
+        return cargo::out_of_bounds;
+      }
+    }
+    value_type *slot = Slots + (head & Mask);
+    value_type value(std::move(*slot));
+    slot->~value_type();
+    Consumer.Head.store(head + 1, std::memory_order_release);
+    return {std::move(value)};
+  }
+
+ private:
+  template <class U>
+  cargo::result emplace(U &&value) {
+    const size_type tail = Producer.Tail.load(std::memory_order_relaxed);
+    if (tail - Producer.CachedHead > Mask) {
+      Producer.CachedHead = Consumer.Head.load(std::memory_order_acquire);
+      if (tail - Producer.CachedHead > Mask) {
+        return cargo::overflow;
+      }
+    }
+    new (Slots + (tail & Mask)) value_type(std::forward<U>(value));
+    Producer.Tail.store(tail + 1, std::memory_order_release);
+    return cargo::success;
+  }
+
+  void clear() {
+    if (nullptr == Slots) {
+      return;
+    }
+    const size_type tail = Producer.Tail.load(std::memory_order_relaxed);
+    for (size_type head = Consumer.Head.load(std::memory_order_relaxed);
+         head != tail; head++) {
+      Slots[head & Mask].~value_type();
+    }
+    Allocator.free(Slots);
+    Slots = nullptr;
+    Mask = 0;
+    Consumer.Head.store(0, std::memory_order_relaxed);
+    Consumer.CachedTail = 0;
+    Producer.Tail.store(0, std::memory_order_relaxed);
+    Producer.CachedHead = 0;
+  }
+
+  /// @brief State written by the consumer thread.
+  struct alignas(CARGO_CACHE_LINE_SIZE) consumer_state {
+    /// @brief Index of the next element to dequeue.
+    std::atomic<size_type> Head{0};
+    /// @brief Last value of `Producer.Tail` seen by the consumer.
+    size_type CachedTail = 0;
+  };
+
+  /// @brief State written by the producer thread.
+  struct alignas(CARGO_CACHE_LINE_SIZE) producer_state {
+    /// @brief Index of the next element to enqueue.
+    std::atomic<size_type> Tail{0};
+    /// @brief Last value of `Consumer.Head` seen by the producer.
+    size_type CachedHead = 0;
+  };
+
+  allocator_type Allocator;
+  value_type *Slots = nullptr;
+  size_type Mask = 0;
+  consumer_state Consumer;
+  producer_state Producer;
+};
+
+/// @}
+}  // namespace cargo
+
+#endif  // CARGO_SPSC_QUEUE_H_INCLUDED
@@ -0,0 +1,376 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cargo/flat_hash_map.h>
+#include <cargo/string_view.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+#include "common.h"
+
+namespace {
+/// @brief Hash which sends every key to the same probe sequence.
+struct colliding_hash {
+  size_t operator()(int) const { return 42; }
+};
+
+/// @brief Allocator which counts its live allocations and fails once a limit
+/// is reached.
+template <class T>
+struct limited_allocator {
+  using value_type = T;
+  using size_type = size_t;
+
+  limited_allocator(int *live, int limit) : live(live), limit(limit) {}
+
+  T *alloc(size_type count) {
+    if (*live >= limit) {
+      return nullptr;
+    }
+    ++*live;
+    return cargo::mallocator<T>().alloc(count);
+  }
+
+  void free(T *pointer) {
+    --*live;
+    cargo::mallocator<T>().free(pointer);
+  }
+
+  int *live;
+  int limit;
+};
+}  // namespace
+
+TEST(flat_hash_map, construct_default) {
+  cargo::flat_hash_map<int, int> map;
+  ASSERT_TRUE(map.empty());
+  ASSERT_EQ(0u, map.size());
+  ASSERT_EQ(0u, map.capacity());
+  ASSERT_TRUE(map.begin() == map.end());
+  ASSERT_TRUE(map.find(42) == map.end());
+  ASSERT_EQ(0u, map.erase(42));
+}
+
+TEST(flat_hash_map, construct_move) {
+  cargo::flat_hash_map<int, int> map;
+  ASSERT_TRUE(map.try_emplace(1, 2));
+  cargo::flat_hash_map<int, int> other(std::move(map));
+  ASSERT_EQ(1u, other.size());
+  ASSERT_EQ(2, other.find(1)->second);
+  ASSERT_TRUE(map.empty());  // NOLINT(bugprone-use-after-move)
+  ASSERT_TRUE(map.try_emplace(3, 4));
+  ASSERT_EQ(1u, map.size());
+}
+
+TEST(flat_hash_map, assign_operator_move) {
+  cargo::flat_hash_map<int, int> map;
+  cargo::flat_hash_map<int, int> other;
+  ASSERT_TRUE(map.try_emplace(1, 2));
+  ASSERT_TRUE(other.try_emplace(3, 4));
+  other = std::move(map);
+  ASSERT_EQ(1u, other.size());
+  ASSERT_EQ(2, other.find(1)->second);
+  ASSERT_TRUE(other.find(3) == other.end());
+}
+
+TEST(flat_hash_map, try_emplace) {
+  cargo::flat_hash_map<int, int> map;
+  auto inserted = map.try_emplace(1, 2);
+  ASSERT_TRUE(inserted);
+  ASSERT_TRUE(inserted->second);
+  ASSERT_EQ(1, inserted->first->first);
+  ASSERT_EQ(2, inserted->first->second);
+  auto existing = map.try_emplace(1, 3);
+  ASSERT_TRUE(existing);
+  ASSERT_FALSE(existing->second);
+  ASSERT_EQ(2, existing->first->second);
+  ASSERT_EQ(1u, map.size());
+}
+
+TEST(flat_hash_map, try_emplace_default) {
+  cargo::flat_hash_map<int, std::string> map;
+  auto inserted = map.try_emplace(7);
+  ASSERT_TRUE(inserted);
+  ASSERT_TRUE(inserted->first->second.empty());
+  inserted->first->second = "seven";
+  ASSERT_EQ("seven", map.find(7)->second);
+}
+
+TEST(flat_hash_map, insert) {
+  cargo::flat_hash_map<std::string, int> map;
+  const std::pair<const std::string, int> value{"one", 1};
+  ASSERT_TRUE(map.insert(value)->second);
+  ASSERT_FALSE(map.insert({"one", 2})->second);
+  ASSERT_EQ(1, map.find("one")->second);
+  ASSERT_TRUE(map.insert({"two", 2})->second);
+  ASSERT_EQ(2u, map.size());
+}
+
+TEST(flat_hash_map, insert_or_assign) {
+  cargo::flat_hash_map<int, int> map;
+  ASSERT_TRUE(map.insert_or_assign(1, 2)->second);
+  ASSERT_FALSE(map.insert_or_assign(1, 3)->second);
+  ASSERT_EQ(3, map.find(1)->second);
+}
+
+TEST(flat_hash_map, count_contains) {
+  cargo::flat_hash_map<int, int> map;
+  ASSERT_TRUE(map.try_emplace(1, 1));
+  ASSERT_EQ(1u, map.count(1));
+  ASSERT_EQ(0u, map.count(2));
+  ASSERT_TRUE(map.contains(1));
+  ASSERT_FALSE(map.contains(2));
+}
+
+TEST(flat_hash_map, find_const) {
+  cargo::flat_hash_map<int, int> map;
+  ASSERT_TRUE(map.try_emplace(1, 2));
+  const auto &const_map = map;
+  auto found = const_map.find(1);
+  ASSERT_TRUE(found != const_map.end());
+  ASSERT_EQ(2, found->second);
+  ASSERT_TRUE(const_map.find(2) == const_map.end());
+}
+
+TEST(flat_hash_map, grow) {
+  cargo::flat_hash_map<int, int> map;
+  for (int i = 0; i < 10000; i++) {
+    ASSERT_TRUE(map.try_emplace(i, i * 2));
+  }
+  ASSERT_EQ(10000u, map.size());
+  ASSERT_LT(map.size(), map.capacity());
+  for (int i = 0; i < 10000; i++) {
+    auto found = map.find(i);
+    ASSERT_TRUE(found != map.end());
+    ASSERT_EQ(i * 2, found->second);
+  }
+  ASSERT_TRUE(map.find(10000) == map.end());
+}
+
+TEST(flat_hash_map, reserve) {
+  cargo::flat_hash_map<int, int> map;
+  ASSERT_EQ(cargo::success, map.reserve(1000));
+  const auto capacity = map.capacity();
+  ASSERT_LE(1000u, capacity);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(map.try_emplace(i, i));
+  }
+  ASSERT_EQ(capacity, map.capacity());
+}
+
+TEST(flat_hash_map, iterate) {
+  cargo::flat_hash_map<int, int> map;
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(map.try_emplace(i, i));
+  }
+  int sum = 0;
+  size_t count = 0;
+  for (auto &pair : map) {
+    ASSERT_EQ(pair.first, pair.second);
+    pair.second = 1;
+    sum += pair.first;
+    count++;
+  }
+  ASSERT_EQ(100u, count);
+  ASSERT_EQ(4950, sum);
+  const auto &const_map = map;
+  for (const auto &pair : const_map) {
+    ASSERT_EQ(1, pair.second);
+  }
+}
+
+TEST(flat_hash_map, erase_key) {
+  cargo::flat_hash_map<int, int> map;
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(map.try_emplace(i, i));
+  }
+  for (int i = 0; i < 100; i += 2) {
+    ASSERT_EQ(1u, map.erase(i));
+  }
+  ASSERT_EQ(0u, map.erase(0));
+  ASSERT_EQ(50u, map.size());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(i % 2 ? 1u : 0u, map.count(i));
+  }
+}
+
+TEST(flat_hash_map, erase_iterator) {
+  cargo::flat_hash_map<int, int> map;
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(map.try_emplace(i, i));
+  }
+  for (auto it = map.begin(); it != map.end();) {
+    if (it->first % 3 == 0) {
+      it = map.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ASSERT_EQ(66u, map.size());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(i % 3 ? 1u : 0u, map.count(i));
+  }
+}
+
+TEST(flat_hash_map, erase_reinsert_churn) {
+  // Repeatedly inserting and erasing must not grow the map without bound.
+  cargo::flat_hash_map<int, int> map;
+  for (int i = 0; i < 100000; i++) {
+    ASSERT_TRUE(map.try_emplace(i, i));
+    if (i >= 8) {
+      ASSERT_EQ(1u, map.erase(i - 8));
+    }
+  }
+  ASSERT_EQ(8u, map.size());
+  ASSERT_GE(63u, map.capacity());
+}
+
+TEST(flat_hash_map, colliding_hash) {
+  cargo::flat_hash_map<int, int, colliding_hash> map;
+  for (int i = 0; i < 200; i++) {
+    ASSERT_TRUE(map.try_emplace(i, -i));
+  }
+  for (int i = 0; i < 200; i += 2) {
+    ASSERT_EQ(1u, map.erase(i));
+  }
+  for (int i = 0; i < 200; i++) {
+    auto found = map.find(i);
+    if (i % 2) {
+      ASSERT_TRUE(found != map.end());
+      ASSERT_EQ(-i, found->second);
+    } else {
+      ASSERT_TRUE(found == map.end());
+    }
+  }
+}
+
+TEST(flat_hash_map, pointer_keys) {
+  std::unique_ptr<int[]> objects(new int[1000]);
+  cargo::flat_hash_map<int *, size_t> map;
+  for (size_t i = 0; i < 1000; i++) {
+    ASSERT_TRUE(map.try_emplace(&objects[i], i));
+  }
+  for (size_t i = 0; i < 1000; i++) {
+    ASSERT_EQ(i, map.find(&objects[i])->second);
+  }
+}
+
+TEST(flat_hash_map, string_view_keys) {
+  const std::string names[] = {"alpha", "beta", "gamma", "delta"};
+  cargo::flat_hash_map<cargo::string_view, int> map;
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(map.try_emplace(names[i], i));
+  }
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(i, map.find(names[i])->second);
+  }
+  ASSERT_EQ(map.end(), map.find("epsilon"));
+}
+
+TEST(flat_hash_map, movable_values) {
+  cargo::flat_hash_map<int, movable_t> map;
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(map.try_emplace(i, movable_t(i)));
+  }
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(i, map.find(i)->second.get());
+  }
+}
+
+TEST(flat_hash_map, destroys_values) {
+  auto counter = std::make_shared<int>(0);
+  {
+    cargo::flat_hash_map<int, std::shared_ptr<int>> map;
+    for (int i = 0; i < 100; i++) {
+      ASSERT_TRUE(map.try_emplace(i, counter));
+    }
+    ASSERT_EQ(101, counter.use_count());
+    ASSERT_EQ(1u, map.erase(0));
+    ASSERT_EQ(100, counter.use_count());
+    map.clear();
+    ASSERT_EQ(1, counter.use_count());
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.begin() == map.end());
+    for (int i = 0; i < 10; i++) {
+      ASSERT_TRUE(map.try_emplace(i, counter));
+    }
+    ASSERT_EQ(11, counter.use_count());
+  }
+  ASSERT_EQ(1, counter.use_count());
+}
+
+TEST(flat_hash_map, allocator) {
+  int live = 0;
+  {
+    using allocator = limited_allocator<std::pair<const int, int>>;
+    cargo::flat_hash_map<int, int, std::hash<int>, std::equal_to<int>,
+                         allocator>
+        map({}, {}, allocator(&live, 1));
+    ASSERT_TRUE(map.try_emplace(1, 1));
+    ASSERT_EQ(1, live);
+    // Growing needs a second allocation while the first is still live.
+    cargo::result error = cargo::success;
+    for (int i = 2; i < 100 && !error; i++) {
+      error = map.try_emplace(i, i).error();
+    }
+    ASSERT_EQ(cargo::bad_alloc, error);
+    // The failed insertion leaves the map intact.
+    for (int i = 1; i <= static_cast<int>(map.size()); i++) {
+      ASSERT_EQ(i, map.find(i)->second);
+    }
+  }
+  ASSERT_EQ(0, live);
+}
+
+TEST(flat_hash_map, matches_unordered_map) {
+  std::mt19937 engine(42);
+  std::uniform_int_distribution<int> keys(0, 511);
+  std::uniform_int_distribution<int> ops(0, 2);
+  cargo::flat_hash_map<int, int> map;
+  std::unordered_map<int, int> reference;
+  for (int i = 0; i < 20000; i++) {
+    const int key = keys(engine);
+    switch (ops(engine)) {
+      case 0: {
+        auto result = map.try_emplace(key, i);
+        ASSERT_TRUE(result);
+        ASSERT_EQ(reference.emplace(key, i).second, result->second);
+      } break;
+      case 1:
+        ASSERT_EQ(reference.erase(key), map.erase(key));
+        break;
+      default: {
+        auto found = map.find(key);
+        auto expected = reference.find(key);
+        ASSERT_EQ(expected == reference.end(), found == map.end());
+        if (found != map.end()) {
+          ASSERT_EQ(expected->second, found->second);
+        }
+      } break;
+    }
+    ASSERT_EQ(reference.size(), map.size());
+  }
+  size_t count = 0;
+  for (auto &pair : map) {
+    ASSERT_EQ(reference.at(pair.first), pair.second);
+    count++;
+  }
+  ASSERT_EQ(reference.size(), count);
+}
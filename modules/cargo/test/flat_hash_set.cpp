@@ -0,0 +1,108 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cargo/flat_hash_set.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(flat_hash_set, construct_default) {
+  cargo::flat_hash_set<int> set;
+  ASSERT_TRUE(set.empty());
+  ASSERT_EQ(0u, set.size());
+  ASSERT_TRUE(set.begin() == set.end());
+  ASSERT_FALSE(set.contains(42));
+}
+
+TEST(flat_hash_set, construct_move) {
+  cargo::flat_hash_set<int> set;
+  ASSERT_TRUE(set.insert(1));
+  cargo::flat_hash_set<int> other(std::move(set));
+  ASSERT_EQ(1u, other.size());
+  ASSERT_TRUE(other.contains(1));
+}
+
+TEST(flat_hash_set, insert) {
+  cargo::flat_hash_set<std::string> set;
+  const std::string one = "one";
+  auto inserted = set.insert(one);
+  ASSERT_TRUE(inserted);
+  ASSERT_TRUE(inserted->second);
+  ASSERT_EQ("one", *inserted->first);
+  auto existing = set.insert(std::string("one"));
+  ASSERT_TRUE(existing);
+  ASSERT_FALSE(existing->second);
+  ASSERT_TRUE(inserted->first == existing->first);
+  ASSERT_EQ(1u, set.size());
+}
+
+TEST(flat_hash_set, find) {
+  cargo::flat_hash_set<int> set;
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(set.insert(i * 3));
+  }
+  for (int i = 0; i < 3000; i++) {
+    auto found = set.find(i);
+    if (i % 3) {
+      ASSERT_TRUE(found == set.end());
+    } else {
+      ASSERT_TRUE(found != set.end());
+      ASSERT_EQ(i, *found);
+    }
+  }
+}
+
+TEST(flat_hash_set, erase) {
+  cargo::flat_hash_set<int> set;
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(set.insert(i));
+  }
+  ASSERT_EQ(1u, set.erase(0));
+  ASSERT_EQ(0u, set.erase(0));
+  for (auto it = set.begin(); it != set.end();) {
+    it = (*it % 2) ? set.erase(it) : std::next(it);
+  }
+  ASSERT_EQ(49u, set.size());
+  for (int i = 1; i < 100; i++) {
+    ASSERT_EQ(i % 2 ? 0u : 1u, set.count(i));
+  }
+}
+
+TEST(flat_hash_set, iterate) {
+  cargo::flat_hash_set<int> set;
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(set.insert(i));
+  }
+  int sum = 0;
+  for (int value : set) {
+    sum += value;
+  }
+  ASSERT_EQ(4950, sum);
+}
+
+TEST(flat_hash_set, clear_reserve) {
+  cargo::flat_hash_set<int> set;
+  ASSERT_EQ(cargo::success, set.reserve(100));
+  const auto capacity = set.capacity();
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(set.insert(i));
+  }
+  ASSERT_EQ(capacity, set.capacity());
+  set.clear();
+  ASSERT_TRUE(set.empty());
+  ASSERT_EQ(capacity, set.capacity());
+  ASSERT_FALSE(set.contains(1));
+}
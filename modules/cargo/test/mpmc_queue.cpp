@@ -0,0 +1,188 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cargo/allocator.h>
+#include <cargo/mpmc_queue.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+
+TEST(mpmc_queue, construct_default) {
+  cargo::mpmc_queue<int> queue;
+  ASSERT_EQ(0, queue.capacity());
+}
+
+TEST(mpmc_queue, alloc) {
+  cargo::mpmc_queue<int> queue;
+  ASSERT_EQ(cargo::bad_argument, queue.alloc(0));
+  ASSERT_EQ(cargo::bad_argument, queue.alloc(1));
+  ASSERT_EQ(cargo::bad_argument, queue.alloc(12));
+  ASSERT_EQ(cargo::success, queue.alloc(16));
+  ASSERT_EQ(16, queue.capacity());
+}
+
+TEST(mpmc_queue, alloc_failure) {
+  cargo::mpmc_queue<int,
+                    cargo::nullacator<cargo::detail::mpmc_queue_cell<int>>>
+      queue;
+  ASSERT_EQ(cargo::bad_alloc, queue.alloc(16));
+  ASSERT_EQ(0, queue.capacity());
+}
+
+TEST(mpmc_queue, enqueue_dequeue) {
+  cargo::mpmc_queue<int> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(4));
+  for (int value : {42, 14, 4, 3}) {
+    ASSERT_EQ(cargo::success, queue.enqueue(value));
+  }
+  for (int value : {42, 14, 4, 3}) {
+    auto eo = queue.dequeue();
+    ASSERT_TRUE(eo);
+    ASSERT_EQ(value, *eo);
+  }
+}
+
+TEST(mpmc_queue, enqueue_when_full) {
+  cargo::mpmc_queue<int> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(2));
+  ASSERT_EQ(cargo::success, queue.enqueue(1));
+  ASSERT_EQ(cargo::success, queue.enqueue(2));
+  ASSERT_EQ(cargo::overflow, queue.enqueue(3));
+  ASSERT_EQ(1, *queue.dequeue());
+  ASSERT_EQ(cargo::success, queue.enqueue(3));
+}
+
+TEST(mpmc_queue, dequeue_when_empty) {
+  cargo::mpmc_queue<int> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(2));
+  ASSERT_EQ(cargo::out_of_bounds, queue.dequeue().error());
+  ASSERT_EQ(cargo::success, queue.enqueue(1));
+  ASSERT_EQ(1, *queue.dequeue());
+  ASSERT_EQ(cargo::out_of_bounds, queue.dequeue().error());
+}
+
+TEST(mpmc_queue, wrap_around) {
+  cargo::mpmc_queue<int> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(4));
+  for (int value = 0; value < 100; value++) {
+    ASSERT_EQ(cargo::success, queue.enqueue(value));
+    ASSERT_EQ(cargo::success, queue.enqueue(value + 1000));
+    ASSERT_EQ(value, *queue.dequeue());
+    ASSERT_EQ(value + 1000, *queue.dequeue());
+  }
+}
+
+TEST(mpmc_queue, movable_values) {
+  cargo::mpmc_queue<movable_t> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(8));
+  for (int value = 0; value < 8; value++) {
+    ASSERT_EQ(cargo::success, queue.enqueue(movable_t(value)));
+  }
+  for (int value = 0; value < 8; value++) {
+    auto eo = queue.dequeue();
+    ASSERT_TRUE(eo);
+    ASSERT_EQ(value, eo->get());
+  }
+}
+
+TEST(mpmc_queue, destroys_values) {
+  auto counter = std::make_shared<int>(0);
+  {
+    cargo::mpmc_queue<std::shared_ptr<int>> queue;
+    ASSERT_EQ(cargo::success, queue.alloc(4));
+    ASSERT_EQ(cargo::success, queue.enqueue(counter));
+    ASSERT_EQ(cargo::success, queue.enqueue(counter));
+    ASSERT_EQ(cargo::success, queue.enqueue(counter));
+    ASSERT_TRUE(queue.dequeue());
+    ASSERT_EQ(3, counter.use_count());
+    ASSERT_EQ(cargo::success, queue.alloc(8));
+    ASSERT_EQ(1, counter.use_count());
+    ASSERT_EQ(cargo::success, queue.enqueue(counter));
+  }
+  ASSERT_EQ(1, counter.use_count());
+}
+
+TEST(mpmc_queue, producers_consumers) {
+  constexpr uint32_t producer_count = 4;
+  constexpr uint32_t consumer_count = 4;
+  constexpr uint32_t count = 50000;
+  cargo::mpmc_queue<uint64_t> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(64));
+
+  // Each element holds the producer in its upper half and a per producer
+  // sequence number in its lower half.
+  std::vector<std::thread> threads;
+  for (uint32_t producer = 0; producer < producer_count; producer++) {
+    threads.emplace_back([&queue, producer] {
+      for (uint32_t index = 0; index < count;) {
+        const uint64_t value = (uint64_t(producer) << 32) | index;
+        if (cargo::success == queue.enqueue(value)) {
+          index++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // Every element must be dequeued exactly once, and the elements of any one
+  // producer must be seen by each consumer in the order they were enqueued.
+  std::atomic<uint32_t> remaining{producer_count * count};
+  std::atomic<uint32_t> mismatches{0};
+  std::unique_ptr<std::atomic<uint32_t>[]> seen(
+      new std::atomic<uint32_t>[producer_count * count]);
+  for (uint32_t index = 0; index < producer_count * count; index++) {
+    seen[index].store(0);
+  }
+  for (uint32_t consumer = 0; consumer < consumer_count; consumer++) {
+    threads.emplace_back([&] {
+      std::vector<int64_t> last(producer_count, -1);
+      while (remaining.load() > 0) {
+        auto eo = queue.dequeue();
+        if (!eo) {
+          std::this_thread::yield();
+          continue;
+        }
+        const uint32_t producer = uint32_t(*eo >> 32);
+        const uint32_t index = uint32_t(*eo);
+        if (producer >= producer_count || index >= count ||
+            int64_t(index) <= last[producer]) {
+          mismatches++;
+          remaining--;
+          continue;
+        }
+        last[producer] = index;
+        seen[producer * count + index]++;
+        remaining--;
+      }
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(0, mismatches.load());
+  for (uint32_t index = 0; index < producer_count * count; index++) {
+    ASSERT_EQ(1, seen[index].load());
+  }
+  ASSERT_EQ(cargo::out_of_bounds, queue.dequeue().error());
+}
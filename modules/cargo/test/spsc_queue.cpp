@@ -0,0 +1,148 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cargo/allocator.h>
+#include <cargo/spsc_queue.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+
+#include "common.h"
+
+TEST(spsc_queue, construct_default) {
+  cargo::spsc_queue<int> queue;
+  ASSERT_EQ(0, queue.capacity());
+  ASSERT_EQ(cargo::out_of_bounds, queue.dequeue().error());
+}
+
+TEST(spsc_queue, alloc) {
+  cargo::spsc_queue<int> queue;
+  ASSERT_EQ(cargo::bad_argument, queue.alloc(0));
+  ASSERT_EQ(cargo::bad_argument, queue.alloc(12));
+  ASSERT_EQ(cargo::success, queue.alloc(16));
+  ASSERT_EQ(16, queue.capacity());
+}
+
+TEST(spsc_queue, alloc_failure) {
+  cargo::spsc_queue<int, cargo::nullacator<int>> queue;
+  ASSERT_EQ(cargo::bad_alloc, queue.alloc(16));
+  ASSERT_EQ(0, queue.capacity());
+}
+
+TEST(spsc_queue, enqueue_dequeue) {
+  cargo::spsc_queue<int> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(4));
+  for (int value : {42, 14, 4, 3}) {
+    ASSERT_EQ(cargo::success, queue.enqueue(value));
+  }
+  for (int value : {42, 14, 4, 3}) {
+    auto eo = queue.dequeue();
+    ASSERT_TRUE(eo);
+    ASSERT_EQ(value, *eo);
+  }
+}
+
+TEST(spsc_queue, enqueue_when_full) {
+  cargo::spsc_queue<int> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(2));
+  ASSERT_EQ(cargo::success, queue.enqueue(1));
+  ASSERT_EQ(cargo::success, queue.enqueue(2));
+  ASSERT_EQ(cargo::overflow, queue.enqueue(3));
+  ASSERT_EQ(1, *queue.dequeue());
+  ASSERT_EQ(cargo::success, queue.enqueue(3));
+}
+
+TEST(spsc_queue, dequeue_when_empty) {
+  cargo::spsc_queue<int> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(2));
+  ASSERT_EQ(cargo::out_of_bounds, queue.dequeue().error());
+  ASSERT_EQ(cargo::success, queue.enqueue(1));
+  ASSERT_EQ(1, *queue.dequeue());
+  ASSERT_EQ(cargo::out_of_bounds, queue.dequeue().error());
+}
+
+TEST(spsc_queue, wrap_around) {
+  cargo::spsc_queue<int> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(4));
+  for (int value = 0; value < 100; value++) {
+    ASSERT_EQ(cargo::success, queue.enqueue(value));
+    ASSERT_EQ(cargo::success, queue.enqueue(value + 1000));
+    ASSERT_EQ(value, *queue.dequeue());
+    ASSERT_EQ(value + 1000, *queue.dequeue());
+  }
+}
+
+TEST(spsc_queue, movable_values) {
+  cargo::spsc_queue<movable_t> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(8));
+  for (int value = 0; value < 8; value++) {
+    ASSERT_EQ(cargo::success, queue.enqueue(movable_t(value)));
+  }
+  for (int value = 0; value < 8; value++) {
+    auto eo = queue.dequeue();
+    ASSERT_TRUE(eo);
+    ASSERT_EQ(value, eo->get());
+  }
+}
+
+TEST(spsc_queue, destroys_values) {
+  auto counter = std::make_shared<int>(0);
+  {
+    cargo::spsc_queue<std::shared_ptr<int>> queue;
+    ASSERT_EQ(cargo::success, queue.alloc(4));
+    ASSERT_EQ(cargo::success, queue.enqueue(counter));
+    ASSERT_EQ(cargo::success, queue.enqueue(counter));
+    ASSERT_EQ(cargo::success, queue.enqueue(counter));
+    ASSERT_TRUE(queue.dequeue());
+    ASSERT_EQ(3, counter.use_count());
+    ASSERT_EQ(cargo::success, queue.alloc(8));
+    ASSERT_EQ(1, counter.use_count());
+    ASSERT_EQ(cargo::success, queue.enqueue(counter));
+  }
+  ASSERT_EQ(1, counter.use_count());
+}
+
+TEST(spsc_queue, producer_consumer) {
+  constexpr int count = 200000;
+  cargo::spsc_queue<int> queue;
+  ASSERT_EQ(cargo::success, queue.alloc(64));
+
+  std::thread producer([&queue] {
+    for (int value = 0; value < count;) {
+      if (cargo::success == queue.enqueue(value)) {
+        value++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  // Elements must arrive exactly once and in the order they were enqueued.
+  int mismatches = 0;
+  for (int expected = 0; expected < count;) {
+    auto eo = queue.dequeue();
+    if (eo) {
+      mismatches += expected != *eo;
+      expected++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  ASSERT_EQ(0, mismatches);
+  ASSERT_EQ(cargo::out_of_bounds, queue.dequeue().error());
+}
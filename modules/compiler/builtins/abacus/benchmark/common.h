@@ -0,0 +1,351 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Harness measuring the throughput and accuracy of abacus builtins.
+
+#ifndef ABACUS_BENCHABACUS_COMMON_H_INCLUDED
+#define ABACUS_BENCHABACUS_COMMON_H_INCLUDED
+
+#include <abacus/abacus_config.h>
+#include <abacus/abacus_type_traits.h>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace benchabacus {
+/// @brief Number of scalar elements evaluated by each benchmark iteration.
+///
+/// Divisible by every vector width other than 3. Vectors of 3 elements
+/// evaluate the largest multiple of 3 which fits.
+constexpr size_t element_count = 4096;
+
+/// @brief Name of the counter reporting the cycles spent per scalar element.
+constexpr const char *cycles_counter = "cycles/elem";
+
+/// @brief Name of the counter reporting the maximum ULP error of a benchmark.
+constexpr const char *ulp_counter = "max_ulp";
+
+/// @brief Interval a builtin parameter is uniformly sampled from.
+struct Range {
+  double low;
+  double high;
+};
+
+/// @brief Throughput and accuracy recorded for a single benchmark.
+struct Result {
+  /// @brief Average number of CPU cycles spent evaluating a scalar element.
+  double cycles_per_element;
+  /// @brief Maximum ULP error of any element against the reference.
+  double max_ulp;
+};
+
+/// @brief Access element `i` of a scalar, which only has element 0.
+template <class T>
+T &element(T &value, unsigned) {
+  return value;
+}
+
+/// @brief Access element `i` of an abacus vector.
+template <class T, unsigned N>
+T &element(abacus_vector<T, N> &value, unsigned i) {
+  return value[i];
+}
+
+/// @brief Vector of `abacus_int` with as many elements as `V`.
+template <class V>
+using IntVector =
+    typename MakeType<abacus_int, TypeTraits<V>::num_elements>::type;
+
+/// @brief Convert each element of a vector to another element type.
+///
+/// Floating point elements are truncated towards zero when converted to an
+/// integer, like the `static_cast` used by reference expressions.
+///
+/// @tparam To Vector type to convert to, with as many elements as `From`.
+/// @tparam From Vector type to convert from.
+template <class To, class From>
+To convert(From value) {
+  using element_type = typename TypeTraits<To>::ElementType;
+  To result(element_type(0));
+  for (unsigned i = 0; i < TypeTraits<From>::num_elements; i++) {
+    element(result, i) = static_cast<element_type>(element(value, i));
+  }
+  return result;
+}
+
+/// @brief Storage for the result a builtin returns through a pointer.
+///
+/// Builtins such as `frexp` or `sincos` store a second result through a
+/// pointer. Only their return value is checked against the reference. The
+/// stored result is written here and discarded.
+template <class T>
+T *discard() {
+  static T storage;
+  return &storage;
+}
+
+/// @brief Calculate the error of a result in units of the last place.
+///
+/// The ULP is the spacing of `T` at the magnitude of the reference rounded to
+/// `T`. NaN and infinite results must match the reference exactly, otherwise
+/// the error is infinite.
+///
+/// @tparam T Scalar floating point type of the result.
+/// @param result Value calculated by the builtin.
+/// @param reference Value calculated by the reference in extended precision.
+///
+/// @return Returns the absolute error of `result` in ULP.
+template <class T>
+double ulpError(T result, long double reference) {
+  const double infinity = std::numeric_limits<double>::infinity();
+  if (std::isnan(reference) || std::isnan(result)) {
+    return std::isnan(reference) && std::isnan(result) ? 0.0 : infinity;
+  }
+  const T rounded = static_cast<T>(reference);
+  if (std::isinf(rounded) || std::isinf(result)) {
+    return rounded == result ? 0.0 : infinity;
+  }
+  const T magnitude = std::fabs(rounded);
+  const T ulp = magnitude == std::numeric_limits<T>::max()
+                    ? magnitude - std::nextafter(magnitude, T(0))
+                    : std::nextafter(magnitude,
+                                     std::numeric_limits<T>::infinity()) -
+                          magnitude;
+  return static_cast<double>(
+      std::fabs(static_cast<long double>(result) - reference) / ulp);
+}
+
+/// @brief Benchmark a builtin over vectors of `N` elements of type `T`.
+///
+/// Inputs are sampled once from the ranges of the builtin and evaluated
+/// against its reference to find the maximum ULP error. The timed loop then
+/// repeatedly evaluates the same inputs.
+///
+/// @tparam Builtin Description of the builtin, see `BENCHABACUS_UNARY`.
+/// @tparam T Scalar floating point type.
+/// @tparam N Number of elements in each vector, 1 for scalars.
+template <class Builtin, class T, unsigned N>
+void benchmarkBuiltin(benchmark::State &state) {
+  using vector_type = typename MakeType<T, N>::type;
+  const size_t vector_count = element_count / N;
+
+  std::mt19937 generator(0xABAC05);
+  std::vector<vector_type> inputs[3];
+  for (unsigned arg = 0; arg < 3; arg++) {
+    inputs[arg].resize(vector_count, vector_type(T(0)));
+    if (arg >= Builtin::arity) {
+      continue;
+    }
+    const Range range = Builtin::range(arg);
+    std::uniform_real_distribution<double> distribution(range.low,
+                                                        range.high);
+    for (vector_type &input : inputs[arg]) {
+      for (unsigned i = 0; i < N; i++) {
+        element(input, i) = static_cast<T>(distribution(generator));
+      }
+    }
+  }
+
+  std::vector<vector_type> outputs(vector_count);
+  double max_ulp = 0.0;
+  for (size_t v = 0; v < vector_count; v++) {
+    outputs[v] = Builtin::evaluate(inputs[0][v], inputs[1][v], inputs[2][v]);
+    for (unsigned i = 0; i < N; i++) {
+      const long double reference =
+          Builtin::reference(element(inputs[0][v], i),
+                             element(inputs[1][v], i),
+                             element(inputs[2][v], i));
+      max_ulp = std::max(max_ulp, ulpError(element(outputs[v], i), reference));
+    }
+  }
+
+  // Cycles are derived from the elapsed time and the nominal clock rate. The
+  // timed loop runs for long enough that its overhead is negligible.
+  const auto start = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    (void)_;
+    for (size_t v = 0; v < vector_count; v++) {
+      outputs[v] =
+          Builtin::evaluate(inputs[0][v], inputs[1][v], inputs[2][v]);
+    }
+    benchmark::DoNotOptimize(outputs.data());
+    benchmark::ClobberMemory();
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  const double elements =
+      static_cast<double>(state.iterations()) * vector_count * N;
+  state.counters[cycles_counter] =
+      elapsed.count() * benchmark::CPUInfo::Get().cycles_per_second /
+      elements;
+  state.counters[ulp_counter] = max_ulp;
+  state.SetItemsProcessed(static_cast<int64_t>(elements));
+}
+
+/// @brief Register a benchmark of a builtin for one type and vector width.
+template <class Builtin, class T, unsigned N>
+void registerBuiltin(const char *type_name) {
+  std::string name = std::string(Builtin::name()) + "/" + type_name;
+  if (N != 1) {
+    name += std::to_string(N);
+  }
+  benchmark::RegisterBenchmark(name.c_str(), benchmarkBuiltin<Builtin, T, N>);
+}
+
+/// @brief Register benchmarks of a builtin for every vector width of `T`.
+template <class Builtin, class T>
+void registerBuiltin(const char *type_name) {
+  registerBuiltin<Builtin, T, 1>(type_name);
+  registerBuiltin<Builtin, T, 2>(type_name);
+  registerBuiltin<Builtin, T, 3>(type_name);
+  registerBuiltin<Builtin, T, 4>(type_name);
+  registerBuiltin<Builtin, T, 8>(type_name);
+  registerBuiltin<Builtin, T, 16>(type_name);
+}
+
+/// @brief Static initializer registering benchmarks of a builtin.
+///
+/// Half precision is not registered since `abacus_static` is not built with
+/// `__CA_BUILTINS_HALF_SUPPORT` and the host compiler has no `half` type.
+template <class Builtin>
+struct Registrar {
+  Registrar() {
+    registerBuiltin<Builtin, abacus_float>("float");
+    registerBuiltin<Builtin, abacus_double>("double");
+  }
+};
+
+/// @brief Static initializer registering benchmarks of a builtin which is only
+/// defined for single precision, such as the `half_` and `native_` builtins.
+template <class Builtin>
+struct FloatRegistrar {
+  FloatRegistrar() { registerBuiltin<Builtin, abacus_float>("float"); }
+};
+}  // namespace benchabacus
+
+/// @brief Define and register a builtin taking one parameter.
+///
+/// @param NAME Name of the builtin without the `__abacus_` prefix.
+/// @param LOW Lower bound of the parameter `x`.
+/// @param HIGH Upper bound of the parameter `x`.
+/// @param ... Reference expression of `long double x`.
+#define BENCHABACUS_UNARY(NAME, LOW, HIGH, ...)                         \
+  BENCHABACUS_BUILTIN(Registrar, NAME, 1, LOW, HIGH, LOW, HIGH,         \
+                      __abacus_##NAME(x), __VA_ARGS__)
+
+/// @brief Define and register a single precision builtin taking one
+/// parameter.
+///
+/// @param NAME Name of the builtin without the `__abacus_` prefix.
+/// @param LOW Lower bound of the parameter `x`.
+/// @param HIGH Upper bound of the parameter `x`.
+/// @param ... Reference expression of `long double x`.
+#define BENCHABACUS_UNARY_FLOAT(NAME, LOW, HIGH, ...)                   \
+  BENCHABACUS_BUILTIN(FloatRegistrar, NAME, 1, LOW, HIGH, LOW, HIGH,    \
+                      __abacus_##NAME(x), __VA_ARGS__)
+
+/// @brief Define and register a builtin taking two parameters.
+///
+/// @param NAME Name of the builtin without the `__abacus_` prefix.
+/// @param XLOW Lower bound of the parameter `x`.
+/// @param XHIGH Upper bound of the parameter `x`.
+/// @param YLOW Lower bound of the parameter `y`.
+/// @param YHIGH Upper bound of the parameter `y`.
+/// @param ... Reference expression of `long double x` and `y`.
+#define BENCHABACUS_BINARY(NAME, XLOW, XHIGH, YLOW, YHIGH, ...)         \
+  BENCHABACUS_BUILTIN(Registrar, NAME, 2, XLOW, XHIGH, YLOW, YHIGH,     \
+                      __abacus_##NAME(x, y), __VA_ARGS__)
+
+/// @brief Define and register a builtin taking one parameter, evaluated by an
+/// expression other than a plain call.
+///
+/// @param NAME Name of the builtin without the `__abacus_` prefix.
+/// @param LOW Lower bound of the parameter `x`.
+/// @param HIGH Upper bound of the parameter `x`.
+/// @param CALL Expression of `V x` evaluating the builtin and returning `V`.
+/// @param ... Reference expression of `long double x`.
+#define BENCHABACUS_UNARY_CALL(NAME, LOW, HIGH, CALL, ...)              \
+  BENCHABACUS_BUILTIN(Registrar, NAME, 1, LOW, HIGH, LOW, HIGH, CALL,   \
+                      __VA_ARGS__)
+
+/// @brief Define and register a builtin taking two parameters, evaluated by
+/// an expression other than a plain call.
+///
+/// @param NAME Name of the builtin without the `__abacus_` prefix.
+/// @param XLOW Lower bound of the parameter `x`.
+/// @param XHIGH Upper bound of the parameter `x`.
+/// @param YLOW Lower bound of the parameter `y`.
+/// @param YHIGH Upper bound of the parameter `y`.
+/// @param CALL Expression of `V x` and `y` evaluating the builtin and
+/// returning `V`.
+/// @param ... Reference expression of `long double x` and `y`.
+#define BENCHABACUS_BINARY_CALL(NAME, XLOW, XHIGH, YLOW, YHIGH, CALL, ...) \
+  BENCHABACUS_BUILTIN(Registrar, NAME, 2, XLOW, XHIGH, YLOW, YHIGH, CALL,  \
+                      __VA_ARGS__)
+
+/// @brief Define and register a builtin taking three parameters sampled from
+/// the same range.
+///
+/// @param NAME Name of the builtin without the `__abacus_` prefix.
+/// @param LOW Lower bound of the parameters.
+/// @param HIGH Upper bound of the parameters.
+/// @param ... Reference expression of `long double x`, `y` and `z`.
+#define BENCHABACUS_TERNARY(NAME, LOW, HIGH, ...)                       \
+  BENCHABACUS_BUILTIN(Registrar, NAME, 3, LOW, HIGH, LOW, HIGH,         \
+                      __abacus_##NAME(x, y, z), __VA_ARGS__)
+
+/// @brief Implementation detail of the `BENCHABACUS_*ARY` macros.
+///
+/// `REGISTRAR` names the static initializer selecting which types are
+/// registered. The range of `z` is the same as the range of `y`.
+#define BENCHABACUS_BUILTIN(REGISTRAR, NAME, ARITY, XLOW, XHIGH, YLOW, YHIGH, \
+                            CALL, ...)                                       \
+  namespace {                                                                \
+  struct NAME##_builtin {                                                    \
+    static constexpr unsigned arity = ARITY;                                 \
+    static const char *name() { return #NAME; }                              \
+    static benchabacus::Range range(unsigned arg) {                          \
+      return 0 == arg ? benchabacus::Range{XLOW, XHIGH}                      \
+                      : benchabacus::Range{YLOW, YHIGH};                     \
+    }                                                                        \
+    template <class V>                                                       \
+    static V evaluate(const V &x, const V &y, const V &z) {                  \
+      (void)y;                                                               \
+      (void)z;                                                               \
+      return CALL;                                                           \
+    }                                                                        \
+    static long double reference(long double x, long double y,               \
+                                 long double z) {                            \
+      (void)y;                                                               \
+      (void)z;                                                               \
+      return __VA_ARGS__;                                                    \
+    }                                                                        \
+  };                                                                         \
+  benchabacus::REGISTRAR<NAME##_builtin> NAME##_registrar;                   \
+  }                                                                          \
+  static_assert(true, "")
+
+#endif  // ABACUS_BENCHABACUS_COMMON_H_INCLUDED
@@ -0,0 +1,192 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Entry point for BenchAbacus, micro-benchmarks of abacus builtins.
+
+#include <cargo/argument_parser.h>
+#include <cargo/utility.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common.h"
+
+namespace {
+/// @brief Console reporter which also records the result of every benchmark.
+class RecordingReporter : public benchmark::ConsoleReporter {
+ public:
+  void ReportRuns(const std::vector<Run> &reports) override {
+    for (const Run &run : reports) {
+      if (run.error_occurred || Run::RT_Iteration != run.run_type) {
+        continue;
+      }
+      const auto cycles = run.counters.find(benchabacus::cycles_counter);
+      const auto ulp = run.counters.find(benchabacus::ulp_counter);
+      if (cycles != run.counters.end() && ulp != run.counters.end()) {
+        results[run.benchmark_name()] = {cycles->second.value,
+                                         ulp->second.value};
+      }
+    }
+    benchmark::ConsoleReporter::ReportRuns(reports);
+  }
+
+  /// @brief Results of every benchmark run, keyed by benchmark name.
+  std::map<std::string, benchabacus::Result> results;
+};
+
+/// @brief Write results to a baseline file, one comma separated line each.
+///
+/// @return Returns `true` on success, `false` if the file could not be
+/// written.
+bool writeBaseline(const std::string &path,
+                   const std::map<std::string, benchabacus::Result> &results) {
+  FILE *file = std::fopen(path.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+  for (const auto &result : results) {
+    std::fprintf(file, "%s,%.17g,%.17g\n", result.first.c_str(),
+                 result.second.cycles_per_element, result.second.max_ulp);
+  }
+  return 0 == std::fclose(file);
+}
+
+/// @brief Read a baseline file written by `writeBaseline`.
+///
+/// @return Returns `true` on success, `false` if the file could not be read.
+bool readBaseline(const std::string &path,
+                  std::map<std::string, benchabacus::Result> &results) {
+  FILE *file = std::fopen(path.c_str(), "r");
+  if (!file) {
+    return false;
+  }
+  char name[256];
+  benchabacus::Result result;
+  while (3 == std::fscanf(file, " %255[^,],%lf,%lf", name,
+                          &result.cycles_per_element, &result.max_ulp)) {
+    results[name] = result;
+  }
+  std::fclose(file);
+  return true;
+}
+
+/// @brief Compare results against a baseline.
+///
+/// A benchmark regresses if its maximum ULP error increased at all or its
+/// cycles per element increased by more than `tolerance` percent. Benchmarks
+/// missing from either side are not compared.
+///
+/// @return Returns the number of regressions found.
+unsigned compareBaseline(
+    const std::map<std::string, benchabacus::Result> &baseline,
+    const std::map<std::string, benchabacus::Result> &results,
+    double tolerance) {
+  unsigned regressions = 0;
+  for (const auto &result : results) {
+    const auto expected = baseline.find(result.first);
+    if (expected == baseline.end()) {
+      continue;
+    }
+    const benchabacus::Result &before = expected->second;
+    const benchabacus::Result &after = result.second;
+    if (after.max_ulp > before.max_ulp) {
+      std::fprintf(stderr, "regression: %s %s %g -> %g\n",
+                   result.first.c_str(), benchabacus::ulp_counter,
+                   before.max_ulp, after.max_ulp);
+      regressions++;
+    }
+    if (after.cycles_per_element >
+        before.cycles_per_element * (1.0 + tolerance / 100.0)) {
+      std::fprintf(stderr, "regression: %s %s %g -> %g\n",
+                   result.first.c_str(), benchabacus::cycles_counter,
+                   before.cycles_per_element, after.cycles_per_element);
+      regressions++;
+    }
+  }
+  return regressions;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  cargo::argument_parser<4> parser(cargo::KEEP_UNRECOGNIZED);
+  cargo::string_view baseline_path;
+  if (parser.add_argument({"--benchabacus_baseline=", baseline_path})) {
+    return -1;
+  }
+  cargo::string_view save_path;
+  if (parser.add_argument({"--benchabacus_save_baseline=", save_path})) {
+    return -1;
+  }
+  cargo::string_view tolerance_string;
+  if (parser.add_argument(
+          {"--benchabacus_tolerance=", tolerance_string})) {
+    return -1;
+  }
+  bool help = false;
+  if (parser.add_argument({"--help", help})) {
+    return -1;
+  }
+  if (auto error = parser.parse_args(argc, argv)) {
+    return error;
+  }
+
+  if (help) {
+    // If --help was passed print usage messages and exit.
+    std::fprintf(stdout,
+                 "BenchAbacus [--benchabacus_baseline=<file>]\n"
+                 "            [--benchabacus_save_baseline=<file>]\n"
+                 "            [--benchabacus_tolerance=<percent>]\n");
+    benchmark::Initialize(&argc, argv);
+    return 0;
+  }
+
+  std::map<std::string, benchabacus::Result> baseline;
+  if (!baseline_path.empty() &&
+      !readBaseline(cargo::as<std::string>(baseline_path), baseline)) {
+    std::fprintf(stderr, "error: unable to read baseline: %.*s\n",
+                 static_cast<int>(baseline_path.size()),
+                 baseline_path.data());
+    return -1;
+  }
+  // Cycle counts vary between runs far more than ULP errors, allow a 10%
+  // slow down by default before reporting a regression.
+  double tolerance = 10.0;
+  if (!tolerance_string.empty()) {
+    tolerance = std::strtod(cargo::as<std::string>(tolerance_string).c_str(),
+                            nullptr);
+  }
+
+  benchmark::Initialize(&argc, argv);
+  RecordingReporter reporter;
+  benchmark::RunSpecifiedBenchmarks(&reporter);
+
+  if (!save_path.empty() &&
+      !writeBaseline(cargo::as<std::string>(save_path), reporter.results)) {
+    std::fprintf(stderr, "error: unable to write baseline: %.*s\n",
+                 static_cast<int>(save_path.size()), save_path.data());
+    return -1;
+  }
+  if (!baseline_path.empty() &&
+      0 != compareBaseline(baseline, reporter.results, tolerance)) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,161 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Benchmarks of the abacus math builtins.
+///
+/// Each builtin is sampled over a range covering its interesting domain.
+/// Trigonometric builtins include large arguments to exercise the Payne-Hanek
+/// range reduction. The `half_` and `native_` builtins are measured against
+/// the same reference as their full precision counterparts so their reported
+/// error is relative to the precise result.
+///
+/// Integer parameters, such as the exponent of `ldexp`, are sampled as floating
+/// point values and truncated towards zero. The integer result of `ilogb` is
+/// compared as a floating point value. Builtins which also store a result
+/// through a pointer, i.e. `frexp`, `fract`, `modf`, `remquo` and `sincos`,
+/// only have their return value checked.
+
+#include <abacus/abacus_math.h>
+
+#include <cmath>
+
+#include "common.h"
+
+namespace {
+const long double pi = 3.14159265358979323846264338327950288L;
+}  // namespace
+
+BENCHABACUS_UNARY(acos, -1.0, 1.0, std::acos(x));
+BENCHABACUS_UNARY(acosh, 1.0, 1.0e4, std::acosh(x));
+BENCHABACUS_UNARY(acospi, -1.0, 1.0, std::acos(x) / pi);
+BENCHABACUS_UNARY(asin, -1.0, 1.0, std::asin(x));
+BENCHABACUS_UNARY(asinh, -1.0e4, 1.0e4, std::asinh(x));
+BENCHABACUS_UNARY(asinpi, -1.0, 1.0, std::asin(x) / pi);
+BENCHABACUS_UNARY(atan, -1.0e4, 1.0e4, std::atan(x));
+BENCHABACUS_UNARY(atanh, -1.0, 1.0, std::atanh(x));
+BENCHABACUS_UNARY(atanpi, -1.0e4, 1.0e4, std::atan(x) / pi);
+BENCHABACUS_UNARY(cbrt, -1.0e6, 1.0e6, std::cbrt(x));
+BENCHABACUS_UNARY(ceil, -1.0e6, 1.0e6, std::ceil(x));
+BENCHABACUS_UNARY(cos, -1.0e6, 1.0e6, std::cos(x));
+BENCHABACUS_UNARY(cosh, -80.0, 80.0, std::cosh(x));
+BENCHABACUS_UNARY(cospi, -1.0e4, 1.0e4, std::cos(pi * std::fmod(x, 2.0L)));
+BENCHABACUS_UNARY(erf, -6.0, 6.0, std::erf(x));
+BENCHABACUS_UNARY(erfc, -6.0, 20.0, std::erfc(x));
+BENCHABACUS_UNARY(exp, -80.0, 80.0, std::exp(x));
+BENCHABACUS_UNARY(exp10, -35.0, 35.0, std::pow(10.0L, x));
+BENCHABACUS_UNARY(exp2, -120.0, 120.0, std::exp2(x));
+BENCHABACUS_UNARY(expm1, -80.0, 80.0, std::expm1(x));
+BENCHABACUS_UNARY(fabs, -1.0e6, 1.0e6, std::fabs(x));
+BENCHABACUS_UNARY(floor, -1.0e6, 1.0e6, std::floor(x));
+BENCHABACUS_UNARY_CALL(fract, -1.0e6, 1.0e6,
+                       __abacus_fract(x, benchabacus::discard<V>()),
+                       x - std::floor(x));
+BENCHABACUS_UNARY_CALL(
+    frexp, -1.0e6, 1.0e6,
+    __abacus_frexp(x, benchabacus::discard<benchabacus::IntVector<V>>()),
+    x / std::exp2(std::ilogb(x) + 1));
+BENCHABACUS_UNARY_CALL(ilogb, -1.0e6, 1.0e6,
+                       benchabacus::convert<V>(__abacus_ilogb(x)),
+                       std::ilogb(x));
+BENCHABACUS_UNARY(lgamma, 0.0, 1.0e3, std::lgamma(x));
+BENCHABACUS_UNARY(log, 0.0, 1.0e6, std::log(x));
+BENCHABACUS_UNARY(log10, 0.0, 1.0e6, std::log10(x));
+BENCHABACUS_UNARY(log1p, -1.0, 1.0e6, std::log1p(x));
+BENCHABACUS_UNARY(log2, 0.0, 1.0e6, std::log2(x));
+BENCHABACUS_UNARY(logb, 0.0, 1.0e6, std::logb(x));
+BENCHABACUS_UNARY_CALL(modf, -1.0e6, 1.0e6,
+                       __abacus_modf(x, benchabacus::discard<V>()),
+                       x - std::trunc(x));
+BENCHABACUS_UNARY(rint, -1.0e6, 1.0e6, std::rint(x));
+BENCHABACUS_UNARY(round, -1.0e6, 1.0e6, std::round(x));
+BENCHABACUS_UNARY(rsqrt, 0.0, 1.0e6, 1.0L / std::sqrt(x));
+BENCHABACUS_UNARY(sin, -1.0e6, 1.0e6, std::sin(x));
+BENCHABACUS_UNARY_CALL(sincos, -1.0e6, 1.0e6,
+                       __abacus_sincos(x, benchabacus::discard<V>()),
+                       std::sin(x));
+BENCHABACUS_UNARY(sinh, -80.0, 80.0, std::sinh(x));
+BENCHABACUS_UNARY(sinpi, -1.0e4, 1.0e4, std::sin(pi * std::fmod(x, 2.0L)));
+BENCHABACUS_UNARY(sqrt, 0.0, 1.0e6, std::sqrt(x));
+BENCHABACUS_UNARY(tan, -1.0e6, 1.0e6, std::tan(x));
+BENCHABACUS_UNARY(tanh, -20.0, 20.0, std::tanh(x));
+BENCHABACUS_UNARY(tanpi, -0.49, 0.49, std::tan(pi * x));
+BENCHABACUS_UNARY(tgamma, 0.0, 30.0, std::tgamma(x));
+BENCHABACUS_UNARY(trunc, -1.0e6, 1.0e6, std::trunc(x));
+
+BENCHABACUS_UNARY_FLOAT(half_cos, -3.14, 3.14, std::cos(x));
+BENCHABACUS_UNARY_FLOAT(half_exp, -80.0, 80.0, std::exp(x));
+BENCHABACUS_UNARY_FLOAT(half_exp10, -35.0, 35.0, std::pow(10.0L, x));
+BENCHABACUS_UNARY_FLOAT(half_exp2, -120.0, 120.0, std::exp2(x));
+BENCHABACUS_UNARY_FLOAT(half_log, 0.0, 1.0e6, std::log(x));
+BENCHABACUS_UNARY_FLOAT(half_log10, 0.0, 1.0e6, std::log10(x));
+BENCHABACUS_UNARY_FLOAT(half_log2, 0.0, 1.0e6, std::log2(x));
+BENCHABACUS_UNARY_FLOAT(half_recip, 1.0e-3, 1.0e6, 1.0L / x);
+BENCHABACUS_UNARY_FLOAT(half_rsqrt, 0.0, 1.0e6, 1.0L / std::sqrt(x));
+BENCHABACUS_UNARY_FLOAT(half_sin, -3.14, 3.14, std::sin(x));
+BENCHABACUS_UNARY_FLOAT(half_sqrt, 0.0, 1.0e6, std::sqrt(x));
+BENCHABACUS_UNARY_FLOAT(half_tan, -1.5, 1.5, std::tan(x));
+
+BENCHABACUS_UNARY_FLOAT(native_cos, -3.14, 3.14, std::cos(x));
+BENCHABACUS_UNARY_FLOAT(native_exp, -80.0, 80.0, std::exp(x));
+BENCHABACUS_UNARY_FLOAT(native_exp10, -35.0, 35.0, std::pow(10.0L, x));
+BENCHABACUS_UNARY_FLOAT(native_exp2, -120.0, 120.0, std::exp2(x));
+BENCHABACUS_UNARY_FLOAT(native_log, 0.0, 1.0e6, std::log(x));
+BENCHABACUS_UNARY_FLOAT(native_log10, 0.0, 1.0e6, std::log10(x));
+BENCHABACUS_UNARY_FLOAT(native_log2, 0.0, 1.0e6, std::log2(x));
+BENCHABACUS_UNARY_FLOAT(native_recip, 1.0e-3, 1.0e6, 1.0L / x);
+BENCHABACUS_UNARY_FLOAT(native_rsqrt, 0.0, 1.0e6, 1.0L / std::sqrt(x));
+BENCHABACUS_UNARY_FLOAT(native_sin, -3.14, 3.14, std::sin(x));
+BENCHABACUS_UNARY_FLOAT(native_sqrt, 0.0, 1.0e6, std::sqrt(x));
+BENCHABACUS_UNARY_FLOAT(native_tan, -1.5, 1.5, std::tan(x));
+
+BENCHABACUS_BINARY(atan2, -1.0e4, 1.0e4, -1.0e4, 1.0e4, std::atan2(x, y));
+BENCHABACUS_BINARY(atan2pi, -1.0e4, 1.0e4, -1.0e4, 1.0e4,
+                   std::atan2(x, y) / pi);
+BENCHABACUS_BINARY(copysign, -1.0e6, 1.0e6, -1.0, 1.0, std::copysign(x, y));
+BENCHABACUS_BINARY(fdim, -1.0e6, 1.0e6, -1.0e6, 1.0e6, std::fdim(x, y));
+BENCHABACUS_BINARY(fmax, -1.0e6, 1.0e6, -1.0e6, 1.0e6, std::fmax(x, y));
+BENCHABACUS_BINARY(fmin, -1.0e6, 1.0e6, -1.0e6, 1.0e6, std::fmin(x, y));
+BENCHABACUS_BINARY(fmod, -1.0e6, 1.0e6, -1.0e3, 1.0e3, std::fmod(x, y));
+BENCHABACUS_BINARY(hypot, -1.0e6, 1.0e6, -1.0e6, 1.0e6, std::hypot(x, y));
+BENCHABACUS_BINARY_CALL(ldexp, -1.0e3, 1.0e3, -64.0, 64.0,
+                        __abacus_ldexp(x, benchabacus::convert<
+                                              benchabacus::IntVector<V>>(y)),
+                        std::ldexp(x, static_cast<int>(y)));
+BENCHABACUS_BINARY(maxmag, -1.0e6, 1.0e6, -1.0e6, 1.0e6,
+                   std::fabs(x) > std::fabs(y) ? x : y);
+BENCHABACUS_BINARY(minmag, -1.0e6, 1.0e6, -1.0e6, 1.0e6,
+                   std::fabs(x) < std::fabs(y) ? x : y);
+BENCHABACUS_BINARY(pow, 0.0, 1.0e2, -16.0, 16.0, std::pow(x, y));
+BENCHABACUS_BINARY_CALL(pown, -1.0e2, 1.0e2, -16.0, 16.0,
+                        __abacus_pown(x, benchabacus::convert<
+                                             benchabacus::IntVector<V>>(y)),
+                        std::pow(x, static_cast<int>(y)));
+BENCHABACUS_BINARY(powr, 0.0, 1.0e2, -16.0, 16.0, std::pow(x, y));
+BENCHABACUS_BINARY(remainder, -1.0e6, 1.0e6, -1.0e3, 1.0e3,
+                   std::remainder(x, y));
+BENCHABACUS_BINARY_CALL(
+    remquo, -1.0e6, 1.0e6, -1.0e3, 1.0e3,
+    __abacus_remquo(x, y, benchabacus::discard<benchabacus::IntVector<V>>()),
+    std::remainder(x, y));
+BENCHABACUS_BINARY_CALL(rootn, 0.0, 1.0e6, 1.0, 16.0,
+                        __abacus_rootn(x, benchabacus::convert<
+                                              benchabacus::IntVector<V>>(y)),
+                        std::pow(x, 1.0L / static_cast<int>(y)));
+
+BENCHABACUS_TERNARY(fma, -1.0e3, 1.0e3, std::fma(x, y, z));
+BENCHABACUS_TERNARY(mad, -1.0e3, 1.0e3, x * y + z);
@@ -129,6 +129,60 @@ libimg::Float4 __Codeplay_read_imagef_2d(Image *image, Sampler sampler,
 libimg::Float4 __Codeplay_read_imagef_2d(Image *image, Sampler sampler,
                                          libimg::Float2 coord);
 
+/// @brief Variant of __Codeplay_read_imagef_2d for samplers known to use
+/// CLK_FILTER_NEAREST.
+///
+/// The filter mode bits of sampler are ignored. Intended to be called by the
+/// compiler when the sampler is a compile-time constant.
+///
+/// @param image pointer to an Image object used by both the host and the kernel
+/// side API's.
+/// @param sampler Sampler value (32-bit integer).
+/// @param coord built-in vector type of 2 integers.
+///
+/// @return built-in vector type of 4 floats.
+libimg::Float4 __Codeplay_read_imagef_2d_nearest(Image *image, Sampler sampler,
+                                                 libimg::Int2 coord);
+
+/// @brief Variant of __Codeplay_read_imagef_2d for samplers known to use
+/// CLK_FILTER_NEAREST.
+///
+/// @param image pointer to an Image object used by both the host and the kernel
+/// side API's.
+/// @param sampler Sampler value (32-bit integer).
+/// @param coord built-in vector type of 2 floats.
+///
+/// @return built-in vector type of 4 floats.
+libimg::Float4 __Codeplay_read_imagef_2d_nearest(Image *image, Sampler sampler,
+                                                 libimg::Float2 coord);
+
+/// @brief Variant of __Codeplay_read_imagef_2d for samplers known to use
+/// CLK_FILTER_LINEAR.
+///
+/// The filter mode bits of sampler are ignored. Intended to be called by the
+/// compiler when the sampler is a compile-time constant.
+///
+/// @param image pointer to an Image object used by both the host and the kernel
+/// side API's.
+/// @param sampler Sampler value (32-bit integer).
+/// @param coord built-in vector type of 2 integers.
+///
+/// @return built-in vector type of 4 floats.
+libimg::Float4 __Codeplay_read_imagef_2d_linear(Image *image, Sampler sampler,
+                                                libimg::Int2 coord);
+
+/// @brief Variant of __Codeplay_read_imagef_2d for samplers known to use
+/// CLK_FILTER_LINEAR.
+///
+/// @param image pointer to an Image object used by both the host and the kernel
+/// side API's.
+/// @param sampler Sampler value (32-bit integer).
+/// @param coord built-in vector type of 2 floats.
+///
+/// @return built-in vector type of 4 floats.
+libimg::Float4 __Codeplay_read_imagef_2d_linear(Image *image, Sampler sampler,
+                                                libimg::Float2 coord);
+
 /// @brief corresponds to OpenCL: float4 read_imagef ( image1d_array_t image,
 /// sampler_t sampler, int2 coord)
 ///
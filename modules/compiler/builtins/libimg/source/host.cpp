@@ -24,6 +24,7 @@
 #include <libimg/shared.h>
 #include <libimg/validate.h>
 
+#include <algorithm>
 #include <cassert>
 #include <climits>
 #include <cstdlib>
@@ -560,24 +561,48 @@ void *libimg::HostGetImageKernelImagePtr(HostImage *image) {
   return &image->image;
 }
 
+// Copies a region of rows between two pitched allocations. Rows which are
+// contiguous in both source and destination are copied together, as are whole
+// slices, so that tightly packed regions are copied with a single call.
+static void HostCopyRegion(uint8_t *dst, const size_t dst_row_pitch,
+                           const size_t dst_slice_pitch, const uint8_t *src,
+                           const size_t src_row_pitch,
+                           const size_t src_slice_pitch, size_t row_size,
+                           size_t rows, const size_t slices) {
+  if (row_size == dst_row_pitch && row_size == src_row_pitch) {
+    const size_t slice_size = row_size * rows;
+    if (1 == slices ||
+        (slice_size == dst_slice_pitch && slice_size == src_slice_pitch)) {
+      std::memmove(dst, src, slice_size * slices);
+      return;
+    }
+    row_size = slice_size;
+    rows = 1;
+  }
+
+  for (size_t z = 0; z < slices; ++z) {
+    const uint8_t *src_row = src + z * src_slice_pitch;
+    uint8_t *dst_row = dst + z * dst_slice_pitch;
+    for (size_t y = 0; y < rows; ++y) {
+      std::memmove(dst_row, src_row, row_size);
+      src_row += src_row_pitch;
+      dst_row += dst_row_pitch;
+    }
+  }
+}
+
 void libimg::HostReadImage(const HostImage *image, const size_t origin[3],
                            const size_t region[3], const size_t dst_row_pitch,
                            const size_t dst_slice_pitch, uint8_t *dst) {
   const ImageMetaData &desc = image->image.meta_data;
 
-  const uint8_t *src = image->image.raw_data + origin[0] * desc.pixel_size;
-
-  const size_t row_size = region[0] * desc.pixel_size;
+  const uint8_t *src = image->image.raw_data + origin[0] * desc.pixel_size +
+                       origin[1] * desc.row_pitch +
+                       origin[2] * desc.slice_pitch;
 
-  for (size_t z = 0; z < region[2]; ++z) {
-    const uint8_t *src_slice = src + (z + origin[2]) * desc.slice_pitch;
-    uint8_t *dst_slice = dst + z * dst_slice_pitch;
-    for (size_t y = 0; y < region[1]; ++y) {
-      const uint8_t *src_row = src_slice + (y + origin[1]) * desc.row_pitch;
-      uint8_t *dst_row = dst_slice + y * dst_row_pitch;
-      std::memmove(dst_row, src_row, row_size);
-    }
-  }
+  HostCopyRegion(dst, dst_row_pitch, dst_slice_pitch, src, desc.row_pitch,
+                 desc.slice_pitch, region[0] * desc.pixel_size, region[1],
+                 region[2]);
 }
 
 void libimg::HostWriteImage(HostImage *image, const size_t origin[3],
@@ -585,19 +610,12 @@ void libimg::HostWriteImage(HostImage *image, const size_t origin[3],
                             const size_t src_slice_pitch, const uint8_t *src) {
   const ImageMetaData &desc = image->image.meta_data;
 
-  uint8_t *dst = image->image.raw_data + origin[0] * desc.pixel_size;
-
-  const size_t row_size = region[0] * desc.pixel_size;
+  uint8_t *dst = image->image.raw_data + origin[0] * desc.pixel_size +
+                 origin[1] * desc.row_pitch + origin[2] * desc.slice_pitch;
 
-  for (size_t z = 0; z < region[2]; ++z) {
-    const uint8_t *src_slice = src + z * src_slice_pitch;
-    uint8_t *dst_slice = dst + (z + origin[2]) * desc.slice_pitch;
-    for (size_t y = 0; y < region[1]; ++y) {
-      const uint8_t *src_row = src_slice + y * src_row_pitch;
-      uint8_t *dst_row = dst_slice + (y + origin[1]) * desc.row_pitch;
-      std::memmove(dst_row, src_row, row_size);
-    }
-  }
+  HostCopyRegion(dst, desc.row_pitch, desc.slice_pitch, src, src_row_pitch,
+                 src_slice_pitch, region[0] * desc.pixel_size, region[1],
+                 region[2]);
 }
 
 libimg::UInt4 ShuffleOrder(const libimg::UInt order, const libimg::UInt4 &in) {
@@ -709,14 +727,24 @@ void libimg::HostFillImage(HostImage *image, const void *fill_color,
   uint8_t *dst = image->image.raw_data + origin[0] * desc.pixel_size +
                  origin[1] * desc.row_pitch + origin[2] * desc.slice_pitch;
 
+  if (0 == region[0] || 0 == region[1] || 0 == region[2]) {
+    return;
+  }
+
+  // Fill the first row by doubling the filled span with each copy, then copy
+  // whole rows from it for the remainder of the region.
+  const size_t row_size = region[0] * desc.pixel_size;
+  std::memcpy(dst, final_color, desc.pixel_size);
+  for (size_t filled = desc.pixel_size; filled < row_size;) {
+    const size_t size = std::min(filled, row_size - filled);
+    std::memcpy(dst + filled, dst, size);
+    filled += size;
+  }
+
   for (size_t z = 0; z < region[2]; ++z) {
     uint8_t *dst_slice = dst + z * desc.slice_pitch;
-    for (size_t y = 0; y < region[1]; ++y) {
-      uint8_t *dst_row = dst_slice + y * desc.row_pitch;
-      for (size_t x = 0; x < region[0]; ++x) {
-        uint8_t *dst_pixel = dst_row + x * desc.pixel_size;
-        std::memcpy(dst_pixel, final_color, desc.pixel_size);
-      }
+    for (size_t y = (0 == z) ? 1 : 0; y < region[1]; ++y) {
+      std::memcpy(dst_slice + y * desc.row_pitch, dst, row_size);
     }
   }
 }
@@ -727,26 +755,18 @@ void libimg::HostCopyImage(const HostImage *src_image, HostImage *dst_image,
   const ImageMetaData &src_desc = src_image->image.meta_data;
   const ImageMetaData &dst_desc = dst_image->image.meta_data;
 
-  const uint8_t *const src =
-      src_image->image.raw_data + src_origin[0] * src_desc.pixel_size;
-  uint8_t *const dst =
-      dst_image->image.raw_data + dst_origin[0] * dst_desc.pixel_size;
-
-  const size_t z_max = region[2];
-  const size_t y_max = region[1];
-  const size_t x_size = region[0] * src_desc.pixel_size;
-
-  for (size_t z = 0; z < z_max; z++) {
-    const uint8_t *const src_slice =
-        src + (z + src_origin[2]) * src_desc.slice_pitch;
-    uint8_t *const dst_slice = dst + (z + dst_origin[2]) * dst_desc.slice_pitch;
-    for (size_t y = 0; y < y_max; y++) {
-      const uint8_t *const src_row =
-          src_slice + (y + src_origin[1]) * src_desc.row_pitch;
-      uint8_t *dst_row = dst_slice + (y + dst_origin[1]) * dst_desc.row_pitch;
-      std::memmove(dst_row, src_row, x_size);
-    }
-  }
+  const uint8_t *const src = src_image->image.raw_data +
+                             src_origin[0] * src_desc.pixel_size +
+                             src_origin[1] * src_desc.row_pitch +
+                             src_origin[2] * src_desc.slice_pitch;
+  uint8_t *const dst = dst_image->image.raw_data +
+                       dst_origin[0] * dst_desc.pixel_size +
+                       dst_origin[1] * dst_desc.row_pitch +
+                       dst_origin[2] * dst_desc.slice_pitch;
+
+  HostCopyRegion(dst, dst_desc.row_pitch, dst_desc.slice_pitch, src,
+                 src_desc.row_pitch, src_desc.slice_pitch,
+                 region[0] * src_desc.pixel_size, region[1], region[2]);
 }
 
 void libimg::HostCopyImageToBuffer(const HostImage *src_image, void *dst_buffer,
@@ -760,19 +780,10 @@ void libimg::HostCopyImageToBuffer(const HostImage *src_image, void *dst_buffer,
       src_origin[1] * desc.row_pitch + src_origin[2] * desc.slice_pitch;
   uint8_t *const dst = static_cast<uint8_t *>(dst_buffer) + dst_offset;
 
-  const size_t z_max = region[2];
-  const size_t y_max = region[1];
-  const size_t x_size = region[0] * desc.pixel_size;
-
-  uint8_t *dst_row = dst;
-  for (size_t z = 0; z < z_max; z++) {
-    const uint8_t *src_row = src + desc.slice_pitch * z;
-    for (size_t y = 0; y < y_max; y++) {
-      std::memmove(dst_row, src_row, x_size);
-      dst_row += x_size;
-      src_row += desc.row_pitch;
-    }
-  }
+  // The buffer side of the copy is tightly packed.
+  const size_t row_size = region[0] * desc.pixel_size;
+  HostCopyRegion(dst, row_size, row_size * region[1], src, desc.row_pitch,
+                 desc.slice_pitch, row_size, region[1], region[2]);
 }
 
 void libimg::HostCopyBufferToImage(const void *src_buffer, HostImage *dst_image,
@@ -781,28 +792,14 @@ void libimg::HostCopyBufferToImage(const void *src_buffer, HostImage *dst_image,
                                    const size_t region[3]) {
   const ImageMetaData &desc = dst_image->image.meta_data;
 
-  const uint8_t *src = static_cast<const uint8_t *>(src_buffer) + src_offset;
-  uint8_t *dst = dst_image->image.raw_data;
-
-  const size_t z_max = dst_origin[2] + region[2];
-  const size_t y_max = dst_origin[1] + region[1];
-  const size_t x_size = region[0] * desc.pixel_size;
-
-  const size_t region_slice_pitch = region[1] * region[0] * desc.pixel_size;
-  const size_t region_row_pitch = region[0] * desc.pixel_size;
-
-  for (size_t z = dst_origin[2]; z < z_max; z++) {
-    const uint8_t *src_row = src;
-    uint8_t *dst_row = dst;
-
-    for (size_t y = dst_origin[1]; y < y_max; y++) {
-      std::memmove(dst_row, src_row, x_size);
-
-      src_row += region_row_pitch;
-      dst_row += desc.row_pitch;
-    }
+  const uint8_t *const src =
+      static_cast<const uint8_t *>(src_buffer) + src_offset;
+  uint8_t *const dst =
+      dst_image->image.raw_data + desc.pixel_size * dst_origin[0] +
+      dst_origin[1] * desc.row_pitch + dst_origin[2] * desc.slice_pitch;
 
-    src += region_slice_pitch;
-    dst += desc.slice_pitch;
-  }
+  // The buffer side of the copy is tightly packed.
+  const size_t row_size = region[0] * desc.pixel_size;
+  HostCopyRegion(dst, desc.row_pitch, desc.slice_pitch, src, row_size,
+                 row_size * region[1], row_size, region[1], region[2]);
 }
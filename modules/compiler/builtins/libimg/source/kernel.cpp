@@ -507,6 +507,36 @@ class float4_reader {
   }
 };
 
+/// @brief Reader for CLK_RGBA/CLK_UNORM_INT8 images.
+///
+/// Skips the channel order and type dispatch of float4_reader; the format is
+/// checked once per read by the caller instead of once per texel.
+class float4_rgba_unorm_int8_reader {
+ public:
+  inline libimg::Float4 operator()(const void *data, const libimg::UInt,
+                                   const libimg::UInt) const {
+    const libimg::UChar *pixel_data = static_cast<const libimg::UChar *>(data);
+    const libimg::Float coefficient = 0.0039215686f;
+    return libimg::make<libimg::Float4>(
+        pixel_data[0] * coefficient, pixel_data[1] * coefficient,
+        pixel_data[2] * coefficient, pixel_data[3] * coefficient);
+  }
+};
+
+/// @brief Reader for CLK_RGBA/CLK_FLOAT images.
+///
+/// Skips the channel order and type dispatch of float4_reader; the format is
+/// checked once per read by the caller instead of once per texel.
+class float4_rgba_float_reader {
+ public:
+  inline libimg::Float4 operator()(const void *data, const libimg::UInt,
+                                   const libimg::UInt) const {
+    const libimg::Float *pixel_data = static_cast<const libimg::Float *>(data);
+    return libimg::make<libimg::Float4>(pixel_data[0], pixel_data[1],
+                                        pixel_data[2], pixel_data[3]);
+  }
+};
+
 class float4_writer {
  public:
   static inline void write(void *data, const libimg::Float4 &color,
@@ -2458,6 +2488,42 @@ inline VecTy image_2d_sampler_read_helper(const libimg::Float2 &coord,
   return border_res;
 }
 
+/// @brief Read a libimg::Float4 from a 2D image with a known filter mode.
+///
+/// The filter mode bits of the sampler are replaced by FilterMode so that the
+/// filter switch in image_2d_sampler_read_helper folds away once inlined. Any
+/// other sampler bits which are constant at the call site fold in the same way.
+/// CLK_RGBA images with CLK_UNORM_INT8 or CLK_FLOAT channels use readers that
+/// skip the per-texel format dispatch.
+///
+/// @tparam FilterMode Either CLK_FILTER_NEAREST or CLK_FILTER_LINEAR.
+template <libimg::UInt FilterMode>
+inline libimg::Float4 image_2d_filtered_read_helper(
+    Image *image, Sampler sampler, const libimg::Float2 &coord) {
+  sampler = (sampler & ~FILTER_MODE_MASK) | FilterMode;
+  ImageMetaData &desc = image->meta_data;
+  if (desc.channel_order == CLK_RGBA) {
+    // The border color of CLK_RGBA images is always transparent black.
+    const libimg::Float4 border_res =
+        libimg::make<libimg::Float4>(0.0f, 0.0f, 0.0f, 0.0f);
+    switch (desc.channel_type) {
+      default:
+        break;
+      case CLK_UNORM_INT8:
+        return image_2d_sampler_read_helper<libimg::Float4, libimg::Float>(
+            coord, sampler, desc, image->raw_data, border_res,
+            float4_rgba_unorm_int8_reader());
+      case CLK_FLOAT:
+        return image_2d_sampler_read_helper<libimg::Float4, libimg::Float>(
+            coord, sampler, desc, image->raw_data, border_res,
+            float4_rgba_float_reader());
+    }
+  }
+  return image_2d_sampler_read_helper<libimg::Float4, libimg::Float>(
+      coord, sampler, desc, image->raw_data,
+      border_color<libimg::Float4>(desc.channel_order), float4_reader());
+}
+
 template <typename VecTy, typename VecElemTy, typename VecAccessTy>
 inline VecTy image_3d_sampler_read_helper(const libimg::Float4 &coord,
                                           const Sampler sampler,
@@ -3176,6 +3242,38 @@ libimg::Float4 __Codeplay_read_imagef_2d(Image *image, Sampler sampler,
       border_color<libimg::Float4>(desc.channel_order), float4_reader());
 }
 
+libimg::Float4 __Codeplay_read_imagef_2d_nearest(Image *image, Sampler sampler,
+                                                 libimg::Int2 coord) {
+  // CLK_NORMALIZED_COORDS_TRUE with int coordinate are not valid.
+  if (get_sampler_normalized_coords(sampler)) {
+    return libimg::make<libimg::Float4>(0.0f, 0.0f, 0.0f, 0.0f);
+  }
+  libimg::Float2 f_coord = libimg::convert_float2(coord);
+  return __Codeplay_read_imagef_2d_nearest(image, sampler, f_coord);
+}
+
+libimg::Float4 __Codeplay_read_imagef_2d_nearest(Image *image, Sampler sampler,
+                                                 libimg::Float2 coord) {
+  return image_2d_filtered_read_helper<CLK_FILTER_NEAREST>(image, sampler,
+                                                           coord);
+}
+
+libimg::Float4 __Codeplay_read_imagef_2d_linear(Image *image, Sampler sampler,
+                                                libimg::Int2 coord) {
+  // CLK_NORMALIZED_COORDS_TRUE with int coordinate are not valid.
+  if (get_sampler_normalized_coords(sampler)) {
+    return libimg::make<libimg::Float4>(0.0f, 0.0f, 0.0f, 0.0f);
+  }
+  libimg::Float2 f_coord = libimg::convert_float2(coord);
+  return __Codeplay_read_imagef_2d_linear(image, sampler, f_coord);
+}
+
+libimg::Float4 __Codeplay_read_imagef_2d_linear(Image *image, Sampler sampler,
+                                                libimg::Float2 coord) {
+  return image_2d_filtered_read_helper<CLK_FILTER_LINEAR>(image, sampler,
+                                                          coord);
+}
+
 libimg::Float4 __Codeplay_read_imagef_1d_array(Image *image, Sampler sampler,
                                                libimg::Int2 coord) {
   // CLK_NORMALIZED_COORDS_TRUE with int coordinate are not valid.
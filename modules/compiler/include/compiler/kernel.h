@@ -103,6 +103,26 @@ class Kernel {
   createSpecializedKernel(
       const mux_ndrange_options_t &specialization_options) = 0;
 
+  /// @brief Creates a binary in the same way as `createSpecializedKernel`, for
+  /// a single enqueue whose argument values can not change afterwards.
+  ///
+  /// The binary is only ever executed with the argument values held in
+  /// @p specialization_options, so it may have them folded in. It must not be
+  /// used for commands whose arguments can be updated after they were created,
+  /// such as commands recorded into a command buffer.
+  ///
+  /// The default implementation calls `createSpecializedKernel`.
+  ///
+  /// @param specialization_options Mux execution options to specialize for.
+  ///
+  /// @return A valid binary object if specialization was successful,
+  /// or a status code otherwise, see `createSpecializedKernel`.
+  virtual cargo::expected<cargo::dynamic_array<uint8_t>, Result>
+  createSpecializedKernelForEnqueue(
+      const mux_ndrange_options_t &specialization_options) {
+    return createSpecializedKernel(specialization_options);
+  }
+
   /// @brief Returns the sub-group size for this kernel.
   ///
   /// This function queries a kernel for maximum sub-group size that would exist
@@ -501,6 +501,8 @@ class Module {
   /// @param[in] buffer View of the SPIR-V binary stream memory.
   /// @param[in] spirv_device_info Target device information.
   /// @param[in] spirv_spec_info Information about constants to be specialized.
+  /// @param[in] spirv_entry_points Names of the entry points to compile along
+  /// with the functions they call. If empty, every function is compiled.
   ///
   /// @return Returns either a SPIR-V module info object on success, or a status
   /// code otherwise.
@@ -513,7 +515,8 @@ class Module {
   virtual cargo::expected<spirv::ModuleInfo, Result> compileSPIRV(
       cargo::array_view<const std::uint32_t> buffer,
       const spirv::DeviceInfo &spirv_device_info,
-      cargo::optional<const spirv::SpecializationInfo &> spirv_spec_info) = 0;
+      cargo::optional<const spirv::SpecializationInfo &> spirv_spec_info,
+      cargo::array_view<const cargo::string_view> spirv_entry_points) = 0;
 
   /// @brief Compile an OpenCL C program.
   ///
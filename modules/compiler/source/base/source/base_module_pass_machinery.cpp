@@ -354,6 +354,8 @@ Expected<compiler::utils::HandleBarriersOptions> parseHandleBarrierPassOptions(
       Opts.IsDebug = true;
     } else if (ParamName == "no-tail") {
       Opts.ForceNoTail = true;
+    } else if (ParamName == "split-barrier-free") {
+      Opts.SplitBarrierFreeWorkGroups = true;
     }
   }
   return Opts;
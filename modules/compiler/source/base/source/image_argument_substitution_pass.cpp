@@ -20,6 +20,7 @@
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
 #include <multi_llvm/multi_llvm.h>
+#include <multi_llvm/optional_helper.h>
 
 #include <map>
 
@@ -47,6 +48,84 @@ const std::map<std::string, std::string> funcToFuncMap = {{
 #define PIAS_WO ""
 #include "image_argument_substitution_pass.inc"
 }};
+
+/// @brief libimg functions with variants specialized on the filter mode of a
+/// sampler known at compile time.
+///
+/// Only 2D `read_imagef` has such variants. `read_imagei`, `read_imageui` and
+/// reads from 1D, 3D and array images always take the generic path, and the
+/// variants' per-format readers sample one texel at a time.
+struct FilterModeVariants {
+  const char *generic;
+  const char *nearest;
+  const char *linear;
+};
+
+const FilterModeVariants filterModeVariants[] = {
+    {"_Z25__Codeplay_read_imagef_2dP5ImagejDv2_i",
+     "_Z33__Codeplay_read_imagef_2d_nearestP5ImagejDv2_i",
+     "_Z32__Codeplay_read_imagef_2d_linearP5ImagejDv2_i"},
+    {"_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f",
+     "_Z33__Codeplay_read_imagef_2d_nearestP5ImagejDv2_f",
+     "_Z32__Codeplay_read_imagef_2d_linearP5ImagejDv2_f"},
+};
+
+// Sampler bits, see libimg/shared.h.
+constexpr uint64_t SamplerFilterModeMask = 0x30;
+constexpr uint64_t SamplerFilterNearest = 0x10;
+constexpr uint64_t SamplerFilterLinear = 0x20;
+
+/// @brief Get the value of a sampler created from a sampler literal.
+///
+/// @param[in] sampler Sampler argument of an image builtin call.
+///
+/// @return Returns the sampler value if it is a compile-time constant,
+/// multi_llvm::None otherwise.
+multi_llvm::Optional<uint64_t> getConstantSampler(Value *sampler) {
+  // Sampler literals are materialized by calls to
+  // __translate_sampler_initializer, whose body this pass defines.
+  if (auto *call = dyn_cast<CallInst>(sampler)) {
+    auto *callee = call->getCalledFunction();
+    if (callee && callee->getName() == "__translate_sampler_initializer" &&
+        call->arg_size() == 1) {
+      if (auto *value = dyn_cast<ConstantInt>(call->getArgOperand(0))) {
+        return value->getZExtValue();
+      }
+    }
+  } else if (auto *expr = dyn_cast<ConstantExpr>(sampler)) {
+    if (expr->getOpcode() == Instruction::IntToPtr) {
+      if (auto *value = dyn_cast<ConstantInt>(expr->getOperand(0))) {
+        return value->getZExtValue();
+      }
+    }
+  }
+  return multi_llvm::None;
+}
+
+/// @brief Pick the libimg function to call for a known sampler value.
+///
+/// @param[in] name Name of the generic libimg function.
+/// @param[in] sampler Value of the sampler passed to it.
+///
+/// @return Returns the name of a variant specialized on the filter mode of
+/// sampler if there is one, name otherwise.
+const char *getSamplerSpecializedName(const std::string &name,
+                                      uint64_t sampler) {
+  for (const auto &variants : filterModeVariants) {
+    if (name != variants.generic) {
+      continue;
+    }
+    switch (sampler & SamplerFilterModeMask) {
+      case SamplerFilterNearest:
+        return variants.nearest;
+      case SamplerFilterLinear:
+        return variants.linear;
+      default:
+        break;
+    }
+  }
+  return name.c_str();
+}
 }  // namespace
 
 PreservedAnalyses compiler::ImageArgumentSubstitutionPass::run(
@@ -109,7 +188,22 @@ PreservedAnalyses compiler::ImageArgumentSubstitutionPass::run(
 
       assert(call && "User wasn't a call instruction!");
 
-      auto dstFunc = module.getFunction(pair.second);
+      // have we got a function that has a sampler in its argument list?
+      const bool hasSampler = std::string::npos != pair.first.find("sampler");
+
+      // if the sampler came from a sampler literal we can call a libimg
+      // function specialized for it, and pass it as a constant so that the
+      // remaining sampler decoding folds once libimg is inlined
+      multi_llvm::Optional<uint64_t> constantSampler;
+      const char *dstName = pair.second.c_str();
+      if (hasSampler) {
+        constantSampler = getConstantSampler(call->getArgOperand(1));
+        if (constantSampler) {
+          dstName = getSamplerSpecializedName(pair.second, *constantSampler);
+        }
+      }
+
+      auto dstFunc = module.getFunction(dstName);
 
       // if we haven't got a declaration for our replacement function, we need
       // to make one!
@@ -125,9 +219,7 @@ PreservedAnalyses compiler::ImageArgumentSubstitutionPass::run(
 
         // we need to change our approach for handling passing samplers into
         // libimg here too
-
-        // have we got a function that has a sampler in its argument list?
-        if (std::string::npos != pair.first.find("sampler")) {
+        if (hasSampler) {
           types.push_back(IntegerType::get(module.getContext(), 32));
 
           // the sampler will always be the second argument in the list
@@ -142,7 +234,7 @@ PreservedAnalyses compiler::ImageArgumentSubstitutionPass::run(
             FunctionType::get(srcFunc->getReturnType(), types, false);
 
         dstFunc = Function::Create(dstFuncType, srcFunc->getLinkage(),
-                                   pair.second, &module);
+                                   dstName, &module);
         dstFunc->setCallingConv(srcFunc->getCallingConv());
       }
 
@@ -168,11 +260,14 @@ PreservedAnalyses compiler::ImageArgumentSubstitutionPass::run(
       // we need to change our approach for handling samplers into libimg here
       // too
 
-      // have we got a function that has a sampler in its argument list?
-      if (std::string::npos != pair.first.find("sampler")) {
-        args.push_back(Builder.CreatePtrToInt(
-            call->getArgOperand(1),
-            dstFunc->getFunctionType()->getParamType(1)));
+      if (hasSampler) {
+        auto samplerType = dstFunc->getFunctionType()->getParamType(1);
+        if (constantSampler) {
+          args.push_back(ConstantInt::get(samplerType, *constantSampler));
+        } else {
+          args.push_back(
+              Builder.CreatePtrToInt(call->getArgOperand(1), samplerType));
+        }
 
         // the sampler will always be the second argument in the list
         i = 2;
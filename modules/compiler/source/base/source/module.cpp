@@ -886,7 +886,8 @@ Result BaseModule::compileSPIR(std::string &output_options) {
 cargo::expected<spirv::ModuleInfo, Result> BaseModule::compileSPIRV(
     cargo::array_view<const std::uint32_t> buffer,
     const spirv::DeviceInfo &spirv_device_info,
-    cargo::optional<const spirv::SpecializationInfo &> spirv_spec_info) {
+    cargo::optional<const spirv::SpecializationInfo &> spirv_spec_info,
+    cargo::array_view<const cargo::string_view> spirv_entry_points) {
   std::lock_guard<compiler::BaseContext> lock(context);
 
   spirv::ModuleInfo module_info;
@@ -921,10 +922,31 @@ cargo::expected<spirv::ModuleInfo, Result> BaseModule::compileSPIRV(
       spirv_ll_spec_info_optional = spirv_ll_spec_info;
     }
 
+    // When entry points are named, index the functions of the SPIR-V binary
+    // so only those reachable from the entry points are translated. The index
+    // is not kept between calls. Building it takes a single pass over the
+    // binary.
+    const llvm::ArrayRef<uint32_t> spvCode{buffer.data(), buffer.size()};
+    spirv_ll::ModuleIndex spvModuleIndex;
+    llvm::SmallVector<llvm::StringRef, 4> spirv_ll_entry_points;
+    if (!spirv_entry_points.empty()) {
+      auto index = spvContext.indexModule(spvCode);
+      if (!index) {
+        log.append(index.error().message + "\n");
+        num_errors = 1;
+        return cargo::make_unexpected(Result::COMPILE_PROGRAM_FAILURE);
+      }
+      spvModuleIndex = std::move(*index);
+      for (const auto &entry_point : spirv_entry_points) {
+        spirv_ll_entry_points.push_back(
+            {entry_point.data(), entry_point.size()});
+      }
+    }
+
     // Translate the SPIR-V binary into an llvm::Module.
-    auto spvModule =
-        spvContext.translate({buffer.data(), buffer.size()},
-                             spirv_ll_device_info, spirv_ll_spec_info_optional);
+    auto spvModule = spvContext.translate(
+        spvCode, spirv_ll_device_info, spirv_ll_spec_info_optional,
+        spvModuleIndex, spirv_ll_entry_points);
     if (!spvModule) {
       // Add error message to the build log.
       log.append(spvModule.error().message + "\n");
@@ -23,7 +23,9 @@
 #include <cargo/optional.h>
 #include <llvm/ADT/ArrayRef.h>
 #include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
 #include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
 #include <spirv-ll/assert.h>
 #include <spirv/unified1/spirv.hpp>
 
@@ -134,6 +136,48 @@ struct SpecializationInfo {
   const void *data;
 };
 
+/// @brief Index of the functions in a SPIR-V module and the calls between
+/// them.
+///
+/// An index is built by a single pass over a SPIR-V binary which does not
+/// translate it. It does not depend on the specialization or on the entry
+/// points translated. `compiler::BaseModule::compileSPIRV` builds a new index
+/// on every call, since the pass is cheap compared to translation.
+struct ModuleIndex {
+  /// @brief Description of a function in the module.
+  struct Function {
+    /// @brief Offset in words of the function's `OpFunction`.
+    uint32_t begin;
+    /// @brief Offset in words of the function's `OpFunctionEnd`.
+    uint32_t end;
+    /// @brief IDs of the functions called by this function.
+    llvm::SmallVector<spv::Id, 4> callees;
+  };
+
+  /// @brief Description of an `OpEntryPoint` in the module.
+  struct EntryPoint {
+    /// @brief Name of the entry point.
+    std::string name;
+    /// @brief ID of the entry point's function.
+    spv::Id function;
+  };
+
+  /// @brief Get the functions reachable from the named entry points.
+  ///
+  /// @param entryPoints Names of the entry points to start from.
+  ///
+  /// @return Returns the set of IDs of the entry points' functions and every
+  /// function they call, directly or indirectly, or an error if any name does
+  /// not match an entry point.
+  cargo::expected<llvm::DenseSet<spv::Id>, Error> getReachableFunctions(
+      llvm::ArrayRef<llvm::StringRef> entryPoints) const;
+
+  /// @brief Entry points declared by the module.
+  llvm::SmallVector<EntryPoint, 4> entryPoints;
+  /// @brief Map of function ID to its description.
+  llvm::DenseMap<spv::Id, Function> functions;
+};
+
 /// @brief Class holding the SPIR-V context information, such as the types
 ///
 /// This class is similar to the LLVM context class. It holds the types and
@@ -187,6 +231,35 @@ class Context {
       llvm::ArrayRef<uint32_t> code, const spirv_ll::DeviceInfo &deviceInfo,
       cargo::optional<const spirv_ll::SpecializationInfo &> specInfo);
 
+  /// @brief Index the functions of a SPIR-V binary stream.
+  ///
+  /// @param code Array view of the SPIR-V binary stream.
+  ///
+  /// @return Returns the module's index on success, otherwise a
+  /// `spirv_ll::Error`.
+  cargo::expected<spirv_ll::ModuleIndex, spirv_ll::Error> indexModule(
+      llvm::ArrayRef<uint32_t> code);
+
+  /// @brief Translate some entry points of a SPIR-V binary stream.
+  ///
+  /// Only the named entry points, and the functions they call, are translated
+  /// into the `spirv_ll::Module`. All other functions are skipped.
+  ///
+  /// @param code Array view of the SPIR-V binary stream.
+  /// @param deviceInfo Information about the target device.
+  /// @param specInfo Information about specialization constants.
+  /// @param index Index created by `indexModule` from the same `code`.
+  /// @param entryPoints Names of the entry points to translate, if empty all
+  /// functions are translated.
+  ///
+  /// @return Returns a `spirv_ll::Module` on success, otherwise a
+  /// `spirv_ll::Error`.
+  cargo::expected<spirv_ll::Module, spirv_ll::Error> translate(
+      llvm::ArrayRef<uint32_t> code, const spirv_ll::DeviceInfo &deviceInfo,
+      cargo::optional<const spirv_ll::SpecializationInfo &> specInfo,
+      const spirv_ll::ModuleIndex &index,
+      llvm::ArrayRef<llvm::StringRef> entryPoints);
+
   /// @brief LLVM context used for translation to LLVM IR.
   llvm::LLVMContext *llvmContext;
 
@@ -124,15 +124,124 @@ spirv_ll::Context::getSpecializableConstants(llvm::ArrayRef<uint32_t> code) {
   return specConstants;
 }
 
+cargo::expected<llvm::DenseSet<spv::Id>, spirv_ll::Error>
+spirv_ll::ModuleIndex::getReachableFunctions(
+    llvm::ArrayRef<llvm::StringRef> entryPointNames) const {
+  llvm::DenseSet<spv::Id> reachable;
+  llvm::SmallVector<spv::Id, 16> worklist;
+  for (auto name : entryPointNames) {
+    bool found = false;
+    for (const auto &entryPoint : entryPoints) {
+      if (entryPoint.name == name) {
+        found = true;
+        if (reachable.insert(entryPoint.function).second) {
+          worklist.push_back(entryPoint.function);
+        }
+      }
+    }
+    if (!found) {
+      return cargo::make_unexpected(
+          Error{"unknown entry point: " + name.str()});
+    }
+  }
+
+  while (!worklist.empty()) {
+    auto found = functions.find(worklist.pop_back_val());
+    if (found == functions.end()) {
+      continue;
+    }
+    for (auto callee : found->second.callees) {
+      if (reachable.insert(callee).second) {
+        worklist.push_back(callee);
+      }
+    }
+  }
+
+  return reachable;
+}
+
+cargo::expected<spirv_ll::ModuleIndex, spirv_ll::Error>
+spirv_ll::Context::indexModule(llvm::ArrayRef<uint32_t> code) {
+  spirv_ll::Module module{*this, code};
+  if (!module.isValid()) {
+    return cargo::make_unexpected(Error{"invalid SPIR-V module binary"});
+  }
+
+  ModuleIndex index;
+  // The function currently being indexed, or null at module scope.
+  ModuleIndex::Function *function = nullptr;
+  for (auto iter = module.begin(), end = module.end(); iter != end; ++iter) {
+    const OpCode op = *iter;
+    const auto offset = static_cast<uint32_t>(iter.word - code.data());
+    switch (op.code) {
+      default:
+        break;
+      case spv::OpEntryPoint: {
+        const OpEntryPoint opEntryPoint{op};
+        index.entryPoints.push_back(
+            {opEntryPoint.Name().str(), opEntryPoint.EntryPoint()});
+      } break;
+      case spv::OpFunction: {
+        if (function) {
+          return cargo::make_unexpected(
+              Error{"OpFunction found before OpFunctionEnd"});
+        }
+        const OpFunction opFunction{op};
+        function = &index.functions[opFunction.IdResult()];
+        function->begin = offset;
+      } break;
+      case spv::OpFunctionEnd:
+        if (!function) {
+          return cargo::make_unexpected(
+              Error{"OpFunctionEnd found outside of a function"});
+        }
+        function->end = offset;
+        function = nullptr;
+        break;
+      case spv::OpFunctionCall:
+        if (function) {
+          function->callees.push_back(OpFunctionCall{op}.Function());
+        }
+        break;
+    }
+  }
+  if (function) {
+    return cargo::make_unexpected(Error{"missing OpFunctionEnd"});
+  }
+
+  return index;
+}
+
 cargo::expected<spirv_ll::Module, spirv_ll::Error> spirv_ll::Context::translate(
     llvm::ArrayRef<uint32_t> code, const spirv_ll::DeviceInfo &deviceInfo,
     cargo::optional<const spirv_ll::SpecializationInfo &> specInfo) {
+  // Every function is translated when no entry points are named, so the index
+  // is never consulted.
+  return translate(code, deviceInfo, specInfo, ModuleIndex{}, {});
+}
+
+cargo::expected<spirv_ll::Module, spirv_ll::Error> spirv_ll::Context::translate(
+    llvm::ArrayRef<uint32_t> code, const spirv_ll::DeviceInfo &deviceInfo,
+    cargo::optional<const spirv_ll::SpecializationInfo &> specInfo,
+    const spirv_ll::ModuleIndex &index,
+    llvm::ArrayRef<llvm::StringRef> entryPoints) {
   SPIRV_LL_ASSERT(llvmContext, "llvmContext must not be null");
   spirv_ll::Module module(*this, code, specInfo);
   if (!module.isValid()) {
     return cargo::make_unexpected(Error{"invalid SPIR-V module binary"});
   }
 
+  // Functions not reachable from the requested entry points are skipped along
+  // with the entry points and execution modes which refer to them.
+  cargo::optional<llvm::DenseSet<spv::Id>> reachable;
+  if (!entryPoints.empty()) {
+    auto reachableFunctions = index.getReachableFunctions(entryPoints);
+    if (!reachableFunctions) {
+      return cargo::make_unexpected(std::move(reachableFunctions.error()));
+    }
+    reachable = std::move(*reachableFunctions);
+  }
+
   spirv_ll::Builder builder(*this, module, deviceInfo);
 
   using IRInsertPoint = llvm::IRBuilder<>::InsertPoint;
@@ -146,7 +255,41 @@ cargo::expected<spirv_ll::Module, spirv_ll::Error> spirv_ll::Context::translate(
   // have been generated
   llvm::SmallVector<OpIRLocTy, 8> Phis;
 
-  for (auto op : module) {
+  for (auto iter = module.begin(), end = module.end(); iter != end; ++iter) {
+    auto op = *iter;
+    if (reachable) {
+      spv::Id function = 0;
+      switch (op.code) {
+        default:
+          break;
+        case spv::OpEntryPoint:
+          function = OpEntryPoint{op}.EntryPoint();
+          break;
+        case spv::OpExecutionMode:
+          function = OpExecutionMode{op}.EntryPoint();
+          break;
+        case spv::OpFunction:
+          function = OpFunction{op}.IdResult();
+          break;
+      }
+      if (function && !reachable->count(function)) {
+        if (op.code == spv::OpFunction) {
+          auto indexed = index.functions.find(function);
+          if (indexed == index.functions.end() ||
+              indexed->second.begin !=
+                  static_cast<uint32_t>(iter.word - code.data())) {
+            return cargo::make_unexpected(
+                Error{"SPIR-V module does not match its index"});
+          }
+          // Jump to the function's OpFunctionEnd, the loop increment then
+          // steps past it.
+          iter = {iter.endianSwap,
+                  iter.word + (indexed->second.end - indexed->second.begin)};
+        }
+        continue;
+      }
+    }
+
     cargo::optional<Error> error;
     switch (op.code) {
         // Unsupported opcodes are ignored.
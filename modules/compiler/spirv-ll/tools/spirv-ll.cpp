@@ -106,6 +106,11 @@ int main(int argc, char **argv) {
   if (auto error = parser.add_argument({"--address-bits", addressBits})) {
     return error;
   }
+  // --entry-point NAME
+  cargo::small_vector<cargo::string_view, 4> entryPoints;
+  if (auto error = parser.add_argument({"--entry-point", entryPoints})) {
+    return error;
+  }
   // -s, --spec-constants
   bool specConstants = false;
   if (auto error = parser.add_argument({"-s", specConstants})) {
@@ -146,6 +151,10 @@ optional arguments:
                         chosen api
         -b {32,64}, --address-bits {32,64}
                         size of device address in bits
+        --entry-point NAME
+                        name of an entry point to translate along with the
+                        functions it calls, multiple supported. By default all
+                        functions are translated.
         -s, --spec-constants
                         output all specialization constants and exit
 )";
@@ -204,8 +213,19 @@ optional arguments:
   // passed here, since this is a debug/test tool we can just pass an empty map.
   spirv_ll::SpecializationInfo spvSpecializationInfo;
 
+  auto spvModuleIndex = spvContext.indexModule(spvCode);
+  if (!spvModuleIndex) {
+    std::cerr << spvModuleIndex.error().message << "\n";
+    return 1;
+  }
+  llvm::SmallVector<llvm::StringRef, 4> spvEntryPoints;
+  for (auto entryPoint : entryPoints) {
+    spvEntryPoints.push_back({entryPoint.data(), entryPoint.size()});
+  }
+
   auto spvModule =
-      spvContext.translate(spvCode, *spvDeviceInfo, spvSpecializationInfo);
+      spvContext.translate(spvCode, *spvDeviceInfo, spvSpecializationInfo,
+                           *spvModuleIndex, spvEntryPoints);
   if (!spvModule) {
     std::cerr << spvModule.error().message << "\n";
     return 1;
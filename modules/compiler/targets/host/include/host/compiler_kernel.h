@@ -22,11 +22,17 @@
 #define HOST_COMPILER_KERNEL_H_INCLUDED
 
 #include <base/kernel.h>
+#include <cargo/flat_hash_map.h>
 #include <compiler/module.h>
 #include <host/utils/jit_kernel.h>
 
+#include <array>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "base/module.h"
 
@@ -73,6 +79,14 @@ class HostKernel : public compiler::BaseKernel {
   createSpecializedKernel(
       const mux_ndrange_options_t &specialization_options) override;
 
+  /// @see Kernel::createSpecializedKernelForEnqueue
+  ///
+  /// Unlike `createSpecializedKernel` this may return a variant with the
+  /// values of the enqueue's scalar arguments folded in.
+  cargo::expected<cargo::dynamic_array<uint8_t>, compiler::Result>
+  createSpecializedKernelForEnqueue(
+      const mux_ndrange_options_t &specialization_options) override;
+
   /// @brief No-op implementation indicating sub-groups are not supported.
   cargo::expected<uint32_t, compiler::Result> querySubGroupSizeForLocalSize(
       size_t local_size_x, size_t local_size_y, size_t local_size_z) override;
@@ -85,21 +99,102 @@ class HostKernel : public compiler::BaseKernel {
   cargo::expected<size_t, compiler::Result> queryMaxSubGroupCount() override;
 
  private:
+  /// @brief Implements `createSpecializedKernel` and
+  /// `createSpecializedKernelForEnqueue`.
+  ///
+  /// @param specialization_options Mux execution options to specialize for.
+  /// @param fold_arguments Whether the binary may have the values of the scalar
+  /// arguments in @p specialization_options folded in.
+  cargo::expected<cargo::dynamic_array<uint8_t>, compiler::Result>
+  specializeKernel(const mux_ndrange_options_t &specialization_options,
+                   bool fold_arguments);
+
   /// @brief Gets an `OptimizedKernel` object for the given local size.
   ///
   /// @param local_size Local size to optimize the kernel for.
+  ///
+  /// @return The optimized kernel, which lives as long as this kernel.
   cargo::expected<const OptimizedKernel &, compiler::Result>
   lookupOrCreateOptimizedKernel(std::array<size_t, 3> local_size);
 
+  /// @brief Gets an `OptimizedKernel` object for the given local size with the
+  /// values of the enqueue's scalar arguments folded in.
+  ///
+  /// Argument specialization is opt-in through the
+  /// `CA_HOST_SPECIALIZE_KERNEL_ARGS` environment variable, which gives the
+  /// number of consecutive enqueues with identical scalar arguments after
+  /// which a specialized variant is compiled. Enqueues with any other values
+  /// fall back to the variant for the local size alone.
+  ///
+  /// @param local_size Local size to optimize the kernel for.
+  /// @param specialization_options Enqueue options holding the arguments.
+  ///
+  /// @return The specialized kernel, or `nullptr` if there isn't one for
+  /// these argument values.
+  cargo::expected<const OptimizedKernel *, compiler::Result>
+  lookupOrCreateArgSpecializedKernel(
+      std::array<size_t, 3> local_size,
+      const mux_ndrange_options_t &specialization_options);
+
+  /// @brief Compiles an `OptimizedKernel` object for the given local size.
+  ///
+  /// @param local_size Local size to optimize the kernel for.
+  /// @param descriptors Argument descriptors whose plain old data values are
+  /// folded into the kernel, or empty to keep all arguments.
+  cargo::expected<OptimizedKernel, compiler::Result> createOptimizedKernel(
+      std::array<size_t, 3> local_size,
+      cargo::array_view<const mux_descriptor_info_t> descriptors);
+
+  /// @brief The scalar argument values a kernel was last enqueued with, and
+  /// the number of enqueues in a row they have been seen for.
+  struct ArgumentHistory {
+    std::vector<uint8_t> values;
+    uint32_t count = 0;
+  };
+
   /// @brief LLVM module containing only the kernel function and functions it
   /// calls, not yet optimized for a local size.
   llvm::Module *module;
 
+  /// @brief Number of consecutive enqueues with identical scalar arguments
+  /// after which a variant is specialized on them, zero if disabled. Read from
+  /// `CA_HOST_SPECIALIZE_KERNEL_ARGS` when the kernel is created.
+  uint32_t arg_specialization_threshold;
+
+  /// @brief Hash function object for local sizes.
+  struct LocalSizeHash {
+    size_t operator()(const std::array<size_t, 3> &local_size) const {
+      size_t hash = local_size[0];
+      hash = hash * 31 + local_size[1];
+      return hash * 31 + local_size[2];
+    }
+  };
+
   /// @brief Map of optimized modules to their local sizes.
   ///
   /// By an "optimized module" we mean a copy of this kernel's LLVM module which
-  /// has had passes that optimize for a specific local size run on it.
-  std::map<std::array<size_t, 3>, OptimizedKernel> optimized_kernel_map;
+  /// has had passes that optimize for a specific local size run on it. This is
+  /// looked up on every enqueue. Adding a local size moves the map's entries,
+  /// so the kernels are held by pointer to keep references to them valid.
+  cargo::flat_hash_map<std::array<size_t, 3>, std::unique_ptr<OptimizedKernel>,
+                       LocalSizeHash>
+      optimized_kernel_map;
+
+  /// @brief Mutex protecting `optimized_kernel_map`, since a kernel may be
+  /// enqueued from several threads at once.
+  std::mutex optimized_kernel_mutex;
+
+  /// @brief Map of argument-specialized kernels to their local sizes and the
+  /// values of their scalar arguments.
+  std::map<std::pair<std::array<size_t, 3>, std::vector<uint8_t>>,
+           OptimizedKernel>
+      arg_specialized_kernel_map;
+
+  /// @brief Map of local sizes to the scalar arguments recently enqueued with.
+  std::map<std::array<size_t, 3>, ArgumentHistory> arg_history_map;
+
+  /// @brief Mutex protecting argument specialization state.
+  std::mutex arg_specialization_mutex;
 
   /// @brief A set of JITDylibs created to manage JIT resources for kernels.
   std::unordered_set<std::string> kernel_jit_dylibs;
@@ -22,7 +22,13 @@
 namespace host {
 
 namespace MiniWGInfoStruct {
-enum Type { group_id = 0, num_groups, total };
+enum Type {
+  group_id = 0,
+  num_groups,
+  local_range_start,
+  local_range_end,
+  total
+};
 }
 
 namespace ScheduleInfoStruct {
@@ -36,6 +36,10 @@
 
 #include <mutex>
 
+namespace llvm {
+class TargetMachine;
+}  // namespace llvm
+
 namespace host {
 
 class HostKernel;
@@ -53,6 +57,11 @@ struct KernelMetadata {
 void initializePassMachineryForFinalize(
     compiler::utils::PassMachinery &passMach, const HostTarget &target);
 
+/// @brief Initialize pass machinery for finalization with a specific target
+/// machine, rather than the default one of the target.
+void initializePassMachineryForFinalize(
+    compiler::utils::PassMachinery &passMach, llvm::TargetMachine *TM);
+
 /// @brief A class that drives the compilation process and stores the compiled
 /// binary.
 class HostModule : public compiler::BaseModule {
@@ -88,9 +97,13 @@ class HostModule : public compiler::BaseModule {
 
   const HostTarget &getHostTarget() const;
 
+  /// @brief Create pass machinery using a specific target machine.
+  std::unique_ptr<compiler::utils::PassMachinery> createPassMachinery(
+      llvm::TargetMachine *TM);
+
   /// @brief Compiles the input LLVM module into an ELF binary.
   ///
-  /// @param target Target to compile the module for.
+  /// @param target_machine Target machine to generate code with.
   /// @param build_options Build options that will affect optimizations
   /// performed.
   /// @param module Module to compile, needs to have been finalized (i.e.
@@ -98,7 +111,8 @@ class HostModule : public compiler::BaseModule {
   ///
   /// @return Cargo dynamic array containing the ELF binary.
   cargo::expected<cargo::dynamic_array<uint8_t>, compiler::Result>
-  hostCompileObject(HostTarget &target, const compiler::Options &build_options,
+  hostCompileObject(llvm::TargetMachine *target_machine,
+                    const compiler::Options &build_options,
                     llvm::Module *module);
 };  // class Module
 }  // namespace host
@@ -28,6 +28,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace llvm {
 class Module;
@@ -71,6 +72,24 @@ class HostTarget : public compiler::BaseTarget {
   /// @brief The llvm TargetMachine.
   std::unique_ptr<llvm::TargetMachine> target_machine;
 
+  /// @brief A target machine generating code for a particular ISA level.
+  struct isa_variant {
+    /// @brief ISA level, see `host::utils::isa_level`.
+    uint32_t isa_level;
+    /// @brief Target machine using the features of the ISA level.
+    std::unique_ptr<llvm::TargetMachine> target_machine;
+  };
+
+  /// @brief Target machines for the ISA levels above the baseline of the
+  /// architecture, in ascending order.
+  ///
+  /// When no CPU is specified `target_machine` only uses the baseline ISA. If
+  /// the `CA_HOST_MULTIVERSION_BINARIES` environment variable is also set,
+  /// binaries are additionally compiled for each of these levels and packed
+  /// into a fat binary from which the loader picks the best variant the
+  /// running CPU supports. Empty otherwise.
+  std::vector<isa_variant> isa_variants;
+
   /// @brief An atomic uint64_t to ensure unique identifiers are used.
   ///
   /// This field is used to ensure that each kernel that is JIT'ed by the
@@ -30,6 +30,7 @@
 #include <multi_llvm/multi_llvm.h>
 #include <multi_llvm/opaque_pointers.h>
 
+#include <array>
 #include <functional>
 
 using namespace llvm;
@@ -137,6 +138,139 @@ PreservedAnalyses AddEntryHookPass::run(Module &M, ModuleAnalysisManager &AM) {
         ir.CreateLoad(ScheduleInfoStructTy->getTypeAtIndex(totalSlicesIdx),
                       gepTotalSlices, "totalSlices");
 
+    if (compiler::utils::isBarrierFree(*function)) {
+      // Barrier-free kernels may execute any sub-range of a work-group, so
+      // rather than handing out whole work-groups we can split each work-group
+      // into several parts when there are fewer work-groups than slices. This
+      // keeps all threads busy for small NDRanges with large work-groups:
+      // g = total number of work-groups
+      // t = total number of slices
+      // p = parts per work-group = g >= t ? 1 : (t + g - 1) / g
+      // u = total units of work = g * p
+      // each slice then runs a contiguous range of (u + t - 1) / t units,
+      // where unit i runs part (i % p) of work-group (i / p). Work-groups are
+      // split along the dimension with the largest local size.
+      auto *const sizeTy = zero->getType();
+      auto *const one = ConstantInt::get(sizeTy, 1);
+
+      auto *const totalGroups = ir.CreateMul(
+          ir.CreateMul(numGroups[0], numGroups[1]), numGroups[2],
+          "totalGroups");
+      auto *const partsPerGroup = ir.CreateSelect(
+          ir.CreateICmpUGE(totalGroups, totalSlices), one,
+          ir.CreateUDiv(
+              ir.CreateAdd(totalSlices, ir.CreateSub(totalGroups, one)),
+              totalGroups),
+          "partsPerGroup");
+      auto *const totalUnits =
+          ir.CreateMul(totalGroups, partsPerGroup, "totalUnits");
+      auto *const unitsPerSlice = ir.CreateUDiv(
+          ir.CreateAdd(totalUnits, ir.CreateSub(totalSlices, one)),
+          totalSlices, "unitsPerSlice");
+      auto *const unitStart = ir.CreateMul(unitsPerSlice, slice, "unitStart");
+      auto *const unitEnd = ir.CreateBinaryIntrinsic(
+          Intrinsic::umin, ir.CreateAdd(unitStart, unitsPerSlice), totalUnits,
+          nullptr, "unitEnd");
+
+      // load the local sizes, and find the dimension we'll split along
+      auto *const localSizeIdx =
+          ir.getInt32(host::ScheduleInfoStruct::local_size);
+      auto *const localSizeTy =
+          ScheduleInfoStructTy->getTypeAtIndex(localSizeIdx);
+      auto *const gepLocalSize = ir.CreateGEP(
+          ScheduleInfoStructTy, ScheduleInfoParam, {i32_0, localSizeIdx});
+      std::array<Value *, 3> localSizes;
+      for (uint32_t i = 0; i < 3; i++) {
+        localSizes[i] = ir.CreateLoad(
+            sizeTy,
+            ir.CreateGEP(localSizeTy, gepLocalSize, {i32_0, getInt32(i)}),
+            "local_size");
+      }
+      Value *splitDim = getInt32(0);
+      Value *splitSize = localSizes[0];
+      for (uint32_t i = 1; i < 3; i++) {
+        auto *const isLarger = ir.CreateICmpUGT(localSizes[i], splitSize);
+        splitDim = ir.CreateSelect(isLarger, getInt32(i), splitDim, "splitDim");
+        splitSize =
+            ir.CreateSelect(isLarger, localSizes[i], splitSize, "splitSize");
+      }
+      auto *const partSize = ir.CreateUDiv(
+          ir.CreateAdd(splitSize, ir.CreateSub(partsPerGroup, one)),
+          partsPerGroup, "partSize");
+
+      IRBuilder<> earlyExitIR(
+          BasicBlock::Create(context, "early-exit", newFunction));
+      earlyExitIR.CreateRetVoid();
+
+      IRBuilder<> loopIR(BasicBlock::Create(context, "loop", newFunction));
+
+      ir.CreateCondBr(ir.CreateICmpULT(unitStart, unitEnd),
+                      loopIR.GetInsertBlock(), earlyExitIR.GetInsertBlock());
+
+      auto *const groupIdIdx = ir.getInt32(host::MiniWGInfoStruct::group_id);
+      auto *const rangeStartIdx =
+          ir.getInt32(host::MiniWGInfoStruct::local_range_start);
+      auto *const rangeEndIdx =
+          ir.getInt32(host::MiniWGInfoStruct::local_range_end);
+      auto *const arrayTy = MiniWGInfoStructTy->getTypeAtIndex(groupIdIdx);
+
+      compiler::utils::CreateLoopOpts opts;
+
+      auto exitBlock = compiler::utils::createLoop(
+          loopIR.GetInsertBlock(), nullptr, unitStart, unitEnd, {}, opts,
+          [&](BasicBlock *block, Value *unit, ArrayRef<Value *>,
+              MutableArrayRef<Value *>) -> BasicBlock * {
+            IRBuilder<> ir(block);
+            auto *const group = ir.CreateUDiv(unit, partsPerGroup, "group");
+            auto *const part = ir.CreateURem(unit, partsPerGroup, "part");
+
+            // decompose the linear group into its group IDs
+            auto *const groupYZ = ir.CreateUDiv(group, numGroups[0]);
+            std::array<Value *, 3> groupIds = {
+                ir.CreateURem(group, numGroups[0], "group_id_x"),
+                ir.CreateURem(groupYZ, numGroups[1], "group_id_y"),
+                ir.CreateUDiv(groupYZ, numGroups[1], "group_id_z"),
+            };
+
+            // the range of local IDs in the split dimension for this part
+            auto *const partStart = ir.CreateBinaryIntrinsic(
+                Intrinsic::umin, ir.CreateMul(part, partSize), splitSize);
+            auto *const partEnd = ir.CreateBinaryIntrinsic(
+                Intrinsic::umin, ir.CreateAdd(partStart, partSize), splitSize);
+
+            auto *const dstGroupId = ir.CreateGEP(
+                MiniWGInfoStructTy, MiniWGInfoParam, {i32_0, groupIdIdx});
+            auto *const dstRangeStart = ir.CreateGEP(
+                MiniWGInfoStructTy, MiniWGInfoParam, {i32_0, rangeStartIdx});
+            auto *const dstRangeEnd = ir.CreateGEP(
+                MiniWGInfoStructTy, MiniWGInfoParam, {i32_0, rangeEndIdx});
+            for (uint32_t i = 0; i < 3; i++) {
+              auto *const isSplitDim = ir.CreateICmpEQ(splitDim, getInt32(i));
+              ir.CreateStore(groupIds[i], ir.CreateGEP(arrayTy, dstGroupId,
+                                                       {i32_0, getInt32(i)}));
+              ir.CreateStore(
+                  ir.CreateSelect(isSplitDim, partStart, zero),
+                  ir.CreateGEP(arrayTy, dstRangeStart, {i32_0, getInt32(i)}));
+              ir.CreateStore(
+                  ir.CreateSelect(isSplitDim, partEnd, localSizes[i]),
+                  ir.CreateGEP(arrayTy, dstRangeEnd, {i32_0, getInt32(i)}));
+            }
+
+            auto ci = ir.CreateCall(function, args);
+            ci->setCallingConv(function->getCallingConv());
+            ci->setAttributes(
+                compiler::utils::getCopiedFunctionAttrs(*function));
+
+            return block;
+          });
+
+      IRBuilder<> exitIR(exitBlock);
+      exitIR.CreateRetVoid();
+
+      Changed = true;
+      continue;
+    }
+
     // round up the number of groups by the total number of slices
     auto *numGroupsRoundedUp =
         ir.CreateAdd(numGroups[vec_dim], totalSlices, "numGroupsRoundedUp");
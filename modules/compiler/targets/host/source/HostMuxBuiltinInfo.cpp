@@ -40,10 +40,13 @@ StructType *HostBIMuxInfo::getMiniWGInfoStruct(Module &M) {
   auto *const size_type = compiler::utils::getSizeType(M);
   auto *const array_type = ArrayType::get(size_type, 3);
 
-  SmallVector<Type *, ScheduleInfoStruct::total> elements(2);
+  SmallVector<Type *, MiniWGInfoStruct::total> elements(
+      MiniWGInfoStruct::total);
 
   elements[MiniWGInfoStruct::group_id] = array_type;
   elements[MiniWGInfoStruct::num_groups] = array_type;
+  elements[MiniWGInfoStruct::local_range_start] = array_type;
+  elements[MiniWGInfoStruct::local_range_end] = array_type;
 
   return StructType::create(elements, HostStructName);
 }
@@ -169,6 +172,16 @@ Function *HostBIMuxInfo::defineMuxBuiltin(compiler::utils::BuiltinID ID,
       DefaultVal = 1;
       WGFieldIdx = MiniWGInfoStruct::num_groups;
       break;
+    case compiler::utils::eMuxBuiltinGetLocalRangeStart:
+      ParamIdx = SchedParamIndices::MINIWG;
+      DefaultVal = 0;
+      WGFieldIdx = MiniWGInfoStruct::local_range_start;
+      break;
+    case compiler::utils::eMuxBuiltinGetLocalRangeEnd:
+      ParamIdx = SchedParamIndices::MINIWG;
+      DefaultVal = 1;
+      WGFieldIdx = MiniWGInfoStruct::local_range_end;
+      break;
     case compiler::utils::eMuxBuiltinGetGlobalOffset:
       ParamIdx = SchedParamIndices::SCHED;
       DefaultVal = 0;
@@ -210,8 +223,9 @@ Value *HostBIMuxInfo::initializeSchedulingParamForWrappedKernel(
   }
 
   // Stack-allocate the mini work-group info, initializing only the
-  // 'num_groups' via data from the scheduling struct. The 'group_id' field is
-  // initialized by the work-group loops before it's ever used.
+  // 'num_groups' via data from the scheduling struct. The 'group_id' and local
+  // range fields are initialized by the work-group loops before they're ever
+  // used.
   if (Info.ID == SchedParamIndices::MINIWG &&
       Info.ParamName == "mini-wg-info") {
     auto IntoSchedParams = getFunctionSchedulingParameters(IntoF);
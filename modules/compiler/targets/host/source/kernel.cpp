@@ -40,9 +40,103 @@
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <multi_llvm/llvm_version.h>
 
+#include <cstdlib>
+#include <cstring>
+
 #include "cargo/expected.h"
 #include "tracer/tracer.h"
 
+#define DEBUG_TYPE "host-kernel"
+
+STATISTIC(NumArgSpecializedKernels,
+          "Number of kernel variants specialized on scalar argument values");
+STATISTIC(NumArgsFolded, "Number of scalar kernel arguments folded");
+STATISTIC(NumArgSpecializationHits,
+          "Number of enqueues using an argument-specialized kernel");
+STATISTIC(NumArgSpecializationMisses,
+          "Number of enqueues falling back to an unspecialized kernel");
+
+namespace {
+/// @brief Maximum number of argument-specialized variants of any one kernel.
+constexpr size_t max_arg_specialized_kernels = 8;
+
+/// @brief Returns the number of consecutive enqueues with identical scalar
+/// arguments after which a kernel gets specialized on them, or zero if
+/// argument specialization is disabled.
+uint32_t getArgSpecializationThreshold() {
+  if (const char *E = std::getenv("CA_HOST_SPECIALIZE_KERNEL_ARGS")) {
+    return static_cast<uint32_t>(std::strtoul(E, nullptr, 10));
+  }
+  return 0;
+}
+
+/// @brief Replaces all uses of a kernel's integer and floating point
+/// arguments with the plain old data values of the matching descriptors.
+///
+/// @param F Kernel function to fold the arguments of.
+/// @param descriptors Argument descriptors of the enqueue to specialize for.
+///
+/// @return The number of arguments that were folded.
+unsigned foldScalarArguments(
+    llvm::Function &F,
+    cargo::array_view<const mux_descriptor_info_t> descriptors) {
+  unsigned folded = 0;
+  auto const num_args = std::min<size_t>(F.arg_size(), descriptors.size());
+  for (size_t i = 0; i < num_args; i++) {
+    auto const &descriptor = descriptors[i];
+    if (descriptor.type != mux_descriptor_info_type_plain_old_data) {
+      continue;
+    }
+
+    auto *const arg = F.getArg(i);
+    auto *const type = arg->getType();
+    auto const &pod = descriptor.plain_old_data_descriptor;
+    if ((!type->isIntegerTy() && !type->isFloatingPointTy()) ||
+        pod.length * 8 != type->getScalarSizeInBits()) {
+      continue;
+    }
+
+    // The host is the device, so the data can be read back with its own
+    // endianness.
+    uint64_t value;
+    switch (pod.length) {
+      case 1: {
+        uint8_t v;
+        std::memcpy(&v, pod.data, sizeof(v));
+        value = v;
+      } break;
+      case 2: {
+        uint16_t v;
+        std::memcpy(&v, pod.data, sizeof(v));
+        value = v;
+      } break;
+      case 4: {
+        uint32_t v;
+        std::memcpy(&v, pod.data, sizeof(v));
+        value = v;
+      } break;
+      case 8:
+        std::memcpy(&value, pod.data, sizeof(value));
+        break;
+      default:
+        continue;
+    }
+
+    llvm::APInt bits(type->getScalarSizeInBits(), value);
+    llvm::Constant *constant = nullptr;
+    if (type->isIntegerTy()) {
+      constant = llvm::ConstantInt::get(F.getContext(), bits);
+    } else {
+      constant = llvm::ConstantFP::get(
+          F.getContext(), llvm::APFloat(type->getFltSemantics(), bits));
+    }
+    arg->replaceAllUsesWith(constant);
+    folded++;
+  }
+  return folded;
+}
+}  // namespace
+
 namespace host {
 
 HostKernel::HostKernel(
@@ -53,6 +147,7 @@ HostKernel::HostKernel(
     : BaseKernel(name, preferred_local_sizes[0], preferred_local_sizes[1],
                  preferred_local_sizes[2], local_memory_used),
       module(module),
+      arg_specialization_threshold(getArgSpecializationThreshold()),
       target(target),
       build_options(build_options),
       snapshots(snapshots) {}
@@ -97,6 +192,18 @@ cargo::expected<uint32_t, compiler::Result> HostKernel::getDynamicWorkWidth(
 cargo::expected<cargo::dynamic_array<uint8_t>, compiler::Result>
 HostKernel::createSpecializedKernel(
     const mux_ndrange_options_t &specialization_options) {
+  return specializeKernel(specialization_options, /* fold_arguments */ false);
+}
+
+cargo::expected<cargo::dynamic_array<uint8_t>, compiler::Result>
+HostKernel::createSpecializedKernelForEnqueue(
+    const mux_ndrange_options_t &specialization_options) {
+  return specializeKernel(specialization_options, /* fold_arguments */ true);
+}
+
+cargo::expected<cargo::dynamic_array<uint8_t>, compiler::Result>
+HostKernel::specializeKernel(
+    const mux_ndrange_options_t &specialization_options, bool fold_arguments) {
   if (!specialization_options.descriptors &&
       specialization_options.descriptors_length > 0) {
     return cargo::make_unexpected(compiler::Result::INVALID_VALUE);
@@ -139,9 +246,24 @@ HostKernel::createSpecializedKernel(
   std::copy(std::begin(specialization_options.local_size),
             std::end(specialization_options.local_size),
             std::begin(local_size));
-  auto optimized_kernel = lookupOrCreateOptimizedKernel(local_size);
+
+  // Prefer a variant with this enqueue's scalar arguments folded in, if there
+  // is one, otherwise fall back to the variant for the local size alone.
+  const OptimizedKernel *optimized_kernel = nullptr;
+  if (fold_arguments) {
+    auto arg_specialized_kernel =
+        lookupOrCreateArgSpecializedKernel(local_size, specialization_options);
+    if (!arg_specialized_kernel) {
+      return cargo::make_unexpected(arg_specialized_kernel.error());
+    }
+    optimized_kernel = *arg_specialized_kernel;
+  }
   if (!optimized_kernel) {
-    return cargo::make_unexpected(optimized_kernel.error());
+    auto local_size_kernel = lookupOrCreateOptimizedKernel(local_size);
+    if (!local_size_kernel) {
+      return cargo::make_unexpected(local_size_kernel.error());
+    }
+    optimized_kernel = &*local_size_kernel;
   }
 
   cargo::dynamic_array<uint8_t> binary_out;
@@ -228,182 +350,261 @@ cargo::expected<size_t, compiler::Result> HostKernel::queryMaxSubGroupCount() {
 
 cargo::expected<const OptimizedKernel &, compiler::Result>
 HostKernel::lookupOrCreateOptimizedKernel(std::array<size_t, 3> local_size) {
-  if (0 < optimized_kernel_map.count(local_size)) {
-    return optimized_kernel_map[local_size];
+  std::lock_guard<std::mutex> lock(optimized_kernel_mutex);
+  auto found = optimized_kernel_map.find(local_size);
+  if (found != optimized_kernel_map.end()) {
+    return *found->second;
   }
 
-  {
-    std::lock_guard<compiler::Context> guard(target.getContext());
+  auto optimized_kernel = createOptimizedKernel(local_size, {});
+  if (!optimized_kernel) {
+    return cargo::make_unexpected(optimized_kernel.error());
+  }
+  auto inserted = optimized_kernel_map.try_emplace(
+      local_size,
+      std::make_unique<OptimizedKernel>(std::move(*optimized_kernel)));
+  if (!inserted) {
+    return cargo::make_unexpected(compiler::Result::OUT_OF_MEMORY);
+  }
+  return *inserted->first->second;
+}
 
-    std::unique_ptr<llvm::Module> optimized_module(llvm::CloneModule(*module));
-    if (nullptr == optimized_module) {
-      return cargo::make_unexpected(compiler::Result::OUT_OF_MEMORY);
-    }
+cargo::expected<const OptimizedKernel *, compiler::Result>
+HostKernel::lookupOrCreateArgSpecializedKernel(
+    std::array<size_t, 3> local_size,
+    const mux_ndrange_options_t &specialization_options) {
+  auto const threshold = arg_specialization_threshold;
+  if (threshold == 0) {
+    return nullptr;
+  }
 
-    // max length of a uint64_t is 20 digits, 64 just to be comfortable with the
-    // prefix of '__mux_host_'
-    const unsigned unique_name_data_length = 64;
-    char unique_name_data[unique_name_data_length];
-    if (snprintf(unique_name_data, unique_name_data_length,
-                 "__mux_host_%" PRIu64, target.unique_identifier++) < 0) {
-      return cargo::make_unexpected(compiler::Result::FAILURE);
+  cargo::array_view<const mux_descriptor_info_t> descriptors(
+      specialization_options.descriptors,
+      specialization_options.descriptors_length);
+
+  // The values of all scalar arguments identify the variant.
+  std::vector<uint8_t> values;
+  for (const auto &descriptor : descriptors) {
+    if (descriptor.type == mux_descriptor_info_type_plain_old_data) {
+      auto const &pod = descriptor.plain_old_data_descriptor;
+      auto const *data = static_cast<const uint8_t *>(pod.data);
+      values.insert(values.end(), data, data + pod.length);
     }
-    llvm::StringRef unique_name(unique_name_data);
-
-    auto device_info = target.getCompilerInfo()->device_info;
-
-    // FIXME: Ideally we'd be able to call/reuse HostModule::createPassMachinery
-    // but we only have access to the HostTarget
-    auto *const TM = target.target_machine.get();
-    auto builtinInfoCallback = [&](const llvm::Module &) {
-      return compiler::utils::BuiltinInfo(
-          std::make_unique<HostBIMuxInfo>(),
-          compiler::utils::createCLBuiltinInfo(target.getBuiltins()));
-    };
-    auto deviceInfo = compiler::initDeviceInfoFromMux(device_info);
-    HostPassMachinery pass_mach(module->getContext(), TM, deviceInfo,
-                                builtinInfoCallback,
-                                target.getContext().isLLVMVerifyEachEnabled(),
-                                target.getContext().getLLVMDebugLoggingLevel(),
-                                target.getContext().isLLVMTimePassesEnabled());
-    host::initializePassMachineryForFinalize(pass_mach, target);
-
-    llvm::ModulePassManager pm;
-    // Set up the kernel metadata which informs later passes which kernel we're
-    // interested in optimizing. We've already done this when initially
-    // creating the kernel, but now we have more accurate local size data.
-    compiler::utils::EncodeKernelMetadataPassOptions pass_opts;
-    pass_opts.KernelName = name;
-    pass_opts.LocalSizes = {static_cast<uint64_t>(local_size[0]),
-                            static_cast<uint64_t>(local_size[1]),
-                            static_cast<uint64_t>(local_size[2])};
-    pm.addPass(compiler::utils::EncodeKernelMetadataPass(pass_opts));
-
-    pm.addPass(hostGetKernelPasses(build_options, pass_mach.getPB(), snapshots,
-                                   unique_name));
-
-    {
-      // Using the CrashRecoveryContext and statistics touches LLVM's global
-      // state.
-      std::lock_guard<std::mutex> globalLock(
-          compiler::utils::getLLVMGlobalMutex());
-      llvm::CrashRecoveryContext CRC;
-      llvm::CrashRecoveryContext::Enable();
-      bool crashed = !CRC.RunSafely(
-          [&] { pm.run(*optimized_module, pass_mach.getMAM()); });
-      llvm::CrashRecoveryContext::Disable();
-      if (crashed) {
-        return cargo::make_unexpected(
-            compiler::Result::FINALIZE_PROGRAM_FAILURE);
-      }
+  }
+  if (values.empty()) {
+    return nullptr;
+  }
 
-      if (llvm::AreStatisticsEnabled()) {
-        llvm::PrintStatistics();
-      }
-    }
+  std::lock_guard<std::mutex> lock(arg_specialization_mutex);
+  auto key = std::make_pair(local_size, std::move(values));
+  auto found = arg_specialized_kernel_map.find(key);
+  if (found != arg_specialized_kernel_map.end()) {
+    ++NumArgSpecializationHits;
+    return &found->second;
+  }
 
-    // Retrieve the vectorization width and amount of local memory used.
-    auto default_work_width = FixedOrScalableQuantity<uint32_t>::getOne();
-    handler::VectorizeInfoMetadata fn_metadata(
-        unique_name.str(), unique_name.str(),
-        /* local_memory_usage */ 0,
-        /* sub_group_size */ FixedOrScalableQuantity<uint32_t>(),
-        /* min_work_item_factor= */ default_work_width,
-        /* pref_work_item_factor */ default_work_width);
-    if (auto *f = optimized_module->getFunction(unique_name)) {
-      fn_metadata =
-          pass_mach.getFAM()
-              .getResult<compiler::utils::VectorizeMetadataAnalysis>(*f);
+  // Only specialize once the same values have been seen for enough enqueues
+  // in a row, since every variant costs a JIT compilation.
+  auto &history = arg_history_map[local_size];
+  if (history.values == key.second) {
+    history.count++;
+  } else {
+    history.values = key.second;
+    history.count = 1;
+  }
+  if (history.count < threshold ||
+      arg_specialized_kernel_map.size() >= max_arg_specialized_kernels) {
+    ++NumArgSpecializationMisses;
+    return nullptr;
+  }
+
+  auto specialized_kernel = createOptimizedKernel(local_size, descriptors);
+  if (!specialized_kernel) {
+    return cargo::make_unexpected(specialized_kernel.error());
+  }
+  ++NumArgSpecializedKernels;
+  ++NumArgSpecializationHits;
+  auto inserted = arg_specialized_kernel_map.emplace(
+      std::move(key), std::move(*specialized_kernel));
+  return &inserted.first->second;
+}
+
+cargo::expected<OptimizedKernel, compiler::Result>
+HostKernel::createOptimizedKernel(
+    std::array<size_t, 3> local_size,
+    cargo::array_view<const mux_descriptor_info_t> descriptors) {
+  std::lock_guard<compiler::Context> guard(target.getContext());
+
+  std::unique_ptr<llvm::Module> optimized_module(llvm::CloneModule(*module));
+  if (nullptr == optimized_module) {
+    return cargo::make_unexpected(compiler::Result::OUT_OF_MEMORY);
+  }
+
+  // Fold in the values of any scalar arguments we're specializing on.
+  if (!descriptors.empty()) {
+    if (auto *const kernel_fn = optimized_module->getFunction(name)) {
+      NumArgsFolded += foldScalarArguments(*kernel_fn, descriptors);
     }
+  }
 
-    // Host doesn't support scalable values.
-    if (fn_metadata.min_work_item_factor.isScalable() ||
-        fn_metadata.pref_work_item_factor.isScalable() ||
-        fn_metadata.sub_group_size.isScalable()) {
+  // max length of a uint64_t is 20 digits, 64 just to be comfortable with the
+  // prefix of '__mux_host_'
+  const unsigned unique_name_data_length = 64;
+  char unique_name_data[unique_name_data_length];
+  if (snprintf(unique_name_data, unique_name_data_length,
+               "__mux_host_%" PRIu64, target.unique_identifier++) < 0) {
+    return cargo::make_unexpected(compiler::Result::FAILURE);
+  }
+  llvm::StringRef unique_name(unique_name_data);
+
+  auto device_info = target.getCompilerInfo()->device_info;
+
+  // FIXME: Ideally we'd be able to call/reuse HostModule::createPassMachinery
+  // but we only have access to the HostTarget
+  auto *const TM = target.target_machine.get();
+  auto builtinInfoCallback = [&](const llvm::Module &) {
+    return compiler::utils::BuiltinInfo(
+        std::make_unique<HostBIMuxInfo>(),
+        compiler::utils::createCLBuiltinInfo(target.getBuiltins()));
+  };
+  auto deviceInfo = compiler::initDeviceInfoFromMux(device_info);
+  HostPassMachinery pass_mach(module->getContext(), TM, deviceInfo,
+                              builtinInfoCallback,
+                              target.getContext().isLLVMVerifyEachEnabled(),
+                              target.getContext().getLLVMDebugLoggingLevel(),
+                              target.getContext().isLLVMTimePassesEnabled());
+  host::initializePassMachineryForFinalize(pass_mach, target);
+
+  llvm::ModulePassManager pm;
+  // Set up the kernel metadata which informs later passes which kernel we're
+  // interested in optimizing. We've already done this when initially
+  // creating the kernel, but now we have more accurate local size data.
+  compiler::utils::EncodeKernelMetadataPassOptions pass_opts;
+  pass_opts.KernelName = name;
+  pass_opts.LocalSizes = {static_cast<uint64_t>(local_size[0]),
+                          static_cast<uint64_t>(local_size[1]),
+                          static_cast<uint64_t>(local_size[2])};
+  pm.addPass(compiler::utils::EncodeKernelMetadataPass(pass_opts));
+
+  pm.addPass(hostGetKernelPasses(build_options, pass_mach.getPB(), snapshots,
+                                 unique_name));
+
+  {
+    // Using the CrashRecoveryContext and statistics touches LLVM's global
+    // state.
+    std::lock_guard<std::mutex> globalLock(
+        compiler::utils::getLLVMGlobalMutex());
+    llvm::CrashRecoveryContext CRC;
+    llvm::CrashRecoveryContext::Enable();
+    bool crashed = !CRC.RunSafely(
+        [&] { pm.run(*optimized_module, pass_mach.getMAM()); });
+    llvm::CrashRecoveryContext::Disable();
+    if (crashed) {
       return cargo::make_unexpected(compiler::Result::FINALIZE_PROGRAM_FAILURE);
     }
 
-    // Note that we grab a handle to the module here, which we use to reference
-    // the module going forward. This is despite us passing ownership of the
-    // module off to the JITDylib. As long as the JITDylib outlives all uses of
-    // the optimized kernels, this should be okay; the JIT has the same lifetime
-    // as this HostKernel.
-    llvm::Module *optimized_module_ptr = optimized_module.get();
-
-    // Create a unique JITDylib for this instance of the kernel, so that its
-    // symbols don't clash with any other kernel's symbols.
-    auto jd = target.orc_engine->createJITDylib(unique_name.str() + ".dylib");
-    if (auto err = jd.takeError()) {
-      if (auto callback = target.getNotifyCallbackFn()) {
-        callback(llvm::toString(std::move(err)).c_str(), /*data*/ nullptr,
-                 /*data_size*/ 0);
-      }
-      return cargo::make_unexpected(compiler::Result::FINALIZE_PROGRAM_FAILURE);
+    if (llvm::AreStatisticsEnabled()) {
+      llvm::PrintStatistics();
+    }
+  }
+
+  // Retrieve the vectorization width and amount of local memory used.
+  auto default_work_width = FixedOrScalableQuantity<uint32_t>::getOne();
+  handler::VectorizeInfoMetadata fn_metadata(
+      unique_name.str(), unique_name.str(),
+      /* local_memory_usage */ 0,
+      /* sub_group_size */ FixedOrScalableQuantity<uint32_t>(),
+      /* min_work_item_factor= */ default_work_width,
+      /* pref_work_item_factor */ default_work_width);
+  if (auto *f = optimized_module->getFunction(unique_name)) {
+    fn_metadata =
+        pass_mach.getFAM()
+            .getResult<compiler::utils::VectorizeMetadataAnalysis>(*f);
+  }
+
+  // Host doesn't support scalable values.
+  if (fn_metadata.min_work_item_factor.isScalable() ||
+      fn_metadata.pref_work_item_factor.isScalable() ||
+      fn_metadata.sub_group_size.isScalable()) {
+    return cargo::make_unexpected(compiler::Result::FINALIZE_PROGRAM_FAILURE);
+  }
+
+  // Note that we grab a handle to the module here, which we use to reference
+  // the module going forward. This is despite us passing ownership of the
+  // module off to the JITDylib. As long as the JITDylib outlives all uses of
+  // the optimized kernels, this should be okay; the JIT has the same lifetime
+  // as this HostKernel.
+  llvm::Module *optimized_module_ptr = optimized_module.get();
+
+  // Create a unique JITDylib for this instance of the kernel, so that its
+  // symbols don't clash with any other kernel's symbols.
+  auto jd = target.orc_engine->createJITDylib(unique_name.str() + ".dylib");
+  if (auto err = jd.takeError()) {
+    if (auto callback = target.getNotifyCallbackFn()) {
+      callback(llvm::toString(std::move(err)).c_str(), /*data*/ nullptr,
+               /*data_size*/ 0);
     }
-    // Register this JITDylib so we can clear up its resources later.
-    kernel_jit_dylibs.insert(jd->getName());
+    return cargo::make_unexpected(compiler::Result::FINALIZE_PROGRAM_FAILURE);
+  }
+  // Register this JITDylib so we can clear up its resources later.
+  kernel_jit_dylibs.insert(jd->getName());
 
-    llvm::orc::SymbolMap symbols;
-    llvm::orc::MangleAndInterner mangle(
-        target.orc_engine->getExecutionSession(),
-        target.orc_engine->getDataLayout());
+  llvm::orc::SymbolMap symbols;
+  llvm::orc::MangleAndInterner mangle(
+      target.orc_engine->getExecutionSession(),
+      target.orc_engine->getDataLayout());
 
-    for (const auto &reloc : host::utils::getRelocations()) {
-      symbols[mangle(reloc.first)] = llvm::JITEvaluatedSymbol(
-          reloc.second, llvm::JITSymbolFlags::Exported);
+  for (const auto &reloc : host::utils::getRelocations()) {
+    symbols[mangle(reloc.first)] = llvm::JITEvaluatedSymbol(
+        reloc.second, llvm::JITSymbolFlags::Exported);
+  }
+
+  // Define our runtime library symbols required for the JIT to successfully
+  // link.
+  if (auto err = jd->define(llvm::orc::absoluteSymbols(std::move(symbols)))) {
+    if (auto callback = target.getNotifyCallbackFn()) {
+      callback(llvm::toString(std::move(err)).c_str(), /*data*/ nullptr,
+               /*data_size*/ 0);
     }
+    return cargo::make_unexpected(compiler::Result::FINALIZE_PROGRAM_FAILURE);
+  }
 
-    // Define our runtime library symbols required for the JIT to successfully
-    // link.
-    if (auto err = jd->define(llvm::orc::absoluteSymbols(std::move(symbols)))) {
-      if (auto callback = target.getNotifyCallbackFn()) {
-        callback(llvm::toString(std::move(err)).c_str(), /*data*/ nullptr,
-                 /*data_size*/ 0);
-      }
-      return cargo::make_unexpected(compiler::Result::FINALIZE_PROGRAM_FAILURE);
+  // Add the module.
+  if (auto err = target.orc_engine->addIRModule(
+          *jd, llvm::orc::ThreadSafeModule(std::move(optimized_module),
+                                           target.llvm_ts_context))) {
+    if (auto callback = target.getNotifyCallbackFn()) {
+      callback(llvm::toString(std::move(err)).c_str(), /*data*/ nullptr,
+               /*data_size*/ 0);
     }
+    return cargo::make_unexpected(compiler::Result::FINALIZE_PROGRAM_FAILURE);
+  }
 
-    // Add the module.
-    if (auto err = target.orc_engine->addIRModule(
-            *jd, llvm::orc::ThreadSafeModule(std::move(optimized_module),
-                                             target.llvm_ts_context))) {
+  // Retrieve the kernel address.
+  uint64_t hook;
+  {
+    // Compiling the kernel may touch the global LLVM state
+    std::lock_guard<std::mutex> globalLock(
+        compiler::utils::getLLVMGlobalMutex());
+    auto sym = target.orc_engine->lookup(*jd, unique_name.str());
+    if (auto err = sym.takeError()) {
       if (auto callback = target.getNotifyCallbackFn()) {
         callback(llvm::toString(std::move(err)).c_str(), /*data*/ nullptr,
                  /*data_size*/ 0);
       }
       return cargo::make_unexpected(compiler::Result::FINALIZE_PROGRAM_FAILURE);
     }
+    hook = sym->getValue();
+  }
 
-    // Retrieve the kernel address.
-    uint64_t hook;
-    {
-      // Compiling the kernel may touch the global LLVM state
-      std::lock_guard<std::mutex> globalLock(
-          compiler::utils::getLLVMGlobalMutex());
-      auto sym = target.orc_engine->lookup(*jd, unique_name.str());
-      if (auto err = sym.takeError()) {
-        if (auto callback = target.getNotifyCallbackFn()) {
-          callback(llvm::toString(std::move(err)).c_str(), /*data*/ nullptr,
-                   /*data_size*/ 0);
-        }
-        return cargo::make_unexpected(
-            compiler::Result::FINALIZE_PROGRAM_FAILURE);
-      }
-      hook = sym->getValue();
-    }
-
-    uint32_t min_width = fn_metadata.min_work_item_factor.getFixedValue();
-    uint32_t pref_width = fn_metadata.pref_work_item_factor.getFixedValue();
-    uint32_t sub_group_size = fn_metadata.sub_group_size.getFixedValue();
+  uint32_t min_width = fn_metadata.min_work_item_factor.getFixedValue();
+  uint32_t pref_width = fn_metadata.pref_work_item_factor.getFixedValue();
+  uint32_t sub_group_size = fn_metadata.sub_group_size.getFixedValue();
 
-    std::unique_ptr<host::utils::jit_kernel_s> jit_kernel(
-        new host::utils::jit_kernel_s{
-            name, hook, static_cast<uint32_t>(fn_metadata.local_memory_usage),
-            min_width, pref_width, sub_group_size});
-    optimized_kernel_map.emplace(
-        local_size,
-        OptimizedKernel{optimized_module_ptr, std::move(jit_kernel)});
-  }
-  return optimized_kernel_map[local_size];
+  std::unique_ptr<host::utils::jit_kernel_s> jit_kernel(
+      new host::utils::jit_kernel_s{
+          name, hook, static_cast<uint32_t>(fn_metadata.local_memory_usage),
+          min_width, pref_width, sub_group_size});
+  return OptimizedKernel{optimized_module_ptr, std::move(jit_kernel)};
 }
 }  // namespace host
@@ -45,6 +45,7 @@
 #include <host/module.h>
 #include <host/passes.h>
 #include <host/target.h>
+#include <host/utils/fat_binary.h>
 #include <llvm-c/BitWriter.h>
 #include <llvm/ADT/STLExtras.h>
 #include <llvm/ADT/Triple.h>
@@ -103,7 +104,7 @@ const HostTarget &HostModule::getHostTarget() const {
 }
 
 cargo::expected<cargo::dynamic_array<uint8_t>, compiler::Result>
-HostModule::hostCompileObject(HostTarget &target,
+HostModule::hostCompileObject(llvm::TargetMachine *target_machine,
                               const compiler::Options &build_options,
                               llvm::Module *module) {
   std::unique_ptr<llvm::Module> cloned_module(llvm::CloneModule(*module));
@@ -112,8 +113,8 @@ HostModule::hostCompileObject(HostTarget &target,
     return cargo::make_unexpected(compiler::Result::OUT_OF_MEMORY);
   }
 
-  auto pass_mach = createPassMachinery();
-  initializePassMachineryForFinalize(*pass_mach);
+  auto pass_mach = createPassMachinery(target_machine);
+  host::initializePassMachineryForFinalize(*pass_mach, target_machine);
 
   llvm::ModulePassManager pm;
   pm.addPass(compiler::utils::TransferKernelMetadataPass());
@@ -139,8 +140,7 @@ HostModule::hostCompileObject(HostTarget &target,
     }
   }
 
-  auto binaryOrError =
-      emitBinary(cloned_module.get(), target.target_machine.get());
+  auto binaryOrError = emitBinary(cloned_module.get(), target_machine);
 
   if (!binaryOrError.has_value()) {
     return cargo::make_unexpected(binaryOrError.error());
@@ -170,13 +170,49 @@ compiler::Result HostModule::createBinary(
     llvm::SmallVector<char, 1024> object_code_buffer;
     llvm::raw_svector_ostream stream(object_code_buffer);
 
-    auto binaryOrError =
-        hostCompileObject(host_target, options, clonedModule.get());
+    auto binaryOrError = hostCompileObject(
+        host_target.target_machine.get(), options, clonedModule.get());
     if (!binaryOrError.has_value()) {
       return binaryOrError.error();
     }
 
     object_code = std::move(binaryOrError.value());
+
+    if (!host_target.isa_variants.empty()) {
+      // Compile a variant for each higher ISA level and pack them together
+      // with the baseline; the loader selects one at runtime.
+      cargo::small_vector<cargo::dynamic_array<uint8_t>, 4> variant_objects;
+      cargo::small_vector<host::utils::fat_binary_variant_s, 4> variants;
+      for (const auto &isa_variant : host_target.isa_variants) {
+        auto variantOrError = hostCompileObject(
+            isa_variant.target_machine.get(), options, clonedModule.get());
+        if (!variantOrError.has_value()) {
+          return variantOrError.error();
+        }
+        if (variant_objects.push_back(std::move(variantOrError.value()))) {
+          return compiler::Result::OUT_OF_MEMORY;
+        }
+      }
+
+      if (variants.push_back({host::utils::isa_level_baseline,
+                              {object_code.data(), object_code.size()}})) {
+        return compiler::Result::OUT_OF_MEMORY;
+      }
+      for (size_t i = 0; i < variant_objects.size(); i++) {
+        if (variants.push_back({host_target.isa_variants[i].isa_level,
+                                {variant_objects[i].data(),
+                                 variant_objects[i].size()}})) {
+          return compiler::Result::OUT_OF_MEMORY;
+        }
+      }
+
+      cargo::dynamic_array<uint8_t> fat_binary;
+      if (fat_binary.alloc(host::utils::getSizeForFatBinary(variants))) {
+        return compiler::Result::OUT_OF_MEMORY;
+      }
+      host::utils::serializeFatBinary(variants, fat_binary.data());
+      object_code = std::move(fat_binary);
+    }
   }
 
   buffer = cargo::array_view<std::uint8_t>(object_code);
@@ -271,7 +307,12 @@ compiler::Kernel *HostModule::createKernel(const std::string &name) {
 
 std::unique_ptr<compiler::utils::PassMachinery>
 HostModule::createPassMachinery() {
-  auto *TM = static_cast<HostTarget &>(target).target_machine.get();
+  return createPassMachinery(
+      static_cast<HostTarget &>(target).target_machine.get());
+}
+
+std::unique_ptr<compiler::utils::PassMachinery>
+HostModule::createPassMachinery(llvm::TargetMachine *TM) {
   auto Info =
       compiler::initDeviceInfoFromMux(target.getCompilerInfo()->device_info);
   auto Callback = [BI = target.getBuiltins()](const llvm::Module &) {
@@ -288,8 +329,11 @@ HostModule::createPassMachinery() {
 
 void initializePassMachineryForFinalize(
     compiler::utils::PassMachinery &passMach, const HostTarget &target) {
-  auto *TM = target.target_machine.get();
+  initializePassMachineryForFinalize(passMach, target.target_machine.get());
+}
 
+void initializePassMachineryForFinalize(
+    compiler::utils::PassMachinery &passMach, llvm::TargetMachine *TM) {
   passMach.initializeStart();
   if (TM) {
     passMach.getFAM().registerPass(
@@ -305,7 +349,7 @@ void initializePassMachineryForFinalize(
   // to adding the pass. Trying to add a TargetLibraryInfoWrapper analysis with
   // disabled functions later will have no affect, due to the analysis already
   // being registered with the pass manager.
-  auto Triple = target.target_machine->getTargetTriple();
+  auto Triple = TM->getTargetTriple();
   auto LibraryInfo = llvm::TargetLibraryInfoImpl(Triple);
   LibraryInfo.disableAllFunctions();
   passMach.getFAM().registerPass(
@@ -118,6 +118,8 @@ llvm::ModulePassManager hostGetKernelPasses(
 #if !defined(UTILS_SYSTEM_32_BIT)
   HBOpts.IsDebug = options.opt_disable;
 #endif
+  // Our entry hook can split barrier-free work-groups across threads.
+  HBOpts.SplitBarrierFreeWorkGroups = true;
 
   PM.addPass(compiler::utils::HandleBarriersPass(HBOpts));
 
@@ -27,9 +27,13 @@
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Target/TargetMachine.h>
 
+#include <cstdlib>
+#include <iterator>
+
 #include "host/device.h"
 #include "host/info.h"
 #include "host/module.h"
+#include "host/utils/fat_binary.h"
 
 #ifdef CA_ENABLE_HOST_BUILTINS
 #include "compiler/utils/memory_buffer.h"
@@ -223,6 +227,54 @@ compiler::Result HostTarget::initWithBuiltins(
   }
   target_machine = std::move(*TM);
 
+  // Without a specific CPU to optimize for the code only uses the baseline ISA
+  // of the architecture. When requested, also create target machines for the
+  // higher ISA levels to build fat binaries which make use of them where
+  // available. This multiplies the cost of code generation by the number of
+  // levels, so it is opt-in and mainly intended for offline compilation.
+  struct isa_level_info {
+    host::utils::isa_level isa_level;
+    const char *cpu;
+    const char *feature;
+  };
+  cargo::array_view<const isa_level_info> isa_levels;
+  const char *multiversion = std::getenv("CA_HOST_MULTIVERSION_BINARIES");
+  if (CPUName.empty() && multiversion && std::atoi(multiversion) != 0) {
+    if (llvm::Triple::x86_64 == triple.getArch()) {
+      static const isa_level_info x86_64_levels[] = {
+          {host::utils::isa_level_x86_64_v2, "x86-64-v2", nullptr},
+          {host::utils::isa_level_x86_64_v3, "x86-64-v3", nullptr},
+          {host::utils::isa_level_x86_64_v4, "x86-64-v4", nullptr},
+      };
+      isa_levels = {x86_64_levels, std::size(x86_64_levels)};
+    } else if (llvm::Triple::aarch64 == triple.getArch()) {
+      static const isa_level_info aarch64_levels[] = {
+          {host::utils::isa_level_aarch64_sve, "", "sve"},
+      };
+      isa_levels = {aarch64_levels, std::size(aarch64_levels)};
+    }
+  }
+
+  for (const auto &level : isa_levels) {
+    llvm::orc::JITTargetMachineBuilder VariantBuilder(triple);
+    VariantBuilder.setCPU(level.cpu);
+    VariantBuilder.setCodeGenOptLevel(llvm::CodeGenOpt::Aggressive);
+    for (auto &Feature : FeatureMap) {
+      VariantBuilder.getFeatures().AddFeature(Feature.first(), Feature.second);
+    }
+    if (level.feature) {
+      VariantBuilder.getFeatures().AddFeature(level.feature);
+    }
+    auto VariantTM = VariantBuilder.createTargetMachine();
+    if (auto err = VariantTM.takeError()) {
+      // Not being able to target a higher ISA level is not fatal, binaries
+      // will contain only the variants which could be created.
+      llvm::consumeError(std::move(err));
+      continue;
+    }
+    isa_variants.push_back({level.isa_level, std::move(*VariantTM)});
+  }
+
   return compiler::Result::SUCCESS;
 }
 
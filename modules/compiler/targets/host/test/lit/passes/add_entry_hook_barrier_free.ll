@@ -0,0 +1,131 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: muxc --device "%default_device" --passes add-entry-hook,verify -S %s  | FileCheck %s
+
+target triple = "spir64-unknown-unknown"
+target datalayout = "e-p:64:64:64-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+; Barrier-free kernels split their work-groups into parts when there are fewer
+; work-groups than slices, and hand out contiguous ranges of parts to each
+; slice.
+; CHECK: define void @bar.host-entry-hook(ptr %wi-info, ptr %sched-info, ptr %wg-info) [[BAR_ATTRS:#[0-9]+]]
+; CHECK-LABEL: entry:
+; CHECK: [[NGPSX:%.*]] = call i64 @__mux_get_num_groups(i32 0, ptr %wi-info, ptr %sched-info, ptr %wg-info)
+; CHECK: [[NGPSY:%.*]] = call i64 @__mux_get_num_groups(i32 1, ptr %wi-info, ptr %sched-info, ptr %wg-info)
+; CHECK: [[NGPSZ:%.*]] = call i64 @__mux_get_num_groups(i32 2, ptr %wi-info, ptr %sched-info, ptr %wg-info)
+; CHECK: [[SLICE:%.*]] = load i64, ptr {{%.*}}, align 8
+; CHECK: [[TTL_SLICES:%.*]] = load i64, ptr {{%.*}}, align 8
+; CHECK: [[T0:%.*]] = mul i64 [[NGPSX]], [[NGPSY]]
+; CHECK: [[TTL_GPS:%.*]] = mul i64 [[T0]], [[NGPSZ]]
+; CHECK: [[T1:%.*]] = sub i64 [[TTL_GPS]], 1
+; CHECK: [[T2:%.*]] = add i64 [[TTL_SLICES]], [[T1]]
+; CHECK: [[T3:%.*]] = udiv i64 [[T2]], [[TTL_GPS]]
+; CHECK: [[T4:%.*]] = icmp uge i64 [[TTL_GPS]], [[TTL_SLICES]]
+; CHECK: [[PARTS:%.*]] = select i1 [[T4]], i64 1, i64 [[T3]]
+; CHECK: [[TTL_UNITS:%.*]] = mul i64 [[TTL_GPS]], [[PARTS]]
+; CHECK: [[T5:%.*]] = sub i64 [[TTL_SLICES]], 1
+; CHECK: [[T6:%.*]] = add i64 [[TTL_UNITS]], [[T5]]
+; CHECK: [[UNITS_PER_SLICE:%.*]] = udiv i64 [[T6]], [[TTL_SLICES]]
+; CHECK: [[UNIT_BEG:%.*]] = mul i64 [[UNITS_PER_SLICE]], [[SLICE]]
+; CHECK: [[T7:%.*]] = add i64 [[UNIT_BEG]], [[UNITS_PER_SLICE]]
+; CHECK: [[UNIT_END:%.*]] = call i64 @llvm.umin.i64(i64 [[T7]], i64 [[TTL_UNITS]])
+
+; Work-groups are split along the dimension with the largest local size.
+; CHECK: [[LSIZES:%.*]] = getelementptr %Mux_schedule_info_s, ptr %sched-info, i32 0, i32 2
+; CHECK: [[LSX:%.*]] = load i64
+; CHECK: [[LSY:%.*]] = load i64
+; CHECK: [[LSZ:%.*]] = load i64
+; CHECK: [[T8:%.*]] = icmp ugt i64 [[LSY]], [[LSX]]
+; CHECK: [[DIM0:%.*]] = select i1 [[T8]], i32 1, i32 0
+; CHECK: [[SIZE0:%.*]] = select i1 [[T8]], i64 [[LSY]], i64 [[LSX]]
+; CHECK: [[T9:%.*]] = icmp ugt i64 [[LSZ]], [[SIZE0]]
+; CHECK: [[DIM:%.*]] = select i1 [[T9]], i32 2, i32 [[DIM0]]
+; CHECK: [[SIZE:%.*]] = select i1 [[T9]], i64 [[LSZ]], i64 [[SIZE0]]
+; CHECK: [[T10:%.*]] = sub i64 [[PARTS]], 1
+; CHECK: [[T11:%.*]] = add i64 [[SIZE]], [[T10]]
+; CHECK: [[PART_SIZE:%.*]] = udiv i64 [[T11]], [[PARTS]]
+; CHECK: [[T12:%.*]] = icmp ult i64 [[UNIT_BEG]], [[UNIT_END]]
+; CHECK: br i1 [[T12]], label %[[LOOP:.*]], label %[[EARLY_EXIT:.*]]
+
+; CHECK: [[EARLY_EXIT]]:
+; CHECK: ret void
+
+; CHECK: [[LOOP]]:
+; CHECK: br label %[[LOOPU:.*]]
+
+; CHECK: [[LOOPU]]:
+; CHECK: [[UNIT:%.*]] = phi i64 [ [[UNIT_BEG]], %[[LOOP]] ], [ [[INCU:%.*]], %[[LOOPU]] ]
+; CHECK: [[GROUP:%.*]] = udiv i64 [[UNIT]], [[PARTS]]
+; CHECK: [[PART:%.*]] = urem i64 [[UNIT]], [[PARTS]]
+; CHECK: [[GROUPYZ:%.*]] = udiv i64 [[GROUP]], [[NGPSX]]
+; CHECK: [[GPIDX:%.*]] = urem i64 [[GROUP]], [[NGPSX]]
+; CHECK: [[GPIDY:%.*]] = urem i64 [[GROUPYZ]], [[NGPSY]]
+; CHECK: [[GPIDZ:%.*]] = udiv i64 [[GROUPYZ]], [[NGPSY]]
+; CHECK: [[T13:%.*]] = mul i64 [[PART]], [[PART_SIZE]]
+; CHECK: [[PART_BEG:%.*]] = call i64 @llvm.umin.i64(i64 [[T13]], i64 [[SIZE]])
+; CHECK: [[T14:%.*]] = add i64 [[PART_BEG]], [[PART_SIZE]]
+; CHECK: [[PART_END:%.*]] = call i64 @llvm.umin.i64(i64 [[T14]], i64 [[SIZE]])
+; CHECK: [[GEPGPIDS:%.*]] = getelementptr %MiniWGInfo, ptr %wg-info, i32 0, i32 0
+; CHECK: [[GEPBEGS:%.*]] = getelementptr %MiniWGInfo, ptr %wg-info, i32 0, i32 2
+; CHECK: [[GEPENDS:%.*]] = getelementptr %MiniWGInfo, ptr %wg-info, i32 0, i32 3
+
+; CHECK: [[ISX:%.*]] = icmp eq i32 [[DIM]], 0
+; CHECK: [[T15:%.*]] = getelementptr [3 x i64], ptr [[GEPGPIDS]], i32 0, i32 0
+; CHECK: store i64 [[GPIDX]], ptr [[T15]], align 8
+; CHECK: [[T16:%.*]] = getelementptr [3 x i64], ptr [[GEPBEGS]], i32 0, i32 0
+; CHECK: [[BEGX:%.*]] = select i1 [[ISX]], i64 [[PART_BEG]], i64 0
+; CHECK: store i64 [[BEGX]], ptr [[T16]], align 8
+; CHECK: [[T17:%.*]] = getelementptr [3 x i64], ptr [[GEPENDS]], i32 0, i32 0
+; CHECK: [[ENDX:%.*]] = select i1 [[ISX]], i64 [[PART_END]], i64 [[LSX]]
+; CHECK: store i64 [[ENDX]], ptr [[T17]], align 8
+
+; CHECK: [[ISY:%.*]] = icmp eq i32 [[DIM]], 1
+; CHECK: store i64 [[GPIDY]]
+; CHECK: [[BEGY:%.*]] = select i1 [[ISY]], i64 [[PART_BEG]], i64 0
+; CHECK: store i64 [[BEGY]]
+; CHECK: [[ENDY:%.*]] = select i1 [[ISY]], i64 [[PART_END]], i64 [[LSY]]
+; CHECK: store i64 [[ENDY]]
+
+; CHECK: [[ISZ:%.*]] = icmp eq i32 [[DIM]], 2
+; CHECK: store i64 [[GPIDZ]]
+; CHECK: [[BEGZ:%.*]] = select i1 [[ISZ]], i64 [[PART_BEG]], i64 0
+; CHECK: store i64 [[BEGZ]]
+; CHECK: [[ENDZ:%.*]] = select i1 [[ISZ]], i64 [[PART_END]], i64 [[LSZ]]
+; CHECK: store i64 [[ENDZ]]
+
+; CHECK: call void @foo(ptr %wi-info, ptr %sched-info, ptr %wg-info) [[FOO_ATTRS:#.*]]
+; CHECK: [[INCU]] = add i64 [[UNIT]], 1
+; CHECK: [[CMPU:%.*]] = icmp ult i64 [[INCU]], [[UNIT_END]]
+; CHECK: br i1 [[CMPU]], label %[[LOOPU]], label %[[EXIT:.*]]
+
+; CHECK: [[EXIT]]:
+; CHECK: ret void
+
+define void @foo(ptr %wi-info, ptr %sched-info, ptr %wg-info) #0 !mux_scheduled_fn !1 {
+  ret void
+}
+
+; CHECK-DAG: attributes [[BAR_ATTRS]] = { nounwind "mux-barrier-free" "mux-base-fn-name"="bar" "mux-kernel"="entry-point" }
+; CHECK-DAG: attributes [[FOO_ATTRS]] = { alwaysinline "mux-barrier-free" "mux-base-fn-name"="bar" }
+
+attributes #0 = { "mux-barrier-free" "mux-base-fn-name"="bar" "mux-kernel"="entry-point" }
+
+!mux-scheduling-params = !{!0}
+
+!0 = !{!"MuxWorkItemInfo", !"Mux_schedule_info_s", !"MiniWGInfo"}
+
+!1 = !{i32 0, i32 1, i32 2}
@@ -22,7 +22,7 @@
 target triple = "spir64-unknown-unknown"
 target datalayout = "e-p:64:64:64-m:e-i64:64-f80:128-n8:16:32:64-S128"
 
-; CHECK: define void @bar.host-entry-hook(i8 signext %x, ptr [[WIATTRS:noalias nonnull align 8 dereferenceable\(40\)]] %wi-info, ptr [[SIATTRS:noalias nonnull align 8 dereferenceable\(96\)]] %sched-info, ptr [[WGATTRS:noalias nonnull align 8 dereferenceable\(48\)]] %mini-wg-info) [[BAR_ATTRS:#[0-9]+]] !test [[FOO_TEST:\![0-9]+]] !mux_scheduled_fn [[FOO_SCHED_FN:\![0-9]+]] {
+; CHECK: define void @bar.host-entry-hook(i8 signext %x, ptr [[WIATTRS:noalias nonnull align 8 dereferenceable\(40\)]] %wi-info, ptr [[SIATTRS:noalias nonnull align 8 dereferenceable\(96\)]] %sched-info, ptr [[WGATTRS:noalias nonnull align 8 dereferenceable\(96\)]] %mini-wg-info) [[BAR_ATTRS:#[0-9]+]] !test [[FOO_TEST:\![0-9]+]] !mux_scheduled_fn [[FOO_SCHED_FN:\![0-9]+]] {
 ; CHECK-LABEL: entry:
 ; CHECK: [[NGPSX:%.*]] = call i64 @__mux_get_num_groups(i32 0, ptr %wi-info, ptr %sched-info, ptr %mini-wg-info)
 ; CHECK: [[NGPSY:%.*]] = call i64 @__mux_get_num_groups(i32 1, ptr %wi-info, ptr %sched-info, ptr %mini-wg-info)
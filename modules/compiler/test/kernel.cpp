@@ -16,6 +16,9 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 #include "common.h"
 
@@ -431,3 +434,128 @@ INSTANTIATE_DEFERRABLE_COMPILER_TARGET_TEST_SUITE_P(QueryMaxSubGroupCount);
 TEST_P(QueryMaxSubGroupCount, ValidateSubGroupCount) {
   ASSERT_GT(kernel->queryMaxSubGroupCount().value(), (size_t)0);
 }
+
+/// @brief Test fixture for testing behaviour of the
+/// compiler::Kernel::createSpecializedKernelForEnqueue API.
+///
+/// Targets may fold the values of scalar arguments into kernels created for a
+/// single enqueue. Host does this when `CA_HOST_SPECIALIZE_KERNEL_ARGS` is set
+/// when the kernel is created, which this fixture sets so that the first
+/// enqueue with new argument values is specialized. Tests skip on targets
+/// which don't specialize on argument values.
+struct CreateSpecializedKernelForEnqueueTest : CompilerKernelTest {
+  void SetUp() override {
+    setEnvironment("CA_HOST_SPECIALIZE_KERNEL_ARGS", "1");
+    RETURN_ON_SKIP_OR_FATAL_FAILURE(CompilerKernelTest::SetUp());
+    kernel = module->getKernel("scale");
+    ASSERT_NE(nullptr, kernel);
+  }
+
+  void TearDown() override {
+    CompilerKernelTest::TearDown();
+    setEnvironment("CA_HOST_SPECIALIZE_KERNEL_ARGS", "");
+  }
+
+  cargo::string_view KernelSource() override {
+    return R"(
+      kernel void nop() {}
+      kernel void scale(global int *out, int factor) {
+        out[get_global_id(0)] *= factor;
+      })";
+  }
+
+  static void setEnvironment(const char *name, const char *value) {
+#ifdef _WIN32
+    _putenv_s(name, value);
+#else
+    setenv(name, value, 1);
+#endif
+  }
+
+  /// @brief Creates a binary for the `scale` kernel with the given factor.
+  ///
+  /// @param factor Value of the kernel's scalar argument.
+  /// @param for_enqueue Whether to create it through
+  /// `createSpecializedKernelForEnqueue` rather than `createSpecializedKernel`.
+  std::vector<uint8_t> createBinary(int32_t factor, bool for_enqueue) {
+    mux_descriptor_info_t descriptors[2];
+    descriptors[0].type = mux_descriptor_info_type_null_buffer;
+    descriptors[1].type = mux_descriptor_info_type_plain_old_data;
+    descriptors[1].plain_old_data_descriptor.data = &factor;
+    descriptors[1].plain_old_data_descriptor.length = sizeof(factor);
+
+    mux_ndrange_options_t nd_range_options{};
+    nd_range_options.descriptors = descriptors;
+    nd_range_options.descriptors_length = 2;
+    size_t local_size[]{1, 1, 1};
+    std::memcpy(nd_range_options.local_size, local_size, sizeof(local_size));
+    size_t global_offset = 0;
+    nd_range_options.global_offset = &global_offset;
+    size_t global_size = 1;
+    nd_range_options.global_size = &global_size;
+    nd_range_options.dimensions = 1;
+
+    cargo::expected<cargo::dynamic_array<uint8_t>, compiler::Result> binary;
+    if (for_enqueue) {
+      binary = kernel->createSpecializedKernelForEnqueue(nd_range_options);
+    } else {
+      binary = kernel->createSpecializedKernel(nd_range_options);
+    }
+    EXPECT_TRUE(binary);
+    if (!binary) {
+      return {};
+    }
+    return {binary->begin(), binary->end()};
+  }
+};
+
+TEST_P(CreateSpecializedKernelForEnqueueTest, FoldArguments) {
+  const auto unspecialized = createBinary(3, false);
+  const auto specialized = createBinary(3, true);
+  if (specialized == unspecialized) {
+    GTEST_SKIP();
+  }
+
+  // The variant is reused for later enqueues with the same values.
+  EXPECT_EQ(specialized, createBinary(3, true));
+  // Other values get a variant of their own.
+  const auto other = createBinary(5, true);
+  EXPECT_NE(specialized, other);
+  EXPECT_NE(unspecialized, other);
+  // Kernels which can have their arguments updated, such as those recorded
+  // into command buffers, never get the values folded in.
+  EXPECT_EQ(unspecialized, createBinary(3, false));
+  EXPECT_EQ(unspecialized, createBinary(5, false));
+}
+
+TEST_P(CreateSpecializedKernelForEnqueueTest, VariantLimitFallback) {
+  const auto unspecialized = createBinary(0, false);
+  std::vector<std::vector<uint8_t>> variants;
+  variants.push_back(createBinary(1, true));
+  if (variants.back() == unspecialized) {
+    GTEST_SKIP();
+  }
+
+  // Keep enqueueing with new values until the target stops specializing,
+  // after which it must fall back to the unspecialized kernel.
+  const int32_t max_factor = 64;
+  int32_t factor = 2;
+  for (; factor < max_factor; factor++) {
+    auto binary = createBinary(factor, true);
+    if (binary == unspecialized) {
+      break;
+    }
+    variants.push_back(std::move(binary));
+  }
+  ASSERT_LT(factor, max_factor);
+
+  // Values seen after the limit keep falling back, while the variants created
+  // before it are still used.
+  EXPECT_EQ(unspecialized, createBinary(factor, true));
+  for (size_t i = 0; i < variants.size(); i++) {
+    EXPECT_EQ(variants[i], createBinary(static_cast<int32_t>(i + 1), true));
+  }
+}
+
+INSTANTIATE_DEFERRABLE_COMPILER_TARGET_TEST_SUITE_P(
+    CreateSpecializedKernelForEnqueueTest);
@@ -0,0 +1,86 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: muxc --passes barriers-pass,verify -S %s | FileCheck %s
+
+target triple = "spir64-unknown-unknown"
+target datalayout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:256-v256:256-v512:512-v1024:1024"
+
+; %a is only live across the first barrier and %c only across the third, so
+; they share a slot. %b is live across the second barrier and needs its own
+; slot. The index and the scaled value are recalculated rather than stored.
+; CHECK: %slots_live_mem_info = type { i64, i32, [4 x i8] }
+
+; CHECK-LABEL: define internal i32 @slots.mux-barrier-region(
+; CHECK: [[A_GEP:%.*]] = getelementptr %slots_live_mem_info, ptr %2, i32 0, i32 0
+; CHECK: store i64 %a, ptr [[A_GEP]]
+
+; CHECK-LABEL: define internal i32 @slots.mux-barrier-region.1(
+; CHECK: [[A_LOAD_GEP:%.*]] = getelementptr %slots_live_mem_info, ptr %2, i32 0, i32 0
+; CHECK: %a_load = load i64, ptr [[A_LOAD_GEP]]
+; CHECK: [[B_GEP:%.*]] = getelementptr %slots_live_mem_info, ptr %2, i32 0, i32 1
+; CHECK: store i32 %b, ptr [[B_GEP]]
+
+; The scaled value is recalculated from the stored value of %b.
+; CHECK-LABEL: define internal i32 @slots.mux-barrier-region.2(
+; CHECK: [[B_LOAD_GEP:%.*]] = getelementptr %slots_live_mem_info, ptr %2, i32 0, i32 1
+; CHECK: %b_load = load i32, ptr [[B_LOAD_GEP]]
+; CHECK: [[C_GEP:%.*]] = getelementptr %slots_live_mem_info, ptr %2, i32 0, i32 0
+; CHECK: %b.scaled = shl i32 %b_load, 2
+; CHECK: store i64 %c, ptr [[C_GEP]]
+
+; The index is recalculated from the work-item IDs.
+; CHECK-LABEL: define internal i32 @slots.mux-barrier-region.3(
+; CHECK: [[C_LOAD_GEP:%.*]] = getelementptr %slots_live_mem_info, ptr %2, i32 0, i32 0
+; CHECK: %c_load = load i64, ptr [[C_LOAD_GEP]]
+; CHECK: %gid = call i64 @__mux_get_global_id(i32 0)
+; CHECK: %idx.mul = mul i64 %gid, 3
+; CHECK: %lid = call i64 @__mux_get_local_id(i32 0)
+; CHECK: %idx = add i64 %idx.mul, %lid
+
+; The barrier struct size is reported on the wrapper.
+; CHECK: define void @slots.mux-barrier-wrapper({{.*}}) [[WRAPPER_ATTRS:#[0-9]+]]
+; CHECK: attributes [[WRAPPER_ATTRS]] = { nounwind "mux-barrier-struct-size"="16" "mux-base-fn-name"="slots" "mux-kernel"="entry-point" }
+
+define void @slots(ptr addrspace(1) %in, ptr addrspace(1) %out) #0 {
+entry:
+  %gid = call i64 @__mux_get_global_id(i32 0)
+  %lid = call i64 @__mux_get_local_id(i32 0)
+  %idx.mul = mul i64 %gid, 3
+  %idx = add i64 %idx.mul, %lid
+  %a.ptr = getelementptr inbounds i64, ptr addrspace(1) %in, i64 %idx
+  %a = load i64, ptr addrspace(1) %a.ptr, align 8
+  call void @__mux_work_group_barrier(i32 0, i32 1, i32 272)
+  %a.trunc = trunc i64 %a to i32
+  %b = mul i32 %a.trunc, %a.trunc
+  call void @__mux_work_group_barrier(i32 1, i32 1, i32 272)
+  %b.scaled = shl i32 %b, 2
+  %c.ptr = getelementptr inbounds i64, ptr addrspace(1) %in, i32 %b.scaled
+  %c = load i64, ptr addrspace(1) %c.ptr, align 8
+  call void @__mux_work_group_barrier(i32 2, i32 1, i32 272)
+  %d = add i64 %c, %idx
+  %out.ptr = getelementptr inbounds i64, ptr addrspace(1) %out, i64 %idx
+  store i64 %d, ptr addrspace(1) %out.ptr, align 8
+  ret void
+}
+
+declare void @__mux_work_group_barrier(i32, i32, i32)
+
+declare i64 @__mux_get_global_id(i32)
+
+declare i64 @__mux_get_local_id(i32)
+
+attributes #0 = { "mux-kernel"="entry-point" }
@@ -0,0 +1,154 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: muxc --passes "barriers-pass<split-barrier-free>,verify" -S %s | FileCheck %s
+
+target triple = "spir64-unknown-unknown"
+target datalayout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:256-v256:256-v512:512-v1024:1024"
+
+; The scalar kernel's work-item loops iterate over the local range directly.
+; CHECK: define void @add.mux-barrier-wrapper(ptr addrspace(1) %in, ptr addrspace(1) %out) [[SCALAR_ATTRS:#[0-9]+]]
+; CHECK: [[START_X:%.*]] = call i64 @__mux_get_local_range_start(i32 0)
+; CHECK: [[END_X:%.*]] = call i64 @__mux_get_local_range_end(i32 0)
+; CHECK: %main.start = call i64 @llvm.umin.i64(i64 [[START_X]], i64 %local_size.x)
+; CHECK: %main.end = call i64 @llvm.umin.i64(i64 [[END_X]], i64 %local_size.x)
+
+; The vector kernel rounds the local range in the first dimension up to the
+; vector width for the main loop, leaving the rest to the scalar tail.
+; CHECK: define void @__vecz_v4_add.mux-barrier-wrapper(ptr addrspace(1) %in, ptr addrspace(1) %out) [[VECTOR_ATTRS:#[0-9]+]]
+; CHECK: %mainLoopLimit = sub i64 %local_size.x, %peel
+; CHECK: [[START_X:%.*]] = call i64 @__mux_get_local_range_start(i32 0)
+; CHECK: [[END_X:%.*]] = call i64 @__mux_get_local_range_end(i32 0)
+; CHECK: [[EMPTY_X:%.*]] = icmp uge i64 [[START_X]], [[END_X]]
+; CHECK: [[START_Y:%.*]] = call i64 @__mux_get_local_range_start(i32 1)
+; CHECK: [[END_Y:%.*]] = call i64 @__mux_get_local_range_end(i32 1)
+; CHECK: [[EMPTY_Y:%.*]] = icmp uge i64 [[START_Y]], [[END_Y]]
+; CHECK: [[EMPTY_XY:%.*]] = or i1 [[EMPTY_X]], [[EMPTY_Y]]
+; CHECK: [[START_Z:%.*]] = call i64 @__mux_get_local_range_start(i32 2)
+; CHECK: [[END_Z:%.*]] = call i64 @__mux_get_local_range_end(i32 2)
+; CHECK: [[EMPTY_Z:%.*]] = icmp uge i64 [[START_Z]], [[END_Z]]
+; CHECK: [[EMPTY:%.*]] = or i1 [[EMPTY_XY]], [[EMPTY_Z]]
+; CHECK: [[T0:%.*]] = add i64 [[START_X]], 3
+; CHECK: [[T1:%.*]] = udiv i64 [[T0]], 4
+; CHECK: [[T2:%.*]] = mul i64 [[T1]], 4
+; CHECK: %main.start = call i64 @llvm.umin.i64(i64 [[T2]], i64 %mainLoopLimit)
+; CHECK: [[T3:%.*]] = add i64 [[END_X]], 3
+; CHECK: [[T4:%.*]] = udiv i64 [[T3]], 4
+; CHECK: [[T5:%.*]] = mul i64 [[T4]], 4
+; CHECK: %main.end = call i64 @llvm.umin.i64(i64 [[T5]], i64 %mainLoopLimit)
+; CHECK: [[T6:%.*]] = call i64 @llvm.umax.i64(i64 [[START_X]], i64 %mainLoopLimit)
+; CHECK: %tail.start = sub i64 [[T6]], %mainLoopLimit
+; CHECK: [[T7:%.*]] = call i64 @llvm.umax.i64(i64 [[END_X]], i64 %mainLoopLimit)
+; CHECK: %tail.end = sub i64 [[T7]], %mainLoopLimit
+; CHECK: br i1 [[EMPTY]], label %kernel.exit, label %[[BODY:.*]]
+
+; CHECK: [[BODY]]:
+; CHECK: [[NEED_MAIN:%.*]] = icmp ult i64 %main.start, %main.end
+; CHECK: br i1 [[NEED_MAIN]], label %ca_work_item_x_vector_preheader, label %ca_work_item_x_vector_exit
+
+; CHECK: ca_work_item_x_vector_exit:
+; CHECK: [[NEED_TAIL:%.*]] = icmp ult i64 %tail.start, %tail.end
+; CHECK: br i1 [[NEED_TAIL]], label %ca_work_item_x_scalar_preheader, label %ca_work_item_x_scalar_exit
+
+; CHECK: [[LOOPZ:loopIR[0-9]*]]:
+; CHECK: [[Z:%.*]] = phi i64 [ [[START_Z]], %ca_work_item_x_vector_preheader ]
+; CHECK: call void @__mux_set_local_id(i32 2, i64 [[Z]])
+; CHECK: [[LOOPY:loopIR[0-9]*]]:
+; CHECK: [[Y:%.*]] = phi i64 [ [[START_Y]], %[[LOOPZ]] ]
+; CHECK: call void @__mux_set_local_id(i32 1, i64 [[Y]])
+; CHECK: [[LOOPX:loopIR[0-9]*]]:
+; CHECK: [[X:%.*]] = phi i64 [ %main.start, %[[LOOPY]] ], [ [[XNEXT:%.*]], %[[LOOPX]] ]
+; CHECK: call void @__mux_set_local_id(i32 0, i64 [[X]])
+; CHECK: call void @__vecz_v4_add(
+; CHECK: [[XNEXT]] = add i64 [[X]], 4
+; CHECK: icmp ult i64 [[XNEXT]], %main.end
+; CHECK: icmp ult i64 {{%.*}}, [[END_Y]]
+; CHECK: icmp ult i64 {{%.*}}, [[END_Z]]
+
+; CHECK: [[TX:%.*]] = phi i64 [ %tail.start, %{{.*}} ], [ [[TXNEXT:%.*]], %{{.*}} ]
+; CHECK: [[LID:%.*]] = add i64 %mainLoopLimit, [[TX]]
+; CHECK: call void @__mux_set_local_id(i32 0, i64 [[LID]])
+; CHECK: call void @add(
+; CHECK: [[TXNEXT]] = add i64 [[TX]], 1
+; CHECK: icmp ult i64 [[TXNEXT]], %tail.end
+
+; CHECK: kernel.exit:
+; CHECK-NEXT: ret void
+
+; A kernel with a barrier executes the whole work-group.
+; CHECK: define void @add_barrier.mux-barrier-wrapper(ptr addrspace(1) %in, ptr addrspace(1) %out) [[BARRIER_ATTRS:#[0-9]+]]
+; CHECK-NOT: @__mux_get_local_range_
+; CHECK: kernel.exit:
+
+; A kernel using local memory executes the whole work-group.
+; CHECK: define void @add_local.mux-barrier-wrapper(ptr addrspace(1) %in, ptr addrspace(3) %tmp) [[LOCAL_ATTRS:#[0-9]+]]
+; CHECK-NOT: @__mux_get_local_range_
+; CHECK: kernel.exit:
+
+; CHECK-DAG: attributes [[SCALAR_ATTRS]] = { nounwind "mux-barrier-free" "mux-base-fn-name"="add" "mux-kernel"="entry-point" }
+; CHECK-DAG: attributes [[VECTOR_ATTRS]] = { nounwind "mux-barrier-free" "mux-base-fn-name"="__vecz_v4_add" "mux-kernel"="entry-point" }
+; CHECK-DAG: attributes [[BARRIER_ATTRS]] = { nounwind "mux-barrier-struct-size"="4" "mux-base-fn-name"="add_barrier" "mux-kernel"="entry-point" }
+; CHECK-DAG: attributes [[LOCAL_ATTRS]] = { nounwind "mux-base-fn-name"="add_local" "mux-kernel"="entry-point" }
+
+define internal void @add(ptr addrspace(1) %in, ptr addrspace(1) %out) #0 !codeplay_ca_vecz.base !1 {
+entry:
+  %id = call i64 @__mux_get_global_id(i32 0)
+  %in.addr = getelementptr inbounds i32, ptr addrspace(1) %in, i64 %id
+  %x = load i32, ptr addrspace(1) %in.addr, align 4
+  %out.addr = getelementptr inbounds i32, ptr addrspace(1) %out, i64 %id
+  store i32 %x, ptr addrspace(1) %out.addr, align 4
+  ret void
+}
+
+define void @__vecz_v4_add(ptr addrspace(1) %in, ptr addrspace(1) %out) #0 !codeplay_ca_vecz.derived !2 {
+entry:
+  %id = call i64 @__mux_get_global_id(i32 0)
+  %in.addr = getelementptr inbounds i32, ptr addrspace(1) %in, i64 %id
+  %x = load <4 x i32>, ptr addrspace(1) %in.addr, align 4
+  %out.addr = getelementptr inbounds i32, ptr addrspace(1) %out, i64 %id
+  store <4 x i32> %x, ptr addrspace(1) %out.addr, align 4
+  ret void
+}
+
+define void @add_barrier(ptr addrspace(1) %in, ptr addrspace(1) %out) #0 {
+entry:
+  %id = call i64 @__mux_get_global_id(i32 0)
+  %in.addr = getelementptr inbounds i32, ptr addrspace(1) %in, i64 %id
+  %x = load i32, ptr addrspace(1) %in.addr, align 4
+  call void @__mux_work_group_barrier(i32 0, i32 1, i32 272)
+  %out.addr = getelementptr inbounds i32, ptr addrspace(1) %out, i64 %id
+  store i32 %x, ptr addrspace(1) %out.addr, align 4
+  ret void
+}
+
+define void @add_local(ptr addrspace(1) %in, ptr addrspace(3) %tmp) #0 {
+entry:
+  %id = call i64 @__mux_get_global_id(i32 0)
+  %in.addr = getelementptr inbounds i32, ptr addrspace(1) %in, i64 %id
+  %x = load i32, ptr addrspace(1) %in.addr, align 4
+  store i32 %x, ptr addrspace(3) %tmp, align 4
+  ret void
+}
+
+declare i64 @__mux_get_global_id(i32)
+
+declare void @__mux_work_group_barrier(i32, i32, i32)
+
+attributes #0 = { "mux-kernel"="entry-point" }
+
+!0 = !{i32 4, i32 0, i32 0, i32 0}
+!1 = !{!0, ptr @__vecz_v4_add}
+!2 = !{!0, ptr @add}
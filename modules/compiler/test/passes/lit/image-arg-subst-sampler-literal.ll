@@ -0,0 +1,72 @@
+; Copyright (C) Codeplay Software Limited
+;
+; Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+; Exceptions; you may not use this file except in compliance with the License.
+; You may obtain a copy of the License at
+;
+;     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+;
+; Unless required by applicable law or agreed to in writing, software
+; distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+; WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+; License for the specific language governing permissions and limitations
+; under the License.
+;
+; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+; RUN: muxc --passes image-arg-subst,verify -S %s | FileCheck %s
+
+target triple = "spir64-unknown-unknown"
+target datalayout = "e-p:64:64:64-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+%opencl.image2d_ro_t = type opaque
+%opencl.sampler_t = type opaque
+
+; Sampler literals select the variant for their filter mode, and are passed as
+; constants.
+
+; CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP_TO_EDGE | CLK_FILTER_NEAREST
+; CHECK-LABEL: define spir_kernel void @nearest(
+; CHECK: call spir_func <4 x float> @_Z33__Codeplay_read_imagef_2d_nearestP5ImagejDv2_f(%struct.Image* %{{.*}}, i32 18, <2 x float> %coord)
+define spir_kernel void @nearest(%opencl.image2d_ro_t addrspace(1)* %img, <2 x float> %coord, <4 x float> addrspace(1)* %out) {
+  %s = call %opencl.sampler_t addrspace(2)* @__translate_sampler_initializer(i32 18)
+  %v = call spir_func <4 x float> @_Z11read_imagef14ocl_image2d_ro11ocl_samplerDv2_f(%opencl.image2d_ro_t addrspace(1)* %img, %opencl.sampler_t addrspace(2)* %s, <2 x float> %coord)
+  store <4 x float> %v, <4 x float> addrspace(1)* %out
+  ret void
+}
+
+; CLK_NORMALIZED_COORDS_TRUE | CLK_ADDRESS_CLAMP | CLK_FILTER_LINEAR
+; CHECK-LABEL: define spir_kernel void @linear(
+; CHECK: call spir_func <4 x float> @_Z32__Codeplay_read_imagef_2d_linearP5ImagejDv2_f(%struct.Image* %{{.*}}, i32 37, <2 x float> %coord)
+define spir_kernel void @linear(%opencl.image2d_ro_t addrspace(1)* %img, <2 x float> %coord, <4 x float> addrspace(1)* %out) {
+  %s = call %opencl.sampler_t addrspace(2)* @__translate_sampler_initializer(i32 37)
+  %v = call spir_func <4 x float> @_Z11read_imagef14ocl_image2d_ro11ocl_samplerDv2_f(%opencl.image2d_ro_t addrspace(1)* %img, %opencl.sampler_t addrspace(2)* %s, <2 x float> %coord)
+  store <4 x float> %v, <4 x float> addrspace(1)* %out
+  ret void
+}
+
+; CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_NONE | CLK_FILTER_NEAREST
+; CHECK-LABEL: define spir_kernel void @nearest_int(
+; CHECK: call spir_func <4 x float> @_Z33__Codeplay_read_imagef_2d_nearestP5ImagejDv2_i(%struct.Image* %{{.*}}, i32 16, <2 x i32> %coord)
+define spir_kernel void @nearest_int(%opencl.image2d_ro_t addrspace(1)* %img, <2 x i32> %coord, <4 x float> addrspace(1)* %out) {
+  %s = call %opencl.sampler_t addrspace(2)* @__translate_sampler_initializer(i32 16)
+  %v = call spir_func <4 x float> @_Z11read_imagef14ocl_image2d_ro11ocl_samplerDv2_i(%opencl.image2d_ro_t addrspace(1)* %img, %opencl.sampler_t addrspace(2)* %s, <2 x i32> %coord)
+  store <4 x float> %v, <4 x float> addrspace(1)* %out
+  ret void
+}
+
+; Samplers only known at runtime still call the generic variant.
+; CHECK-LABEL: define spir_kernel void @runtime(
+; CHECK: [[SAMPLER:%.*]] = ptrtoint %opencl.sampler_t addrspace(2)* %s to i32
+; CHECK: call spir_func <4 x float> @_Z25__Codeplay_read_imagef_2dP5ImagejDv2_f(%struct.Image* %{{.*}}, i32 [[SAMPLER]], <2 x float> %coord)
+define spir_kernel void @runtime(%opencl.image2d_ro_t addrspace(1)* %img, %opencl.sampler_t addrspace(2)* %s, <2 x float> %coord, <4 x float> addrspace(1)* %out) {
+  %v = call spir_func <4 x float> @_Z11read_imagef14ocl_image2d_ro11ocl_samplerDv2_f(%opencl.image2d_ro_t addrspace(1)* %img, %opencl.sampler_t addrspace(2)* %s, <2 x float> %coord)
+  store <4 x float> %v, <4 x float> addrspace(1)* %out
+  ret void
+}
+
+; CHECK-NOT: @_Z11read_imagef14ocl_image2d_ro11ocl_samplerDv2_f
+
+declare %opencl.sampler_t addrspace(2)* @__translate_sampler_initializer(i32)
+declare spir_func <4 x float> @_Z11read_imagef14ocl_image2d_ro11ocl_samplerDv2_f(%opencl.image2d_ro_t addrspace(1)*, %opencl.sampler_t addrspace(2)*, <2 x float>)
+declare spir_func <4 x float> @_Z11read_imagef14ocl_image2d_ro11ocl_samplerDv2_i(%opencl.image2d_ro_t addrspace(1)*, %opencl.sampler_t addrspace(2)*, <2 x i32>)
@@ -117,6 +117,24 @@ void setLocalMemoryUsage(llvm::Function &F, uint64_t LocalMemUsage);
 /// otherwise.
 multi_llvm::Optional<uint64_t> getLocalMemoryUsage(const llvm::Function &F);
 
+/// @brief Sets the size of the barrier struct for the given function.
+///
+/// The barrier struct holds the values that a work-item keeps live across
+/// barriers. For barrier structs with scalable members, this is the size for
+/// a vscale of one.
+///
+/// @param[in] F the function in which to add the attribute
+/// @param[in] BarrierStructSize the size of the barrier struct in bytes per
+/// work-item
+void setBarrierStructSize(llvm::Function &F, uint64_t BarrierStructSize);
+
+/// @brief Gets the size of the barrier struct for the given function.
+///
+/// @param[in] F Function from which to pull the attribute
+/// @return the size of the barrier struct in bytes per work-item if present,
+/// llvm::None otherwise.
+multi_llvm::Optional<uint64_t> getBarrierStructSize(const llvm::Function &F);
+
 /// @brief Sets information about a function's required DMA size as an
 /// attribute.
 ///
@@ -172,6 +190,20 @@ void setHasDegenerateSubgroups(llvm::Function &F);
 /// @param[in] F Function to check.
 bool hasDegenerateSubgroups(const llvm::Function &F);
 
+/// @brief Marks a kernel as being free of work-group synchronization.
+///
+/// Such a kernel has no barriers, no local memory and no sub-group
+/// operations, so its work-items may be partitioned arbitrarily between
+/// independent invocations covering disjoint ranges of local IDs.
+///
+/// @param[in] F Function in which to encode the information.
+void setIsBarrierFree(llvm::Function &F);
+
+/// @brief Returns whether the kernel is free of work-group synchronization.
+///
+/// @param[in] F Function to check.
+bool isBarrierFree(const llvm::Function &F);
+
 }  // namespace utils
 }  // namespace compiler
 
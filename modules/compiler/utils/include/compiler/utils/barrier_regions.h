@@ -22,6 +22,8 @@
 #define COMPILER_UTILS_HANDLE_BARRIER_REGIONS_H_INCLUDED
 
 #include <compiler/utils/attributes.h>
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/ADT/DenseSet.h>
 #include <llvm/ADT/SetVector.h>
 #include <llvm/ADT/SmallPtrSet.h>
@@ -272,6 +274,18 @@ class Barrier {
   ///        barrier, for instance casts and vector splats.
   void TidyLiveVariables();
 
+  /// @brief Find the barrier regions across which each live variable has to
+  /// be preserved in the barrier struct.
+  ///
+  /// Live variables whose sets of regions don't intersect are never live at
+  /// the same time, so they can share the same slot in the barrier struct.
+  ///
+  /// @param[out] live_regions the set of barrier regions (indexed from zero)
+  /// for each live variable. Live variables not stored by any region are left
+  /// out.
+  void FindLiveVariableRegions(
+      llvm::DenseMap<llvm::Value *, llvm::BitVector> &live_regions);
+
   /// @brief Pad the field types to an alignment by adding an int array if
   /// needed
   /// @param field_tys The vector of types representing the final structure
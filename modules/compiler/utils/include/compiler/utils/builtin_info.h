@@ -70,6 +70,8 @@ enum BaseBuiltinID {
   eMuxBuiltinGetGlobalLinearId,
   eMuxBuiltinGetLocalLinearId,
   eMuxBuiltinGetEnqueuedLocalSize,
+  eMuxBuiltinGetLocalRangeStart,
+  eMuxBuiltinGetLocalRangeEnd,
   // Synchronization builtins
   eMuxBuiltinMemBarrier,
   eMuxBuiltinSubGroupBarrier,
@@ -229,6 +231,8 @@ constexpr const char set_local_id[] = "__mux_set_local_id";
 constexpr const char set_sub_group_id[] = "__mux_set_sub_group_id";
 constexpr const char set_num_sub_groups[] = "__mux_set_num_sub_groups";
 constexpr const char set_max_sub_group_size[] = "__mux_set_max_sub_group_size";
+constexpr const char get_local_range_start[] = "__mux_get_local_range_start";
+constexpr const char get_local_range_end[] = "__mux_get_local_range_end";
 }  // namespace MuxBuiltins
 
 static inline llvm::Type *getPointerReturnPointeeTy(const llvm::Function &F,
@@ -720,6 +724,8 @@ class BIMuxInfoConcept {
   llvm::Function *defineGetLocalLinearId(llvm::Module &M);
   llvm::Function *defineGetGlobalLinearId(llvm::Module &M);
   llvm::Function *defineGetEnqueuedLocalSize(llvm::Module &M);
+  llvm::Function *defineGetLocalRangeStart(llvm::Module &M);
+  llvm::Function *defineGetLocalRangeEnd(llvm::Module &M);
   llvm::Function *defineMemBarrier(llvm::Function &F, unsigned ScopeIdx,
                                    unsigned SemanticsIdx);
   /// @brief Provides a default implementation for `__mux_dma_read_1D` and
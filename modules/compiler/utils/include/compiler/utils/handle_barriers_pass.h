@@ -48,6 +48,12 @@ struct HandleBarriersOptions {
   /// tail loops from wrapped vector kernels, even if the local work-group size
   /// is not known to be a multiple of the vectorization factor.
   bool ForceNoTail = false;
+  /// @brief Set to true if the pass should allow kernels free of barriers,
+  /// local memory and sub-group operations to execute only a sub-range of
+  /// their work-group, as given by `__mux_get_local_range_start` and
+  /// `__mux_get_local_range_end`. Such wrappers are marked with the
+  /// "mux-barrier-free" function attribute.
+  bool SplitBarrierFreeWorkGroups = false;
 };
 
 /// @brief The "handle barriers" pass.
@@ -75,7 +81,9 @@ class HandleBarriersPass final
  public:
   /// @brief Constructor.
   HandleBarriersPass(const HandleBarriersOptions &Options)
-      : IsDebug(Options.IsDebug), ForceNoTail(Options.ForceNoTail) {}
+      : IsDebug(Options.IsDebug),
+        ForceNoTail(Options.ForceNoTail),
+        SplitBarrierFreeWorkGroups(Options.SplitBarrierFreeWorkGroups) {}
 
   llvm::PreservedAnalyses run(llvm::Module &, llvm::ModuleAnalysisManager &);
 
@@ -110,6 +118,7 @@ class HandleBarriersPass final
 
   const bool IsDebug;
   const bool ForceNoTail;
+  const bool SplitBarrierFreeWorkGroups;
 };
 }  // namespace utils
 }  // namespace compiler
@@ -134,6 +134,23 @@ multi_llvm::Optional<uint64_t> getLocalMemoryUsage(const Function &F) {
                          : multi_llvm::None;
 }
 
+static constexpr const char *BarrierStructSizeAttrName =
+    "mux-barrier-struct-size";
+
+void setBarrierStructSize(Function &F, uint64_t BarrierStructSize) {
+  Attribute Attr = Attribute::get(F.getContext(), BarrierStructSizeAttrName,
+                                  itostr(BarrierStructSize));
+  F.addFnAttr(Attr);
+}
+
+multi_llvm::Optional<uint64_t> getBarrierStructSize(const Function &F) {
+  Attribute Attr = F.getFnAttribute(BarrierStructSizeAttrName);
+  auto Val = getStringFnAttrAsInt(Attr);
+  // Only return non-negative integers
+  return Val && Val >= 0 ? multi_llvm::Optional<uint64_t>(*Val)
+                         : multi_llvm::None;
+}
+
 static constexpr const char *DMAReqdSizeBytesAttrName = "mux-dma-reqd-size";
 
 void setDMAReqdSizeBytes(Function &F, uint32_t DMASizeBytes) {
@@ -199,5 +216,13 @@ bool hasDegenerateSubgroups(const Function &F) {
   return Attr.isValid();
 }
 
+static constexpr const char *MuxBarrierFreeAttrName = "mux-barrier-free";
+
+void setIsBarrierFree(Function &F) { F.addFnAttr(MuxBarrierFreeAttrName); }
+
+bool isBarrierFree(const Function &F) {
+  return F.hasFnAttribute(MuxBarrierFreeAttrName);
+}
+
 }  // namespace utils
 }  // namespace compiler
@@ -18,6 +18,7 @@
 #include <compiler/utils/builtin_info.h>
 #include <compiler/utils/metadata.h>
 #include <compiler/utils/pass_functions.h>
+#include <llvm/ADT/BitVector.h>
 #include <llvm/ADT/SetOperations.h>
 #include <llvm/ADT/SetVector.h>
 #include <llvm/ADT/SmallSet.h>
@@ -159,58 +160,71 @@ bool IsRematerializableBuiltinCall(Value *v, compiler::utils::BuiltinInfo &bi) {
   return false;
 }
 
-// It traces through instructions with a single Instruction operand, looking
-// for work item functions or function arguments.
-bool IsTrivialValue(Value *v, unsigned depth,
+// It traces through trivial instructions (casts, unary and binary operators,
+// GEPs and vector splats), looking for work item functions, function arguments
+// or constants. The budget limits the number of instructions that would have
+// to be rematerialized.
+bool IsTrivialValue(Value *v, unsigned &budget,
                     compiler::utils::BuiltinInfo &bi) {
-  while (depth--) {
-    auto *const I = dyn_cast<Instruction>(v);
-    if (!I || IsRematerializableBuiltinCall(v, bi)) {
-      return true;
-    }
+  auto *const I = dyn_cast<Instruction>(v);
+  if (!I) {
+    return true;
+  }
 
-    // Pass through a vector splat to the splatted value
-    if (auto *const shuffle = dyn_cast<ShuffleVectorInst>(I)) {
-      if (shuffle->isZeroEltSplat()) {
-        if (auto *const ins =
-                dyn_cast<InsertElementInst>(shuffle->getOperand(0))) {
-          if (auto *const src = dyn_cast<Instruction>(ins->getOperand(1))) {
-            v = src;
-            continue;
-          } else {
-            // Splat of a non-Instruction (i.e. an Argument)
-            return true;
-          }
-        }
+  if (budget == 0) {
+    return false;
+  }
+  --budget;
+
+  if (IsRematerializableBuiltinCall(v, bi)) {
+    return true;
+  }
+
+  // Pass through a vector splat to the splatted value
+  if (auto *const shuffle = dyn_cast<ShuffleVectorInst>(I)) {
+    if (shuffle->isZeroEltSplat()) {
+      if (auto *const ins =
+              dyn_cast<InsertElementInst>(shuffle->getOperand(0))) {
+        return IsTrivialValue(ins->getOperand(1), budget, bi);
       }
-      return false;
     }
+    return false;
+  }
+
+  // Consider only certain trivial operations
+  if (!I->isBinaryOp() && !I->isCast() && !I->isUnaryOp() &&
+      !isa<GetElementPtrInst>(I)) {
+    return false;
+  }
 
-    // Consider only certain trivial operations
-    if (!I->isBinaryOp() && !I->isCast() && !I->isUnaryOp()) {
+  // It's trivial if all of its operands are trivial as well.
+  for (auto *op : I->operand_values()) {
+    if (!IsTrivialValue(op, budget, bi)) {
       return false;
     }
+  }
+  return true;
+}
 
-    Value *chain = nullptr;
-    for (auto *op : I->operand_values()) {
-      if (auto *const opI = dyn_cast<Instruction>(op)) {
-        if (!chain) {
-          chain = opI;
-        } else if (chain != op) {
-          // It's non-trivial if it has more than one Instruction operand.
-          return false;
-        }
-      }
-    }
+// Binary operators on a single other barrier member, such as address
+// arithmetic, are cheap enough to recalculate from that member.
+template <typename SetT>
+bool IsCheapOperationOnMember(Value *v, const SetT &members) {
+  auto *const binop = dyn_cast<BinaryOperator>(v);
+  if (!binop) {
+    return false;
+  }
 
-    // It's trivial if it didn't have any operands that were instructions.
-    if (!chain) {
-      return true;
+  unsigned num_members = 0;
+  for (auto *op : binop->operand_values()) {
+    if (isa<Instruction>(op)) {
+      if (!members.count(op)) {
+        return false;
+      }
+      ++num_members;
     }
-
-    v = chain;
   }
-  return false;
+  return num_members == 1;
 }
 
 // GEPs typically have a low cost, allow up to 1 non-trivial operand
@@ -629,9 +643,13 @@ void compiler::utils::Barrier::TidyLiveVariables() {
   // turn out to be redundant, we can remove them again.
   whole_live_variables_set_.set_union(redirects);
 
-  // Remove work item calls and casts of arguments or other barrier members.
+  // Remove work item calls and cheap calculations on arguments, and casts of
+  // or cheap operations on other barrier members. These get rematerialized
+  // wherever they are used instead.
   for (auto v : whole_live_variables_set_) {
-    if (IsTrivialValue(v, 4u, *bi_)) {
+    unsigned budget = 4u;
+    if (IsTrivialValue(v, budget, *bi_) ||
+        IsCheapOperationOnMember(v, whole_live_variables_set_)) {
       removals.push_back(v);
     } else if (auto *cast = dyn_cast<CastInst>(v)) {
       Value *op = cast->getOperand(0);
@@ -643,6 +661,94 @@ void compiler::utils::Barrier::TidyLiveVariables() {
   whole_live_variables_set_.set_subtract(removals);
 }
 
+/// @brief Find the barrier regions across which each live variable has to be
+/// preserved in the barrier struct.
+void compiler::utils::Barrier::FindLiveVariableRegions(
+    DenseMap<Value *, BitVector> &live_regions) {
+  unsigned const num_regions = barrier_graph.size();
+
+  // Find the regions reachable from each region, including itself.
+  SmallVector<BitVector, 8> reachable(num_regions, BitVector(num_regions));
+  for (unsigned i = 0; i != num_regions; ++i) {
+    SmallVector<unsigned, 8> worklist{i};
+    reachable[i].set(i);
+    while (!worklist.empty()) {
+      auto &region = barrier_graph[worklist.pop_back_val()];
+      for (auto *BB : region.barrier_blocks) {
+        unsigned const succ =
+            barrier_id_map_[BB->getSingleSuccessor()] - kBarrier_FirstID;
+        if (!reachable[i].test(succ)) {
+          reachable[i].set(succ);
+          worklist.push_back(succ);
+        }
+      }
+    }
+  }
+
+  // Find the regions that store and the regions that load each live variable.
+  DenseMap<Value *, BitVector> defs;
+  DenseMap<Value *, BitVector> uses;
+  for (unsigned i = 0; i != num_regions; ++i) {
+    auto &region = barrier_graph[i];
+    for (auto *v : region.defs) {
+      if (whole_live_variables_set_.count(v)) {
+        auto &bits = defs[v];
+        bits.resize(num_regions);
+        bits.set(i);
+      }
+    }
+
+    // Values that are not in the barrier get rematerialized from their
+    // operands, so those get loaded in this region instead.
+    SmallVector<Value *, 16> worklist(region.uses_ext.begin(),
+                                      region.uses_ext.end());
+    worklist.append(region.uses_int.begin(), region.uses_int.end());
+    SmallPtrSet<Value *, 16> visited;
+    while (!worklist.empty()) {
+      Value *const v = worklist.pop_back_val();
+      if (!visited.insert(v).second) {
+        continue;
+      }
+
+      if (whole_live_variables_set_.count(v)) {
+        auto &bits = uses[v];
+        bits.resize(num_regions);
+        bits.set(i);
+      } else if (auto *const I = dyn_cast<Instruction>(v)) {
+        for (auto *op : I->operand_values()) {
+          if (isa<Instruction>(op)) {
+            worklist.push_back(op);
+          }
+        }
+      }
+    }
+  }
+
+  // A variable is live in every region that stores it, and in every region on
+  // a path from a region that stores it to a region that loads it.
+  for (auto *v : whole_live_variables_set_) {
+    auto def_it = defs.find(v);
+    if (def_it == defs.end()) {
+      continue;
+    }
+
+    BitVector live(num_regions);
+    auto use_it = uses.find(v);
+    if (use_it != uses.end()) {
+      for (unsigned d : def_it->second.set_bits()) {
+        live |= reachable[d];
+      }
+      for (unsigned i = 0; i != num_regions; ++i) {
+        if (live.test(i) && !reachable[i].anyCommon(use_it->second)) {
+          live.reset(i);
+        }
+      }
+    }
+    live |= def_it->second;
+    live_regions[v] = std::move(live);
+  }
+}
+
 /// @brief Pad the field types to an alignment by adding an int array if
 /// needed
 /// @param field_tys The vector of types representing the final structure
@@ -729,26 +835,85 @@ void compiler::utils::Barrier::MakeLiveVariableMemType() {
                      return lhs.alignment > rhs.alignment;
                    });
 
-  // Deal with non-scalable members first
-  unsigned offset = 0;
+  // Find the barrier regions across which each member has to be preserved,
+  // so that members that are never live at the same time can share a slot.
+  // Sharing is disabled when debugging, so every variable keeps its own slot.
+  DenseMap<Value *, BitVector> live_regions;
+  if (!is_debug_) {
+    FindLiveVariableRegions(live_regions);
+  }
+
+  struct slot_info {
+    Type *type;
+    unsigned alignment;
+    unsigned size;
+    /// @brief the regions the members of this slot are live across, or empty
+    /// if the slot can not be shared.
+    BitVector live;
+    SmallVector<Value *, 2> values;
+  };
+
+  // Deal with non-scalable members first, assigning each of them to the first
+  // slot that it doesn't interfere with. Allocas always get their own slot,
+  // since their address might be used anywhere.
+  SmallVector<slot_info, 16> slots;
   for (auto &member : barrier_members) {
     if (isa<ScalableVectorType>(member.type)) {
       continue;
     }
 
-    offset = PadTypeToAlignment(field_tys, offset, member.alignment);
+    auto live_it = live_regions.find(member.value);
+    bool const can_share =
+        !isa<AllocaInst>(member.value) && live_it != live_regions.end();
+
+    slot_info *slot = nullptr;
+    if (can_share) {
+      for (auto &s : slots) {
+        if (!s.live.empty() && member.alignment <= s.alignment &&
+            !s.live.anyCommon(live_it->second)) {
+          slot = &s;
+          break;
+        }
+      }
+    }
+
+    if (!slot) {
+      slots.push_back(
+          {member.type, member.alignment, member.size, BitVector(), {}});
+      slot = &slots.back();
+    } else if (member.size > slot->size) {
+      // The slot has to be big enough for its largest member.
+      slot->type = member.type;
+      slot->size = member.size;
+    }
+
+    if (can_share) {
+      if (slot->live.empty()) {
+        slot->live = live_it->second;
+      } else {
+        slot->live |= live_it->second;
+      }
+    }
+    slot->values.push_back(member.value);
+  }
 
-    // Check if the alloca has a debug info source variable attached. If
-    // so record this and the matching byte offset into the struct.
-    auto DbgIntrinsics = FindDbgAddrUses(member.value);
-    for (auto DII : DbgIntrinsics) {
-      if (auto dbgDeclare = dyn_cast<DbgDeclareInst>(DII)) {
-        debug_intrinsics_.push_back(std::make_pair(dbgDeclare, offset));
+  unsigned offset = 0;
+  for (auto &slot : slots) {
+    offset = PadTypeToAlignment(field_tys, offset, slot.alignment);
+
+    for (auto *value : slot.values) {
+      // Check if the alloca has a debug info source variable attached. If
+      // so record this and the matching byte offset into the struct.
+      auto DbgIntrinsics = FindDbgAddrUses(value);
+      for (auto DII : DbgIntrinsics) {
+        if (auto dbgDeclare = dyn_cast<DbgDeclareInst>(DII)) {
+          debug_intrinsics_.push_back(std::make_pair(dbgDeclare, offset));
+        }
       }
+      live_variable_index_map_[value] = field_tys.size();
     }
-    offset += member.size;
-    live_variable_index_map_[member.value] = field_tys.size();
-    field_tys.push_back(member.type);
+    offset += slot.size;
+    field_tys.push_back(slot.type);
   }
   // Pad the end of the struct to the max alignment as we are creating an
   // array
@@ -996,6 +1161,15 @@ Function *compiler::utils::Barrier::GenerateNewKernel(BarrierRegion &region) {
         gep = GetElementPtrInst::Create(
             barrier.live_var_mem_ty_, barrier_struct, live_variable_info_idxs,
             Twine("live_gep_") + live->getName(), insert_point);
+
+        // Live variables that share a slot might not have the slot's type.
+        if (barrier.live_var_mem_ty_->getElementType(field_index) != data_ty) {
+          IRBuilder<> B(insert_point);
+          gep = B.CreatePointerCast(
+              gep, PointerType::get(data_ty,
+                                    cast<PointerType>(barrier_struct->getType())
+                                        ->getAddressSpace()));
+        }
       } else {
         auto field_it = barrier.live_variable_scalables_map_.find(live);
         if (field_it == barrier.live_variable_scalables_map_.end()) {
@@ -77,6 +77,9 @@ BuiltinID BuiltinInfo::identifyMuxBuiltin(Function const &F) const {
           .Case(MuxBuiltins::get_local_linear_id, eMuxBuiltinGetLocalLinearId)
           .Case(MuxBuiltins::get_enqueued_local_size,
                 eMuxBuiltinGetEnqueuedLocalSize)
+          .Case(MuxBuiltins::get_local_range_start,
+                eMuxBuiltinGetLocalRangeStart)
+          .Case(MuxBuiltins::get_local_range_end, eMuxBuiltinGetLocalRangeEnd)
           .Case(MuxBuiltins::work_group_barrier, eMuxBuiltinWorkGroupBarrier)
           .Case(MuxBuiltins::sub_group_barrier, eMuxBuiltinSubGroupBarrier)
           .Case(MuxBuiltins::mem_barrier, eMuxBuiltinMemBarrier)
@@ -257,6 +260,8 @@ Builtin BuiltinInfo::analyzeBuiltin(Function const &F) const {
     case eMuxBuiltinGetGlobalLinearId:
     case eMuxBuiltinGetLocalLinearId:
     case eMuxBuiltinGetGlobalId:
+    case eMuxBuiltinGetLocalRangeStart:
+    case eMuxBuiltinGetLocalRangeEnd:
       Properties = eBuiltinPropertyWorkItem | eBuiltinPropertyRematerializable;
       break;
     case eMuxBuiltinGetLocalId:
@@ -485,6 +490,10 @@ StringRef BuiltinInfo::getMuxBuiltinName(BuiltinID ID) {
       return MuxBuiltins::get_local_linear_id;
     case eMuxBuiltinGetEnqueuedLocalSize:
       return MuxBuiltins::get_enqueued_local_size;
+    case eMuxBuiltinGetLocalRangeStart:
+      return MuxBuiltins::get_local_range_start;
+    case eMuxBuiltinGetLocalRangeEnd:
+      return MuxBuiltins::get_local_range_end;
     case eMuxBuiltinMemBarrier:
       return MuxBuiltins::mem_barrier;
     case eMuxBuiltinWorkGroupBarrier:
@@ -14,9 +14,11 @@
 //
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <compiler/utils/address_spaces.h>
 #include <compiler/utils/attributes.h>
 #include <compiler/utils/barrier_regions.h>
 #include <compiler/utils/builtin_info.h>
+#include <compiler/utils/group_collective_helpers.h>
 #include <compiler/utils/handle_barriers_pass.h>
 #include <compiler/utils/pass_functions.h>
 #include <compiler/utils/vectorization_factor.h>
@@ -202,6 +204,18 @@ struct ScheduleGenerator {
   Value *peel = nullptr;
   bool emitTail = true;
   bool isVectorPredicated = false;
+  // When set, the work-item loops only cover the half-open ranges of local IDs
+  // given by the range values below, rather than the whole work-group. The y
+  // and z ranges are indexed by dimension; the x range is split into the part
+  // covered by the main loop and the part covered by the tail loop, the latter
+  // being relative to mainLoopLimit.
+  bool splitRange = false;
+  Value *localRangeStart[3] = {nullptr, nullptr, nullptr};
+  Value *localRangeEnd[3] = {nullptr, nullptr, nullptr};
+  Value *mainRangeStart = nullptr;
+  Value *mainRangeEnd = nullptr;
+  Value *tailRangeStart = nullptr;
+  Value *tailRangeEnd = nullptr;
   bool wrapperHasMain = false;
   bool wrapperHasTail = false;
 
@@ -368,16 +382,28 @@ struct ScheduleGenerator {
     // the vector loop is skipped.
     PHINode *subgroupMergePhi = nullptr;
 
+    // The bounds of the loops in each dimension.
+    Value *const startDim2 = splitRange ? localRangeStart[workItemDim2] : zero;
+    Value *const endDim2 =
+        splitRange ? localRangeEnd[workItemDim2] : localSizeDim[workItemDim2];
+    Value *const startDim1 = splitRange ? localRangeStart[workItemDim1] : zero;
+    Value *const endDim1 =
+        splitRange ? localRangeEnd[workItemDim1] : localSizeDim[workItemDim1];
+    Value *const mainStart = splitRange ? mainRangeStart : zero;
+    Value *const mainEnd = splitRange ? mainRangeEnd : mainLoopLimit;
+    Value *const tailStart = splitRange ? tailRangeStart : zero;
+    Value *const tailEnd = splitRange ? tailRangeEnd : peel;
+
     // If we are emitting a tail, we might need to bypass the vector loop (if
-    // the local size is less than the vector width).
-    if (emitTail) {
-      if (auto *const loopLimitConst = dyn_cast<Constant>(mainLoopLimit)) {
-        if (loopLimitConst->isZeroValue()) {
-          // No vector iterations at all!
-          mainPreheaderBB = nullptr;
-          mainExitBB = block;
-        }
-      } else {
+    // the local size is less than the vector width). If we are only executing
+    // a sub-range of the work-group, the range may not cover the vector loop.
+    if (emitTail || splitRange) {
+      auto *const loopLimitConst = dyn_cast<Constant>(mainLoopLimit);
+      if (loopLimitConst && loopLimitConst->isZeroValue()) {
+        // No vector iterations at all!
+        mainPreheaderBB = nullptr;
+        mainExitBB = block;
+      } else if (!loopLimitConst || splitRange) {
         mainPreheaderBB = BasicBlock::Create(
             context, "ca_work_item_x_vector_preheader", func);
 
@@ -390,7 +416,9 @@ struct ScheduleGenerator {
         subgroupMergePhi->addIncoming(i32Zero, block);
 
         auto needMain =
-            new ICmpInst(*block, CmpInst::ICMP_NE, zero, mainLoopLimit);
+            splitRange
+                ? new ICmpInst(*block, CmpInst::ICMP_ULT, mainStart, mainEnd)
+                : new ICmpInst(*block, CmpInst::ICMP_NE, zero, mainLoopLimit);
 
         BranchInst::Create(mainPreheaderBB, mainExitBB, needMain, block);
       }
@@ -407,8 +435,8 @@ struct ScheduleGenerator {
 
       // looping through num groups in the third (outermost) dimension
       mainExitBB = compiler::utils::createLoop(
-          mainPreheaderBB, mainExitBB, zero, localSizeDim[workItemDim2],
-          subgroupIVs2, outer_opts,
+          mainPreheaderBB, mainExitBB, startDim2, endDim2, subgroupIVs2,
+          outer_opts,
           [&](BasicBlock *block, Value *dim_2, ArrayRef<Value *> ivs2,
               MutableArrayRef<Value *> ivsNext2) -> BasicBlock * {
             // if we need to set the local id, do so here.
@@ -419,8 +447,7 @@ struct ScheduleGenerator {
 
             // looping through num groups in the second dimension
             BasicBlock *exit1 = compiler::utils::createLoop(
-                block, nullptr, zero, localSizeDim[workItemDim1], ivs2,
-                outer_opts,
+                block, nullptr, startDim1, endDim1, ivs2, outer_opts,
                 [&](BasicBlock *block, Value *dim_1, ArrayRef<Value *> ivs1,
                     MutableArrayRef<Value *> ivsNext1) -> BasicBlock * {
                   IRBuilder<> ir(block);
@@ -437,7 +464,7 @@ struct ScheduleGenerator {
                   inner_opts.indexInc = VF;
                   inner_opts.attemptUnroll = true;
                   BasicBlock *exit0 = compiler::utils::createLoop(
-                      block, nullptr, zero, mainLoopLimit, ivs1, inner_opts,
+                      block, nullptr, mainStart, mainEnd, ivs1, inner_opts,
                       [&](BasicBlock *block, Value *dim_0,
                           ArrayRef<Value *> ivs0,
                           MutableArrayRef<Value *> ivsNext0) -> BasicBlock * {
@@ -482,13 +509,12 @@ struct ScheduleGenerator {
 
     if (emitTail && peel) {
       // We might need to bypass the tail loop.
-      if (auto *const peelConst = dyn_cast<Constant>(peel)) {
-        if (peelConst->isZeroValue()) {
-          // No tail iterations at all!
-          tailPreheaderBB = nullptr;
-          tailExitBB = mainExitBB;
-        }
-      } else {
+      auto *const peelConst = dyn_cast<Constant>(peel);
+      if (peelConst && peelConst->isZeroValue()) {
+        // No tail iterations at all!
+        tailPreheaderBB = nullptr;
+        tailExitBB = mainExitBB;
+      } else if (!peelConst || splitRange) {
         tailPreheaderBB = BasicBlock::Create(
             context, "ca_work_item_x_scalar_preheader", func);
 
@@ -498,7 +524,10 @@ struct ScheduleGenerator {
         tailExitBB->moveAfter(tailPreheaderBB);
 
         auto needPeeling =
-            new ICmpInst(*mainExitBB, CmpInst::ICMP_NE, zero, peel);
+            splitRange
+                ? new ICmpInst(*mainExitBB, CmpInst::ICMP_ULT, tailStart,
+                               tailEnd)
+                : new ICmpInst(*mainExitBB, CmpInst::ICMP_NE, zero, peel);
 
         BranchInst::Create(tailPreheaderBB, tailExitBB, needPeeling,
                            mainExitBB);
@@ -522,8 +551,8 @@ struct ScheduleGenerator {
 
       // looping through num groups in the third (outermost) dimension
       tailExitBB = compiler::utils::createLoop(
-          tailPreheaderBB, tailExitBB, zero, localSizeDim[workItemDim2],
-          subgroupIVs2, outer_opts,
+          tailPreheaderBB, tailExitBB, startDim2, endDim2, subgroupIVs2,
+          outer_opts,
           [&](BasicBlock *block, Value *dim_2, ArrayRef<Value *> ivs2,
               MutableArrayRef<Value *> ivsNext2) -> BasicBlock * {
             // set the local id
@@ -534,8 +563,7 @@ struct ScheduleGenerator {
 
             // looping through num groups in the second dimension
             BasicBlock *exit1 = compiler::utils::createLoop(
-                block, nullptr, zero, localSizeDim[workItemDim1], ivs2,
-                outer_opts,
+                block, nullptr, startDim1, endDim1, ivs2, outer_opts,
                 [&](BasicBlock *block, Value *dim_1, ArrayRef<Value *> ivs1,
                     MutableArrayRef<Value *> ivsNext1) -> BasicBlock * {
                   IRBuilder<> ir(block);
@@ -548,7 +576,7 @@ struct ScheduleGenerator {
                   inner_opts.disableVectorize = true;
 
                   BasicBlock *exit0 = compiler::utils::createLoop(
-                      block, nullptr, zero, peel, ivs1, inner_opts,
+                      block, nullptr, tailStart, tailEnd, ivs1, inner_opts,
                       [&](BasicBlock *block, Value *dim_0,
                           ArrayRef<Value *> ivs0,
                           MutableArrayRef<Value *> ivsNext0) -> BasicBlock * {
@@ -914,6 +942,83 @@ void setUpLiveVarsAlloca(compiler::utils::BarrierWithLiveVars &barrier,
   }
 }
 
+/// @brief Returns true if the work-items of the given barrier-split kernel
+/// can be executed in any partition of the work-group.
+///
+/// This is the case when the kernel contains no barriers, has no live
+/// variables, doesn't use local memory and doesn't make use of any sub-group
+/// or work-group collective operations.
+bool isBarrierFreeKernel(compiler::utils::BarrierWithLiveVars &barrier,
+                         compiler::utils::BuiltinInfo &BI) {
+  if (barrier.getNumSubkernels() != 1 || barrier.hasLiveVars() ||
+      barrier.getVFInfo().IsVectorPredicated) {
+    return false;
+  }
+
+  auto const schedule = barrier.getSchedule(compiler::utils::kBarrier_FirstID);
+  if (schedule != compiler::utils::BarrierSchedule::Unordered &&
+      schedule != compiler::utils::BarrierSchedule::ScalarTail) {
+    return false;
+  }
+
+  auto isLocalPtr = [](Type *Ty) {
+    return Ty->isPointerTy() &&
+           Ty->getPointerAddressSpace() == compiler::utils::AddressSpace::Local;
+  };
+
+  Function &F = barrier.getFunc();
+  if (any_of(F.args(), [&](Argument &A) { return isLocalPtr(A.getType()); })) {
+    return false;
+  }
+
+  // Be conservative, and bail out if any local memory is present in the
+  // module at all.
+  if (any_of(F.getParent()->globals(),
+             [&](GlobalVariable &GV) { return isLocalPtr(GV.getType()); })) {
+    return false;
+  }
+
+  SmallPtrSet<Function *, 8> Visited;
+  SmallVector<Function *, 8> Worklist = {&F};
+  while (!Worklist.empty()) {
+    auto *const Fn = Worklist.pop_back_val();
+    if (!Visited.insert(Fn).second) {
+      continue;
+    }
+    for (auto &BB : *Fn) {
+      for (auto &I : BB) {
+        auto *const CI = dyn_cast<CallInst>(&I);
+        if (!CI) {
+          continue;
+        }
+        auto *const Callee = CI->getCalledFunction();
+        if (!Callee) {
+          // We can't see through indirect calls.
+          return false;
+        }
+        switch (BI.analyzeBuiltin(*Callee).ID) {
+          default:
+            break;
+          case compiler::utils::eMuxBuiltinGetSubGroupId:
+          case compiler::utils::eMuxBuiltinGetNumSubGroups:
+          case compiler::utils::eMuxBuiltinGetMaxSubGroupSize:
+          case compiler::utils::eMuxBuiltinSubGroupBarrier:
+          case compiler::utils::eMuxBuiltinWorkGroupBarrier:
+            return false;
+        }
+        if (compiler::utils::isGroupCollective(Callee)) {
+          return false;
+        }
+        if (!Callee->isDeclaration()) {
+          Worklist.push_back(Callee);
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
 }  // namespace
 
 Function *compiler::utils::HandleBarriersPass::makeWrapperFunction(
@@ -1090,6 +1195,72 @@ Function *compiler::utils::HandleBarriersPass::makeWrapperFunction(
                         peel, "live_variables_peel", IsDebug);
   }
 
+  // Barrier-free kernels may be asked to execute only a sub-range of their
+  // work-group, so that the work-group can be shared between several threads.
+  bool const splitRange =
+      SplitBarrierFreeWorkGroups && isBarrierFreeKernel(barrierMain, BI) &&
+      (!emitTail || isBarrierFreeKernel(*barrierTail, BI));
+  Value *localRangeStart[3] = {nullptr, nullptr, nullptr};
+  Value *localRangeEnd[3] = {nullptr, nullptr, nullptr};
+  Value *mainRangeStart = nullptr;
+  Value *mainRangeEnd = nullptr;
+  Value *tailRangeStart = nullptr;
+  Value *tailRangeEnd = nullptr;
+  Value *rangeIsEmpty = nullptr;
+  if (splitRange) {
+    auto *const getRangeStart =
+        BI.getOrDeclareMuxBuiltin(eMuxBuiltinGetLocalRangeStart, M);
+    auto *const getRangeEnd =
+        BI.getOrDeclareMuxBuiltin(eMuxBuiltinGetLocalRangeEnd, M);
+    assert(getRangeStart && getRangeEnd &&
+           "Missing __mux_get_local_range_start/end");
+    for (auto i = 0; i < 3; i++) {
+      auto *const start =
+          entryIR.CreateCall(getRangeStart, entryIR.getInt32(i), "range.start");
+      start->setCallingConv(getRangeStart->getCallingConv());
+      auto *const end =
+          entryIR.CreateCall(getRangeEnd, entryIR.getInt32(i), "range.end");
+      end->setCallingConv(getRangeEnd->getCallingConv());
+      localRangeStart[i] = start;
+      localRangeEnd[i] = end;
+      auto *const isEmpty = entryIR.CreateICmpUGE(start, end);
+      rangeIsEmpty =
+          rangeIsEmpty ? entryIR.CreateOr(rangeIsEmpty, isEmpty) : isEmpty;
+    }
+
+    // The vector loop can only start and end on multiples of the vector
+    // width, so round the range in the first dimension up to the next
+    // multiple, leaving the scalar tail to execute any work-items beyond the
+    // main loop limit.
+    auto *const vfMinus1 =
+        entryIR.CreateSub(VF, ConstantInt::get(VF->getType(), 1));
+    auto roundUpToVF = [&](Value *V) -> Value * {
+      if (auto *const VFConst = dyn_cast<ConstantInt>(VF)) {
+        if (VFConst->isOne()) {
+          return V;
+        }
+      }
+      return entryIR.CreateMul(
+          entryIR.CreateUDiv(entryIR.CreateAdd(V, vfMinus1), VF), VF);
+    };
+    auto *const start0 = localRangeStart[workItemDim0];
+    auto *const end0 = localRangeEnd[workItemDim0];
+    mainRangeStart = entryIR.CreateBinaryIntrinsic(
+        Intrinsic::umin, roundUpToVF(start0), mainLoopLimit, nullptr,
+        "main.start");
+    mainRangeEnd = entryIR.CreateBinaryIntrinsic(
+        Intrinsic::umin, roundUpToVF(end0), mainLoopLimit, nullptr,
+        "main.end");
+    if (emitTail) {
+      tailRangeStart = entryIR.CreateSub(
+          entryIR.CreateBinaryIntrinsic(Intrinsic::umax, start0, mainLoopLimit),
+          mainLoopLimit, "tail.start");
+      tailRangeEnd = entryIR.CreateSub(
+          entryIR.CreateBinaryIntrinsic(Intrinsic::umax, end0, mainLoopLimit),
+          mainLoopLimit, "tail.end");
+    }
+  }
+
   // next means next barrier id. This variable is uninitialized to begin with,
   // and is set by the first pass below
   IntegerType *index_type = i32Ty;
@@ -1118,6 +1289,15 @@ Function *compiler::utils::HandleBarriersPass::makeWrapperFunction(
   schedule.emitTail = emitTail;
   schedule.isVectorPredicated = isVectorPredicated;
   schedule.peel = peel;
+  schedule.splitRange = splitRange;
+  std::copy(std::begin(localRangeStart), std::end(localRangeStart),
+            std::begin(schedule.localRangeStart));
+  std::copy(std::begin(localRangeEnd), std::end(localRangeEnd),
+            std::begin(schedule.localRangeEnd));
+  schedule.mainRangeStart = mainRangeStart;
+  schedule.mainRangeEnd = mainRangeEnd;
+  schedule.tailRangeStart = tailRangeStart;
+  schedule.tailRangeEnd = tailRangeEnd;
 
   // Make call instruction for first new kernel. It follows wrapper function's
   // parameters.
@@ -1125,8 +1305,14 @@ Function *compiler::utils::HandleBarriersPass::makeWrapperFunction(
     schedule.args.push_back(&arg);
   }
 
-  // Branch directly into the first basic block.
-  entryIR.CreateBr(bbs[kBarrier_FirstID]);
+  if (rangeIsEmpty) {
+    // Skip straight to the exit if there are no work-items to execute.
+    entryIR.CreateCondBr(rangeIsEmpty, bbs[kBarrier_EndID],
+                         bbs[kBarrier_FirstID]);
+  } else {
+    // Branch directly into the first basic block.
+    entryIR.CreateBr(bbs[kBarrier_FirstID]);
+  }
 
   for (unsigned i = kBarrier_EndID; i <= num_blocks; i++) {
     // Keep it linear
@@ -1279,6 +1465,27 @@ Function *compiler::utils::HandleBarriersPass::makeWrapperFunction(
 
   encodeWrapperFnMetadata(*new_wrapper, mainInfo, tailInfo);
 
+  if (splitRange) {
+    setIsBarrierFree(*new_wrapper);
+  }
+
+  // Report the size of the live variables each work-item keeps across
+  // barriers. The main and tail kernels each have their own barrier struct,
+  // but any given work-item only uses one of them.
+  uint64_t barrierStructSize = 0;
+  if (barrierMain.hasLiveVars()) {
+    barrierStructSize = barrierMain.getLiveVarMemSizeFixed() +
+                        barrierMain.getLiveVarMemSizeScalable();
+  }
+  if (emitTail && barrierTail->hasLiveVars()) {
+    barrierStructSize = std::max<uint64_t>(
+        barrierStructSize, barrierTail->getLiveVarMemSizeFixed() +
+                               barrierTail->getLiveVarMemSizeScalable());
+  }
+  if (barrierStructSize) {
+    setBarrierStructSize(*new_wrapper, barrierStructSize);
+  }
+
   // The subkernels can be marked as internal since its external uses have been
   // superceded by this wrapper. This will help it get DCE'd once inlined. Any
   // existing calls to this subkernel (e.g., another kernel calling this
@@ -36,6 +36,7 @@
 #include <compiler/utils/mangling.h>
 #include <llvm/ADT/DenseSet.h>
 #include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringMap.h>
 #include <llvm/ADT/StringSet.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/Support/Error.h>
@@ -95,6 +96,12 @@ const StringSet<> DeferredBuiltins = {
 };
 
 bool isDeferredBuiltin(Function &F) {
+  // This is queried for every call in every builtin we clone so reject the
+  // common case before paying for demangling. Every deferred builtin's
+  // mangled name contains its base name.
+  if (!F.getName().contains("sub_group")) {
+    return false;
+  }
   compiler::utils::NameMangler Mangler(&F.getContext(), F.getParent());
 
   SmallVector<Type *, 4> Types;
@@ -151,24 +158,34 @@ class GlobalVarMaterializer final : public ValueMaterializer {
 /// corresponding module types
 void compiler::utils::LinkBuiltinsPass::cloneStructs(
     Module &M, Module &BuiltinsModule, compiler::utils::StructMap &Map) {
-  for (auto *StructTy : M.getIdentifiedStructTypes()) {
-    auto StructName = StructTy->getName();
-
-    for (auto *BuiltinStructTy : BuiltinsModule.getIdentifiedStructTypes()) {
-      auto BuiltinStructName = BuiltinStructTy->getName();
-
-      const char *Suffix = ".0123456789";
+  const auto StructTys = M.getIdentifiedStructTypes();
+  if (StructTys.empty()) {
+    return;
+  }
 
-      // check if the names match (minus the suffix LLVM sometimes adds to
-      // struct types to differentiate between them)
-      if (StructName.rtrim(Suffix).equals(BuiltinStructName.rtrim(Suffix))) {
-        if (StructTy->isOpaque() && !BuiltinStructTy->isOpaque()) {
-          StructTy->setBody(BuiltinStructTy->elements(),
-                            BuiltinStructTy->isPacked());
-        }
+  // Finding the builtins module's struct types walks every function in it,
+  // including those materialized by previous links, so only do it once and
+  // group the types by name (minus the suffix LLVM sometimes adds to struct
+  // types to differentiate between them).
+  const char *Suffix = ".0123456789";
+  StringMap<SmallVector<StructType *, 1>> BuiltinStructTys;
+  for (auto *BuiltinStructTy : BuiltinsModule.getIdentifiedStructTypes()) {
+    BuiltinStructTys[BuiltinStructTy->getName().rtrim(Suffix)].push_back(
+        BuiltinStructTy);
+  }
 
-        Map[BuiltinStructTy] = StructTy;
+  for (auto *StructTy : StructTys) {
+    auto Found = BuiltinStructTys.find(StructTy->getName().rtrim(Suffix));
+    if (Found == BuiltinStructTys.end()) {
+      continue;
+    }
+    for (auto *BuiltinStructTy : Found->second) {
+      if (StructTy->isOpaque() && !BuiltinStructTy->isOpaque()) {
+        StructTy->setBody(BuiltinStructTy->elements(),
+                          BuiltinStructTy->isPacked());
       }
+
+      Map[BuiltinStructTy] = StructTy;
     }
   }
 }
@@ -418,6 +418,47 @@ Function *BIMuxInfoConcept::defineGetEnqueuedLocalSize(Module &M) {
   return F;
 }
 
+Function *BIMuxInfoConcept::defineGetLocalRangeStart(Module &M) {
+  Function *F = M.getFunction(
+      BuiltinInfo::getMuxBuiltinName(eMuxBuiltinGetLocalRangeStart));
+  assert(F);
+  setDefaultBuiltinAttributes(*F);
+  F->setLinkage(GlobalValue::InternalLinkage);
+
+  IRBuilder<> B(BasicBlock::Create(M.getContext(), "", F));
+
+  // By default each invocation of a kernel executes the whole work-group, so
+  // the range of local IDs always starts at zero.
+  B.CreateRet(ConstantInt::get(F->getReturnType(), 0));
+  return F;
+}
+
+Function *BIMuxInfoConcept::defineGetLocalRangeEnd(Module &M) {
+  Function *F = M.getFunction(
+      BuiltinInfo::getMuxBuiltinName(eMuxBuiltinGetLocalRangeEnd));
+  assert(F);
+  setDefaultBuiltinAttributes(*F);
+  F->setLinkage(GlobalValue::InternalLinkage);
+
+  auto *const MuxGetLocalSizeFn =
+      getOrDeclareMuxBuiltin(eMuxBuiltinGetLocalSize, M);
+  assert(MuxGetLocalSizeFn);
+
+  IRBuilder<> B(BasicBlock::Create(M.getContext(), "", F));
+
+  // Pass on all arguments through to dependent builtins. We expect that each
+  // function has identical prototypes, regardless of whether scheduling
+  // parameters have been added
+  SmallVector<Value *, 4> Args(make_pointer_range(F->args()));
+
+  // By default each invocation of a kernel executes the whole work-group, so
+  // get_local_range_end(x) == get_local_size(x).
+  auto *const GetLocalSize = createCallHelper(B, *MuxGetLocalSizeFn, Args);
+
+  B.CreateRet(GetLocalSize);
+  return F;
+}
+
 Function *BIMuxInfoConcept::defineMemBarrier(Function &F, unsigned,
                                              unsigned SemanticsIdx) {
   // FIXME: We're ignoring some operands here. We're dropping the 'scope' but
@@ -703,6 +744,10 @@ Function *BIMuxInfoConcept::defineMuxBuiltin(BuiltinID ID, Module &M) {
       return defineGetGlobalLinearId(M);
     case eMuxBuiltinGetEnqueuedLocalSize:
       return defineGetEnqueuedLocalSize(M);
+    case eMuxBuiltinGetLocalRangeStart:
+      return defineGetLocalRangeStart(M);
+    case eMuxBuiltinGetLocalRangeEnd:
+      return defineGetLocalRangeEnd(M);
     // Just handle the memory synchronization requirements of any barrier
     // builtin. We assume that the control requirements of work-group and
     // sub-group control barriers have been handled by earlier passes.
@@ -757,6 +802,8 @@ bool BIMuxInfoConcept::requiresSchedulingParameters(BuiltinID ID) {
     case eMuxBuiltinGetLocalSize:
     case eMuxBuiltinGetGlobalOffset:
     case eMuxBuiltinGetEnqueuedLocalSize:
+    case eMuxBuiltinGetLocalRangeStart:
+    case eMuxBuiltinGetLocalRangeEnd:
       // Work-group struct only
       return true;
     case eMuxBuiltinGetGlobalId:
@@ -793,6 +840,8 @@ Function *BIMuxInfoConcept::getOrDeclareMuxBuiltin(BuiltinID ID, Module &M) {
     case eMuxBuiltinGetNumGroups:
     case eMuxBuiltinGetGroupId:
     case eMuxBuiltinGetEnqueuedLocalSize:
+    case eMuxBuiltinGetLocalRangeStart:
+    case eMuxBuiltinGetLocalRangeEnd:
       ParamTys.push_back(Int32Ty);
       ParamNames.push_back("idx");
       LLVM_FALLTHROUGH;
@@ -0,0 +1,324 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief BenchLoader, micro-benchmarks of ELF symbol and section lookup and
+/// relocation over synthetic objects with increasing symbol counts.
+
+#include <benchmark/benchmark.h>
+#include <loader/elf.h>
+#include <loader/relocation_types.h>
+#include <loader/relocations.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+using loader::ElfFile;
+namespace ElfFields = loader::ElfFields;
+
+/// @brief Section indices of the synthetic object.
+enum SectionIndex : uint16_t {
+  NULL_SECTION,
+  TEXT,
+  RELA_TEXT,
+  SYMTAB,
+  STRTAB,
+  SHSTRTAB,
+  SECTION_COUNT
+};
+
+/// @brief A relocatable x86_64 ELF object built in memory.
+///
+/// The object has a `.text` section holding one 8-byte slot per symbol. Three
+/// quarters of the symbols are defined in `.text` and the rest are undefined
+/// externals, which are resolved through `loader::ElfMap` callbacks. Every
+/// slot has an absolute relocation against its symbol, so resolving the object
+/// looks up every symbol once.
+struct SyntheticObject {
+  explicit SyntheticObject(size_t num_symbols);
+
+  cargo::array_view<uint8_t> bytes() {
+    return {reinterpret_cast<uint8_t *>(storage.data()), size};
+  }
+
+  /// @brief Names of all the symbols, in symbol table order.
+  std::vector<std::string> names;
+  /// @brief Number of symbols defined in `.text`.
+  size_t num_defined;
+  /// @brief File offset and size of `.text`.
+  size_t text_offset;
+  size_t text_size;
+
+ private:
+  /// @brief Backing storage, `uint64_t` keeps it aligned to 8 bytes.
+  std::vector<uint64_t> storage;
+  size_t size;
+};
+
+/// @brief Appends a string to a string table, returning its offset.
+uint32_t appendString(std::string &table, const std::string &str) {
+  const auto offset = static_cast<uint32_t>(table.size());
+  table += str;
+  table += '\0';
+  return offset;
+}
+
+/// @brief Rounds @p value up to a multiple of 8.
+size_t alignTo8(size_t value) { return (value + 7) & ~size_t(7); }
+
+SyntheticObject::SyntheticObject(size_t num_symbols)
+    : num_defined(num_symbols - num_symbols / 4) {
+  std::string strtab(1, '\0');
+  std::vector<ElfFile::Symbol64> symbols(num_symbols + 1);
+  std::memset(symbols.data(), 0, symbols.size() * sizeof(symbols[0]));
+  for (size_t index = 0; index < num_symbols; index++) {
+    const bool defined = index < num_defined;
+    names.push_back((defined ? "kernel_" : "external_") +
+                    std::to_string(index));
+    auto &symbol = symbols[index + 1];
+    symbol.name_offset = appendString(strtab, names.back());
+    // STB_GLOBAL with STT_FUNC for definitions or STT_NOTYPE for externals.
+    symbol.info = defined ? 0x12 : 0x10;
+    symbol.section = defined ? uint16_t{TEXT} : uint16_t{0};
+    symbol.value = defined ? index * 8 : 0;
+    symbol.size = defined ? 8 : 0;
+  }
+
+  struct Rela64 {
+    uint64_t offset;
+    uint64_t info;
+    uint64_t addend;
+  };
+  std::vector<Rela64> relocations(num_symbols);
+  for (size_t index = 0; index < num_symbols; index++) {
+    const uint64_t symbol_index = index + 1;
+    relocations[index] = {
+        index * 8,
+        (symbol_index << 32) | loader::RelocationTypes::X86_64::R_X86_64_64,
+        0};
+  }
+
+  std::string shstrtab(1, '\0');
+  const uint32_t text_name = appendString(shstrtab, ".text");
+  const uint32_t rela_text_name = appendString(shstrtab, ".rela.text");
+  const uint32_t symtab_name = appendString(shstrtab, ".symtab");
+  const uint32_t strtab_name = appendString(shstrtab, ".strtab");
+  const uint32_t shstrtab_name = appendString(shstrtab, ".shstrtab");
+
+  text_offset = sizeof(ElfFile::Header64);
+  text_size = num_symbols * 8;
+  const size_t rela_offset = alignTo8(text_offset + text_size);
+  const size_t rela_size = relocations.size() * sizeof(Rela64);
+  const size_t symtab_offset = alignTo8(rela_offset + rela_size);
+  const size_t symtab_size = symbols.size() * sizeof(ElfFile::Symbol64);
+  const size_t strtab_offset = alignTo8(symtab_offset + symtab_size);
+  const size_t shstrtab_offset = alignTo8(strtab_offset + strtab.size());
+  const size_t sht_offset = alignTo8(shstrtab_offset + shstrtab.size());
+  size = sht_offset + SECTION_COUNT * sizeof(ElfFile::SectionHeader64);
+  storage.assign(alignTo8(size) / 8, 0);
+  auto *data = reinterpret_cast<uint8_t *>(storage.data());
+
+  ElfFile::Header64 header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.identifier.magic, ElfFile::HeaderIdent::ELF_MAGIC.data(),
+              ElfFile::HeaderIdent::ELF_MAGIC.size());
+  header.identifier.bitness = ElfFields::Bitness::B64;
+  header.identifier.endianness = cargo::is_little_endian()
+                                     ? ElfFields::Endianness::LITTLE
+                                     : ElfFields::Endianness::BIG;
+  header.identifier.version = ElfFields::Version::V1;
+  header.identifier.abi = ElfFields::ABI::SYSV;
+  header.type = ElfFields::Type::RELOCATABLE;
+  header.machine = ElfFields::Machine::X86_64;
+  header.version = 1;
+  header.section_header_offset = sht_offset;
+  header.header_size = sizeof(ElfFile::Header64);
+  header.sht_entry_size = sizeof(ElfFile::SectionHeader64);
+  header.sht_entry_count = SECTION_COUNT;
+  header.sht_names_index = SHSTRTAB;
+  std::memcpy(data, &header, sizeof(header));
+
+  std::memcpy(data + rela_offset, relocations.data(), rela_size);
+  std::memcpy(data + symtab_offset, symbols.data(), symtab_size);
+  std::memcpy(data + strtab_offset, strtab.data(), strtab.size());
+  std::memcpy(data + shstrtab_offset, shstrtab.data(), shstrtab.size());
+
+  ElfFile::SectionHeader64 sections[SECTION_COUNT];
+  std::memset(sections, 0, sizeof(sections));
+  sections[TEXT] = {text_name,
+                    ElfFields::SectionType::PROGBITS,
+                    ElfFields::SectionFlags::Type(
+                        ElfFields::SectionFlags::ALLOC |
+                        ElfFields::SectionFlags::EXECINSTR),
+                    0,
+                    text_offset,
+                    text_size,
+                    0,
+                    0,
+                    8,
+                    0};
+  sections[RELA_TEXT] = {rela_text_name,
+                         ElfFields::SectionType::RELA,
+                         ElfFields::SectionFlags::INFO_LINK,
+                         0,
+                         rela_offset,
+                         rela_size,
+                         SYMTAB,
+                         TEXT,
+                         8,
+                         sizeof(Rela64)};
+  // The info field holds the index of the first non-local symbol.
+  sections[SYMTAB] = {symtab_name,
+                      ElfFields::SectionType::SYMTAB,
+                      ElfFields::SectionFlags::Type(0),
+                      0,
+                      symtab_offset,
+                      symtab_size,
+                      STRTAB,
+                      1,
+                      8,
+                      sizeof(ElfFile::Symbol64)};
+  sections[STRTAB] = {strtab_name,
+                      ElfFields::SectionType::STRTAB,
+                      ElfFields::SectionFlags::Type(0),
+                      0,
+                      strtab_offset,
+                      strtab.size(),
+                      0,
+                      0,
+                      1,
+                      0};
+  sections[SHSTRTAB] = {shstrtab_name,
+                        ElfFields::SectionType::STRTAB,
+                        ElfFields::SectionFlags::Type(0),
+                        0,
+                        shstrtab_offset,
+                        shstrtab.size(),
+                        0,
+                        0,
+                        1,
+                        0};
+  std::memcpy(data + sht_offset, sections, sizeof(sections));
+}
+
+/// @brief Benchmark arguments for the number of symbols in the object.
+void symbolCountArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->RangeMultiplier(4)->Range(64, 16384);
+}
+
+/// @brief Look up every symbol by name in an object whose index is already
+/// built, reporting one item per lookup.
+void SymbolLookup(benchmark::State &state) {
+  SyntheticObject object(static_cast<size_t>(state.range(0)));
+  ElfFile file(object.bytes());
+  size_t next = 0;
+  for (auto _ : state) {
+    (void)_;
+    auto symbol = file.symbol(object.names[next]);
+    benchmark::DoNotOptimize(symbol);
+    if (!symbol) {
+      state.SkipWithError("Symbol lookup failed");
+      break;
+    }
+    next = (next + 1) % object.names.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(SymbolLookup)->Apply(symbolCountArguments);
+
+/// @brief Construct an `ElfFile` and perform its first lookup by name, which
+/// includes building the index.
+void FirstSymbolLookup(benchmark::State &state) {
+  SyntheticObject object(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    (void)_;
+    ElfFile file(object.bytes());
+    auto symbol = file.symbol(object.names.back());
+    benchmark::DoNotOptimize(symbol);
+    if (!symbol) {
+      state.SkipWithError("Symbol lookup failed");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(FirstSymbolLookup)->Apply(symbolCountArguments);
+
+/// @brief Look up each named section of the object in turn.
+void SectionLookup(benchmark::State &state) {
+  SyntheticObject object(static_cast<size_t>(state.range(0)));
+  ElfFile file(object.bytes());
+  const char *const section_names[] = {".text", ".rela.text", ".symtab",
+                                       ".strtab", ".shstrtab"};
+  size_t next = 0;
+  for (auto _ : state) {
+    (void)_;
+    auto section = file.section(section_names[next]);
+    benchmark::DoNotOptimize(section);
+    if (!section) {
+      state.SkipWithError("Section lookup failed");
+      break;
+    }
+    next = (next + 1) % (sizeof(section_names) / sizeof(section_names[0]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(SectionLookup)->Apply(symbolCountArguments);
+
+/// @brief Map `.text`, register a callback for every external and resolve all
+/// relocations, as a target does when loading an executable. Reports one item
+/// per resolved relocation.
+void ResolveRelocations(benchmark::State &state) {
+  SyntheticObject object(static_cast<size_t>(state.range(0)));
+  std::vector<uint8_t> text(object.text_size);
+  for (auto _ : state) {
+    (void)_;
+    ElfFile file(object.bytes());
+    std::memcpy(text.data(), object.bytes().data() + object.text_offset,
+                object.text_size);
+    loader::ElfMap map(&file);
+    if (map.addSectionMapping(file.section(TEXT), text.data(),
+                              text.data() + text.size(), 0x10000)) {
+      state.SkipWithError("Failed to add section mapping");
+      break;
+    }
+    bool callbacks_added = true;
+    for (size_t index = object.num_defined; index < object.names.size();
+         index++) {
+      if (map.addCallback(object.names[index], 0x80000000 + index * 16)) {
+        callbacks_added = false;
+        break;
+      }
+    }
+    if (!callbacks_added) {
+      state.SkipWithError("Failed to add callback");
+      break;
+    }
+    if (!loader::resolveRelocations(file, map)) {
+      state.SkipWithError("Failed to resolve relocations");
+      break;
+    }
+    benchmark::DoNotOptimize(text.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(object.names.size()));
+}
+BENCHMARK(ResolveRelocations)->Apply(symbolCountArguments);
+}  // namespace
@@ -31,6 +31,8 @@
 #include <cargo/string_view.h>
 #include <array>
 #include <cstdint>
+#include <string>
+#include <unordered_map>
 
 namespace loader {
 
@@ -430,6 +432,9 @@ class ElfFile {
   /// @brief The section with the symbol table in it.
   cargo::optional<Section> symbol_section;
 
+  /// @brief The section with the symbol names in it.
+  cargo::optional<Section> symbol_names_section;
+
   /// @brief Gets the identification part of the ELF header, shared across both
   /// ELF formats.
   inline const HeaderIdent *headerIdent() const {
@@ -517,6 +522,21 @@ class ElfFile {
                ? v
                : static_cast<Enum>(cargo::byte_swap(static_cast<Integer>(v)));
   }
+
+ private:
+  // Relocatable objects carry no `.gnu.hash` or `.hash` section, so the name
+  // indices below are built from the section header and symbol tables on the
+  // first lookup by name. The first entry with a given name wins, matching a
+  // linear search.
+
+  /// @brief Whether `section_index` has been built.
+  bool section_index_built = false;
+  /// @brief Maps section names to their index in the section header table.
+  std::unordered_map<cargo::string_view, uint32_t> section_index;
+  /// @brief Whether `symbol_index` has been built.
+  bool symbol_index_built = false;
+  /// @brief Maps symbol names to their index in the symbol table.
+  std::unordered_map<cargo::string_view, uint32_t> symbol_index;
 };
 
 /// @brief A map of ELF sections and symbols to virtual memory.
@@ -552,22 +572,15 @@ struct ElfMap {
   inline Mapping *sectionMappingsEnd() { return sectionMappings.end(); }
 
   /// @brief Adds a new ELF section mapping.
-  inline cargo::result addSectionMapping(const ElfFile::Section &section,
-                                         uint8_t *writable_address,
-                                         uint8_t *writable_end,
-                                         uint64_t target_address) {
-    return sectionMappings.push_back({section.index(), writable_address,
-                                      writable_address + section.size(),
-                                      writable_end, target_address});
-  }
+  cargo::result addSectionMapping(const ElfFile::Section &section,
+                                  uint8_t *writable_address,
+                                  uint8_t *writable_end,
+                                  uint64_t target_address);
 
   /// @brief Adds a new callback, which allows to define undefined symbols that
   /// are present outside of the ELF file.
-  CARGO_NODISCARD inline cargo::result addCallback(cargo::string_view name,
-                                                   uint64_t target_address) {
-    return callbacks.push_back(
-        {std::string{name.data(), name.size()}, target_address});
-  }
+  CARGO_NODISCARD cargo::result addCallback(cargo::string_view name,
+                                            uint64_t target_address);
 
   /// @brief Gets the address where the section with a given index is mapped in
   /// host memory.
@@ -607,9 +620,19 @@ struct ElfMap {
 #endif
 
  private:
+  /// @brief Finds the mapping for the section with a given index.
+  const Mapping *findSectionMapping(uint32_t section_index) const;
+  /// @brief Finds the callback registered under a given name.
+  const Callback *findCallback(cargo::string_view name) const;
+
   ElfFile *file;
   cargo::small_vector<Mapping, 8> sectionMappings;
   cargo::small_vector<Callback, 8> callbacks;
+  /// @brief Maps a section index to one plus the position of its entry in
+  /// `sectionMappings`. A zero entry marks an unmapped section.
+  cargo::small_vector<uint32_t, 16> sectionMappingSlots;
+  /// @brief Maps the hash of a callback name to its position in `callbacks`.
+  std::unordered_multimap<size_t, uint32_t> callbackIndices;
 };
 
 /// @brief Iterates over the sections in an ELF file.
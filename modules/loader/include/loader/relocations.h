@@ -25,6 +25,7 @@
 #include <cargo/small_vector.h>
 #include <loader/elf.h>
 #include <array>
+#include <unordered_map>
 
 namespace loader {
 
@@ -33,8 +34,7 @@ struct Relocation {
   /// @brief Relocation entry types present in ELF files - the A variants have
   /// an additional field with an explicit addend.
   enum class EntryType { Elf32Rel, Elf32RelA, Elf64Rel, Elf64RelA };
-  /// @brief A map of stub locations, a separate one should be instantiated for
-  /// each relocated section in the ELF file.
+  /// @brief A map of stub locations.
   ///
   /// Some architectures, like Arm and AArch64, require the linker to generate
   /// additional code in case a relocation exceeds the number of bits available
@@ -45,13 +45,42 @@ struct Relocation {
   /// fit within the addressable space of the instruction, if they don't that's
   /// the fault of the compiler, as it generated a section that's too big for
   /// that architecture.
+  ///
+  /// Stubs are keyed by the section they were written to as well as by the
+  /// address they jump to. A stub in one section may be out of range of a
+  /// branch in another, so a map shared between sections only reuses a stub
+  /// for branches in the section that holds it.
   struct StubMap {
-    struct Entry {
+    /// @brief Identifies the stub in a section jumping to an address.
+    struct Key {
+      /// @brief Index of the section the stub was written to.
+      uint32_t section_index;
+      /// @brief Target address the stub jumps to.
       uint64_t value;
-      uint64_t target;
+
+      bool operator==(const Key &other) const {
+        return section_index == other.section_index && value == other.value;
+      }
     };
-    cargo::small_vector<Entry, 4> stubs;
-    cargo::optional<uint64_t> getTarget(uint64_t value) const;
+
+    /// @brief Hashes a `Key`.
+    struct KeyHash {
+      size_t operator()(const Key &key) const {
+        return std::hash<uint64_t>{}(key.value) ^
+               (std::hash<uint32_t>{}(key.section_index) << 1);
+      }
+    };
+
+    /// @brief Maps a section and a symbol target address to the address of the
+    /// stub in that section jumping to it.
+    std::unordered_map<Key, uint64_t, KeyHash> stubs;
+    /// @brief Gets the address of the stub in section @p section_index jumping
+    /// to @p value, if any.
+    cargo::optional<uint64_t> getTarget(uint32_t section_index,
+                                        uint64_t value) const;
+    /// @brief Records that the stub at @p target in section @p section_index
+    /// jumps to @p value.
+    void addStub(uint32_t section_index, uint64_t value, uint64_t target);
   };
 
   /// @brief Platform-dependent type of the relocation.
@@ -35,7 +35,7 @@ const cargo::string_view ElfFile::Section::name() const {
 
 cargo::optional<cargo::string_view> ElfFile::Symbol::name() const {
   CARGO_ASSERT(file != nullptr, "Using a null ElfFile instance");
-  auto sh = file->section(ElfFields::SYMBOL_NAMES_SECTION);
+  const auto &sh = file->symbol_names_section;
   if (!sh) {
     return cargo::nullopt;
   }
@@ -57,6 +57,7 @@ ElfFile::ElfFile(cargo::array_view<uint8_t> aligned_data) {
   if (is_aligned) {
     bytes = aligned_data;
     symbol_section = section(ElfFields::SYMBOL_TABLE_SECTION);
+    symbol_names_section = section(ElfFields::SYMBOL_NAMES_SECTION);
   } else {
     bytes = {};
   }
@@ -106,11 +107,19 @@ ElfFile::Section ElfFile::section(size_t index) {
 }
 
 cargo::optional<ElfFile::Section> ElfFile::section(cargo::string_view name) {
-  auto result =
-      std::find_if(sectionsBegin(), sectionsEnd(),
-                   [name](const Section &v) { return name == v.name(); });
-  return (result == sectionsEnd()) ? cargo::nullopt
-                                   : cargo::optional<ElfFile::Section>(*result);
+  if (!section_index_built) {
+    const size_t count = sectionCount();
+    section_index.reserve(count);
+    for (size_t index = 0; index < count; index++) {
+      section_index.emplace(section(index).name(),
+                            static_cast<uint32_t>(index));
+    }
+    section_index_built = true;
+  }
+  auto found = section_index.find(name);
+  return (found == section_index.end())
+             ? cargo::nullopt
+             : cargo::optional<ElfFile::Section>(section(found->second));
 }
 
 loader::SymbolIterator ElfFile::symbolsBegin() {
@@ -132,66 +141,118 @@ ElfFile::Symbol ElfFile::symbol(size_t index) {
 }
 
 cargo::optional<ElfFile::Symbol> ElfFile::symbol(cargo::string_view name) {
-  auto result =
-      std::find_if(symbolsBegin(), symbolsEnd(),
-                   [name](const Symbol &v) { return name == v.name(); });
-  return (result == symbolsEnd()) ? cargo::nullopt
-                                  : cargo::optional<ElfFile::Symbol>(*result);
+  if (!symbol_index_built) {
+    const size_t count = symbolCount();
+    symbol_index.reserve(count);
+    for (size_t index = 0; index < count; index++) {
+      if (auto symbol_name = symbol(index).name()) {
+        symbol_index.emplace(*symbol_name, static_cast<uint32_t>(index));
+      }
+    }
+    symbol_index_built = true;
+  }
+  auto found = symbol_index.find(name);
+  return (found == symbol_index.end())
+             ? cargo::nullopt
+             : cargo::optional<ElfFile::Symbol>(symbol(found->second));
+}
+
+cargo::result loader::ElfMap::addSectionMapping(
+    const ElfFile::Section &section, uint8_t *writable_address,
+    uint8_t *writable_end, uint64_t target_address) {
+  const uint32_t index = section.index();
+  if (index >= sectionMappingSlots.size()) {
+    if (auto error = sectionMappingSlots.resize(index + 1, 0)) {
+      return error;
+    }
+  }
+  if (auto error = sectionMappings.push_back(
+          {index, writable_address, writable_address + section.size(),
+           writable_end, target_address})) {
+    return error;
+  }
+  // Keep the first mapping of a section, matching a linear search.
+  if (sectionMappingSlots[index] == 0) {
+    sectionMappingSlots[index] =
+        static_cast<uint32_t>(sectionMappings.size());
+  }
+  return cargo::success;
+}
+
+cargo::result loader::ElfMap::addCallback(cargo::string_view name,
+                                          uint64_t target_address) {
+  const bool shadowed = findCallback(name) != nullptr;
+  if (auto error = callbacks.push_back(
+          {std::string{name.data(), name.size()}, target_address})) {
+    return error;
+  }
+  // Keep the first callback with a given name, matching a linear search.
+  if (!shadowed) {
+    callbackIndices.emplace(std::hash<cargo::string_view>{}(name),
+                            static_cast<uint32_t>(callbacks.size() - 1));
+  }
+  return cargo::success;
+}
+
+const loader::ElfMap::Mapping *loader::ElfMap::findSectionMapping(
+    uint32_t section_index) const {
+  if (section_index >= sectionMappingSlots.size() ||
+      sectionMappingSlots[section_index] == 0) {
+    return nullptr;
+  }
+  return &sectionMappings[sectionMappingSlots[section_index] - 1];
+}
+
+const loader::ElfMap::Callback *loader::ElfMap::findCallback(
+    cargo::string_view name) const {
+  auto range =
+      callbackIndices.equal_range(std::hash<cargo::string_view>{}(name));
+  for (auto it = range.first; it != range.second; ++it) {
+    const Callback &callback = callbacks[it->second];
+    if (name == callback.name) {
+      return &callback;
+    }
+  }
+  return nullptr;
 }
 
 cargo::optional<uint64_t> loader::ElfMap::getSectionTargetAddress(
     uint32_t index) const {
-  auto it = std::find_if(
-      sectionMappings.begin(), sectionMappings.end(),
-      [index](const Mapping &m) { return m.section_index == index; });
-  return (it == sectionMappings.end())
-             ? cargo::nullopt
-             : cargo::optional<uint64_t>{it->target_address};
+  auto mapping = findSectionMapping(index);
+  return mapping ? cargo::optional<uint64_t>{mapping->target_address}
+                 : cargo::nullopt;
 }
 
 cargo::optional<uint8_t *> loader::ElfMap::getSectionWritableAddress(
     uint32_t index) const {
-  auto it = std::find_if(
-      sectionMappings.begin(), sectionMappings.end(),
-      [index](const Mapping &m) { return m.section_index == index; });
-  return (it == sectionMappings.end())
-             ? cargo::nullopt
-             : cargo::optional<uint8_t *>{it->writable_address};
+  auto mapping = findSectionMapping(index);
+  return mapping ? cargo::optional<uint8_t *>{mapping->writable_address}
+                 : cargo::nullopt;
 }
 
 cargo::optional<cargo::array_view<uint8_t>>
 loader::ElfMap::getRemainingStubSpace(uint32_t section_index) const {
-  auto it = std::find_if(sectionMappings.begin(), sectionMappings.end(),
-                         [section_index](const Mapping &m) {
-                           return m.section_index == section_index;
-                         });
-  return (it == sectionMappings.end())
-             ? cargo::nullopt
-             : cargo::make_optional<cargo::array_view<uint8_t>>(
-                   it->stub_address, it->writable_end);
+  auto mapping = findSectionMapping(section_index);
+  return mapping ? cargo::make_optional<cargo::array_view<uint8_t>>(
+                       mapping->stub_address, mapping->writable_end)
+                 : cargo::nullopt;
 }
 
 cargo::optional<uint64_t> loader::ElfMap::getStubTargetAddress(
     uint32_t section_index) const {
-  auto it = std::find_if(sectionMappings.begin(), sectionMappings.end(),
-                         [section_index](const Mapping &m) {
-                           return m.section_index == section_index;
-                         });
-  return (it == sectionMappings.end())
-             ? cargo::nullopt
-             : cargo::optional<uint64_t>{
-                   it->target_address +
-                   (it->stub_address - it->writable_address)};
+  auto mapping = findSectionMapping(section_index);
+  return mapping ? cargo::optional<uint64_t>{mapping->target_address +
+                                             (mapping->stub_address -
+                                              mapping->writable_address)}
+                 : cargo::nullopt;
 }
 
 void loader::ElfMap::shrinkRemainingStubSpace(uint32_t section_index,
                                               uint64_t bytes) {
-  auto it = std::find_if(sectionMappings.begin(), sectionMappings.end(),
-                         [section_index](const Mapping &m) {
-                           return m.section_index == section_index;
-                         });
-  if (it != sectionMappings.end()) {
-    it->stub_address += static_cast<size_t>(bytes);
+  if (section_index < sectionMappingSlots.size() &&
+      sectionMappingSlots[section_index] != 0) {
+    sectionMappings[sectionMappingSlots[section_index] - 1].stub_address +=
+        static_cast<size_t>(bytes);
   }
 }
 
@@ -200,10 +261,10 @@ cargo::optional<uint64_t> loader::ElfMap::getSymbolTargetAddress(
   auto sym = file->symbol(index);
   auto name = sym.name();
 
-  auto cb = std::find_if(callbacks.begin(), callbacks.end(),
-                         [&name](const Callback &c) { return c.name == name; });
-  if (cb != callbacks.end()) {
-    return cb->target_address;
+  if (name) {
+    if (auto cb = findCallback(*name)) {
+      return cb->target_address;
+    }
   }
   if (sym.sectionIndex() == ElfFields::SymbolSpecialSection::ABSOLUTE) {
     return sym.value();
@@ -218,9 +279,7 @@ cargo::optional<uint64_t> loader::ElfMap::getSymbolTargetAddress(
 
 cargo::optional<uint64_t> loader::ElfMap::getSymbolTargetAddress(
     cargo::string_view name) const {
-  auto cb = std::find_if(callbacks.begin(), callbacks.end(),
-                         [&name](const Callback &c) { return c.name == name; });
-  if (cb != callbacks.end()) {
+  if (auto cb = findCallback(name)) {
     return cb->target_address;
   }
   auto sym = file->symbol(name);
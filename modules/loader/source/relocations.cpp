@@ -18,8 +18,6 @@
 #include <loader/relocation_types.h>
 #include <loader/relocations.h>
 
-#include <algorithm>
-
 // There are many relocation types, but LLVM only emits a few, only those
 // present in lib/ExecutionEngine/RuntimeDyld/RuntimeDyldELF.cpp are implemented
 
@@ -54,13 +52,17 @@
 //   on the target symbol address
 
 cargo::optional<uint64_t> loader::Relocation::StubMap::getTarget(
-    uint64_t value) const {
-  auto it = std::find_if(stubs.begin(), stubs.end(),
-                         [value](const Entry &e) { return e.value == value; });
-  return (it != stubs.end()) ? cargo::optional<uint64_t>(it->target)
+    uint32_t section_index, uint64_t value) const {
+  auto it = stubs.find({section_index, value});
+  return (it != stubs.end()) ? cargo::optional<uint64_t>(it->second)
                              : cargo::nullopt;
 }
 
+void loader::Relocation::StubMap::addStub(uint32_t section_index,
+                                          uint64_t value, uint64_t target) {
+  stubs.emplace(Key{section_index, value}, target);
+}
+
 namespace {
 // Gets the [first, first+size) bits of value as a size-bit integer.
 template <typename Integer>
@@ -305,7 +307,8 @@ bool resolveArm(const loader::Relocation &r, loader::ElfMap &map,
 
   // returns the address of the stub to jump to
   auto getOrCreateStub = [&]() -> uint32_t {
-    auto found_stub_target = stubs.getTarget(symbol_target_address);
+    auto found_stub_target =
+        stubs.getTarget(r.section_index, symbol_target_address);
     if (found_stub_target) {
       return static_cast<uint32_t>(*found_stub_target);
     }
@@ -322,6 +325,7 @@ bool resolveArm(const loader::Relocation &r, loader::ElfMap &map,
     cargo::write_little_endian(symbol_target_address, remaining->begin() + 4);
     auto target = *map.getStubTargetAddress(r.section_index);
     map.shrinkRemainingStubSpace(r.section_index, 8);
+    stubs.addStub(r.section_index, symbol_target_address, target);
     return static_cast<uint32_t>(target);
   };
 
@@ -423,7 +427,8 @@ bool resolveAArch64(const loader::Relocation &r, loader::ElfMap &map,
   using namespace loader::RelocationTypes::AArch64;
   // returns the address of the stub to jump to
   auto getOrCreateStub = [&](uint64_t symbol_target_address) -> uint64_t {
-    auto found_stub_target = stubs.getTarget(symbol_target_address);
+    auto found_stub_target =
+        stubs.getTarget(r.section_index, symbol_target_address);
     if (found_stub_target) {
       return *found_stub_target;
     }
@@ -462,9 +467,10 @@ bool resolveAArch64(const loader::Relocation &r, loader::ElfMap &map,
         remaining->begin() + 12);
     // br ip0
     cargo::write_little_endian(uint32_t{0xD61F0200}, remaining->begin() + 16);
-    auto target = *map.getStubTargetAddress(r.section_index);
+    auto target = *map.getStubTargetAddress(r.section_index) + 4;
     map.shrinkRemainingStubSpace(r.section_index, 20);
-    return target + 4;
+    stubs.addStub(r.section_index, symbol_target_address, target);
+    return target;
   };
 
   switch (r.type) {
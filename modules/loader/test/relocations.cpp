@@ -0,0 +1,298 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <gtest/gtest.h>
+#include <loader/elf.h>
+#include <loader/relocation_types.h>
+#include <loader/relocations.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+using loader::ElfFile;
+namespace ElfFields = loader::ElfFields;
+
+/// @brief Section indices of the test object.
+enum SectionIndex : uint16_t {
+  NULL_SECTION,
+  TEXT_A,
+  TEXT_B,
+  RELA_TEXT_A,
+  RELA_TEXT_B,
+  SYMTAB,
+  STRTAB,
+  SHSTRTAB,
+  SECTION_COUNT
+};
+
+/// @brief Encoding of `bl #0`.
+constexpr uint32_t BL = 0x94000000;
+
+/// @brief Appends a string to a string table, returning its offset.
+uint32_t appendString(std::string &table, const char *str) {
+  const auto offset = static_cast<uint32_t>(table.size());
+  table += str;
+  table += '\0';
+  return offset;
+}
+
+/// @brief Rounds @p value up to a multiple of 8.
+size_t alignTo8(size_t value) { return (value + 7) & ~size_t(7); }
+
+/// @brief A relocatable AArch64 ELF object built in memory.
+///
+/// The object has two text sections, `.text.a` and `.text.b`, each holding a
+/// single `bl` to the undefined symbol `far_function` with an
+/// `R_AARCH64_CALL26` relocation.
+struct AArch64Object {
+  AArch64Object();
+
+  cargo::array_view<uint8_t> bytes() {
+    return {reinterpret_cast<uint8_t *>(storage.data()), size};
+  }
+
+ private:
+  /// @brief Backing storage, `uint64_t` keeps it aligned to 8 bytes.
+  std::vector<uint64_t> storage;
+  size_t size;
+};
+
+AArch64Object::AArch64Object() {
+  std::string strtab(1, '\0');
+  ElfFile::Symbol64 symbols[2];
+  std::memset(symbols, 0, sizeof(symbols));
+  symbols[1].name_offset = appendString(strtab, "far_function");
+  // STB_GLOBAL with STT_NOTYPE, undefined.
+  symbols[1].info = 0x10;
+
+  struct Rela64 {
+    uint64_t offset;
+    uint64_t info;
+    uint64_t addend;
+  };
+  const Rela64 relocation = {
+      0,
+      (uint64_t{1} << 32) | loader::RelocationTypes::AArch64::R_AARCH64_CALL26,
+      0};
+
+  std::string shstrtab(1, '\0');
+  const uint32_t text_a_name = appendString(shstrtab, ".text.a");
+  const uint32_t text_b_name = appendString(shstrtab, ".text.b");
+  const uint32_t rela_text_a_name = appendString(shstrtab, ".rela.text.a");
+  const uint32_t rela_text_b_name = appendString(shstrtab, ".rela.text.b");
+  const uint32_t symtab_name = appendString(shstrtab, ".symtab");
+  const uint32_t strtab_name = appendString(shstrtab, ".strtab");
+  const uint32_t shstrtab_name = appendString(shstrtab, ".shstrtab");
+
+  const size_t text_a_offset = sizeof(ElfFile::Header64);
+  const size_t text_b_offset = alignTo8(text_a_offset + sizeof(BL));
+  const size_t rela_a_offset = alignTo8(text_b_offset + sizeof(BL));
+  const size_t rela_b_offset = rela_a_offset + sizeof(Rela64);
+  const size_t symtab_offset = rela_b_offset + sizeof(Rela64);
+  const size_t strtab_offset = symtab_offset + sizeof(symbols);
+  const size_t shstrtab_offset = alignTo8(strtab_offset + strtab.size());
+  const size_t sht_offset = alignTo8(shstrtab_offset + shstrtab.size());
+  size = sht_offset + SECTION_COUNT * sizeof(ElfFile::SectionHeader64);
+  storage.assign(alignTo8(size) / 8, 0);
+  auto *data = reinterpret_cast<uint8_t *>(storage.data());
+
+  ElfFile::Header64 header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.identifier.magic, ElfFile::HeaderIdent::ELF_MAGIC.data(),
+              ElfFile::HeaderIdent::ELF_MAGIC.size());
+  header.identifier.bitness = ElfFields::Bitness::B64;
+  header.identifier.endianness = ElfFields::Endianness::LITTLE;
+  header.identifier.version = ElfFields::Version::V1;
+  header.identifier.abi = ElfFields::ABI::SYSV;
+  header.type = ElfFields::Type::RELOCATABLE;
+  header.machine = ElfFields::Machine::AARCH64;
+  header.version = 1;
+  header.section_header_offset = sht_offset;
+  header.header_size = sizeof(ElfFile::Header64);
+  header.sht_entry_size = sizeof(ElfFile::SectionHeader64);
+  header.sht_entry_count = SECTION_COUNT;
+  header.sht_names_index = SHSTRTAB;
+  std::memcpy(data, &header, sizeof(header));
+
+  std::memcpy(data + text_a_offset, &BL, sizeof(BL));
+  std::memcpy(data + text_b_offset, &BL, sizeof(BL));
+  std::memcpy(data + rela_a_offset, &relocation, sizeof(relocation));
+  std::memcpy(data + rela_b_offset, &relocation, sizeof(relocation));
+  std::memcpy(data + symtab_offset, symbols, sizeof(symbols));
+  std::memcpy(data + strtab_offset, strtab.data(), strtab.size());
+  std::memcpy(data + shstrtab_offset, shstrtab.data(), shstrtab.size());
+
+  const auto text_flags = ElfFields::SectionFlags::Type(
+      ElfFields::SectionFlags::ALLOC | ElfFields::SectionFlags::EXECINSTR);
+  ElfFile::SectionHeader64 sections[SECTION_COUNT];
+  std::memset(sections, 0, sizeof(sections));
+  sections[TEXT_A] = {text_a_name,
+                      ElfFields::SectionType::PROGBITS,
+                      text_flags,
+                      0,
+                      text_a_offset,
+                      sizeof(BL),
+                      0,
+                      0,
+                      4,
+                      0};
+  sections[TEXT_B] = {text_b_name,
+                      ElfFields::SectionType::PROGBITS,
+                      text_flags,
+                      0,
+                      text_b_offset,
+                      sizeof(BL),
+                      0,
+                      0,
+                      4,
+                      0};
+  sections[RELA_TEXT_A] = {rela_text_a_name,
+                           ElfFields::SectionType::RELA,
+                           ElfFields::SectionFlags::INFO_LINK,
+                           0,
+                           rela_a_offset,
+                           sizeof(Rela64),
+                           SYMTAB,
+                           TEXT_A,
+                           8,
+                           sizeof(Rela64)};
+  sections[RELA_TEXT_B] = {rela_text_b_name,
+                           ElfFields::SectionType::RELA,
+                           ElfFields::SectionFlags::INFO_LINK,
+                           0,
+                           rela_b_offset,
+                           sizeof(Rela64),
+                           SYMTAB,
+                           TEXT_B,
+                           8,
+                           sizeof(Rela64)};
+  // The info field holds the index of the first non-local symbol.
+  sections[SYMTAB] = {symtab_name,
+                      ElfFields::SectionType::SYMTAB,
+                      ElfFields::SectionFlags::Type(0),
+                      0,
+                      symtab_offset,
+                      sizeof(symbols),
+                      STRTAB,
+                      1,
+                      8,
+                      sizeof(ElfFile::Symbol64)};
+  sections[STRTAB] = {strtab_name,
+                      ElfFields::SectionType::STRTAB,
+                      ElfFields::SectionFlags::Type(0),
+                      0,
+                      strtab_offset,
+                      strtab.size(),
+                      0,
+                      0,
+                      1,
+                      0};
+  sections[SHSTRTAB] = {shstrtab_name,
+                        ElfFields::SectionType::STRTAB,
+                        ElfFields::SectionFlags::Type(0),
+                        0,
+                        shstrtab_offset,
+                        shstrtab.size(),
+                        0,
+                        0,
+                        1,
+                        0};
+  std::memcpy(data + sht_offset, sections, sizeof(sections));
+}
+
+/// @brief Decodes the target address of the `bl` at @p code, which is mapped
+/// at @p address on the device.
+uint64_t branchTarget(const uint8_t *code, uint64_t address) {
+  uint32_t instruction;
+  std::memcpy(&instruction, code, sizeof(instruction));
+  // Sign-extend the 26-bit word offset.
+  const int64_t offset =
+      static_cast<int64_t>(static_cast<int32_t>(instruction << 6) >> 6) * 4;
+  return address + offset;
+}
+
+/// @brief Maps both text sections of an `AArch64Object` 1GiB apart, each with
+/// room for stubs, and maps `far_function` out of range of either.
+struct RelocationsAArch64Test : ::testing::Test {
+  void SetUp() override {
+    ASSERT_EQ(cargo::success,
+              map.addSectionMapping(file.section(TEXT_A), text_a.data(),
+                                    text_a.data() + text_a.size(),
+                                    text_a_address));
+    ASSERT_EQ(cargo::success,
+              map.addSectionMapping(file.section(TEXT_B), text_b.data(),
+                                    text_b.data() + text_b.size(),
+                                    text_b_address));
+    ASSERT_EQ(cargo::success,
+              map.addCallback("far_function", far_function_address));
+  }
+
+  /// @brief Checks that the branch in each text section was relocated to a
+  /// stub in the same section.
+  void checkBranchesUseLocalStubs() {
+    const uint64_t target_a = branchTarget(text_a.data(), text_a_address);
+    EXPECT_GT(target_a, text_a_address);
+    EXPECT_LT(target_a, text_a_address + text_a.size());
+    const uint64_t target_b = branchTarget(text_b.data(), text_b_address);
+    EXPECT_GT(target_b, text_b_address);
+    EXPECT_LT(target_b, text_b_address + text_b.size());
+  }
+
+  static constexpr uint64_t text_a_address = 0x10000000;
+  static constexpr uint64_t text_b_address = 0x50000000;
+  static constexpr uint64_t far_function_address = 0x7000000000;
+
+  AArch64Object object;
+  ElfFile file{object.bytes()};
+  loader::ElfMap map{&file};
+  // The code of each section is followed by space for stubs.
+  std::vector<uint8_t> text_a = std::vector<uint8_t>(64, 0);
+  std::vector<uint8_t> text_b = std::vector<uint8_t>(64, 0);
+};
+
+constexpr uint64_t RelocationsAArch64Test::text_a_address;
+constexpr uint64_t RelocationsAArch64Test::text_b_address;
+constexpr uint64_t RelocationsAArch64Test::far_function_address;
+}  // namespace
+
+TEST_F(RelocationsAArch64Test, ResolveStubsPerSection) {
+  std::memcpy(text_a.data(), &BL, sizeof(BL));
+  std::memcpy(text_b.data(), &BL, sizeof(BL));
+  ASSERT_TRUE(loader::resolveRelocations(file, map));
+  checkBranchesUseLocalStubs();
+}
+
+TEST_F(RelocationsAArch64Test, SharedStubMapStubsPerSection) {
+  std::memcpy(text_a.data(), &BL, sizeof(BL));
+  std::memcpy(text_b.data(), &BL, sizeof(BL));
+  // Both branches go to the same far symbol through one stub map, so the
+  // second one must not reuse the stub written to the other section.
+  loader::Relocation::StubMap stubs;
+  loader::Relocation relocation;
+  relocation.type = loader::RelocationTypes::AArch64::R_AARCH64_CALL26;
+  relocation.symbol_index = 1;
+  relocation.offset = 0;
+  relocation.addend = 0;
+  relocation.section_index = TEXT_A;
+  ASSERT_TRUE(relocation.resolve(file, map, stubs));
+  relocation.section_index = TEXT_B;
+  ASSERT_TRUE(relocation.resolve(file, map, stubs));
+  checkBranchesUseLocalStubs();
+  EXPECT_EQ(2u, stubs.stubs.size());
+}
@@ -0,0 +1,173 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Benchmarks of recording, finalizing, cloning and updating command
+/// buffers.
+
+#include "common.h"
+
+namespace {
+/// @brief Benchmark arguments for the number of commands recorded.
+void commandCountArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+}
+
+/// @brief Record `state.range(0)` fill commands then finalize.
+void RecordFinalizeFillBuffer(benchmark::State &state,
+                              benchmux::Device &device) {
+  benchmux::buffer_handle buffer(device);
+  benchmux::memory_handle memory(device);
+  BENCHMUX_CHECK(state, benchmux::createBuffer(device, sizeof(uint32_t), buffer,
+                                               memory));
+  benchmux::command_buffer_handle command_buffer(device);
+  BENCHMUX_CHECK(state, muxCreateCommandBuffer(device.device, nullptr,
+                                               device.allocator,
+                                               command_buffer.out()));
+
+  const uint32_t pattern = 0xCAFEF00D;
+  for (auto _ : state) {
+    (void)_;
+    BENCHMUX_CHECK(state, muxResetCommandBuffer(command_buffer.get()));
+    for (int64_t i = 0; i < state.range(0); i++) {
+      BENCHMUX_CHECK(state, muxCommandFillBuffer(
+                                command_buffer.get(), buffer.get(), 0,
+                                sizeof(pattern), &pattern, sizeof(pattern), 0,
+                                nullptr, nullptr));
+    }
+    BENCHMUX_CHECK(state, muxFinalizeCommandBuffer(command_buffer.get()));
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMUX(RecordFinalizeFillBuffer, commandCountArguments);
+
+/// @brief Record `state.range(0)` ND range commands then finalize.
+void RecordFinalizeNDRange(benchmark::State &state, benchmux::Device &device) {
+  BENCHMUX_REQUIRE_COMPILER(state, device);
+  benchmux::command_buffer_handle command_buffer(device);
+  BENCHMUX_CHECK(state, muxCreateCommandBuffer(device.device, nullptr,
+                                               device.allocator,
+                                               command_buffer.out()));
+
+  const size_t global_size = 1;
+  const mux_ndrange_options_t options =
+      benchmux::getNDRangeOptions(&global_size);
+  for (auto _ : state) {
+    (void)_;
+    BENCHMUX_CHECK(state, muxResetCommandBuffer(command_buffer.get()));
+    for (int64_t i = 0; i < state.range(0); i++) {
+      BENCHMUX_CHECK(state,
+                     muxCommandNDRange(command_buffer.get(), device.nop_kernel,
+                                       options, 0, nullptr, nullptr));
+    }
+    BENCHMUX_CHECK(state, muxFinalizeCommandBuffer(command_buffer.get()));
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMUX(RecordFinalizeNDRange, commandCountArguments);
+
+/// @brief Clone a finalized command buffer of `state.range(0)` commands.
+void CloneCommandBuffer(benchmark::State &state, benchmux::Device &device) {
+  if (!device.device->info->can_clone_command_buffers) {
+    state.SkipWithError("Device can not clone command buffers");
+    return;
+  }
+  benchmux::buffer_handle buffer(device);
+  benchmux::memory_handle memory(device);
+  BENCHMUX_CHECK(state, benchmux::createBuffer(device, sizeof(uint32_t), buffer,
+                                               memory));
+  benchmux::command_buffer_handle command_buffer(device);
+  BENCHMUX_CHECK(state, muxCreateCommandBuffer(device.device, nullptr,
+                                               device.allocator,
+                                               command_buffer.out()));
+  const uint32_t pattern = 0xCAFEF00D;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    BENCHMUX_CHECK(state,
+                   muxCommandFillBuffer(command_buffer.get(), buffer.get(), 0,
+                                        sizeof(pattern), &pattern,
+                                        sizeof(pattern), 0, nullptr, nullptr));
+  }
+  BENCHMUX_CHECK(state, muxFinalizeCommandBuffer(command_buffer.get()));
+
+  for (auto _ : state) {
+    (void)_;
+    mux_command_buffer_t clone = nullptr;
+    BENCHMUX_CHECK(state,
+                   muxCloneCommandBuffer(device.device, device.allocator,
+                                         command_buffer.get(), &clone));
+    muxDestroyCommandBuffer(device.device, clone, device.allocator);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMUX(CloneCommandBuffer, commandCountArguments);
+
+/// @brief Update the buffer argument of a finalized ND range command.
+void UpdateDescriptors(benchmark::State &state, benchmux::Device &device) {
+  BENCHMUX_REQUIRE_COMPILER(state, device);
+  if (!device.device->info->descriptors_updatable) {
+    state.SkipWithError("Device can not update descriptors");
+    return;
+  }
+  const size_t global_size = 64;
+  benchmux::buffer_handle buffer_a(device);
+  benchmux::memory_handle memory_a(device);
+  BENCHMUX_CHECK(state, benchmux::createBuffer(device,
+                                               global_size * sizeof(int32_t),
+                                               buffer_a, memory_a));
+  benchmux::buffer_handle buffer_b(device);
+  benchmux::memory_handle memory_b(device);
+  BENCHMUX_CHECK(state, benchmux::createBuffer(device,
+                                               global_size * sizeof(int32_t),
+                                               buffer_b, memory_b));
+  mux_descriptor_info_t descriptors[2];
+  descriptors[0].type = mux_descriptor_info_type_buffer;
+  descriptors[0].buffer_descriptor.buffer = buffer_a.get();
+  descriptors[0].buffer_descriptor.offset = 0;
+  descriptors[1].type = mux_descriptor_info_type_buffer;
+  descriptors[1].buffer_descriptor.buffer = buffer_b.get();
+  descriptors[1].buffer_descriptor.offset = 0;
+
+  benchmux::command_buffer_handle command_buffer(device);
+  BENCHMUX_CHECK(state, muxCreateCommandBuffer(device.device, nullptr,
+                                               device.allocator,
+                                               command_buffer.out()));
+  const mux_ndrange_options_t options =
+      benchmux::getNDRangeOptions(&global_size, &descriptors[0], 1);
+  BENCHMUX_CHECK(state,
+                 muxCommandNDRange(command_buffer.get(), device.store_kernel,
+                                   options, 0, nullptr, nullptr));
+  BENCHMUX_CHECK(state, muxFinalizeCommandBuffer(command_buffer.get()));
+
+  // The ND range is the only command, so has index 0.
+  const mux_command_id_t command_id = 0;
+  uint64_t arg_index = 0;
+  size_t next = 1;
+  for (auto _ : state) {
+    (void)_;
+    BENCHMUX_CHECK(state,
+                   muxUpdateDescriptors(command_buffer.get(), command_id, 1,
+                                        &arg_index, &descriptors[next]));
+    next ^= 1;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMUX(UpdateDescriptors, nullptr);
+}  // namespace
@@ -0,0 +1,214 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Common utilities for BenchMux benchmarks.
+
+#ifndef MUX_BENCHMUX_COMMON_H_INCLUDED
+#define MUX_BENCHMUX_COMMON_H_INCLUDED
+
+#include <benchmark/benchmark.h>
+#include <mux/mux.h>
+#include <mux/utils/helpers.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace benchmux {
+/// @brief State shared by all benchmarks run against a single device.
+struct Device {
+  /// @brief Mux device the benchmarks are run against.
+  mux_device_t device = nullptr;
+  /// @brief Allocator used to create all Mux objects.
+  mux_allocator_info_t allocator = {mux::alloc, mux::free, nullptr};
+  /// @brief Compute queue of the device.
+  mux_queue_t queue = nullptr;
+  /// @brief Kernel with no arguments and an empty body, null if the device has
+  /// no compiler.
+  mux_kernel_t nop_kernel = nullptr;
+  /// @brief Kernel taking a single `global int *` argument, null if the device
+  /// has no compiler.
+  mux_kernel_t store_kernel = nullptr;
+};
+
+/// @brief Signature of a benchmark function run against a device.
+using benchmark_function_t = void (*)(benchmark::State &, Device &);
+
+/// @brief Signature of a function configuring the arguments of a benchmark.
+using arguments_function_t = void (*)(benchmark::internal::Benchmark *);
+
+/// @brief A benchmark to be instantiated for every device.
+struct Registration {
+  /// @brief Name of the benchmark, the device name is appended to it.
+  const char *name;
+  /// @brief Benchmark function.
+  benchmark_function_t function;
+  /// @brief Optional function configuring the benchmark arguments.
+  arguments_function_t arguments;
+};
+
+/// @brief Access the list of benchmarks to instantiate for every device.
+inline std::vector<Registration> &getRegistrations() {
+  static std::vector<Registration> registrations;
+  return registrations;
+}
+
+/// @brief Static initializer adding a benchmark to the registrations.
+struct Registrar {
+  Registrar(const char *name, benchmark_function_t function,
+            arguments_function_t arguments) {
+    getRegistrations().push_back({name, function, arguments});
+  }
+};
+
+/// @brief Owning handle to a Mux object, destroyed when the handle is.
+///
+/// @tparam T Type of the Mux object.
+/// @tparam Destroy Entry point used to destroy the object.
+template <class T, void (*Destroy)(mux_device_t, T, mux_allocator_info_t)>
+struct handle {
+  explicit handle(Device &device) : device(device), object(nullptr) {}
+  handle(const handle &) = delete;
+  handle &operator=(const handle &) = delete;
+
+  ~handle() {
+    if (object) {
+      Destroy(device.device, object, device.allocator);
+    }
+  }
+
+  T get() const { return object; }
+
+  T *out() { return &object; }
+
+ private:
+  Device &device;
+  T object;
+};
+
+using buffer_handle = handle<mux_buffer_t, muxDestroyBuffer>;
+using command_buffer_handle =
+    handle<mux_command_buffer_t, muxDestroyCommandBuffer>;
+using fence_handle = handle<mux_fence_t, muxDestroyFence>;
+using memory_handle = handle<mux_memory_t, muxFreeMemory>;
+using semaphore_handle = handle<mux_semaphore_t, muxDestroySemaphore>;
+
+/// @brief Create a buffer with memory bound to it.
+///
+/// @param[in] device Device to create the buffer on.
+/// @param[in] size Size in bytes of the buffer.
+/// @param[out] buffer Handle to store the buffer in.
+/// @param[out] memory Handle to store the buffer's memory in.
+///
+/// @return Returns `mux_success`, or a `mux_error_*` if an error occurred.
+inline mux_result_t createBuffer(Device &device, uint64_t size,
+                                 buffer_handle &buffer,
+                                 memory_handle &memory) {
+  if (auto error = muxCreateBuffer(device.device, size, device.allocator,
+                                   buffer.out())) {
+    return error;
+  }
+  const mux_allocation_type_e allocation_type =
+      (mux_allocation_capabilities_alloc_device &
+       device.device->info->allocation_capabilities)
+          ? mux_allocation_type_alloc_device
+          : mux_allocation_type_alloc_host;
+  const uint32_t heap = mux::findFirstSupportedHeap(
+      buffer.get()->memory_requirements.supported_heaps);
+  if (auto error = muxAllocateMemory(
+          device.device, size, heap, mux_memory_property_host_visible,
+          allocation_type, 0, device.allocator, memory.out())) {
+    return error;
+  }
+  return muxBindBufferMemory(device.device, memory.get(), buffer.get(), 0);
+}
+
+/// @brief Dispatch a command buffer and block until it has completed.
+///
+/// @param[in] device Device to dispatch to.
+/// @param[in] command_buffer Finalized command buffer to dispatch.
+/// @param[in] fence Fence to signal, it is reset before returning.
+///
+/// @return Returns `mux_success`, or a `mux_error_*` if an error occurred.
+inline mux_result_t dispatchAndWait(Device &device,
+                                    mux_command_buffer_t command_buffer,
+                                    mux_fence_t fence) {
+  if (auto error = muxDispatch(device.queue, command_buffer, fence, nullptr, 0,
+                               nullptr, 0, nullptr, nullptr)) {
+    return error;
+  }
+  if (auto error = muxTryWait(device.queue, UINT64_MAX, fence)) {
+    return error;
+  }
+  return muxResetFence(fence);
+}
+
+/// @brief Fill in ND range options for a 1-dimensional range.
+///
+/// @param[in] global_size Pointer to the global size, must outlive the options.
+/// @param[in] descriptors Kernel argument descriptors, may be null.
+/// @param[in] descriptors_length Number of elements in @p descriptors.
+///
+/// @return Returns the ND range options.
+inline mux_ndrange_options_t getNDRangeOptions(
+    const size_t *global_size, mux_descriptor_info_t *descriptors = nullptr,
+    uint64_t descriptors_length = 0) {
+  mux_ndrange_options_t options{};
+  options.descriptors = descriptors;
+  options.descriptors_length = descriptors_length;
+  options.local_size[0] = 1;
+  options.local_size[1] = 1;
+  options.local_size[2] = 1;
+  options.global_offset = nullptr;
+  options.global_size = global_size;
+  options.dimensions = 1;
+  return options;
+}
+}  // namespace benchmux
+
+/// @brief Skip the benchmark if a Mux entry point fails.
+///
+/// @param STATE The `benchmark::State` of the running benchmark.
+/// @param ... Expression returning a `mux_result_t`.
+#define BENCHMUX_CHECK(STATE, ...)       \
+  if (mux_success != (__VA_ARGS__)) {    \
+    (STATE).SkipWithError(#__VA_ARGS__); \
+    return;                              \
+  }                                      \
+  (void)0
+
+/// @brief Skip the benchmark if the device has no compiler.
+///
+/// @param STATE The `benchmark::State` of the running benchmark.
+/// @param DEVICE The `benchmux::Device` the benchmark is running against.
+#define BENCHMUX_REQUIRE_COMPILER(STATE, DEVICE)              \
+  if (nullptr == (DEVICE).nop_kernel) {                       \
+    (STATE).SkipWithError("Device does not have a compiler"); \
+    return;                                                   \
+  }                                                           \
+  (void)0
+
+/// @brief Register a benchmark to be run against every device.
+///
+/// @param NAME Name of a function matching `benchmux::benchmark_function_t`.
+/// @param ARGUMENTS Function matching `benchmux::arguments_function_t`
+/// configuring the benchmark, or `nullptr`.
+#define BENCHMUX(NAME, ARGUMENTS) \
+  static benchmux::Registrar NAME##_registrar(#NAME, NAME, ARGUMENTS)
+
+#endif  // MUX_BENCHMUX_COMMON_H_INCLUDED
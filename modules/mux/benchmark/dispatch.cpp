@@ -0,0 +1,169 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Benchmarks of dispatch latency, ND range throughput and semaphore
+/// chains.
+
+#include <vector>
+
+#include "common.h"
+
+namespace {
+/// @brief Benchmark arguments for the number of commands in the dispatched
+/// command buffer.
+void dispatchToFenceArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->Arg(0)->Arg(1);
+}
+
+/// @brief Benchmark arguments for the number of ND ranges and the number of
+/// work-items in each.
+void emptyNDRangeArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"ranges", "items"});
+  for (int64_t ranges : {1, 64, 1024}) {
+    for (int64_t items : {1, 1024, 65536}) {
+      benchmark->Args({ranges, items});
+    }
+  }
+}
+
+/// @brief Benchmark arguments for the length of the semaphore chain.
+void semaphoreChainArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->Arg(1)->Arg(8)->Arg(64);
+}
+
+/// @brief Time from dispatch to the fence signalling, for a command buffer of
+/// `state.range(0)` small fill commands.
+void DispatchToFence(benchmark::State &state, benchmux::Device &device) {
+  benchmux::buffer_handle buffer(device);
+  benchmux::memory_handle memory(device);
+  BENCHMUX_CHECK(state, benchmux::createBuffer(device, sizeof(uint32_t), buffer,
+                                               memory));
+  benchmux::command_buffer_handle command_buffer(device);
+  BENCHMUX_CHECK(state, muxCreateCommandBuffer(device.device, nullptr,
+                                               device.allocator,
+                                               command_buffer.out()));
+  const uint32_t pattern = 0xCAFEF00D;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    BENCHMUX_CHECK(state,
+                   muxCommandFillBuffer(command_buffer.get(), buffer.get(), 0,
+                                        sizeof(pattern), &pattern,
+                                        sizeof(pattern), 0, nullptr, nullptr));
+  }
+  BENCHMUX_CHECK(state, muxFinalizeCommandBuffer(command_buffer.get()));
+  benchmux::fence_handle fence(device);
+  BENCHMUX_CHECK(state,
+                 muxCreateFence(device.device, device.allocator, fence.out()));
+
+  for (auto _ : state) {
+    (void)_;
+    BENCHMUX_CHECK(state, benchmux::dispatchAndWait(
+                              device, command_buffer.get(), fence.get()));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMUX(DispatchToFence, dispatchToFenceArguments);
+
+/// @brief Throughput of `state.range(0)` empty ND ranges of `state.range(1)`
+/// work-items each, in a single command buffer.
+void EmptyNDRange(benchmark::State &state, benchmux::Device &device) {
+  BENCHMUX_REQUIRE_COMPILER(state, device);
+  benchmux::command_buffer_handle command_buffer(device);
+  BENCHMUX_CHECK(state, muxCreateCommandBuffer(device.device, nullptr,
+                                               device.allocator,
+                                               command_buffer.out()));
+  const size_t global_size = state.range(1);
+  const mux_ndrange_options_t options =
+      benchmux::getNDRangeOptions(&global_size);
+  for (int64_t i = 0; i < state.range(0); i++) {
+    BENCHMUX_CHECK(state,
+                   muxCommandNDRange(command_buffer.get(), device.nop_kernel,
+                                     options, 0, nullptr, nullptr));
+  }
+  BENCHMUX_CHECK(state, muxFinalizeCommandBuffer(command_buffer.get()));
+  benchmux::fence_handle fence(device);
+  BENCHMUX_CHECK(state,
+                 muxCreateFence(device.device, device.allocator, fence.out()));
+
+  for (auto _ : state) {
+    (void)_;
+    BENCHMUX_CHECK(state, benchmux::dispatchAndWait(
+                              device, command_buffer.get(), fence.get()));
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMUX(EmptyNDRange, emptyNDRangeArguments);
+
+/// @brief Dispatch a chain of `state.range(0)` command buffers, each waiting
+/// on a semaphore signalled by the previous one.
+void SemaphoreChain(benchmark::State &state, benchmux::Device &device) {
+  const size_t length = state.range(0);
+  std::vector<mux_command_buffer_t> command_buffers(length, nullptr);
+  std::vector<mux_semaphore_t> semaphores(length, nullptr);
+  struct cleanup_t {
+    benchmux::Device &device;
+    std::vector<mux_command_buffer_t> &command_buffers;
+    std::vector<mux_semaphore_t> &semaphores;
+    ~cleanup_t() {
+      for (auto semaphore : semaphores) {
+        if (semaphore) {
+          muxDestroySemaphore(device.device, semaphore, device.allocator);
+        }
+      }
+      for (auto command_buffer : command_buffers) {
+        if (command_buffer) {
+          muxDestroyCommandBuffer(device.device, command_buffer,
+                                  device.allocator);
+        }
+      }
+    }
+  } cleanup{device, command_buffers, semaphores};
+
+  for (size_t i = 0; i < length; i++) {
+    BENCHMUX_CHECK(state, muxCreateCommandBuffer(device.device, nullptr,
+                                                 device.allocator,
+                                                 &command_buffers[i]));
+    BENCHMUX_CHECK(state, muxFinalizeCommandBuffer(command_buffers[i]));
+    BENCHMUX_CHECK(state, muxCreateSemaphore(device.device, device.allocator,
+                                             &semaphores[i]));
+  }
+  benchmux::fence_handle fence(device);
+  BENCHMUX_CHECK(state,
+                 muxCreateFence(device.device, device.allocator, fence.out()));
+
+  for (auto _ : state) {
+    (void)_;
+    for (auto semaphore : semaphores) {
+      BENCHMUX_CHECK(state, muxResetSemaphore(semaphore));
+    }
+    for (size_t i = 0; i < length; i++) {
+      mux_semaphore_t *wait = i ? &semaphores[i - 1] : nullptr;
+      mux_fence_t signal_fence = (i + 1 == length) ? fence.get() : nullptr;
+      BENCHMUX_CHECK(state, muxDispatch(device.queue, command_buffers[i],
+                                        signal_fence, wait, wait ? 1 : 0,
+                                        &semaphores[i], 1, nullptr, nullptr));
+    }
+    BENCHMUX_CHECK(state, muxTryWait(device.queue, UINT64_MAX, fence.get()));
+    BENCHMUX_CHECK(state, muxResetFence(fence.get()));
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMUX(SemaphoreChain, semaphoreChainArguments);
+}  // namespace
@@ -0,0 +1,232 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Entry point for BenchMux, micro-benchmarks of the Mux API.
+
+#include <builtins/printf.h>
+#include <cargo/argument_parser.h>
+#include <compiler/context.h>
+#include <compiler/loader.h>
+#include <compiler/module.h>
+#include <compiler/target.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include "common.h"
+
+namespace {
+/// @brief OpenCL C source of the kernels provided to benchmarks.
+const char *kernels_source = R"(
+kernel void nop() {}
+
+kernel void store(global int *out) {
+  out[get_global_id(0)] = 0;
+})";
+
+/// @brief A device and the compiler state its kernels were built with.
+struct DeviceState {
+  benchmux::Device device;
+  std::string name;
+  std::unique_ptr<compiler::Library> library;
+  std::unique_ptr<compiler::Context> context;
+  std::unique_ptr<compiler::Target> target;
+  std::unique_ptr<compiler::Module> module;
+  mux_executable_t executable = nullptr;
+  uint32_t num_errors = 0;
+  std::string log;
+
+  ~DeviceState() {
+    if (device.store_kernel) {
+      muxDestroyKernel(device.device, device.store_kernel, device.allocator);
+    }
+    if (device.nop_kernel) {
+      muxDestroyKernel(device.device, device.nop_kernel, device.allocator);
+    }
+    if (executable) {
+      muxDestroyExecutable(device.device, executable, device.allocator);
+    }
+    module.reset();
+    if (device.device) {
+      muxDestroyDevice(device.device, device.allocator);
+    }
+  }
+};
+
+/// @brief Get the compiler capabilities of a device.
+uint32_t getBuiltinCapabilities(mux_device_info_t device_info) {
+  uint32_t caps = 0;
+  if (device_info->address_capabilities & mux_address_capabilities_bits32) {
+    caps |= compiler::CAPS_32BIT;
+  }
+  if (device_info->double_capabilities) {
+    caps |= compiler::CAPS_FP64;
+  }
+  if (device_info->half_capabilities) {
+    caps |= compiler::CAPS_FP16;
+  }
+  return caps;
+}
+
+/// @brief Build the benchmark kernels for a device, if it has a compiler.
+///
+/// @return Returns `true` if the kernels were created or there is no
+/// compiler, `false` if creating the kernels failed.
+bool createKernels(DeviceState &state) {
+  auto library = compiler::loadLibrary();
+  if (!library.has_value()) {
+    std::fprintf(stderr, "error: unable to load compiler library: %s\n",
+                 library.error().c_str());
+    return false;
+  }
+  state.library = std::move(*library);
+  if (!state.library) {
+    // No compiler, ND range benchmarks will be skipped.
+    return true;
+  }
+  const mux_device_info_t device_info = state.device.device->info;
+  const compiler::Info *info =
+      compiler::getCompilerForDevice(state.library.get(), device_info);
+  if (!info) {
+    return true;
+  }
+  state.context = compiler::createContext(state.library.get());
+  if (!state.context) {
+    return false;
+  }
+  state.target = info->createTarget(state.context.get(), nullptr);
+  if (!state.target || compiler::Result::SUCCESS !=
+                           state.target->init(
+                               getBuiltinCapabilities(device_info))) {
+    return false;
+  }
+  state.module = state.target->createModule(state.num_errors, state.log);
+  if (!state.module) {
+    return false;
+  }
+
+  std::vector<builtins::printf::descriptor> printf_calls;
+  cargo::array_view<std::uint8_t> binary;
+  if (compiler::Result::SUCCESS !=
+          state.module->compileOpenCLC(mux::detectOpenCLProfile(device_info),
+                                       kernels_source, {}) ||
+      compiler::Result::SUCCESS !=
+          state.module->finalize([](compiler::KernelInfo) {}, printf_calls) ||
+      compiler::Result::SUCCESS != state.module->createBinary(binary)) {
+    std::fprintf(stderr, "error: failed to compile kernels: %s\n",
+                 state.log.c_str());
+    return false;
+  }
+
+  benchmux::Device &device = state.device;
+  if (muxCreateExecutable(device.device, binary.data(), binary.size(),
+                          device.allocator, &state.executable) ||
+      muxCreateKernel(device.device, state.executable, "nop",
+                      std::strlen("nop"), device.allocator,
+                      &device.nop_kernel) ||
+      muxCreateKernel(device.device, state.executable, "store",
+                      std::strlen("store"), device.allocator,
+                      &device.store_kernel)) {
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  cargo::argument_parser<2> parser(cargo::KEEP_UNRECOGNIZED);
+  cargo::string_view device_name;
+  if (parser.add_argument({"--benchmux_device=", device_name})) {
+    return -1;
+  }
+  bool help = false;
+  if (parser.add_argument({"--help", help})) {
+    return -1;
+  }
+  if (auto error = parser.parse_args(argc, argv)) {
+    return error;
+  }
+
+  if (help) {
+    // If --help was passed print usage messages and exit.
+    std::fprintf(stdout,
+                 "BenchMux [--benchmux_device=<Mux device name substring>]\n");
+    benchmark::Initialize(&argc, argv);
+    return 0;
+  }
+
+  uint64_t num_devices = 0;
+  if (muxGetDeviceInfos(mux_device_type_all, 0, nullptr, &num_devices)) {
+    return -1;
+  }
+  std::vector<mux_device_info_t> device_infos(num_devices);
+  if (muxGetDeviceInfos(mux_device_type_all, num_devices, device_infos.data(),
+                        nullptr)) {
+    return -1;
+  }
+
+  // Devices are referenced by the registered benchmarks so must not move.
+  std::vector<std::unique_ptr<DeviceState>> devices;
+  for (auto device_info : device_infos) {
+    cargo::string_view name(device_info->device_name);
+    if (!device_name.empty() && name.find(device_name) == name.npos) {
+      continue;
+    }
+    std::unique_ptr<DeviceState> state(new DeviceState);
+    state->name = device_info->device_name;
+    benchmux::Device &device = state->device;
+    if (muxCreateDevices(1, &device_info, device.allocator, &device.device) ||
+        muxGetQueue(device.device, mux_queue_type_compute, 0, &device.queue)) {
+      std::fprintf(stderr, "error: unable to create Mux device: %s\n",
+                   state->name.c_str());
+      return -1;
+    }
+    if (!createKernels(*state)) {
+      std::fprintf(stderr, "error: unable to create kernels for device: %s\n",
+                   state->name.c_str());
+      return -1;
+    }
+    devices.push_back(std::move(state));
+  }
+
+  if (devices.empty()) {
+    std::fprintf(stderr, "error: no matching Mux devices found\n");
+    return -1;
+  }
+
+  for (auto &state : devices) {
+    benchmux::Device *device = &state->device;
+    for (auto &registration : benchmux::getRegistrations()) {
+      const std::string name =
+          std::string(registration.name) + "/" + state->name;
+      auto function = registration.function;
+      auto *benchmark = benchmark::RegisterBenchmark(
+          name.c_str(), [function, device](benchmark::State &benchmark_state) {
+            function(benchmark_state, *device);
+          });
+      if (registration.arguments) {
+        registration.arguments(benchmark);
+      }
+    }
+  }
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
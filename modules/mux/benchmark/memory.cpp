@@ -0,0 +1,113 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Benchmarks of buffer copy, fill, read and write bandwidth.
+
+#include <vector>
+
+#include "common.h"
+
+namespace {
+/// @brief Benchmark arguments for the number of bytes transferred.
+void byteCountArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+}
+
+/// @brief Record a single command into a command buffer then time dispatching
+/// it, reporting `state.range(0)` bytes processed per iteration.
+template <class Record>
+void dispatchTransfer(benchmark::State &state, benchmux::Device &device,
+                      Record record) {
+  benchmux::command_buffer_handle command_buffer(device);
+  BENCHMUX_CHECK(state, muxCreateCommandBuffer(device.device, nullptr,
+                                               device.allocator,
+                                               command_buffer.out()));
+  BENCHMUX_CHECK(state, record(command_buffer.get()));
+  BENCHMUX_CHECK(state, muxFinalizeCommandBuffer(command_buffer.get()));
+  benchmux::fence_handle fence(device);
+  BENCHMUX_CHECK(state,
+                 muxCreateFence(device.device, device.allocator, fence.out()));
+
+  for (auto _ : state) {
+    (void)_;
+    BENCHMUX_CHECK(state, benchmux::dispatchAndWait(
+                              device, command_buffer.get(), fence.get()));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+/// @brief Copy between two device buffers.
+void CopyBuffer(benchmark::State &state, benchmux::Device &device) {
+  const uint64_t size = state.range(0);
+  benchmux::buffer_handle src(device);
+  benchmux::memory_handle src_memory(device);
+  BENCHMUX_CHECK(state, benchmux::createBuffer(device, size, src, src_memory));
+  benchmux::buffer_handle dst(device);
+  benchmux::memory_handle dst_memory(device);
+  BENCHMUX_CHECK(state, benchmux::createBuffer(device, size, dst, dst_memory));
+  dispatchTransfer(state, device, [&](mux_command_buffer_t command_buffer) {
+    return muxCommandCopyBuffer(command_buffer, src.get(), 0, dst.get(), 0,
+                                size, 0, nullptr, nullptr);
+  });
+}
+BENCHMUX(CopyBuffer, byteCountArguments);
+
+/// @brief Fill a device buffer with a 4 byte pattern.
+void FillBuffer(benchmark::State &state, benchmux::Device &device) {
+  const uint64_t size = state.range(0);
+  benchmux::buffer_handle buffer(device);
+  benchmux::memory_handle memory(device);
+  BENCHMUX_CHECK(state, benchmux::createBuffer(device, size, buffer, memory));
+  const uint32_t pattern = 0xCAFEF00D;
+  dispatchTransfer(state, device, [&](mux_command_buffer_t command_buffer) {
+    return muxCommandFillBuffer(command_buffer, buffer.get(), 0, size,
+                                &pattern, sizeof(pattern), 0, nullptr,
+                                nullptr);
+  });
+}
+BENCHMUX(FillBuffer, byteCountArguments);
+
+/// @brief Write host memory into a device buffer.
+void WriteBuffer(benchmark::State &state, benchmux::Device &device) {
+  const uint64_t size = state.range(0);
+  benchmux::buffer_handle buffer(device);
+  benchmux::memory_handle memory(device);
+  BENCHMUX_CHECK(state, benchmux::createBuffer(device, size, buffer, memory));
+  const std::vector<uint8_t> host(size, 0x42);
+  dispatchTransfer(state, device, [&](mux_command_buffer_t command_buffer) {
+    return muxCommandWriteBuffer(command_buffer, buffer.get(), 0, host.data(),
+                                 size, 0, nullptr, nullptr);
+  });
+}
+BENCHMUX(WriteBuffer, byteCountArguments);
+
+/// @brief Read a device buffer into host memory.
+void ReadBuffer(benchmark::State &state, benchmux::Device &device) {
+  const uint64_t size = state.range(0);
+  benchmux::buffer_handle buffer(device);
+  benchmux::memory_handle memory(device);
+  BENCHMUX_CHECK(state, benchmux::createBuffer(device, size, buffer, memory));
+  std::vector<uint8_t> host(size);
+  dispatchTransfer(state, device, [&](mux_command_buffer_t command_buffer) {
+    return muxCommandReadBuffer(command_buffer, buffer.get(), 0, host.data(),
+                                size, 0, nullptr, nullptr);
+  });
+}
+BENCHMUX(ReadBuffer, byteCountArguments);
+}  // namespace
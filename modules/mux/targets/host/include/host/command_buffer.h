@@ -23,6 +23,7 @@
 #include <cargo/expected.h>
 
 #include <array>
+#include <memory>
 #include <mutex>
 
 #include "host/fence.h"
@@ -39,14 +40,19 @@ namespace host {
 ///
 /// This struct later gets cast to `void*` and passed to the lambda that threads
 /// in the threadpool execute to actually run the range.
+///
+/// An ND range is shared between a command buffer and its clones until one of
+/// them updates its descriptors, at which point that command buffer makes its
+/// own copy, see `hostUpdateDescriptors`.
 struct ndrange_info_s {
-  ndrange_info_s(void *packed_args,
+  ndrange_info_s(mux_allocator_info_t allocator_info, void *packed_args,
                  mux::dynamic_array<uint8_t *> &arg_addresses,
                  mux::dynamic_array<mux_descriptor_info_t> &descriptors,
                  std::array<size_t, 3> global_size,
                  std::array<size_t, 3> global_offset,
                  std::array<size_t, 3> local_size, size_t dimensions)
-      : packed_args(packed_args),
+      : allocator_info(allocator_info),
+        packed_args(packed_args),
         arg_addresses(std::move(arg_addresses)),
         descriptors(std::move(descriptors)),
         global_size(global_size),
@@ -54,6 +60,15 @@ struct ndrange_info_s {
         local_size(local_size),
         dimensions(dimensions) {}
 
+  ndrange_info_s(const ndrange_info_s &) = delete;
+  ndrange_info_s &operator=(const ndrange_info_s &) = delete;
+
+  /// @brief Frees the packed descriptors.
+  ~ndrange_info_s();
+
+  /// @brief Allocator the packed descriptors were allocated with.
+  mux_allocator_info_t allocator_info;
+
   /// @brief Packed descriptors.
   void *packed_args;
 
@@ -306,7 +321,8 @@ struct command_buffer_s final : public mux_command_buffer_s {
   ~command_buffer_s();
 
   mux::small_vector<host::command_info_s, 16> commands;
-  mux::small_vector<std::unique_ptr<host::ndrange_info_s>, 4> ndranges;
+  /// @brief ND ranges referenced by `commands`, possibly shared with clones.
+  mux::small_vector<std::shared_ptr<host::ndrange_info_s>, 4> ndranges;
   mux::small_vector<host::sync_point_s *, 4> sync_points;
   std::mutex mutex;
   mux::small_vector<mux_semaphore_t, 8> signal_semaphores;
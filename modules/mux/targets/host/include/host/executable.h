@@ -24,10 +24,14 @@
 #include <unordered_map>
 #include <vector>
 
+#include "cargo/dynamic_array.h"
+#include "cargo/expected.h"
+#include "cargo/small_vector.h"
 #include "host/utils/jit_kernel.h"
 #include "loader/elf.h"
 #include "loader/mapper.h"
 #include "mux/mux.h"
+#include "mux/utils/allocator.h"
 #include "mux/utils/dynamic_array.h"
 #include "mux/utils/small_vector.h"
 
@@ -61,6 +65,46 @@ struct binary_kernel_s {
 using kernel_variant_map =
     std::unordered_map<std::string, std::vector<::host::binary_kernel_s>>;
 
+/// @brief An ELF binary loaded into executable memory.
+///
+/// Loading is the expensive part of creating an executable, the binary is
+/// parsed, its sections are copied into freshly allocated pages and every
+/// relocation is applied. Images without writable sections are immutable once
+/// loaded, so a single image is shared by all executables created from
+/// identical bytes. As an image may outlive the context it was first created
+/// in it does not use the mux allocator.
+struct elf_image_s {
+  /// @brief Copy of the ELF binary the image was loaded from.
+  ///
+  /// Only kept for shareable images, where it is used to match binaries.
+  cargo::dynamic_array<uint64_t> contents;
+  /// @brief Length in bytes of the ELF binary held in `contents`.
+  uint64_t length = 0;
+  /// @brief Pages allocated by our ELF loader for the binary's sections.
+  cargo::small_vector<loader::PageRange, 4> allocated_pages;
+  /// @brief Map of kernel names to binary kernels contained in the image.
+  kernel_variant_map kernels;
+  /// @brief Whether the image can be shared between executables.
+  bool shareable = false;
+};
+
+/// @brief Get a loaded image of an ELF binary.
+///
+/// Returns the existing image if one has already been loaded from identical
+/// bytes and is shareable, otherwise loads the binary. Images are only shared
+/// within the current process. Each process still loads and relocates its own
+/// copy of a binary.
+///
+/// @param[in] binary ELF binary to load.
+/// @param[in] allocator Allocator used for temporary allocations while
+/// loading.
+///
+/// @return Returns the loaded image on success, or `mux_error_invalid_binary`,
+/// `mux_error_out_of_memory` or `mux_error_internal` on failure.
+cargo::expected<std::shared_ptr<const elf_image_s>, mux_result_t>
+acquireElfImage(cargo::array_view<const uint8_t> binary,
+                mux::allocator allocator);
+
 struct executable_s final : public mux_executable_s {
   /// @brief Create an executable from a single binary kernel outwith an ELF
   /// file.
@@ -68,18 +112,14 @@ struct executable_s final : public mux_executable_s {
   /// @param[in] device Mux device.
   /// @param[in] jit_kernel The single JIT binary kernel to be stored in this
   /// executable.
-  executable_s(mux_device_t device, utils::jit_kernel_s jit_kernel,
-               mux::allocator allocator);
+  executable_s(mux_device_t device, utils::jit_kernel_s jit_kernel);
 
   /// @brief Create an executable from a pre-compiled binary.
   ///
   /// @param[in] device Mux device.
-  /// @param[in] elf_contents Contents of ELF file.
-  /// @param[in] allocated_pages Allocated pages for loaded binary.
-  /// @param[in] binary_kernels Binary kernel map.
-  executable_s(mux_device_t device, mux::dynamic_array<uint64_t> elf_contents,
-               mux::small_vector<loader::PageRange, 4> allocated_pages,
-               host::kernel_variant_map binary_kernels);
+  /// @param[in] elf_image Loaded image of the ELF binary.
+  executable_s(mux_device_t device,
+               std::shared_ptr<const elf_image_s> elf_image);
 
   /// @brief Deleted copy constructor.
   ///
@@ -110,14 +150,11 @@ struct executable_s final : public mux_executable_s {
   /// that kernel.
   std::string jit_kernel_name;
 
-  /// @brief ELF binary this executable was created from.
-  mux::dynamic_array<uint64_t> elf_contents;
-
-  /// @brief Pages allocated by our ELF loader for the binary.
+  /// @brief Loaded image of the ELF binary this executable was created from.
   ///
   /// Kept around here for lifetime reasons, our executable shouldn't outlive
-  /// these.
-  mux::small_vector<loader::PageRange, 4> allocated_pages;
+  /// the pages the image owns.
+  std::shared_ptr<const elf_image_s> elf_image;
 
   /// @brief Map of kernel names to binary kernels contained in this executable.
   kernel_variant_map kernels;
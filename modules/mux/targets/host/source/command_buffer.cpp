@@ -23,6 +23,7 @@
 #include <mux/utils/allocator.h>
 #include <mux/utils/helpers.h>
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <new>
@@ -174,6 +175,11 @@ command_buffer_s::~command_buffer_s() {
   hostDestroyFence(device, fence, allocator_info);
 }
 
+ndrange_info_s::~ndrange_info_s() {
+  mux::allocator allocator(allocator_info);
+  allocator.free(packed_args);
+}
+
 sync_point_s::sync_point_s(mux_command_buffer_t command_buffer) {
   this->command_buffer = command_buffer;
 }
@@ -225,8 +231,8 @@ ndrange_info_s::clone(mux_allocator_info_t allocator_info) const {
   std::memcpy(packed_args_allocation, packed_args, packed_args_alloc_size);
 
   return std::make_unique<host::ndrange_info_s>(
-      packed_args_allocation, clone_arg_addresses, clone_descriptors,
-      global_size, global_offset, local_size, dimensions);
+      allocator_info, packed_args_allocation, clone_arg_addresses,
+      clone_descriptors, global_size, global_offset, local_size, dimensions);
 }
 }  // namespace host
 
@@ -957,9 +963,10 @@ mux_result_t hostCommandNDRange(mux_command_buffer_t command_buffer,
   // Store necessary argument information in the packed args allocation
   populatePackedArgs(packed_args_allocation, descriptors);
 
-  if (host->ndranges.emplace_back(std::make_unique<host::ndrange_info_s>(
-          packed_args_allocation, arg_addresses, descriptors, global_size,
-          global_offset, local_size, options.dimensions))) {
+  if (host->ndranges.emplace_back(std::make_shared<host::ndrange_info_s>(
+          host_kernel->allocator_info, packed_args_allocation, arg_addresses,
+          descriptors, global_size, global_offset, local_size,
+          options.dimensions))) {
     return mux_error_out_of_memory;
   }
 
@@ -987,6 +994,7 @@ mux_result_t hostUpdateDescriptors(mux_command_buffer_t command_buffer,
                                    mux_descriptor_info_t *descriptors) {
   // Get the command to update.
   auto *host = static_cast<host::command_buffer_s *>(command_buffer);
+  std::lock_guard<std::mutex> lock(host->mutex);
   auto &nd_range_to_update = host->commands[command_id];
 
   // Check the command being updated is actually an ND range.
@@ -994,6 +1002,24 @@ mux_result_t hostUpdateDescriptors(mux_command_buffer_t command_buffer,
     return mux_error_invalid_value;
   }
 
+  // ND ranges are shared with clones of the command buffer, copy it before
+  // writing so the update is only seen by this command buffer.
+  host::ndrange_info_s *&ndrange_info =
+      nd_range_to_update.ndrange_command.ndrange_info;
+  auto shared = std::find_if(
+      host->ndranges.begin(), host->ndranges.end(),
+      [&](const std::shared_ptr<host::ndrange_info_s> &ndrange) {
+        return ndrange.get() == ndrange_info;
+      });
+  if (shared != host->ndranges.end() && shared->use_count() > 1) {
+    auto copy = ndrange_info->clone(host->allocator_info);
+    if (!copy) {
+      return copy.error();
+    }
+    *shared = std::move(*copy);
+    ndrange_info = shared->get();
+  }
+
   // Patch its arguments.
   for (unsigned i = 0; i < num_args; ++i) {
     auto index = arg_indices[i];
@@ -1209,39 +1235,22 @@ mux_result_t hostCloneCommandBuffer(mux_device_t device,
     return mux_error_out_of_memory;
   }
 
-  // Deep copy ndrange kernel commands so that we can update them with the
-  // MuxUpdateDescriptors() without affecting the original command-buffer.
+  // Share the ndrange kernel commands with the original command-buffer, they
+  // are only copied if MuxUpdateDescriptors() is called on either command
+  // buffer so cloning does not copy the packed arguments of every kernel.
   auto *host_command_buffer =
       static_cast<host::command_buffer_s *>(command_buffer);
   std::lock_guard<std::mutex> lock_original(host_command_buffer->mutex);
   std::lock_guard<std::mutex> lock_clone{cloned_command_buffer->mutex};
-  for (const auto &command : host_command_buffer->commands) {
-    if (command.type != host::command_type_ndrange) {
-      if (cloned_command_buffer->commands.push_back(command)) {
-        return mux_error_out_of_memory;
-      }
-    } else {
-      const host::command_info_ndrange_s &ndrange_command =
-          command.ndrange_command;
-      const auto &ndrange_info = ndrange_command.ndrange_info;
-
-      auto cloned_ndrange_info = ndrange_info->clone(allocator_info);
-      if (!cloned_ndrange_info) {
-        return cloned_ndrange_info.error();
-      }
-
-      if (cloned_command_buffer->ndranges.emplace_back(
-              std::move(*cloned_ndrange_info))) {
-        return mux_error_out_of_memory;
-      }
-
-      if (cloned_command_buffer->commands.push_back(
-              host::command_info_ndrange_s{
-                  ndrange_command.kernel,
-                  cloned_command_buffer->ndranges.back().get()})) {
-        return mux_error_out_of_memory;
-      }
-    }
+  if (!cloned_command_buffer->commands.insert(
+          cloned_command_buffer->commands.end(),
+          host_command_buffer->commands.begin(),
+          host_command_buffer->commands.end()) ||
+      !cloned_command_buffer->ndranges.insert(
+          cloned_command_buffer->ndranges.end(),
+          host_command_buffer->ndranges.begin(),
+          host_command_buffer->ndranges.end())) {
+    return mux_error_out_of_memory;
   }
 
   *out_command_buffer = cloned_command_buffer;
@@ -1256,10 +1265,6 @@ void hostDestroyCommandBuffer(mux_device_t device,
   mux::allocator allocator(allocator_info);
 
   auto host = static_cast<host::command_buffer_s *>(command_buffer);
-  for (auto &range : host->ndranges) {
-    allocator.free(range->packed_args);
-  }
-
   for (auto sync_point : host->sync_points) {
     allocator.destroy(sync_point);
   }
@@ -19,21 +19,23 @@
 #include <host/executable.h>
 #include <host/host.h>
 #include <host/metadata_hooks.h>
+#include <host/utils/fat_binary.h>
 #include <host/utils/jit_kernel.h>
 #include <host/utils/relocations.h>
 #include <loader/relocations.h>
 #include <mux/utils/allocator.h>
 #include <utils/system.h>
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
 #include <new>
+#include <string_view>
+#include <unordered_map>
 
 host::executable_s::executable_s(mux_device_t device,
-                                 utils::jit_kernel_s kernel,
-                                 mux::allocator allocator)
-    : jit_kernel_name(kernel.name),
-      elf_contents(allocator),
-      allocated_pages(allocator) {
+                                 utils::jit_kernel_s kernel)
+    : jit_kernel_name(kernel.name) {
   this->device = device;
   kernels.emplace(jit_kernel_name,
                   std::vector<binary_kernel_s>(
@@ -43,66 +45,87 @@ host::executable_s::executable_s(mux_device_t device,
 }
 
 host::executable_s::executable_s(
-    mux_device_t device, mux::dynamic_array<uint64_t> elf_contents,
-    mux::small_vector<loader::PageRange, 4> allocated_pages,
-    kernel_variant_map binary_kernels)
-    : elf_contents(std::move(elf_contents)),
-      allocated_pages(std::move(allocated_pages)),
-      kernels(std::move(binary_kernels)) {
+    mux_device_t device, std::shared_ptr<const elf_image_s> elf_image)
+    : elf_image(std::move(elf_image)), kernels(this->elf_image->kernels) {
   this->device = device;
 }
 
-mux_result_t hostCreateExecutable(mux_device_t device, const void *binary,
-                                  uint64_t binary_length,
-                                  mux_allocator_info_t allocator_info,
-                                  mux_executable_t *out_executable) {
-  mux::allocator allocator(allocator_info);
+namespace {
+/// @brief Process wide cache of shareable ELF images.
+///
+/// Images are keyed by a hash of the binary they were loaded from, matches are
+/// confirmed by comparing against the binary held by the image. The cache only
+/// holds weak references, an image is destroyed along with the last executable
+/// using it.
+struct elf_image_cache_s {
+  std::mutex mutex;
+  std::unordered_multimap<size_t, std::weak_ptr<const host::elf_image_s>>
+      images;
+};
 
-  // If we're passing through a JIT compiled kernel.
-  if (host::utils::isJITKernel(binary, binary_length)) {
-    cargo::optional<host::utils::jit_kernel_s> jit_kernel =
-        host::utils::deserializeJITKernel(binary, binary_length);
-    if (!jit_kernel) {
-      return mux_error_invalid_binary;
-    }
+elf_image_cache_s &getElfImageCache() {
+  static elf_image_cache_s cache;
+  return cache;
+}
 
-    auto executable = allocator.create<host::executable_s>(
-        device, std::move(*jit_kernel), allocator);
-    if (nullptr == executable) {
-      return mux_error_out_of_memory;
+size_t hashBinary(cargo::array_view<const uint8_t> binary) {
+  return std::hash<std::string_view>{}(std::string_view{
+      reinterpret_cast<const char *>(binary.data()), binary.size()});
+}
+
+/// @brief Find a live image loaded from @p binary, cache mutex must be held.
+std::shared_ptr<const host::elf_image_s> findElfImage(
+    elf_image_cache_s &cache, size_t hash,
+    cargo::array_view<const uint8_t> binary) {
+  auto range = cache.images.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto image = it->second.lock();
+    if (image && image->length == binary.size() &&
+        std::equal(binary.begin(), binary.end(),
+                   reinterpret_cast<const uint8_t *>(image->contents.data()))) {
+      return image;
     }
+  }
+  return nullptr;
+}
 
-    *out_executable = executable;
-    return mux_success;
+cargo::expected<std::shared_ptr<host::elf_image_s>, mux_result_t>
+loadElfImage(cargo::array_view<const uint8_t> binary,
+             mux::allocator &allocator) {
+  std::shared_ptr<host::elf_image_s> image{new (std::nothrow)
+                                               host::elf_image_s};
+  if (nullptr == image) {
+    return cargo::make_unexpected(mux_error_out_of_memory);
   }
 
-  mux::dynamic_array<uint64_t> elf_contents{allocator};
-  if (elf_contents.alloc((binary_length / sizeof(uint64_t)) + 1)) {
-    return mux_error_out_of_memory;
+  if (image->contents.alloc((binary.size() / sizeof(uint64_t)) + 1)) {
+    return cargo::make_unexpected(mux_error_out_of_memory);
   }
+  image->length = binary.size();
   cargo::array_view<uint8_t> elf_bytes{
-      reinterpret_cast<uint8_t *>(elf_contents.data()),
-      static_cast<size_t>(binary_length)};
-  std::copy_n(reinterpret_cast<const uint8_t *>(binary),
-              static_cast<size_t>(binary_length), elf_bytes.begin());
-  host::kernel_variant_map kernels;
+      reinterpret_cast<uint8_t *>(image->contents.data()), binary.size()};
+  std::copy(binary.begin(), binary.end(), elf_bytes.begin());
 
   if (!loader::ElfFile::isValidElf(elf_bytes)) {
-    return mux_error_invalid_binary;
+    return cargo::make_unexpected(mux_error_invalid_binary);
   }
   std::unique_ptr<loader::ElfFile> elf_file{new loader::ElfFile(elf_bytes)};
 
   auto parsed_kernels = host::readBinaryMetadata(elf_file.get(), &allocator);
   if (parsed_kernels) {
-    kernels = std::move(parsed_kernels.take().value());
+    image->kernels = std::move(parsed_kernels.take().value());
   } else {
-    return mux_error_invalid_binary;
+    return cargo::make_unexpected(mux_error_invalid_binary);
   }
 
-  mux::small_vector<loader::PageRange, 4> allocated_pages{allocator};
-  mux::small_vector<loader::MemoryProtection, 4> page_protection{allocator};
+  auto &allocated_pages = image->allocated_pages;
+  cargo::small_vector<loader::MemoryProtection, 4> page_protection;
   loader::ElfMap elf_map{elf_file.get()};
 
+  // Sections which are written to while kernels run would be shared between
+  // executables, only read-only images can be reused.
+  image->shareable = true;
+
   // load
   for (auto &section : elf_file->sections()) {
     if (!(section.flags() & loader::ElfFields::SectionFlags::ALLOC)) {
@@ -116,15 +139,18 @@ mux_result_t hostCreateExecutable(mux_device_t device, const void *binary,
     // allocate and protect pages if the size is greater than 0.
     if (section.sizeToAlloc() > 0) {
       if (allocated_pages.emplace_back()) {
-        return mux_error_out_of_memory;
+        return cargo::make_unexpected(mux_error_out_of_memory);
       }
       if (page_protection.emplace_back()) {
-        return mux_error_out_of_memory;
+        return cargo::make_unexpected(mux_error_out_of_memory);
       }
       if (allocated_pages.back().allocate(section.sizeToAlloc())) {
-        return mux_error_out_of_memory;
+        return cargo::make_unexpected(mux_error_out_of_memory);
       }
       page_protection.back() = loader::getSectionProtection(section);
+      if (page_protection.back() & loader::MEM_WRITABLE) {
+        image->shareable = false;
+      }
       if (section.type() != loader::ElfFields::SectionType::NOBITS) {
         std::copy(section.data().begin(), section.data().end(),
                   allocated_pages.back().data().begin());
@@ -133,11 +159,11 @@ mux_result_t hostCreateExecutable(mux_device_t device, const void *binary,
       if (elf_map.addSectionMapping(section, dataptr,
                                     allocated_pages.back().data().end(),
                                     reinterpret_cast<uint64_t>(dataptr))) {
-        return mux_error_out_of_memory;
+        return cargo::make_unexpected(mux_error_out_of_memory);
       }
     } else {
       if (elf_map.addSectionMapping(section, nullptr, nullptr, 0)) {
-        return mux_error_out_of_memory;
+        return cargo::make_unexpected(mux_error_out_of_memory);
       }
     }
   }
@@ -146,7 +172,7 @@ mux_result_t hostCreateExecutable(mux_device_t device, const void *binary,
   // functions
   for (const auto &reloc : host::utils::getRelocations()) {
     if (elf_map.addCallback(reloc.first, reloc.second)) {
-      return mux_error_out_of_memory;
+      return cargo::make_unexpected(mux_error_out_of_memory);
     }
   }
 
@@ -155,7 +181,7 @@ mux_result_t hostCreateExecutable(mux_device_t device, const void *binary,
   // callback isn't getting added. See the `elf_map.addCallback()`s above.
   // Callbacks are resolved in `loader::ElfMap::getSymbolTargetAddress()`.
   if (!loader::resolveRelocations(*elf_file, elf_map)) {
-    return mux_error_internal;
+    return cargo::make_unexpected(mux_error_internal);
   }
 
   // protect
@@ -164,20 +190,112 @@ mux_result_t hostCreateExecutable(mux_device_t device, const void *binary,
   }
 
   // set hooks
-  for (auto &p : kernels) {
+  for (auto &p : image->kernels) {
     for (auto &variant : p.second) {
       auto hook = elf_map.getSymbolTargetAddress(
           {variant.kernel_name.data(), variant.kernel_name.size()});
       if (!hook) {
-        return mux_error_invalid_binary;
+        return cargo::make_unexpected(mux_error_invalid_binary);
       }
       variant.hook = *hook;
     }
   }
 
-  auto executable = allocator.create<host::executable_s>(
-      device, std::move(elf_contents), std::move(allocated_pages),
-      std::move(kernels));
+  // The binary is only needed after loading to match against other binaries.
+  if (!image->shareable) {
+    image->contents.clear();
+    image->length = 0;
+  }
+
+  return image;
+}
+}  // namespace
+
+cargo::expected<std::shared_ptr<const host::elf_image_s>, mux_result_t>
+host::acquireElfImage(cargo::array_view<const uint8_t> binary,
+                      mux::allocator allocator) {
+  auto &cache = getElfImageCache();
+  const size_t hash = hashBinary(binary);
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (auto image = findElfImage(cache, hash, binary)) {
+      return image;
+    }
+  }
+
+  // Load outside of the lock, this is the expensive part.
+  auto image = loadElfImage(binary, allocator);
+  if (!image) {
+    return cargo::make_unexpected(image.error());
+  }
+  if (!(*image)->shareable) {
+    return std::shared_ptr<const host::elf_image_s>{std::move(*image)};
+  }
+
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  // Another thread may have loaded the same binary in the meantime, prefer
+  // its image so there is only ever one copy.
+  if (auto existing = findElfImage(cache, hash, binary)) {
+    return existing;
+  }
+  // Drop entries for images which have since been destroyed.
+  for (auto it = cache.images.begin(); it != cache.images.end();) {
+    if (it->second.expired()) {
+      it = cache.images.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  cache.images.emplace(hash, *image);
+  return std::shared_ptr<const host::elf_image_s>{std::move(*image)};
+}
+
+mux_result_t hostCreateExecutable(mux_device_t device, const void *binary,
+                                  uint64_t binary_length,
+                                  mux_allocator_info_t allocator_info,
+                                  mux_executable_t *out_executable) {
+  mux::allocator allocator(allocator_info);
+
+  // If we're passing through a JIT compiled kernel.
+  if (host::utils::isJITKernel(binary, binary_length)) {
+    cargo::optional<host::utils::jit_kernel_s> jit_kernel =
+        host::utils::deserializeJITKernel(binary, binary_length);
+    if (!jit_kernel) {
+      return mux_error_invalid_binary;
+    }
+
+    auto executable =
+        allocator.create<host::executable_s>(device, std::move(*jit_kernel));
+    if (nullptr == executable) {
+      return mux_error_out_of_memory;
+    }
+
+    *out_executable = executable;
+    return mux_success;
+  }
+
+  // Offline compiled binaries may contain an ELF executable for each of
+  // several ISA levels; pick the best one the running CPU supports.
+  if (host::utils::isFatBinary(binary, binary_length)) {
+    auto variant = host::utils::selectFatBinaryVariant(
+        binary, binary_length, host::utils::getHostISALevel());
+    if (!variant) {
+      return mux_error_invalid_binary;
+    }
+    binary = variant->data();
+    binary_length = variant->size();
+  }
+
+  auto elf_image = host::acquireElfImage(
+      {reinterpret_cast<const uint8_t *>(binary),
+       static_cast<size_t>(binary_length)},
+      allocator);
+  if (!elf_image) {
+    return elf_image.error();
+  }
+
+  auto executable =
+      allocator.create<host::executable_s>(device, std::move(*elf_image));
   if (nullptr == executable) {
     return mux_error_out_of_memory;
   }
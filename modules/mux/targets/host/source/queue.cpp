@@ -32,6 +32,8 @@
 #include <libimg/host.h>
 #endif
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstring>
 #include <memory>
@@ -123,7 +125,83 @@ void commandCopyBuffer(host::command_info_s *info) {
               copy->size);
 }
 
-void commandReadImage(host::command_info_s *info) {
+#ifdef HOST_IMAGE_SUPPORT
+/// Image commands moving fewer bytes than this are run on the calling thread,
+/// as splitting them across the thread pool would cost more than it saves.
+constexpr size_t image_tile_min_bytes = 1 << 20;
+
+/// @brief A tile of the region of an image command.
+struct image_tile_s {
+  /// @brief Offset in pixels of the tile from the origin of the region.
+  size_t offset[3];
+  /// @brief Extent in pixels of the tile.
+  size_t region[3];
+};
+
+/// @brief Split the region of an image command into tiles and process them
+/// across the thread pool.
+///
+/// 3D regions are split into ranges of slices and 2D regions into ranges of
+/// rows, so each tile is a box that libimg can process independently. Small
+/// regions are processed as a single tile on the calling thread.
+///
+/// @tparam F Type of the function processing a tile.
+///
+/// @param[in] queue Queue executing the command.
+/// @param[in] region Extent in pixels of the command's region.
+/// @param[in] pixel_size Size in bytes of a pixel of the image.
+/// @param[in] f Function called with each `image_tile_s`.
+template <typename F>
+void forEachImageTile(host::queue_s *queue, const size_t region[3],
+                      size_t pixel_size, const F &f) {
+  auto host_device = static_cast<host::device_s *>(queue->device);
+  auto &thread_pool = host_device->thread_pool;
+
+  const size_t split_dim = region[2] > 1 ? 2 : 1;
+  const size_t bytes = region[0] * region[1] * region[2] * pixel_size;
+  const size_t tiles = std::min(thread_pool.num_threads(), region[split_dim]);
+
+  if (tiles < 2 || bytes < image_tile_min_bytes) {
+    f(image_tile_s{{0, 0, 0}, {region[0], region[1], region[2]}});
+    return;
+  }
+
+  struct tiling_s {
+    const F *f;
+    const size_t *region;
+    size_t split_dim;
+    size_t tiles;
+  } tiling{&f, region, split_dim, tiles};
+
+  std::array<std::atomic<bool>, host::thread_pool_s::max_num_threads> signals;
+  std::atomic<uint32_t> queued(0);
+  thread_pool.enqueue_range(
+      [](void *const in, void *const, void *const, size_t index) {
+        auto *const tiling = static_cast<tiling_s *>(in);
+        const size_t extent = tiling->region[tiling->split_dim];
+        const size_t begin = index * extent / tiling->tiles;
+        const size_t end = (index + 1) * extent / tiling->tiles;
+
+        image_tile_s tile{
+            {0, 0, 0},
+            {tiling->region[0], tiling->region[1], tiling->region[2]}};
+        tile.offset[tiling->split_dim] = begin;
+        tile.region[tiling->split_dim] = end - begin;
+        (*tiling->f)(tile);
+      },
+      &tiling, nullptr, signals, &queued, tiles);
+
+  // See commandNDRange for why waiting on the pool alone is not enough.
+  thread_pool.wait(&queued);
+  {
+    std::unique_lock<std::mutex> lock(thread_pool.wait_mutex);
+    thread_pool.finished.wait(lock, [&queued] { return queued == 0; });
+  }
+  assert(0 == queued);
+}
+#endif
+
+void commandReadImage(host::queue_s *queue, host::command_info_s *info) {
 #ifdef HOST_IMAGE_SUPPORT
   host::command_info_read_image_s const &read = info->read_image_command;
 
@@ -134,14 +212,22 @@ void commandReadImage(host::command_info_s *info) {
   const size_t slice_pitch = static_cast<size_t>(read.slice_size);
   uint8_t *pointer = static_cast<uint8_t *>(read.pointer);
 
-  libimg::HostReadImage(&image->image, origin, region, row_pitch, slice_pitch,
-                        pointer);
+  forEachImageTile(
+      queue, region, image->pixel_size, [&](const image_tile_s &tile) {
+        const size_t tile_origin[3] = {origin[0], origin[1] + tile.offset[1],
+                                       origin[2] + tile.offset[2]};
+        libimg::HostReadImage(&image->image, tile_origin, tile.region,
+                              row_pitch, slice_pitch,
+                              pointer + tile.offset[1] * row_pitch +
+                                  tile.offset[2] * slice_pitch);
+      });
 #else
+  (void)queue;
   (void)info;
 #endif
 }
 
-void commandWriteImage(host::command_info_s *info) {
+void commandWriteImage(host::queue_s *queue, host::command_info_s *info) {
 #ifdef HOST_IMAGE_SUPPORT
   host::command_info_write_image_s const &write = info->write_image_command;
 
@@ -152,14 +238,22 @@ void commandWriteImage(host::command_info_s *info) {
   size_t slice_pitch = static_cast<size_t>(write.slice_size);
   const uint8_t *pointer = static_cast<const uint8_t *>(write.pointer);
 
-  libimg::HostWriteImage(&image->image, origin, region, row_pitch, slice_pitch,
-                         pointer);
+  forEachImageTile(
+      queue, region, image->pixel_size, [&](const image_tile_s &tile) {
+        const size_t tile_origin[3] = {origin[0], origin[1] + tile.offset[1],
+                                       origin[2] + tile.offset[2]};
+        libimg::HostWriteImage(&image->image, tile_origin, tile.region,
+                               row_pitch, slice_pitch,
+                               pointer + tile.offset[1] * row_pitch +
+                                   tile.offset[2] * slice_pitch);
+      });
 #else
+  (void)queue;
   (void)info;
 #endif
 }
 
-void commandFillImage(host::command_info_s *info) {
+void commandFillImage(host::queue_s *queue, host::command_info_s *info) {
 #ifdef HOST_IMAGE_SUPPORT
   host::command_info_fill_image_s const &fill = info->fill_image_command;
 
@@ -167,13 +261,20 @@ void commandFillImage(host::command_info_s *info) {
 
   size_t origin[3] = {fill.offset.x, fill.offset.y, fill.offset.z};
   size_t region[3] = {fill.extent.x, fill.extent.y, fill.extent.z};
-  libimg::HostFillImage(&image->image, fill.color, origin, region);
+  forEachImageTile(
+      queue, region, image->pixel_size, [&](const image_tile_s &tile) {
+        const size_t tile_origin[3] = {origin[0], origin[1] + tile.offset[1],
+                                       origin[2] + tile.offset[2]};
+        libimg::HostFillImage(&image->image, fill.color, tile_origin,
+                              tile.region);
+      });
 #else
+  (void)queue;
   (void)info;
 #endif
 }
 
-void commandCopyImage(host::command_info_s *info) {
+void commandCopyImage(host::queue_s *queue, host::command_info_s *info) {
 #ifdef HOST_IMAGE_SUPPORT
   host::command_info_copy_image_s *const copy = &(info->copy_image_command);
 
@@ -185,14 +286,25 @@ void commandCopyImage(host::command_info_s *info) {
   size_t dstOrigin[3] = {copy->dst_offset.x, copy->dst_offset.y,
                          copy->dst_offset.z};
   size_t region[3] = {copy->extent.x, copy->extent.y, copy->extent.z};
-  libimg::HostCopyImage(&srcImage->image, &dstImage->image, srcOrigin,
-                        dstOrigin, region);
+  forEachImageTile(
+      queue, region, srcImage->pixel_size, [&](const image_tile_s &tile) {
+        const size_t tileSrcOrigin[3] = {srcOrigin[0],
+                                         srcOrigin[1] + tile.offset[1],
+                                         srcOrigin[2] + tile.offset[2]};
+        const size_t tileDstOrigin[3] = {dstOrigin[0],
+                                         dstOrigin[1] + tile.offset[1],
+                                         dstOrigin[2] + tile.offset[2]};
+        libimg::HostCopyImage(&srcImage->image, &dstImage->image,
+                              tileSrcOrigin, tileDstOrigin, tile.region);
+      });
 #else
+  (void)queue;
   (void)info;
 #endif
 }
 
-void commandCopyImageToBuffer(host::command_info_s *info) {
+void commandCopyImageToBuffer(host::queue_s *queue,
+                              host::command_info_s *info) {
 #ifdef HOST_IMAGE_SUPPORT
   host::command_info_copy_image_to_buffer_s const &copy =
       info->copy_image_to_buffer_command;
@@ -204,14 +316,28 @@ void commandCopyImageToBuffer(host::command_info_s *info) {
                          copy.src_offset.z};
   size_t region[3] = {copy.extent.x, copy.extent.y, copy.extent.z};
   size_t dstOffset = static_cast<size_t>(copy.dst_offset);
-  libimg::HostCopyImageToBuffer(&srcImage->image, dstBuffer->data, srcOrigin,
-                                region, dstOffset);
+  // The buffer side of the copy is tightly packed.
+  const size_t rowSize = region[0] * srcImage->pixel_size;
+  forEachImageTile(
+      queue, region, srcImage->pixel_size, [&](const image_tile_s &tile) {
+        const size_t tileSrcOrigin[3] = {srcOrigin[0],
+                                         srcOrigin[1] + tile.offset[1],
+                                         srcOrigin[2] + tile.offset[2]};
+        const size_t tileDstOffset =
+            dstOffset +
+            (tile.offset[2] * region[1] + tile.offset[1]) * rowSize;
+        libimg::HostCopyImageToBuffer(&srcImage->image, dstBuffer->data,
+                                      tileSrcOrigin, tile.region,
+                                      tileDstOffset);
+      });
 #else
+  (void)queue;
   (void)info;
 #endif
 }
 
-void commandCopyBufferToImage(host::command_info_s *info) {
+void commandCopyBufferToImage(host::queue_s *queue,
+                              host::command_info_s *info) {
 #ifdef HOST_IMAGE_SUPPORT
   host::command_info_copy_buffer_to_image_s *copy =
       &(info->copy_buffer_to_image_command);
@@ -223,9 +349,22 @@ void commandCopyBufferToImage(host::command_info_s *info) {
                          copy->dst_offset.z};
   size_t region[3] = {copy->extent.x, copy->extent.y, copy->extent.z};
 
-  libimg::HostCopyBufferToImage(srcBuffer->data, &dstImage->image,
-                                copy->src_offset, dstOrigin, region);
+  // The buffer side of the copy is tightly packed.
+  const size_t rowSize = region[0] * dstImage->pixel_size;
+  forEachImageTile(
+      queue, region, dstImage->pixel_size, [&](const image_tile_s &tile) {
+        const size_t tileSrcOffset =
+            copy->src_offset +
+            (tile.offset[2] * region[1] + tile.offset[1]) * rowSize;
+        const size_t tileDstOrigin[3] = {dstOrigin[0],
+                                         dstOrigin[1] + tile.offset[1],
+                                         dstOrigin[2] + tile.offset[2]};
+        libimg::HostCopyBufferToImage(srcBuffer->data, &dstImage->image,
+                                      tileSrcOffset, tileDstOrigin,
+                                      tile.region);
+      });
 #else
+  (void)queue;
   (void)info;
 #endif
 }
@@ -393,22 +532,22 @@ void threadPoolProcessCommands(void *const v_queue,
         commandCopyBuffer(info);
         break;
       case host::command_type_read_image:
-        commandReadImage(info);
+        commandReadImage(queue, info);
         break;
       case host::command_type_write_image:
-        commandWriteImage(info);
+        commandWriteImage(queue, info);
         break;
       case host::command_type_fill_image:
-        commandFillImage(info);
+        commandFillImage(queue, info);
         break;
       case host::command_type_copy_image:
-        commandCopyImage(info);
+        commandCopyImage(queue, info);
         break;
       case host::command_type_copy_image_to_buffer:
-        commandCopyImageToBuffer(info);
+        commandCopyImageToBuffer(queue, info);
         break;
       case host::command_type_copy_buffer_to_image:
-        commandCopyBufferToImage(info);
+        commandCopyBufferToImage(queue, info);
         break;
       case host::command_type_ndrange:
         commandNDRange(queue, info);
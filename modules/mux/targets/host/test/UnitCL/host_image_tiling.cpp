@@ -0,0 +1,168 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <CL/cl.h>
+#include <Common.h>
+
+#include <array>
+#include <vector>
+
+#include "Device.h"
+
+// Host splits large image commands into tiles across its thread pool, check
+// that every command touches exactly the pixels of its region when tiled.
+struct host_image_tiling_test
+    : ucl::CommandQueueTest,
+      testing::WithParamInterface<cl_mem_object_type> {
+  void SetUp() override {
+    UCL_RETURN_ON_FATAL_FAILURE(CommandQueueTest::SetUp());
+    if (!UCL::isDevice_host(device) || !getDeviceImageSupport()) {
+      GTEST_SKIP();
+    }
+    desc.image_type = GetParam();
+    if (CL_MEM_OBJECT_IMAGE3D == desc.image_type) {
+      desc.image_width = 256;
+      desc.image_height = 128;
+      desc.image_depth = 16;
+    } else {
+      desc.image_width = 1024;
+      desc.image_height = 512;
+      desc.image_depth = 1;
+    }
+    if (!UCL::isImageFormatSupported(context, {CL_MEM_READ_WRITE},
+                                     desc.image_type, format)) {
+      GTEST_SKIP();
+    }
+  }
+
+  void TearDown() override {
+    for (cl_mem mem_object : mem_objects) {
+      EXPECT_SUCCESS(clReleaseMemObject(mem_object));
+    }
+    CommandQueueTest::TearDown();
+  }
+
+  cl_mem createImage() {
+    cl_int error;
+    cl_mem image = clCreateImage(context, CL_MEM_READ_WRITE, &format, &desc,
+                                 nullptr, &error);
+    EXPECT_SUCCESS(error);
+    mem_objects.push_back(image);
+    return image;
+  }
+
+  size_t pixelIndex(size_t x, size_t y, size_t z) const {
+    return (z * desc.image_height + y) * desc.image_width + x;
+  }
+
+  cl_image_format format = {CL_RGBA, CL_UNSIGNED_INT32};
+  cl_image_desc desc = {};
+  std::vector<cl_mem> mem_objects;
+};
+
+TEST_P(host_image_tiling_test, Transfers) {
+  const size_t width = desc.image_width;
+  const size_t height = desc.image_height;
+  const size_t depth = desc.image_depth;
+  const size_t full_origin[3] = {0, 0, 0};
+  const size_t full_region[3] = {width, height, depth};
+
+  std::vector<cl_uint4> pixels(width * height * depth);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    for (cl_uint element = 0; element < 4; element++) {
+      pixels[i].s[element] = static_cast<cl_uint>(i * 4 + element);
+    }
+  }
+
+  cl_mem image = createImage();
+  ASSERT_SUCCESS(clEnqueueWriteImage(command_queue, image, CL_FALSE,
+                                     full_origin, full_region, 0, 0,
+                                     pixels.data(), 0, nullptr, nullptr));
+
+  const cl_uint4 color = {{0xdead, 0xbeef, 0xf00d, 0xcafe}};
+  const size_t fill_origin[3] = {5, 3, depth > 1 ? 2u : 0u};
+  const size_t fill_region[3] = {width - 10, height - 6,
+                                 depth > 1 ? depth - 4 : 1};
+  ASSERT_SUCCESS(clEnqueueFillImage(command_queue, image, &color, fill_origin,
+                                    fill_region, 0, nullptr, nullptr));
+  for (size_t z = 0; z < fill_region[2]; z++) {
+    for (size_t y = 0; y < fill_region[1]; y++) {
+      for (size_t x = 0; x < fill_region[0]; x++) {
+        pixels[pixelIndex(x + fill_origin[0], y + fill_origin[1],
+                          z + fill_origin[2])] = color;
+      }
+    }
+  }
+
+  cl_mem copy = createImage();
+  ASSERT_SUCCESS(clEnqueueCopyImage(command_queue, image, copy, full_origin,
+                                    full_origin, full_region, 0, nullptr,
+                                    nullptr));
+
+  // Round trip an offset region of the copy through a buffer into a third
+  // image at a different origin.
+  const size_t src_origin[3] = {1, 2, depth > 1 ? 1u : 0u};
+  const size_t dst_origin[3] = {3, 1, 0};
+  const size_t region[3] = {width - 4, height - 3, depth > 1 ? depth - 1 : 1};
+  const size_t region_size =
+      region[0] * region[1] * region[2] * sizeof(cl_uint4);
+  cl_int error;
+  cl_mem buffer =
+      clCreateBuffer(context, CL_MEM_READ_WRITE, region_size, nullptr, &error);
+  ASSERT_SUCCESS(error);
+  mem_objects.push_back(buffer);
+  ASSERT_SUCCESS(clEnqueueCopyImageToBuffer(command_queue, copy, buffer,
+                                            src_origin, region, 0, 0, nullptr,
+                                            nullptr));
+
+  cl_mem result_image = createImage();
+  const std::vector<cl_uint4> zeros(pixels.size(), cl_uint4{});
+  ASSERT_SUCCESS(clEnqueueWriteImage(command_queue, result_image, CL_FALSE,
+                                     full_origin, full_region, 0, 0,
+                                     zeros.data(), 0, nullptr, nullptr));
+  ASSERT_SUCCESS(clEnqueueCopyBufferToImage(command_queue, buffer,
+                                            result_image, 0, dst_origin,
+                                            region, 0, nullptr, nullptr));
+
+  std::vector<cl_uint4> result(pixels.size());
+  ASSERT_SUCCESS(clEnqueueReadImage(command_queue, result_image, CL_TRUE,
+                                    full_origin, full_region, 0, 0,
+                                    result.data(), 0, nullptr, nullptr));
+
+  for (size_t z = 0; z < depth; z++) {
+    for (size_t y = 0; y < height; y++) {
+      for (size_t x = 0; x < width; x++) {
+        cl_uint4 expected = {};
+        if (x >= dst_origin[0] && x < dst_origin[0] + region[0] &&
+            y >= dst_origin[1] && y < dst_origin[1] + region[1] &&
+            z >= dst_origin[2] && z < dst_origin[2] + region[2]) {
+          expected = pixels[pixelIndex(x - dst_origin[0] + src_origin[0],
+                                       y - dst_origin[1] + src_origin[1],
+                                       z - dst_origin[2] + src_origin[2])];
+        }
+        const cl_uint4 &actual = result[pixelIndex(x, y, z)];
+        for (size_t element = 0; element < 4; element++) {
+          ASSERT_EQ(expected.s[element], actual.s[element])
+              << "at (" << x << ", " << y << ", " << z << ")";
+        }
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(Image, host_image_tiling_test,
+                        testing::Values(CL_MEM_OBJECT_IMAGE2D,
+                                        CL_MEM_OBJECT_IMAGE3D));
@@ -0,0 +1,124 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+
+#include <CL/cl.h>
+#include <Common.h>
+
+#include <vector>
+
+#include "Device.h"
+
+// When CA_HOST_MULTIVERSION_BINARIES is set and no target CPU is forced, host
+// compiles a baseline object along with ISA specific variants, wrapping them in
+// a fat binary which is unpacked when the executable is loaded. Check that
+// binaries round-trip through clCreateProgramWithBinary and still execute
+// correctly, whether or not multiversioning is enabled.
+struct host_multiversioned_binary_test : ucl::CommandQueueTest {
+  void SetUp() override {
+    UCL_RETURN_ON_FATAL_FAILURE(CommandQueueTest::SetUp());
+    if (!UCL::isDevice_host(device) || !getDeviceCompilerAvailable()) {
+      GTEST_SKIP();
+    }
+  }
+
+  void TearDown() override {
+    if (kernel) {
+      EXPECT_SUCCESS(clReleaseKernel(kernel));
+    }
+    if (binary_program) {
+      EXPECT_SUCCESS(clReleaseProgram(binary_program));
+    }
+    if (source_program) {
+      EXPECT_SUCCESS(clReleaseProgram(source_program));
+    }
+    CommandQueueTest::TearDown();
+  }
+
+  cl_program source_program = nullptr;
+  cl_program binary_program = nullptr;
+  cl_kernel kernel = nullptr;
+};
+
+TEST_F(host_multiversioned_binary_test, RoundTrip) {
+  const char *source =
+      "kernel void saxpy(float a, global float *x, global float *y) {\n"
+      "  size_t i = get_global_id(0);\n"
+      "  y[i] = a * x[i] + y[i];\n"
+      "}\n";
+  cl_int error;
+  source_program =
+      clCreateProgramWithSource(context, 1, &source, nullptr, &error);
+  ASSERT_SUCCESS(error);
+  ASSERT_SUCCESS(
+      clBuildProgram(source_program, 1, &device, nullptr, nullptr, nullptr));
+
+  size_t binary_size = 0;
+  ASSERT_SUCCESS(clGetProgramInfo(source_program, CL_PROGRAM_BINARY_SIZES,
+                                  sizeof(binary_size), &binary_size, nullptr));
+  ASSERT_NE(0u, binary_size);
+  std::vector<unsigned char> binary(binary_size);
+  unsigned char *binary_ptr = binary.data();
+  ASSERT_SUCCESS(clGetProgramInfo(source_program, CL_PROGRAM_BINARIES,
+                                  sizeof(binary_ptr), &binary_ptr, nullptr));
+
+  const unsigned char *binaries[] = {binary.data()};
+  cl_int binary_status;
+  binary_program =
+      clCreateProgramWithBinary(context, 1, &device, &binary_size, binaries,
+                                &binary_status, &error);
+  ASSERT_SUCCESS(error);
+  ASSERT_SUCCESS(binary_status);
+  ASSERT_SUCCESS(
+      clBuildProgram(binary_program, 1, &device, nullptr, nullptr, nullptr));
+
+  kernel = clCreateKernel(binary_program, "saxpy", &error);
+  ASSERT_SUCCESS(error);
+
+  constexpr size_t count = 1024;
+  const cl_float a = 2.0f;
+  std::vector<cl_float> x(count), y(count);
+  for (size_t i = 0; i < count; i++) {
+    x[i] = static_cast<cl_float>(i);
+    y[i] = static_cast<cl_float>(count - i);
+  }
+
+  cl_mem x_buffer =
+      clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                     sizeof(cl_float) * count, x.data(), &error);
+  ASSERT_SUCCESS(error);
+  cl_mem y_buffer =
+      clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                     sizeof(cl_float) * count, y.data(), &error);
+  ASSERT_SUCCESS(error);
+
+  EXPECT_SUCCESS(clSetKernelArg(kernel, 0, sizeof(a), &a));
+  EXPECT_SUCCESS(clSetKernelArg(kernel, 1, sizeof(x_buffer), &x_buffer));
+  EXPECT_SUCCESS(clSetKernelArg(kernel, 2, sizeof(y_buffer), &y_buffer));
+  EXPECT_SUCCESS(clEnqueueNDRangeKernel(command_queue, kernel, 1, nullptr,
+                                        &count, nullptr, 0, nullptr, nullptr));
+
+  std::vector<cl_float> result(count);
+  EXPECT_SUCCESS(clEnqueueReadBuffer(command_queue, y_buffer, CL_TRUE, 0,
+                                     sizeof(cl_float) * count, result.data(),
+                                     0, nullptr, nullptr));
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_EQ(a * x[i] + y[i], result[i]) << "at index " << i;
+  }
+
+  EXPECT_SUCCESS(clReleaseMemObject(y_buffer));
+  EXPECT_SUCCESS(clReleaseMemObject(x_buffer));
+}
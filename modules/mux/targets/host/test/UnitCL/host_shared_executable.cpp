@@ -0,0 +1,145 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+
+#include <CL/cl.h>
+#include <Common.h>
+
+#include <vector>
+
+#include "Device.h"
+
+// Host shares the loaded image of a read-only ELF binary between every
+// executable created from the same bytes. The kernel reports the address of a
+// constant table, which is only identical for two live programs when they use
+// the same loaded image.
+struct host_shared_executable_test : ucl::ContextTest {
+  void SetUp() override {
+    UCL_RETURN_ON_FATAL_FAILURE(ContextTest::SetUp());
+    if (!UCL::isDevice_host(device) || !getDeviceCompilerAvailable()) {
+      GTEST_SKIP();
+    }
+  }
+
+  cl_program createProgramFromBinary(cl_context context,
+                                     const std::vector<unsigned char> &binary) {
+    const unsigned char *binaries[] = {binary.data()};
+    const size_t binary_size = binary.size();
+    cl_int binary_status;
+    cl_int error;
+    cl_program program =
+        clCreateProgramWithBinary(context, 1, &device, &binary_size, binaries,
+                                  &binary_status, &error);
+    EXPECT_SUCCESS(error);
+    EXPECT_SUCCESS(binary_status);
+    EXPECT_SUCCESS(
+        clBuildProgram(program, 1, &device, nullptr, nullptr, nullptr));
+    return program;
+  }
+
+  void runKernel(cl_context context, cl_program program, cl_int value,
+                 cl_ulong *table_address) {
+    cl_int error;
+    cl_command_queue queue = clCreateCommandQueue(context, device, 0, &error);
+    ASSERT_SUCCESS(error);
+    cl_kernel kernel = clCreateKernel(program, "fill", &error);
+    ASSERT_SUCCESS(error);
+
+    constexpr size_t count = 64;
+    cl_mem buffer = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                   sizeof(cl_int) * count, nullptr, &error);
+    ASSERT_SUCCESS(error);
+    cl_mem address_buffer = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                           sizeof(cl_ulong), nullptr, &error);
+    ASSERT_SUCCESS(error);
+    EXPECT_SUCCESS(clSetKernelArg(kernel, 0, sizeof(buffer), &buffer));
+    EXPECT_SUCCESS(
+        clSetKernelArg(kernel, 1, sizeof(address_buffer), &address_buffer));
+    EXPECT_SUCCESS(clSetKernelArg(kernel, 2, sizeof(value), &value));
+    EXPECT_SUCCESS(clEnqueueNDRangeKernel(queue, kernel, 1, nullptr, &count,
+                                          nullptr, 0, nullptr, nullptr));
+    std::vector<cl_int> result(count);
+    EXPECT_SUCCESS(clEnqueueReadBuffer(queue, buffer, CL_TRUE, 0,
+                                       sizeof(cl_int) * count, result.data(),
+                                       0, nullptr, nullptr));
+    EXPECT_SUCCESS(clEnqueueReadBuffer(queue, address_buffer, CL_TRUE, 0,
+                                       sizeof(cl_ulong), table_address, 0,
+                                       nullptr, nullptr));
+    const cl_int table[4] = {3, 1, 4, 1};
+    for (size_t i = 0; i < count; i++) {
+      EXPECT_EQ(value + static_cast<cl_int>(i) + table[i % 4], result[i])
+          << "at index " << i;
+    }
+
+    EXPECT_SUCCESS(clReleaseMemObject(address_buffer));
+    EXPECT_SUCCESS(clReleaseMemObject(buffer));
+    EXPECT_SUCCESS(clReleaseKernel(kernel));
+    EXPECT_SUCCESS(clReleaseCommandQueue(queue));
+  }
+};
+
+TEST_F(host_shared_executable_test, ProgramsInSeparateContexts) {
+  const char *source =
+      "constant int table[4] = {3, 1, 4, 1};\n"
+      "kernel void fill(global int *out, global ulong *table_address,\n"
+      "                 int value) {\n"
+      "  size_t i = get_global_id(0);\n"
+      "  out[i] = value + (int)i + table[i % 4];\n"
+      "  if (i == 0) {\n"
+      "    *table_address = (ulong)table;\n"
+      "  }\n"
+      "}\n";
+  cl_int error;
+  cl_program source_program =
+      clCreateProgramWithSource(context, 1, &source, nullptr, &error);
+  ASSERT_SUCCESS(error);
+  ASSERT_SUCCESS(
+      clBuildProgram(source_program, 1, &device, nullptr, nullptr, nullptr));
+
+  size_t binary_size = 0;
+  ASSERT_SUCCESS(clGetProgramInfo(source_program, CL_PROGRAM_BINARY_SIZES,
+                                  sizeof(binary_size), &binary_size, nullptr));
+  ASSERT_NE(0u, binary_size);
+  std::vector<unsigned char> binary(binary_size);
+  unsigned char *binary_ptr = binary.data();
+  ASSERT_SUCCESS(clGetProgramInfo(source_program, CL_PROGRAM_BINARIES,
+                                  sizeof(binary_ptr), &binary_ptr, nullptr));
+  EXPECT_SUCCESS(clReleaseProgram(source_program));
+
+  cl_context other_context =
+      clCreateContext(nullptr, 1, &device, nullptr, nullptr, &error);
+  ASSERT_SUCCESS(error);
+
+  cl_program first = createProgramFromBinary(context, binary);
+  cl_program second = createProgramFromBinary(other_context, binary);
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+
+  cl_ulong first_address = 0;
+  cl_ulong second_address = 0;
+  runKernel(context, first, 42, &first_address);
+  runKernel(other_context, second, 7, &second_address);
+  EXPECT_NE(0u, first_address);
+  EXPECT_EQ(first_address, second_address);
+
+  // Releasing one program must not affect the other.
+  EXPECT_SUCCESS(clReleaseProgram(first));
+  runKernel(other_context, second, 13, &second_address);
+  EXPECT_EQ(first_address, second_address);
+
+  EXPECT_SUCCESS(clReleaseProgram(second));
+  EXPECT_SUCCESS(clReleaseContext(other_context));
+}
@@ -103,8 +103,25 @@ struct command_ndrange_s {
   std::array<size_t, 3> global_offset;
   std::array<size_t, 3> local_size;
   size_t dimensions;
+  /// @brief Program and kernel launch prepared by the HAL when the
+  /// command-buffer was finalized. When the HAL does not support prepared
+  /// launches the launch is invalid and the kernel is set up from scratch
+  /// every time the command is executed.
+  hal::hal_program_t program;
+  hal::hal_launch_t launch;
 
   void operator()(riscv::queue_s *queue, bool &error);
+
+  /// @brief Ask the HAL to prepare a launch for this command so that it can be
+  /// executed without re-encoding it.
+  ///
+  /// @param hal_device HAL device that will execute the command.
+  void prepare(hal::hal_device_t *hal_device);
+
+  /// @brief Release the launch prepared by `prepare`, if any.
+  ///
+  /// @param hal_device HAL device the launch was prepared on.
+  void release(hal::hal_device_t *hal_device);
 };
 
 struct command_user_callback_s {
@@ -193,6 +210,10 @@ struct command_buffer_s final : public mux_command_buffer_s {
 
   mux_result_t execute(riscv::queue_s *queue) CARGO_TS_REQUIRES(mutex);
 
+  /// @brief Release the HAL launches prepared when finalizing the
+  /// command-buffer.
+  void releaseLaunches() CARGO_TS_REQUIRES(mutex);
+
   mux::small_vector<riscv::command_s, 16> commands CARGO_TS_GUARDED_BY(mutex);
   mux::small_vector<mux::dynamic_array<uint8_t>, 16> pod_data_allocs
       CARGO_TS_GUARDED_BY(mutex);
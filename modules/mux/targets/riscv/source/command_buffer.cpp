@@ -53,41 +53,70 @@ void command_fill_buffer_s::operator()(riscv::device_s *device, bool &error) {
   device->profiler.update_counters(*device->hal_device);
 }
 
-void command_ndrange_s::operator()(riscv::queue_s *queue, bool &error) {
-  auto device = static_cast<riscv::device_s *>(queue->device);
-  hal::hal_device_t *hal_device = device->hal_device;
-  assert(kernel && hal_device);
+namespace {
+// Load the kernel's object code and find the entry point of the variant that
+// matches the command's local size. The caller is responsible for freeing the
+// program on success.
+hal::hal_kernel_t findHALKernel(hal::hal_device_t *hal_device,
+                                const riscv::command_ndrange_s &ndrange,
+                                hal::hal_program_t &program) {
+  riscv::kernel_s *kernel = ndrange.kernel;
   // ensure the elf file is loaded
   if (kernel->object_code.empty()) {
-    error = true;
-    return;
+    return hal::hal_invalid_kernel;
   }
-  hal::hal_program_t program = hal_device->program_load(
-      kernel->object_code.data(), kernel->object_code.size());
+  program = hal_device->program_load(kernel->object_code.data(),
+                                     kernel->object_code.size());
   if (program == hal::hal_invalid_program) {
-    error = true;
-    return;
+    return hal::hal_invalid_kernel;
   }
   // decide on which kernel to execute
   mux::hal::kernel_variant_s variant;
-  if (mux_success !=
-      kernel->getKernelVariantForWGSize(local_size[0], local_size[1],
-                                        local_size[2], &variant)) {
-    error = true;
-    return;
+  if (mux_success != kernel->getKernelVariantForWGSize(
+                         ndrange.local_size[0], ndrange.local_size[1],
+                         ndrange.local_size[2], &variant)) {
+    hal_device->program_free(program);
+    return hal::hal_invalid_kernel;
   }
   // find the kernel entry point
   auto hal_kernel =
       hal_device->program_find_kernel(program, variant.variant_name.data());
+  if (hal_kernel == hal::hal_invalid_kernel) {
+    hal_device->program_free(program);
+  }
+  return hal_kernel;
+}
+
+hal::hal_ndrange_t getHALNDRange(const riscv::command_ndrange_s &ndrange) {
+  return {{ndrange.global_offset[0], ndrange.global_offset[1],
+           ndrange.global_offset[2]},
+          {ndrange.global_size[0], ndrange.global_size[1],
+           ndrange.global_size[2]},
+          {ndrange.local_size[0], ndrange.local_size[1],
+           ndrange.local_size[2]}};
+}
+}  // namespace
+
+void command_ndrange_s::operator()(riscv::queue_s *queue, bool &error) {
+  auto device = static_cast<riscv::device_s *>(queue->device);
+  hal::hal_device_t *hal_device = device->hal_device;
+  assert(kernel && hal_device);
+  // replay the launch prepared when the command-buffer was finalized
+  if (launch != hal::hal_invalid_launch) {
+    if (!hal_device->launch_exec(launch, kernel_args, num_kernel_args)) {
+      error = true;
+    }
+    device->profiler.update_counters(*device->hal_device, kernel->name.data());
+    return;
+  }
+  hal::hal_program_t program = hal::hal_invalid_program;
+  auto hal_kernel = findHALKernel(hal_device, *this, program);
   if (hal_kernel == hal::hal_invalid_kernel) {
     error = true;
     return;
   }
   // copy across the ndrange to run
-  const hal::hal_ndrange_t hal_ndrange = {
-      {global_offset[0], global_offset[1], global_offset[2]},
-      {global_size[0], global_size[1], global_size[2]},
-      {local_size[0], local_size[1], local_size[2]}};
+  const hal::hal_ndrange_t hal_ndrange = getHALNDRange(*this);
   // execute the kernel
   bool success =
       hal_device->kernel_exec(program, hal_kernel, &hal_ndrange, kernel_args,
@@ -99,6 +128,38 @@ void command_ndrange_s::operator()(riscv::queue_s *queue, bool &error) {
   device->profiler.update_counters(*device->hal_device, kernel->name.data());
 }
 
+void command_ndrange_s::prepare(hal::hal_device_t *hal_device) {
+  if (launch != hal::hal_invalid_launch) {
+    return;
+  }
+  hal::hal_program_t prepared_program = hal::hal_invalid_program;
+  auto hal_kernel = findHALKernel(hal_device, *this, prepared_program);
+  if (hal_kernel == hal::hal_invalid_kernel) {
+    // Leave the command to report the failure when it is executed.
+    return;
+  }
+  const hal::hal_ndrange_t hal_ndrange = getHALNDRange(*this);
+  launch = hal_device->launch_prepare(prepared_program, hal_kernel,
+                                      &hal_ndrange, kernel_args,
+                                      num_kernel_args, dimensions);
+  if (launch == hal::hal_invalid_launch) {
+    // The HAL does not support prepared launches.
+    hal_device->program_free(prepared_program);
+    return;
+  }
+  program = prepared_program;
+}
+
+void command_ndrange_s::release(hal::hal_device_t *hal_device) {
+  if (launch == hal::hal_invalid_launch) {
+    return;
+  }
+  hal_device->launch_free(launch);
+  hal_device->program_free(program);
+  launch = hal::hal_invalid_launch;
+  program = hal::hal_invalid_program;
+}
+
 void command_user_callback_s::operator()(
     riscv::queue_s *queue, riscv::command_buffer_s *command_buffer) {
   user_function(queue, command_buffer, user_data);
@@ -159,9 +220,22 @@ command_buffer_s::command_buffer_s(mux_device_t device,
 }
 
 command_buffer_s::~command_buffer_s() {
+  {
+    cargo::lock_guard<cargo::mutex> lock(mutex);
+    releaseLaunches();
+  }
   riscv::fence_s::destroy(device, fence, mux::allocator(allocator_info));
 }
 
+void command_buffer_s::releaseLaunches() {
+  auto *hal_device = static_cast<riscv::device_s *>(device)->hal_device;
+  for (riscv::command_s &command : commands) {
+    if (command.type == riscv::command_type_ndrange) {
+      command.ndrange.release(hal_device);
+    }
+  }
+}
+
 mux_result_t command_buffer_s::execute(riscv::queue_s *queue) {
   riscv::device_s *riscv_device = static_cast<riscv::device_s *>(device);
   mux_query_duration_result_t duration_query = nullptr;
@@ -844,7 +918,8 @@ mux_result_t riscvCommandNDRange(mux_command_buffer_t command_buffer,
           static_cast<riscv::kernel_s *>(kernel), kernel_args.data(),
           descriptors.data(), static_cast<uint32_t>(options.descriptors_length),
           pod_data.data(), global_size, global_offset, local_size,
-          options.dimensions})) {
+          options.dimensions, hal::hal_invalid_program,
+          hal::hal_invalid_launch})) {
     return mux_error_out_of_memory;
   }
 
@@ -1053,6 +1128,7 @@ mux_result_t riscvResetCommandBuffer(mux_command_buffer_t command_buffer) {
 
   cargo::lock_guard<cargo::mutex> lock(riscv->mutex);
 
+  riscv->releaseLaunches();
   riscv->commands.clear();
 
   return mux_success;
@@ -1064,7 +1140,14 @@ mux_result_t riscvFinalizeCommandBuffer(mux_command_buffer_t command_buffer) {
   if (nullptr == command_buffer) {
     return mux_error_null_out_parameter;
   }
-  // Finalizing a command buffer is a nop on riscv.
+  // The commands can no longer change, so give the HAL a chance to encode each
+  // kernel launch once rather than every time the command-buffer is run.
+  auto *hal_device = static_cast<riscv::device_s *>(riscv->device)->hal_device;
+  for (riscv::command_s &command : riscv->commands) {
+    if (command.type == riscv::command_type_ndrange) {
+      command.ndrange.prepare(hal_device);
+    }
+  }
   return mux_success;
 }
 
@@ -1107,7 +1190,8 @@ mux_result_t cloneNDRangeCommand(mux_allocator_info_t allocator_info,
   if (cloned_command_buffer->commands.push_back(riscv::command_ndrange_s{
           original.kernel, kernel_args.data(), descriptors.data(),
           original.num_kernel_args, pod_data.data(), original.global_size,
-          original.global_offset, original.local_size, original.dimensions})) {
+          original.global_offset, original.local_size, original.dimensions,
+          hal::hal_invalid_program, hal::hal_invalid_launch})) {
     return mux_error_out_of_memory;
   }
 
@@ -1124,6 +1208,14 @@ mux_result_t cloneNDRangeCommand(mux_allocator_info_t allocator_info,
           std::move(descriptors))) {
     return mux_error_out_of_memory;
   }
+  // The original command was prepared when its command-buffer was finalized.
+  // Give the clone a launch of its own.
+  if (original.launch != hal::hal_invalid_launch) {
+    auto *hal_device =
+        static_cast<riscv::device_s *>(cloned_command_buffer->device)
+            ->hal_device;
+    cloned_command_buffer->commands.back().ndrange.prepare(hal_device);
+  }
   return mux_success;
 }
 }  // anonymous namespace
@@ -20,7 +20,7 @@ namespace riscv {
 
 /// @brief Current version of the HAL API. The version number needs to be
 /// bumped any time the interface is changed.
-static const uint32_t expected_hal_version = 6;
+static const uint32_t expected_hal_version = 7;
 
 // hal instances
 static hal::hal_library_t hal_library;
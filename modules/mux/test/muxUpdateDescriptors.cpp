@@ -297,6 +297,60 @@ struct muxUpdateDescriptorsBufferTest : public muxUpdateDescriptorsTest {
     // Do the tear down for the parent class.
     muxUpdateDescriptorsTest::TearDown();
   }
+
+  /// @brief Reinitialize the buffers then run a command buffer.
+  ///
+  /// The command buffer holding the initializing writes must have been
+  /// finalized.
+  ///
+  /// @param nd_range_command_buffer Finalized command buffer to run after the
+  /// writes.
+  void runAfterInit(mux_command_buffer_t nd_range_command_buffer) {
+    EXPECT_SUCCESS(muxDispatch(queue, command_buffer, nullptr, nullptr, 0,
+                               nullptr, 0, nullptr, nullptr));
+    EXPECT_SUCCESS(muxWaitAll(queue));
+    EXPECT_SUCCESS(muxDispatch(queue, nd_range_command_buffer, nullptr,
+                               nullptr, 0, nullptr, 0, nullptr, nullptr));
+    EXPECT_SUCCESS(muxWaitAll(queue));
+  }
+
+  /// @brief Record the nd range and reads of both output buffers.
+  ///
+  /// @param nd_range_command_buffer Command buffer to record into, the nd
+  /// range is its first command.
+  /// @param results Storage the output buffer is read into.
+  /// @param results_updated Storage the updated output buffer is read into.
+  void recordNDRange(mux_command_buffer_t nd_range_command_buffer,
+                     char *results, char *results_updated) {
+    EXPECT_SUCCESS(muxCommandNDRange(nd_range_command_buffer, kernel,
+                                     nd_range_options, 0, nullptr, nullptr));
+    EXPECT_SUCCESS(muxCommandReadBuffer(nd_range_command_buffer, buffer_out, 0,
+                                        results, buffer_size, 0, nullptr,
+                                        nullptr));
+    EXPECT_SUCCESS(muxCommandReadBuffer(nd_range_command_buffer,
+                                        buffer_out_updated, 0, results_updated,
+                                        buffer_size, 0, nullptr, nullptr));
+  }
+
+  /// @brief Check which output buffer the kernel copied the input into.
+  ///
+  /// @param results Contents of the output buffer.
+  /// @param results_updated Contents of the updated output buffer.
+  /// @param updated Whether the updated output buffer is expected to have
+  /// been written rather than the initial one.
+  void expectCopiedInto(const char *results, const char *results_updated,
+                        bool updated) {
+    const char expected = updated ? 0x00 : input_value;
+    const char expected_updated = updated ? input_value : 0x00;
+    for (unsigned i = 0; i < buffer_size; ++i) {
+      ASSERT_EQ(expected, results[i])
+          << "Error: result mismatch at index: " << i
+          << " in initial output buffer\n";
+      ASSERT_EQ(expected_updated, results_updated[i])
+          << "Error: result mismatch at index: " << i
+          << " in updated output buffer\n";
+    }
+  }
 };
 
 #if __cplusplus < 201703L
@@ -486,6 +540,89 @@ TEST_P(muxUpdateDescriptorsBufferTest, NonZeroCommandIndexUpdateOutputBuffer) {
   }
 }
 
+// Tests that updating the descriptors of a clone of a finalized command buffer
+// only affects the clone. Targets which prepare kernel launches when a command
+// buffer is finalized, such as riscv, must give the clone launches of its own.
+TEST_P(muxUpdateDescriptorsBufferTest, UpdateClonedCommandBuffer) {
+  if (!device->info->can_clone_command_buffers) {
+    GTEST_SKIP();
+  }
+  mux_command_buffer_t second_command_buffer{};
+  ASSERT_SUCCESS(muxCreateCommandBuffer(device, callback, allocator,
+                                        &second_command_buffer));
+  char results[buffer_size];
+  char results_updated[buffer_size];
+  recordNDRange(second_command_buffer, results, results_updated);
+  EXPECT_SUCCESS(muxFinalizeCommandBuffer(command_buffer));
+  EXPECT_SUCCESS(muxFinalizeCommandBuffer(second_command_buffer));
+
+  // Run the original once before cloning it.
+  runAfterInit(second_command_buffer);
+  expectCopiedInto(results, results_updated, false);
+
+  mux_command_buffer_t cloned_command_buffer{};
+  ASSERT_SUCCESS(muxCloneCommandBuffer(device, allocator, second_command_buffer,
+                                       &cloned_command_buffer));
+  uint64_t arg_indices[]{0};
+  constexpr uint64_t num_args = 1;
+  EXPECT_SUCCESS(muxUpdateDescriptors(cloned_command_buffer, 0, num_args,
+                                      arg_indices, &descriptor_updated));
+
+  // The clone writes to the updated output buffer.
+  runAfterInit(cloned_command_buffer);
+  expectCopiedInto(results, results_updated, true);
+
+  // The original still writes to the initial output buffer.
+  runAfterInit(second_command_buffer);
+  expectCopiedInto(results, results_updated, false);
+
+  // Update the original as well, then run both again.
+  EXPECT_SUCCESS(muxUpdateDescriptors(second_command_buffer, 0, num_args,
+                                      arg_indices, &descriptor_updated));
+  runAfterInit(second_command_buffer);
+  expectCopiedInto(results, results_updated, true);
+  runAfterInit(cloned_command_buffer);
+  expectCopiedInto(results, results_updated, true);
+
+  muxDestroyCommandBuffer(device, cloned_command_buffer, allocator);
+  muxDestroyCommandBuffer(device, second_command_buffer, allocator);
+}
+
+// Tests that a finalized command buffer whose descriptors were updated can be
+// reset, recorded and finalized again. Targets which prepare kernel launches
+// when a command buffer is finalized, such as riscv, must release them on
+// reset and prepare the newly recorded commands.
+TEST_P(muxUpdateDescriptorsBufferTest, UpdateThenResetCommandBuffer) {
+  mux_command_buffer_t second_command_buffer{};
+  ASSERT_SUCCESS(muxCreateCommandBuffer(device, callback, allocator,
+                                        &second_command_buffer));
+  char results[buffer_size];
+  char results_updated[buffer_size];
+  recordNDRange(second_command_buffer, results, results_updated);
+  EXPECT_SUCCESS(muxFinalizeCommandBuffer(command_buffer));
+  EXPECT_SUCCESS(muxFinalizeCommandBuffer(second_command_buffer));
+
+  runAfterInit(second_command_buffer);
+  expectCopiedInto(results, results_updated, false);
+
+  // Run the same launch a second time with an updated argument.
+  uint64_t arg_indices[]{0};
+  constexpr uint64_t num_args = 1;
+  EXPECT_SUCCESS(muxUpdateDescriptors(second_command_buffer, 0, num_args,
+                                      arg_indices, &descriptor_updated));
+  runAfterInit(second_command_buffer);
+  expectCopiedInto(results, results_updated, true);
+
+  // Recording again uses the original descriptors.
+  EXPECT_SUCCESS(muxResetCommandBuffer(second_command_buffer));
+  recordNDRange(second_command_buffer, results, results_updated);
+  EXPECT_SUCCESS(muxFinalizeCommandBuffer(second_command_buffer));
+  runAfterInit(second_command_buffer);
+  expectCopiedInto(results, results_updated, false);
+
+  muxDestroyCommandBuffer(device, second_command_buffer, allocator);
+}
+
 // Instantiate the test suite so that it runs for all devices.
 INSTANTIATE_DEVICE_TEST_SUITE_P(muxUpdateDescriptorsBufferTest);
 
@@ -0,0 +1,258 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Cache of freed memory allocations shared by the USM implementations.
+
+#ifndef MUX_UTILS_ALLOCATION_POOL_H_INCLUDED
+#define MUX_UTILS_ALLOCATION_POOL_H_INCLUDED
+
+#include <cargo/dynamic_array.h>
+#include <cargo/error.h>
+#include <cargo/small_vector.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <mutex>
+
+namespace mux {
+/// @addtogroup mux_utils
+/// @{
+
+/// @brief Cache of freed memory allocations for reuse by later allocations.
+///
+/// Freed allocations are kept rather than destroyed and handed back out by
+/// later requests of the same size class from the same free list, avoiding
+/// the creation of Mux memory and buffer objects on every allocation. Callers
+/// pick which free list an allocation belongs to, e.g. one per device plus one
+/// for host allocations. Requests are rounded up to power of two size classes.
+/// The total capacity cached is bounded by a retention limit, past which the
+/// largest and oldest allocations are destroyed first.
+///
+/// @tparam Allocation Type of the cached allocations. It must have a `size_t
+/// capacity` member holding the size in bytes of the memory backing it.
+template <class Allocation>
+class allocation_pool {
+ public:
+  /// @brief Smallest size class, requests below this are rounded up to it.
+  static constexpr size_t min_size_class = 64;
+  /// @brief Largest size class, larger requests bypass the pool.
+  static constexpr size_t max_size_class = 4 * 1024 * 1024;
+  /// @brief Number of power of two size classes in the pool.
+  static constexpr size_t num_size_classes = 17;
+  /// @brief Default value of the retention limit in bytes, can be overridden
+  /// with the `CA_USM_POOL_LIMIT` environment variable.
+  static constexpr size_t default_limit = 16 * 1024 * 1024;
+
+  static_assert(min_size_class << (num_size_classes - 1) == max_size_class,
+                "num_size_classes does not span min to max size class");
+
+  /// @brief Counters describing how effective the pool has been.
+  struct stats {
+    /// @brief Number of requests satisfied by a cached allocation.
+    size_t hits = 0;
+    /// @brief Number of pooled size requests no cached allocation satisfied.
+    size_t misses = 0;
+    /// @brief Number of cached allocations destroyed to respect a limit.
+    size_t trims = 0;
+    /// @brief Number of bytes currently held in the free lists.
+    size_t bytes_retained = 0;
+  };
+
+  /// @brief Default constructor, reads the retention limit from the
+  /// environment.
+  allocation_pool() : allocation_pool(getDefaultLimit()) {}
+
+  /// @brief Constructor.
+  ///
+  /// @param[in] limit Maximum number of bytes to retain, zero disables
+  /// caching.
+  explicit allocation_pool(size_t limit) : limit(limit) {}
+
+  allocation_pool(const allocation_pool &) = delete;
+  allocation_pool &operator=(const allocation_pool &) = delete;
+
+  /// @brief Allocate the free lists.
+  ///
+  /// @param[in] num_lists Number of free lists for each size class.
+  ///
+  /// @return Returns `cargo::success` or `cargo::bad_alloc` on failure.
+  cargo::result init(size_t num_lists) {
+    return free_lists.alloc(num_lists * num_size_classes);
+  }
+
+  /// @brief Query the retention limit from the environment.
+  ///
+  /// @return Value of `CA_USM_POOL_LIMIT` if set, `default_limit` otherwise.
+  static size_t getDefaultLimit() {
+    // Setting the limit to zero disables caching of freed allocations.
+    if (const char *env = std::getenv("CA_USM_POOL_LIMIT")) {
+      return std::strtoull(env, nullptr, 0);
+    }
+    return default_limit;
+  }
+
+  /// @brief Get the capacity a request should be allocated with to be pooled.
+  ///
+  /// @param[in] size Requested allocation size in bytes.
+  ///
+  /// @return The size class the request belongs to, or zero if the request is
+  /// too large to be pooled.
+  static size_t getPooledSize(size_t size) {
+    if (size > max_size_class) {
+      return 0;
+    }
+    return min_size_class << getSizeClassIndex(size);
+  }
+
+  /// @brief Take a cached allocation able to satisfy a request.
+  ///
+  /// @param[in] list_index Index of the free list to take the allocation from.
+  /// @param[in] size Requested allocation size in bytes.
+  /// @param[in] matches Predicate called with each candidate allocation,
+  /// returning whether it satisfies the remaining requirements of the request.
+  ///
+  /// @return The cached allocation, or nullptr if there is none.
+  template <class Predicate>
+  std::unique_ptr<Allocation> acquire(size_t list_index, size_t size,
+                                      Predicate matches) {
+    const size_t pooled_size = getPooledSize(size);
+    if (0 == pooled_size || 0 == limit) {
+      return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &free_list = getFreeList(list_index, getSizeClassIndex(pooled_size));
+    // Prefer the most recently freed allocation. It is the most likely to still
+    // be resident in the cache.
+    auto found = std::find_if(
+        free_list.rbegin(), free_list.rend(),
+        [&](const std::unique_ptr<Allocation> &allocation) {
+          return matches(*allocation);
+        });
+    if (found == free_list.rend()) {
+      counters.misses++;
+      return nullptr;
+    }
+    std::unique_ptr<Allocation> cached = std::move(*found);
+    free_list.erase(std::next(found).base());
+    counters.bytes_retained -= cached->capacity;
+    counters.hits++;
+    return cached;
+  }
+
+  /// @brief Return a freed allocation to the pool.
+  ///
+  /// Caching may destroy older allocations to stay within the retention limit.
+  ///
+  /// @param[in] list_index Index of the free list to cache the allocation in.
+  /// @param[in] allocation Allocation which was freed by the user.
+  ///
+  /// @return Returns nullptr if the allocation was cached. Otherwise returns
+  /// `allocation`, which the caller is responsible for destroying, if its
+  /// capacity is not a pooled size class or it could not be cached.
+  std::unique_ptr<Allocation> release(size_t list_index,
+                                      std::unique_ptr<Allocation> allocation) {
+    const size_t capacity = allocation->capacity;
+    if (0 == limit || capacity > limit || getPooledSize(capacity) != capacity) {
+      return allocation;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &free_list = getFreeList(list_index, getSizeClassIndex(capacity));
+    if (cargo::success != free_list.push_back(std::move(allocation))) {
+      return allocation;
+    }
+    counters.bytes_retained += capacity;
+    trimLocked(limit);
+    return nullptr;
+  }
+
+  /// @brief Destroy cached allocations until at most `target` bytes remain.
+  ///
+  /// @param[in] target Number of bytes the pool may keep retaining.
+  void trim(size_t target) {
+    std::lock_guard<std::mutex> lock(mutex);
+    trimLocked(target);
+  }
+
+  /// @brief Get a snapshot of the pool's counters.
+  ///
+  /// @return Returns the counters at the time of the call.
+  stats getStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+  }
+
+ private:
+  /// @brief List of cached allocations of a single size class.
+  using free_list_t = cargo::small_vector<std::unique_ptr<Allocation>, 2>;
+
+  /// @brief Get the index of the size class `capacity` belongs to.
+  static size_t getSizeClassIndex(size_t capacity) {
+    size_t class_index = 0;
+    for (size_t class_size = min_size_class; class_size < capacity;
+         class_size <<= 1) {
+      class_index++;
+    }
+    return class_index;
+  }
+
+  /// @brief Get a free list, must be called with `mutex` held.
+  free_list_t &getFreeList(size_t list_index, size_t class_index) {
+    return free_lists[list_index * num_size_classes + class_index];
+  }
+
+  /// @brief Destroy cached allocations until at most `target` bytes remain,
+  /// must be called with `mutex` held.
+  void trimLocked(size_t target) {
+    // Evict the largest size classes first, since they give back the most
+    // memory for each set of Mux objects destroyed. Within a size class the
+    // oldest allocations are evicted before the more recently freed ones.
+    const size_t num_lists = free_lists.size() / num_size_classes;
+    for (size_t class_index = num_size_classes; class_index-- > 0;) {
+      for (size_t list_index = 0; list_index < num_lists; list_index++) {
+        auto &free_list = getFreeList(list_index, class_index);
+        while (!free_list.empty()) {
+          if (counters.bytes_retained <= target) {
+            return;
+          }
+          counters.bytes_retained -= free_list.front()->capacity;
+          counters.trims++;
+          free_list.erase(free_list.begin());
+        }
+      }
+    }
+  }
+
+  /// @brief Maximum number of bytes to retain in the free lists.
+  const size_t limit;
+  /// @brief Free lists for each list index and size class.
+  cargo::dynamic_array<free_list_t> free_lists;
+  /// @brief Counters returned by `getStats`.
+  stats counters;
+  /// @brief Mutex protecting `free_lists` and `counters`.
+  std::mutex mutex;
+};
+
+/// @}
+}  // namespace mux
+
+#endif  // MUX_UTILS_ALLOCATION_POOL_H_INCLUDED
@@ -0,0 +1,137 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <gtest/gtest.h>
+#include <mux/utils/allocation_pool.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace {
+/// @brief Allocation cached by the pool under test.
+struct test_allocation {
+  /// @brief Size in bytes of the memory backing the allocation.
+  size_t capacity;
+};
+
+using test_pool = mux::allocation_pool<test_allocation>;
+
+/// @brief Predicate accepting any cached allocation.
+bool any(const test_allocation &) { return true; }
+
+/// @brief Fixture providing a pool with two free lists which retains up to
+/// 1 KiB.
+struct AllocationPoolTest : ::testing::Test {
+  void SetUp() override { ASSERT_EQ(cargo::success, pool.init(2)); }
+
+  /// @brief Frees an allocation of @p capacity bytes into a free list.
+  ///
+  /// @return Returns whether the pool cached the allocation.
+  bool release(size_t list_index, size_t capacity) {
+    return nullptr ==
+           pool.release(list_index, std::unique_ptr<test_allocation>(
+                                        new test_allocation{capacity}));
+  }
+
+  test_pool pool{1024};
+};
+
+TEST_F(AllocationPoolTest, EmptyStats) {
+  const test_pool::stats stats = pool.getStats();
+  EXPECT_EQ(0, stats.hits);
+  EXPECT_EQ(0, stats.misses);
+  EXPECT_EQ(0, stats.trims);
+  EXPECT_EQ(0, stats.bytes_retained);
+}
+
+TEST_F(AllocationPoolTest, MissThenHit) {
+  EXPECT_EQ(nullptr, pool.acquire(0, 100, any));
+  EXPECT_EQ(1, pool.getStats().misses);
+
+  ASSERT_TRUE(release(0, test_pool::getPooledSize(100)));
+  EXPECT_EQ(128, pool.getStats().bytes_retained);
+
+  auto allocation = pool.acquire(0, 100, any);
+  ASSERT_NE(nullptr, allocation);
+  EXPECT_EQ(128, allocation->capacity);
+  const test_pool::stats stats = pool.getStats();
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+  EXPECT_EQ(0, stats.bytes_retained);
+}
+
+TEST_F(AllocationPoolTest, FreeListsAreSeparate) {
+  ASSERT_TRUE(release(1, 64));
+  EXPECT_EQ(nullptr, pool.acquire(0, 64, any));
+  EXPECT_NE(nullptr, pool.acquire(1, 64, any));
+  const test_pool::stats stats = pool.getStats();
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+}
+
+TEST_F(AllocationPoolTest, PredicateRejects) {
+  ASSERT_TRUE(release(0, 64));
+  EXPECT_EQ(nullptr,
+            pool.acquire(0, 64, [](const test_allocation &) { return false; }));
+  const test_pool::stats stats = pool.getStats();
+  EXPECT_EQ(0, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+  EXPECT_EQ(64, stats.bytes_retained);
+}
+
+TEST_F(AllocationPoolTest, UnpooledSizes) {
+  // Requests larger than the largest size class bypass the pool and are not
+  // counted as misses.
+  EXPECT_EQ(nullptr, pool.acquire(0, test_pool::max_size_class + 1, any));
+  // Capacities which aren't a size class are never cached.
+  EXPECT_FALSE(release(0, 100));
+  const test_pool::stats stats = pool.getStats();
+  EXPECT_EQ(0, stats.misses);
+  EXPECT_EQ(0, stats.bytes_retained);
+}
+
+TEST_F(AllocationPoolTest, TrimsLargestFirst) {
+  ASSERT_TRUE(release(0, 256));
+  ASSERT_TRUE(release(1, 256));
+  ASSERT_TRUE(release(0, 512));
+  EXPECT_EQ(1024, pool.getStats().bytes_retained);
+
+  // Exceeding the limit evicts the largest size class before the smaller
+  // ones.
+  ASSERT_TRUE(release(1, 64));
+  test_pool::stats stats = pool.getStats();
+  EXPECT_EQ(1, stats.trims);
+  EXPECT_EQ(576, stats.bytes_retained);
+  EXPECT_EQ(nullptr, pool.acquire(0, 512, any));
+
+  pool.trim(0);
+  stats = pool.getStats();
+  EXPECT_EQ(4, stats.trims);
+  EXPECT_EQ(0, stats.bytes_retained);
+}
+
+TEST(AllocationPool, ZeroLimitDisablesCaching) {
+  test_pool pool(0);
+  ASSERT_EQ(cargo::success, pool.init(1));
+  EXPECT_NE(nullptr,
+            pool.release(0, std::unique_ptr<test_allocation>(
+                                new test_allocation{64})));
+  EXPECT_EQ(nullptr, pool.acquire(0, 64, any));
+  const test_pool::stats stats = pool.getStats();
+  EXPECT_EQ(0, stats.misses);
+  EXPECT_EQ(0, stats.bytes_retained);
+}
+}  // namespace
@@ -0,0 +1,100 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef HOST_UTILS_FAT_BINARY_INCLUDED
+#define HOST_UTILS_FAT_BINARY_INCLUDED
+
+#include <cargo/array_view.h>
+#include <cargo/optional.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace host {
+namespace utils {
+/// @brief ISA levels a variant of a fat binary may require.
+///
+/// The upper bits of a level identify its architecture and the low eight bits
+/// its position within that architecture. Higher levels are strict supersets
+/// of the lower levels on the same architecture. Levels of different
+/// architectures are unrelated.
+enum isa_level : uint32_t {
+  /// @brief The baseline ISA of the architecture, runs everywhere.
+  isa_level_baseline = 1,
+  /// @brief x86-64-v2: SSE4.2, SSSE3, POPCNT and CMPXCHG16B.
+  isa_level_x86_64_v2 = 0x102,
+  /// @brief x86-64-v3: AVX2, BMI1/2, FMA, F16C, LZCNT and MOVBE.
+  isa_level_x86_64_v3 = 0x103,
+  /// @brief x86-64-v4: AVX-512 F, BW, CD, DQ and VL.
+  isa_level_x86_64_v4 = 0x104,
+  /// @brief AArch64 with the Scalable Vector Extension.
+  isa_level_aarch64_sve = 0x202,
+};
+
+/// @brief A variant of a binary compiled for a particular ISA level.
+struct fat_binary_variant_s {
+  /// @brief ISA level the variant requires to run.
+  uint32_t isa_level;
+  /// @brief ELF executable of the variant.
+  cargo::array_view<const uint8_t> binary;
+};
+
+/// @brief Detects whether this binary buffer contains several variants of an
+/// ELF executable, each compiled for a different ISA level.
+///
+/// @param binary The source binary data.
+/// @param binary_length The length of the source binary (in bytes).
+/// @return `true` if the binary is a fat binary, `false` otherwise.
+bool isFatBinary(const void *binary, uint64_t binary_length);
+
+/// @brief Returns the size of a binary buffer that can contain the given
+/// variants serialized as a fat binary.
+///
+/// @param variants The variants to be serialized.
+/// @return The size in bytes of the serialized fat binary.
+size_t getSizeForFatBinary(
+    cargo::array_view<const fat_binary_variant_s> variants);
+
+/// @brief Serializes a list of variants to a buffer as a fat binary.
+///
+/// @param variants The variants to write to `buffer`.
+/// @param buffer A buffer that is at least `getSizeForFatBinary(variants)`
+/// bytes long.
+void serializeFatBinary(cargo::array_view<const fat_binary_variant_s> variants,
+                        uint8_t *buffer);
+
+/// @brief Selects the variant of a fat binary best suited to an ISA level.
+///
+/// @param binary The source binary data, must be a fat binary.
+/// @param binary_length The length of the source binary (in bytes).
+/// @param isa_level The highest ISA level the variant may require.
+/// @return The ELF executable of the variant with the highest ISA level of
+/// the same architecture as `isa_level` not greater than it, falling back to
+/// the baseline variant, or `cargo::nullopt` if the binary is malformed or has
+/// no such variant.
+cargo::optional<cargo::array_view<const uint8_t>> selectFatBinaryVariant(
+    const void *binary, uint64_t binary_length, uint32_t isa_level);
+
+/// @brief Detects the highest ISA level supported by the CPU the process is
+/// running on.
+///
+/// @return The ISA level of the running CPU, `isa_level_baseline` if it could
+/// not be determined.
+uint32_t getHostISALevel();
+}  // namespace utils
+}  // namespace host
+
+#endif  // HOST_UTILS_FAT_BINARY_INCLUDED
@@ -0,0 +1,188 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <host/utils/fat_binary.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__linux__) && defined(__aarch64__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace {
+// The magic must not overlap the first byte of the ELF header, or the magic
+// byte of a serialized JIT kernel.
+const uint8_t magic[8] = {'C', 'A', 'F', 'A', 'T', 'B', 'I', 'N'};
+
+// Header layout, all fields are little-endian:
+//   uint8_t  magic[8]
+//   uint32_t num_variants
+//   uint32_t reserved
+// Followed by `num_variants` entries of:
+//   uint32_t isa_level
+//   uint32_t reserved
+//   uint64_t offset (from the start of the fat binary)
+//   uint64_t size
+// Followed by the ELF executables, each starting on a 16 byte boundary.
+const size_t header_size = sizeof(magic) + 2 * sizeof(uint32_t);
+const size_t entry_size = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+const size_t variant_alignment = 16;
+
+// Whether a variant requiring `level` can run on a CPU supporting `isa_level`.
+bool isCompatible(uint32_t level, uint32_t isa_level) {
+  if (level == host::utils::isa_level_baseline) {
+    return true;
+  }
+  return (level >> 8) == (isa_level >> 8) && level <= isa_level;
+}
+
+size_t alignUp(size_t value) {
+  return (value + variant_alignment - 1) & ~(variant_alignment - 1);
+}
+
+template <typename T>
+uint8_t *write(uint8_t *buffer, T value) {
+  for (size_t i = 0; i < sizeof(T); i++) {
+    *buffer++ = static_cast<uint8_t>(value >> (i * 8));
+  }
+  return buffer;
+}
+
+template <typename T>
+T read(const uint8_t *buffer) {
+  T value = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    value |= static_cast<T>(buffer[i]) << (i * 8);
+  }
+  return value;
+}
+
+uint32_t detectHostISALevel() {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+  __builtin_cpu_init();
+  // Only the features __builtin_cpu_supports knows about across all supported
+  // compilers are checked. Every CPU implementing these also implements the
+  // remaining features of the level.
+  if (!__builtin_cpu_supports("sse4.2") || !__builtin_cpu_supports("ssse3") ||
+      !__builtin_cpu_supports("popcnt")) {
+    return host::utils::isa_level_baseline;
+  }
+  if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("bmi") ||
+      !__builtin_cpu_supports("bmi2") || !__builtin_cpu_supports("fma")) {
+    return host::utils::isa_level_x86_64_v2;
+  }
+  if (!__builtin_cpu_supports("avx512f") ||
+      !__builtin_cpu_supports("avx512bw") ||
+      !__builtin_cpu_supports("avx512cd") ||
+      !__builtin_cpu_supports("avx512dq") ||
+      !__builtin_cpu_supports("avx512vl")) {
+    return host::utils::isa_level_x86_64_v3;
+  }
+  return host::utils::isa_level_x86_64_v4;
+#elif defined(__linux__) && defined(__aarch64__) && defined(HWCAP_SVE)
+  if (getauxval(AT_HWCAP) & HWCAP_SVE) {
+    return host::utils::isa_level_aarch64_sve;
+  }
+  return host::utils::isa_level_baseline;
+#else
+  return host::utils::isa_level_baseline;
+#endif
+}
+}  // namespace
+
+namespace host {
+namespace utils {
+
+bool isFatBinary(const void *binary, uint64_t binary_length) {
+  if (binary_length < header_size) {
+    return false;
+  }
+  return 0 == std::memcmp(binary, magic, sizeof(magic));
+}
+
+size_t getSizeForFatBinary(
+    cargo::array_view<const fat_binary_variant_s> variants) {
+  size_t size = header_size + entry_size * variants.size();
+  for (const auto &variant : variants) {
+    size = alignUp(size) + variant.binary.size();
+  }
+  return size;
+}
+
+void serializeFatBinary(cargo::array_view<const fat_binary_variant_s> variants,
+                        uint8_t *buffer) {
+  uint8_t *const begin = buffer;
+  buffer = std::copy(std::begin(magic), std::end(magic), buffer);
+  buffer = write<uint32_t>(buffer, static_cast<uint32_t>(variants.size()));
+  buffer = write<uint32_t>(buffer, 0);
+
+  size_t offset = header_size + entry_size * variants.size();
+  for (const auto &variant : variants) {
+    offset = alignUp(offset);
+    buffer = write<uint32_t>(buffer, variant.isa_level);
+    buffer = write<uint32_t>(buffer, 0);
+    buffer = write<uint64_t>(buffer, offset);
+    buffer = write<uint64_t>(buffer, variant.binary.size());
+    offset += variant.binary.size();
+  }
+
+  for (const auto &variant : variants) {
+    // Zero the padding so the output is deterministic.
+    uint8_t *const aligned = begin + alignUp(buffer - begin);
+    std::fill(buffer, aligned, 0);
+    buffer = std::copy(variant.binary.begin(), variant.binary.end(), aligned);
+  }
+}
+
+cargo::optional<cargo::array_view<const uint8_t>> selectFatBinaryVariant(
+    const void *binary, uint64_t binary_length, uint32_t isa_level) {
+  if (!isFatBinary(binary, binary_length)) {
+    return cargo::nullopt;
+  }
+  auto *const bytes = static_cast<const uint8_t *>(binary);
+  const uint32_t num_variants = read<uint32_t>(bytes + sizeof(magic));
+  if (num_variants > (binary_length - header_size) / entry_size) {
+    return cargo::nullopt;
+  }
+
+  cargo::optional<cargo::array_view<const uint8_t>> selected;
+  uint32_t selected_level = 0;
+  for (uint32_t i = 0; i < num_variants; i++) {
+    const uint8_t *entry = bytes + header_size + entry_size * i;
+    const uint32_t level = read<uint32_t>(entry);
+    const uint64_t offset = read<uint64_t>(entry + 2 * sizeof(uint32_t));
+    const uint64_t size =
+        read<uint64_t>(entry + 2 * sizeof(uint32_t) + sizeof(uint64_t));
+    if (offset > binary_length || size > binary_length - offset) {
+      return cargo::nullopt;
+    }
+    if (isCompatible(level, isa_level) && level > selected_level) {
+      selected_level = level;
+      selected.emplace(bytes + offset, bytes + offset + size);
+    }
+  }
+  return selected;
+}
+
+uint32_t getHostISALevel() {
+  static const uint32_t isa_level = detectHostISALevel();
+  return isa_level;
+}
+
+}  // namespace utils
+}  // namespace host
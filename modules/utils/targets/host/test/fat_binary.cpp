@@ -0,0 +1,170 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <gtest/gtest.h>
+#include <host/utils/fat_binary.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+using host::utils::fat_binary_variant_s;
+
+/// @brief Size of the fat binary header, see fat_binary.cpp.
+constexpr size_t header_size = 16;
+/// @brief Size of each variant entry following the header.
+constexpr size_t entry_size = 24;
+
+/// @brief Fixture serializing a baseline, an x86-64-v2 and an x86-64-v3
+/// variant, each filled with a distinct byte value.
+struct FatBinaryTest : ::testing::Test {
+  void SetUp() override {
+    baseline.assign(13, 0xB0);
+    v2.assign(29, 0xB2);
+    v3.assign(7, 0xB3);
+    const std::vector<fat_binary_variant_s> variants = {
+        {host::utils::isa_level_baseline, {baseline.data(), baseline.size()}},
+        {host::utils::isa_level_x86_64_v2, {v2.data(), v2.size()}},
+        {host::utils::isa_level_x86_64_v3, {v3.data(), v3.size()}},
+    };
+    binary.resize(host::utils::getSizeForFatBinary(variants));
+    host::utils::serializeFatBinary(variants, binary.data());
+  }
+
+  /// @brief Selects a variant of `binary` truncated to @p length bytes.
+  cargo::optional<cargo::array_view<const uint8_t>> select(uint32_t isa_level,
+                                                           size_t length) {
+    return host::utils::selectFatBinaryVariant(binary.data(), length,
+                                               isa_level);
+  }
+
+  /// @brief Selects a variant of the whole of `binary`.
+  cargo::optional<cargo::array_view<const uint8_t>> select(uint32_t isa_level) {
+    return select(isa_level, binary.size());
+  }
+
+  /// @brief Overwrites a little-endian field of `binary` at @p offset.
+  template <typename T>
+  void poke(size_t offset, T value) {
+    for (size_t i = 0; i < sizeof(T); i++) {
+      binary[offset + i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+  }
+
+  std::vector<uint8_t> baseline;
+  std::vector<uint8_t> v2;
+  std::vector<uint8_t> v3;
+  std::vector<uint8_t> binary;
+};
+
+/// @brief Checks that @p selected is exactly @p expected.
+void expectVariant(
+    const cargo::optional<cargo::array_view<const uint8_t>> &selected,
+    const std::vector<uint8_t> &expected) {
+  ASSERT_TRUE(selected.has_value());
+  EXPECT_EQ(expected, std::vector<uint8_t>(selected->begin(), selected->end()));
+}
+}  // namespace
+
+TEST_F(FatBinaryTest, IsFatBinary) {
+  EXPECT_TRUE(host::utils::isFatBinary(binary.data(), binary.size()));
+  EXPECT_FALSE(host::utils::isFatBinary(baseline.data(), baseline.size()));
+  const uint8_t elf[header_size] = {0x7f, 'E', 'L', 'F'};
+  EXPECT_FALSE(host::utils::isFatBinary(elf, sizeof(elf)));
+}
+
+TEST_F(FatBinaryTest, VariantsAligned) {
+  for (uint32_t i = 0; i < 3; i++) {
+    const size_t entry = header_size + entry_size * i;
+    uint64_t offset = 0;
+    for (size_t byte = 0; byte < sizeof(offset); byte++) {
+      offset |= uint64_t(binary[entry + 8 + byte]) << (byte * 8);
+    }
+    EXPECT_EQ(0u, offset % 16) << "variant " << i;
+  }
+}
+
+TEST_F(FatBinaryTest, SelectHighestSupported) {
+  expectVariant(select(host::utils::isa_level_baseline), baseline);
+  expectVariant(select(host::utils::isa_level_x86_64_v2), v2);
+  expectVariant(select(host::utils::isa_level_x86_64_v3), v3);
+  // No v4 variant was serialized, so the best lower level is used.
+  expectVariant(select(host::utils::isa_level_x86_64_v4), v3);
+}
+
+TEST_F(FatBinaryTest, SelectOtherArchitecture) {
+  // x86-64 variants must never be picked for an AArch64 CPU.
+  expectVariant(select(host::utils::isa_level_aarch64_sve), baseline);
+}
+
+TEST_F(FatBinaryTest, SelectNoCompatibleVariant) {
+  const std::vector<fat_binary_variant_s> variants = {
+      {host::utils::isa_level_x86_64_v3, {v3.data(), v3.size()}},
+  };
+  binary.resize(host::utils::getSizeForFatBinary(variants));
+  host::utils::serializeFatBinary(variants, binary.data());
+  EXPECT_FALSE(select(host::utils::isa_level_x86_64_v2).has_value());
+  EXPECT_FALSE(select(host::utils::isa_level_aarch64_sve).has_value());
+  expectVariant(select(host::utils::isa_level_x86_64_v3), v3);
+}
+
+TEST_F(FatBinaryTest, BadMagic) {
+  binary[0] = 0x7f;
+  EXPECT_FALSE(host::utils::isFatBinary(binary.data(), binary.size()));
+  EXPECT_FALSE(select(host::utils::isa_level_x86_64_v4).has_value());
+}
+
+TEST_F(FatBinaryTest, TruncatedHeader) {
+  EXPECT_FALSE(host::utils::isFatBinary(binary.data(), header_size - 1));
+  EXPECT_FALSE(select(host::utils::isa_level_baseline, 0).has_value());
+  EXPECT_FALSE(
+      select(host::utils::isa_level_baseline, header_size - 1).has_value());
+}
+
+TEST_F(FatBinaryTest, TruncatedEntries) {
+  EXPECT_FALSE(select(host::utils::isa_level_baseline, header_size + 1)
+                   .has_value());
+  EXPECT_FALSE(
+      select(host::utils::isa_level_baseline, header_size + entry_size * 3 - 1)
+          .has_value());
+}
+
+TEST_F(FatBinaryTest, TruncatedVariant) {
+  // Cuts off the last byte of the final (v3) variant.
+  EXPECT_FALSE(
+      select(host::utils::isa_level_baseline, binary.size() - 1).has_value());
+}
+
+TEST_F(FatBinaryTest, NumVariantsOverflow) {
+  poke<uint32_t>(8, 0xFFFFFFFF);
+  EXPECT_FALSE(select(host::utils::isa_level_x86_64_v4).has_value());
+}
+
+TEST_F(FatBinaryTest, OffsetBeyondEnd) {
+  poke<uint64_t>(header_size + 8, binary.size() + 1);
+  EXPECT_FALSE(select(host::utils::isa_level_baseline).has_value());
+}
+
+TEST_F(FatBinaryTest, SizeBeyondEnd) {
+  poke<uint64_t>(header_size + 16, binary.size());
+  EXPECT_FALSE(select(host::utils::isa_level_baseline).has_value());
+}
+
+TEST_F(FatBinaryTest, SizeOverflow) {
+  // offset + size wraps around, which must not pass the bounds check.
+  poke<uint64_t>(header_size + 16, UINT64_MAX);
+  EXPECT_FALSE(select(host::utils::isa_level_baseline).has_value());
+}
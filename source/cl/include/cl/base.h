@@ -364,6 +364,18 @@ cl_int releaseExternal(T object) {
 template <>
 cl_int releaseExternal<cl_mem>(cl_mem object);
 
+/// @brief Declare specialization for `cl_event`.
+///
+/// Event storage is recycled through the owning context's event pool rather
+/// than being returned to the system allocator.
+///
+/// @param object Object to decrement the reference count on.
+///
+/// @return Returns CL_SUCCESS, CL_INVALID_EVENT if the external reference
+/// count is zero.
+template <>
+cl_int releaseExternal<cl_event>(cl_event object);
+
 /// @brief Increment an object's internal reference count.
 ///
 /// @tparam T Type of the object.
@@ -408,6 +420,15 @@ void releaseInternal(T object) {
 template <>
 void releaseInternal<cl_mem>(cl_mem object);
 
+/// @brief Declare specialization for `cl_event`.
+///
+/// Event storage is recycled through the owning context's event pool rather
+/// than being returned to the system allocator.
+///
+/// @param object Object to decrement the reference count on.
+template <>
+void releaseInternal<cl_event>(cl_event object);
+
 /// @}
 }  // cl
 
@@ -0,0 +1,91 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Threads which run program builds in the background.
+
+#ifndef CL_BUILD_POOL_H_INCLUDED
+#define CL_BUILD_POOL_H_INCLUDED
+
+#include <CL/cl.h>
+#include <cargo/small_vector.h>
+#include <cargo/thread.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace cl {
+/// @addtogroup cl
+/// @{
+
+/// @brief Pool of threads which run the builds started by `clBuildProgram`
+/// and `clCompileProgram` when a notification callback is given.
+///
+/// The threads are only started once the first build is enqueued, so
+/// applications which never request a background build do not pay for them.
+/// The number of threads defaults to the number of hardware threads, up to
+/// `max_num_threads`, and can be lowered with the `CA_CL_BUILD_THREADS`
+/// environment variable.
+class build_pool {
+ public:
+  /// @brief Maximum number of threads in the pool.
+  static constexpr size_t max_num_threads = 8;
+
+  build_pool() = default;
+  build_pool(const build_pool &) = delete;
+  build_pool &operator=(const build_pool &) = delete;
+
+  /// @brief Destructor, calls `shutdown`.
+  ~build_pool();
+
+  /// @brief Run every queued build then join the pool's threads.
+  ///
+  /// Builds call into the compiler library and use the platform's devices, so
+  /// this must be called before either is destroyed. Builds enqueued after
+  /// this is called are rejected.
+  void shutdown();
+
+  /// @brief Enqueue a build to be run on one of the pool's threads.
+  ///
+  /// @param[in] build Function performing the build.
+  ///
+  /// @return Returns `CL_SUCCESS`, `CL_OUT_OF_HOST_MEMORY` if the build could
+  /// not be enqueued, or `CL_OUT_OF_RESOURCES` if the pool was shut down.
+  cl_int enqueue(std::function<void()> build);
+
+ private:
+  /// @brief Entry point of the pool's threads.
+  void run();
+
+  /// @brief Mutex protecting the members below.
+  std::mutex mutex;
+  /// @brief Condition signalled when a build is enqueued or the pool stops.
+  std::condition_variable condition;
+  /// @brief Builds waiting for a thread.
+  std::deque<std::function<void()>> builds;
+  /// @brief The pool's threads, empty until the first build is enqueued.
+  cargo::small_vector<cargo::thread, max_num_threads> threads;
+  /// @brief Set when the pool is being destroyed.
+  bool stop = false;
+};
+
+/// @}
+}  // namespace cl
+
+#endif  // CL_BUILD_POOL_H_INCLUDED
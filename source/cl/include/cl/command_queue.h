@@ -24,6 +24,7 @@
 #include <CL/cl.h>
 #include <cargo/array_view.h>
 #include <cargo/expected.h>
+#include <cargo/flat_hash_map.h>
 #include <cargo/ring_buffer.h>
 #include <cargo/small_vector.h>
 #include <cl/base.h>
@@ -423,18 +424,23 @@ struct _cl_command_queue final : public cl::base<_cl_command_queue> {
 
     /// @brief Flag specifying if it is the responsibility of the command queue
     /// to destroy  the command buffer. This is true for non-user command
-    /// buffers and user command buffers which have been cloned.
+    /// buffers and transient instances of user command buffers.
     bool should_destroy_command_buffer;
   };
 
   /// @brief Ordered list of pending command buffers.
   cargo::small_vector<mux_command_buffer_t, 16> pending_command_buffers;
   /// @brief Mapping from command buffer to dispatch information.
-  std::unordered_map<mux_command_buffer_t, dispatch_state_t> pending_dispatches;
+  ///
+  /// Looked up on every enqueue so this is a flat map. References into it are
+  /// invalidated by insertions, so they must not be held across a call which
+  /// may add a new pending command buffer.
+  cargo::flat_hash_map<mux_command_buffer_t, dispatch_state_t>
+      pending_dispatches;
   /// @brief Mapping from command buffer to fence.
   /// TODO: This is probably not the best way to do this. Fences can be reset,
   /// so we could create a pool of them and reuse them as they are signaled.
-  std::unordered_map<mux_command_buffer_t, mux_fence_t> fences;
+  cargo::flat_hash_map<mux_command_buffer_t, mux_fence_t> fences;
 
   /// @brief State required for tracking a running command buffer.
   struct running_state_t {
@@ -449,7 +455,7 @@ struct _cl_command_queue final : public cl::base<_cl_command_queue> {
     bool is_user_command_buffer;
     /// @brief Flag specifying if it is the responsibility of the command queue
     /// to destroy  the command buffer. This is true for non-user command
-    /// buffers and user command buffers which have been cloned.
+    /// buffers and transient instances of user command buffers.
     bool should_destroy_command_buffer;
   };
 
@@ -212,9 +212,26 @@ struct _cl_context final : public cl::base<_cl_context> {
   /// @brief List of allocations made through the USM extension entry points.
   cargo::small_vector<std::unique_ptr<extension::usm::allocation_info>, 1>
       usm_allocations;
+  /// @brief Cache of freed USM allocations for reuse by later allocations.
+  extension::usm::allocation_pool usm_pool;
 #endif
   std::mutex &getCommandQueueMutex() { return command_queue_mutex; }
 
+  /// @brief Take storage for an event from the context's event pool.
+  ///
+  /// Events are created and released at a very high rate, recycling their
+  /// storage avoids a trip to the system allocator for each enqueue.
+  ///
+  /// @return Returns uninitialized storage suitably sized and aligned for a
+  /// `_cl_event`, or `nullptr` if an allocation failed.
+  void *acquireEventStorage();
+
+  /// @brief Return storage for a destroyed event to the context's event pool.
+  ///
+  /// @param storage Storage previously returned by `acquireEventStorage`, the
+  /// event occupying it must already have been destroyed.
+  void releaseEventStorage(void *storage);
+
  private:
   /// @brief Default constructor, made private to enforce use of `create`.
   _cl_context()
@@ -230,6 +247,10 @@ struct _cl_context final : public cl::base<_cl_context> {
   std::mutex compiler_targets_mutex;
   /// @brief A mutex that guards any command queues.
   std::mutex command_queue_mutex;
+  /// @brief A mutex that guards the event pool.
+  std::mutex event_pool_mutex;
+  /// @brief Free list of recycled event storage.
+  cargo::small_vector<void *, 64> event_pool;
   /// @brief Map of OpenCL devices to compiler targets.
   std::unordered_map<cl_device_id, std::unique_ptr<compiler::Target>>
       compiler_targets;
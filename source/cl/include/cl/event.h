@@ -29,8 +29,12 @@
 #include <cl/limits.h>
 #include <mux/mux.h>
 
-#include <condition_variable>
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#if !defined(__linux__)
+#include <condition_variable>
+#endif
 
 namespace cl {
 /// @addtogroup cl
@@ -99,8 +103,10 @@ struct _cl_event final : public cl::base<_cl_event> {
   /// @retval `CL_OUT_OF_HOST_MEMORY` if an allocation failed.
   static cargo::expected<cl_event, cl_int> create(cl_context context);
 
-  /// @brief Destructor.
-  ~_cl_event();
+  /// @brief Destroy an event and return its storage to the context's pool.
+  ///
+  /// @param event Event to destroy, its reference counts must be zero.
+  static void destroy(cl_event event);
 
   /// @brief Register a notification callback function to the event.
   ///
@@ -149,25 +155,41 @@ struct _cl_event final : public cl::base<_cl_event> {
   _cl_event(const _cl_event &) = delete;
   _cl_event &operator=(const _cl_event &) = delete;
 
+  /// @brief Destructor, made private to enforce use of `destroy`.
+  ~_cl_event();
+
   /// @brief Remove all registered callbacks and call them.
   ///
   /// Function removes all callbacks regardless of if their status has been
   /// reached or surpassed. Only call for completed events or user events.
   void clear();
 
+  /// @brief Completion word, set once _cl_event::complete() has finished.
+  ///
+  /// _cl_event::wait() spins on this word before sleeping on it, on Linux the
+  /// sleep is a futex wait directly on the word.
+  std::atomic<uint32_t> signalled;
+  /// @brief Number of threads sleeping in _cl_event::wait(), allows
+  /// _cl_event::complete() to skip the wake-up when nobody is waiting.
+  std::atomic<uint32_t> waiters;
+#if !defined(__linux__)
   /// @brief Mutex used for signalling between _cl_event::wait() and
   /// _cl_event::complete() member functions.
   std::mutex wait_complete_mutex;
   /// @brief Condition variable used for signalling between _cl_event::wait()
   /// and _cl_event::complete() member functions.
   std::condition_variable wait_complete_condition;
+#endif
   /// @brief Mutex to protect concurrent access to _cl_event::callbacks.
   ///
   /// The mutex needs to be recursive, as nothing prohibits a callback from
   /// calling clSetEventCallback on the event it is operating on.
   std::mutex callback_mutex;
   /// @brief Vector of registered event callback functions.
-  cargo::small_vector<callback_state_t, 4> callbacks;
+  ///
+  /// Events almost always have at most a single callback, which is stored
+  /// inline.
+  cargo::small_vector<callback_state_t, 1> callbacks;
 };
 
 /// @}
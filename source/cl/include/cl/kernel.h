@@ -124,6 +124,10 @@ class MuxKernelWrapper {
   /// contains a kernel optimized for the specific Mux execution parameters.
   ///
   /// @param specialization_options Mux execution options to specialize for.
+  /// @param for_enqueue Whether the kernel is for a single enqueue whose
+  /// arguments can not be updated, see
+  /// `compiler::Kernel::createSpecializedKernelForEnqueue`. Commands recorded
+  /// into a command buffer must pass false.
   ///
   /// @return A valid SpecializedKernel object if specialization was successful,
   /// or a status code otherwise.
@@ -132,7 +136,7 @@ class MuxKernelWrapper {
   /// invalid.
   /// @retval `Result::FAILURE` if this kernel is not specializable.
   cargo::expected<SpecializedKernel, compiler::Result> createSpecializedKernel(
-      const mux_ndrange_options_t &specialization_options);
+      const mux_ndrange_options_t &specialization_options, bool for_enqueue);
 
   /// @brief If this kernel does not support specialization, this returns the
   /// generic Mux kernel that is not specialized for any particular config.
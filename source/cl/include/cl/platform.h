@@ -26,6 +26,7 @@
 #include <cargo/expected.h>
 #include <cargo/optional.h>
 #include <cl/base.h>
+#include <cl/build_pool.h>
 #include <compiler/loader.h>
 #include <mux/mux.h>
 
@@ -82,6 +83,13 @@ struct _cl_platform_id final : cl::base<_cl_platform_id> {
   cargo::expected<std::unique_ptr<compiler::Library>, std::string>
       compiler_library;
 
+ public:
+  /// @brief Threads running program builds in the background.
+  ///
+  /// Declared after `compiler_library` so that it is destroyed first. Builds
+  /// call into the compiler.
+  cl::build_pool build_pool;
+
 #if defined(CL_VERSION_3_0)
  public:
   /// @brief Resolution of the timestamp returned by clGetHostTimer and
@@ -23,6 +23,7 @@
 
 #include <CL/cl.h>
 #include <cargo/expected.h>
+#include <cargo/flat_hash_map.h>
 #include <cargo/optional.h>
 #include <cargo/string_view.h>
 #include <cl/base.h>
@@ -32,6 +33,8 @@
 #include <cl/kernel.h>
 #include <extension/config.h>
 
+#include <condition_variable>
+#include <mutex>
 #include <unordered_map>
 
 namespace cl {
@@ -104,7 +107,7 @@ class mux_kernel_cache {
   // We need to guard against creating kernels in parallel, to avoid
   // corrupting the kernel map.
   std::mutex kernel_map_mutex;
-  std::unordered_map<std::string, mux::unique_ptr<mux_kernel_t>> kernel_map;
+  cargo::flat_hash_map<std::string, mux::unique_ptr<mux_kernel_t>> kernel_map;
 };
 
 /// @brief A class which encapsulates device specific program information, such
@@ -498,6 +501,44 @@ struct _cl_program final : public cl::base<_cl_program> {
   /// @return Return true on success, false on failure.
   bool finalize(cargo::array_view<const cl_device_id> devices);
 
+  /// @brief Compile, and optionally finalize, the program on a build thread.
+  ///
+  /// The build is marked as in progress before this function returns and
+  /// `pfn_notify` is invoked from the build thread once it has completed. If
+  /// the application releases the program before the build completes the
+  /// remaining build steps are skipped and the build fails.
+  ///
+  /// @param[in] devices List of devices to build the program for.
+  /// @param[in] input_headers List of input headers to be included. These are
+  /// copied so need not outlive the call.
+  /// @param[in] finalize_program Finalize the program after compiling it, as
+  /// `clBuildProgram` does.
+  /// @param[in] pfn_notify Callback to invoke when the build has completed.
+  /// @param[in] user_data User data to be passed to `pfn_notify`.
+  ///
+  /// @return Returns an OpenCL error code.
+  /// @retval `CL_SUCCESS` when the build was started.
+  /// @retval `CL_INVALID_OPERATION` if a build is already in progress.
+  /// @retval `CL_OUT_OF_HOST_MEMORY` if an allocation failed.
+  cl_int buildAsync(
+      cargo::array_view<const cl_device_id> devices,
+      cargo::array_view<const compiler::InputHeader> input_headers,
+      bool finalize_program, cl::pfn_notify_program_t pfn_notify,
+      void *user_data);
+
+  /// @brief Query the program to determine if a build is in progress.
+  ///
+  /// @return Return true if a build started by `buildAsync` has not yet
+  /// completed, false otherwise.
+  bool isBuildInProgress();
+
+  /// @brief Wait for any build started by `buildAsync` to complete.
+  ///
+  /// Entry points which access the build state of the program **must** call
+  /// this first because the build thread writes that state without holding a
+  /// lock.
+  void waitForBuild();
+
   /// @brief Query the program for a named kernel.
   ///
   /// @param[in] name Name of the kernel to query.
@@ -596,6 +637,14 @@ struct _cl_program final : public cl::base<_cl_program> {
   /// @brief The type of the program
   cl::program_type type;
 
+  /// @brief Mutex protecting `build_in_progress`.
+  std::mutex build_mutex;
+  /// @brief Condition signalled when a build started by `buildAsync`
+  /// completes.
+  std::condition_variable build_completed;
+  /// @brief True while a build started by `buildAsync` is running.
+  bool build_in_progress = false;
+
 #ifdef OCL_EXTENSION_cl_codeplay_wfv
   /// @brief The work-item ordering of the program.
   std::unordered_map<cl_device_id, cl::program_work_item_order> work_item_order;
@@ -16,6 +16,7 @@
 
 #include <cl/base.h>
 #include <cl/buffer.h>
+#include <cl/event.h>
 #include <cl/image.h>
 
 namespace {
@@ -123,4 +124,32 @@ void releaseInternal<cl_mem>(cl_mem object) {
     destroyMemObject(object);
   }
 }
+
+template <>
+cl_int releaseExternal<cl_event>(cl_event object) {
+  if (!object) {
+    return invalid<cl_event>();
+  }
+  bool should_destroy = false;
+  const cl_int error = object->releaseExternal(should_destroy);
+  if (error) {
+    return error;
+  }
+  if (should_destroy) {
+    _cl_event::destroy(object);
+  }
+  return CL_SUCCESS;
+}
+
+template <>
+void releaseInternal<cl_event>(cl_event object) {
+  if (!object) {
+    return;
+  }
+  bool should_destroy = false;
+  object->releaseInternal(should_destroy);
+  if (should_destroy) {
+    _cl_event::destroy(object);
+  }
+}
 }  // cl
@@ -0,0 +1,86 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cl/build_pool.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+cl::build_pool::~build_pool() { shutdown(); }
+
+void cl::build_pool::shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  condition.notify_all();
+  for (auto &thread : threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+cl_int cl::build_pool::enqueue(std::function<void()> build) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stop) {
+      return CL_OUT_OF_RESOURCES;
+    }
+    if (threads.empty()) {
+      size_t num_threads =
+          std::max<size_t>(1, cargo::thread::hardware_concurrency());
+      if (const char *env = std::getenv("CA_CL_BUILD_THREADS")) {
+        if (const int value = std::atoi(env)) {
+          num_threads = std::min<size_t>(num_threads, std::max(value, 1));
+        }
+      }
+      num_threads = std::min(num_threads, max_num_threads);
+      for (size_t index = 0; index < num_threads; index++) {
+        if (threads.emplace_back(&build_pool::run, this)) {
+          break;
+        }
+        threads.back().set_name("cl:build:" + std::to_string(index));
+      }
+      if (threads.empty()) {
+        return CL_OUT_OF_HOST_MEMORY;
+      }
+    }
+    builds.push_back(std::move(build));
+  }
+  condition.notify_one();
+  return CL_SUCCESS;
+}
+
+void cl::build_pool::run() {
+  while (true) {
+    std::function<void()> build;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this] { return stop || !builds.empty(); });
+      // Queued builds hold a reference to their program and must notify the
+      // application, so they are run rather than dropped when stopping. A
+      // build of a program which was already released cancels itself.
+      if (builds.empty()) {
+        return;
+      }
+      build = std::move(builds.front());
+      builds.pop_front();
+    }
+    build();
+  }
+}
@@ -234,7 +234,10 @@ cl_int _cl_command_queue::flush() {
 
       // Filter out all pending_dispatches which depend on user events.
       for (auto &command_buffer : pending_command_buffers) {
-        auto &dispatch = pending_dispatches[command_buffer];
+        auto found = pending_dispatches.find(command_buffer);
+        OCL_ASSERT(found != pending_dispatches.end(),
+                   "command_buffer not found in pending_dispatches");
+        auto &dispatch = found->second;
         if (std::none_of(dispatch.wait_events.begin(),
                          dispatch.wait_events.end(), cl::isUserEvent)) {
           for (auto &wait_event : dispatch.wait_events) {
@@ -291,8 +294,10 @@ cl_int _cl_command_queue::cleanupCompletedCommandBuffers() {
     }
 
     // Check if the first running command buffer has completed.
-    auto fence = fences[running_command_buffers.front().command_buffer];
-    assert(fence && "Missing fence entry for command buffer dispatch!");
+    auto found = fences.find(running_command_buffers.front().command_buffer);
+    assert(found != fences.end() && found->second &&
+           "Missing fence entry for command buffer dispatch!");
+    auto fence = found->second;
     mux_result_t error = muxTryWait(mux_queue, 0, fence);
     OCL_ASSERT(mux_success == error || mux_error_fence_failure == error ||
                    mux_fence_not_ready == error,
@@ -310,7 +315,7 @@ cl_int _cl_command_queue::cleanupCompletedCommandBuffers() {
     // and remove the associated entry from the map.
     // TODO: We could do better here and reset the fences then reuse them.
     muxDestroyFence(device->mux_device, fence, device->mux_allocator);
-    fences.erase(running_command_buffers.front().command_buffer);
+    fences.erase(found);
 
     // Note that by this point 'error' may be either mux_success or
     // mux_error_fence_failure.  This function does not care about
@@ -331,8 +336,10 @@ cl_int _cl_command_queue::cleanupCompletedCommandBuffers() {
     // We need to release references on any command buffers associated with user
     // command buffers even if they are cloned.
     if (completed.is_user_command_buffer) {
-      user_command_buffers[completed.command_buffer]->execution_refcount--;
-      cl::releaseInternal(user_command_buffers[completed.command_buffer]);
+      auto command_buffer = user_command_buffers[completed.command_buffer];
+      command_buffer->endInstance(completed.command_buffer);
+      command_buffer->execution_refcount--;
+      cl::releaseInternal(command_buffer);
       user_command_buffers.erase(completed.command_buffer);
     }
 #endif
@@ -420,7 +427,11 @@ _cl_command_queue::getCommandBuffer(
   auto registerEvents = [this, event_wait_list,
                          event](mux_command_buffer_t command_buffer)
       -> cargo::expected<mux_command_buffer_t, cl_int> {
-    auto &dispatch = pending_dispatches[command_buffer];
+    auto found = pending_dispatches.try_emplace(command_buffer);
+    if (!found) {
+      return cargo::make_unexpected(CL_OUT_OF_RESOURCES);
+    }
+    auto &dispatch = found->first->second;
     if (auto error = dispatch.addWaitEvents(event_wait_list)) {
       return cargo::make_unexpected(error);
     }
@@ -451,9 +462,9 @@ _cl_command_queue::getCommandBuffer(
 CARGO_NODISCARD cl_int _cl_command_queue::registerDispatchCallback(
     mux_command_buffer_t command_buffer, cl_event event,
     std::function<void()> callback) {
-  OCL_ASSERT(
-      pending_dispatches.end() != pending_dispatches.find(command_buffer),
-      "command_buffer not found in pending_dispatches");
+  auto found = pending_dispatches.find(command_buffer);
+  OCL_ASSERT(pending_dispatches.end() != found,
+             "command_buffer not found in pending_dispatches");
   if (event && (properties & CL_QUEUE_PROFILING_ENABLE)) {
     if (auto mux_error = muxCommandEndQuery(command_buffer,
                                             event->profiling.duration_queries,
@@ -461,7 +472,7 @@ CARGO_NODISCARD cl_int _cl_command_queue::registerDispatchCallback(
       return cl::getErrorFrom(mux_error);
     }
   }
-  if (pending_dispatches[command_buffer].addCallback(std::move(callback))) {
+  if (found->second.addCallback(std::move(callback))) {
     return CL_OUT_OF_RESOURCES;
   }
   return CL_SUCCESS;
@@ -484,14 +495,17 @@ _cl_command_queue::getCommandBufferPending(
   // Utility function object adds wait semaphores to a pending dispatch.
   struct add_wait {
     add_wait(cargo::array_view<mux_shared_semaphore> semaphores,
-             std::unordered_map<mux_command_buffer_t, dispatch_state_t>
+             cargo::flat_hash_map<mux_command_buffer_t, dispatch_state_t>
                  &pending_dispatches)
         : semaphores(semaphores), pending_dispatches(pending_dispatches) {}
 
     cargo::expected<mux_command_buffer_t, cl_int> operator()(
         mux_command_buffer_t command_buffer) {
       if (!semaphores.empty()) {
-        auto &dispatch = pending_dispatches[command_buffer];
+        auto found = pending_dispatches.find(command_buffer);
+        OCL_ASSERT(found != pending_dispatches.end(),
+                   "command_buffer not found in pending_dispatches");
+        auto &dispatch = found->second;
         auto wait_sems_size = dispatch.wait_semaphores.size();
 
         // Insert the wait semaphores into the list.
@@ -521,12 +535,13 @@ _cl_command_queue::getCommandBufferPending(
     }
 
     cargo::array_view<mux_shared_semaphore> semaphores;
-    std::unordered_map<mux_command_buffer_t, dispatch_state_t>
+    cargo::flat_hash_map<mux_command_buffer_t, dispatch_state_t>
         &pending_dispatches;
   };
 
   // Storage for the pending dispatches on which this command buffer will
-  // depend.
+  // depend. These point into `pending_dispatches` so they must not be used
+  // once `createCommandBuffer` has added a new entry.
   using dispatch_pair = std::pair<const mux_command_buffer_t, dispatch_state_t>;
   cargo::small_vector<dispatch_pair *, 8> dependent_dispatches;
 
@@ -649,7 +664,10 @@ _cl_command_queue::getCommandBufferPending(
 CARGO_NODISCARD cl_int _cl_command_queue::dispatch(
     cargo::array_view<mux_command_buffer_t> command_buffers) {
   for (auto command_buffer : command_buffers) {
-    auto &dispatch = pending_dispatches[command_buffer];
+    auto found = pending_dispatches.find(command_buffer);
+    OCL_ASSERT(found != pending_dispatches.end(),
+               "command_buffer not found in pending_dispatches");
+    auto &dispatch = found->second;
 
     if (counter_queries) {
       if (auto mux_error =
@@ -689,9 +707,12 @@ CARGO_NODISCARD cl_int _cl_command_queue::dispatch(
 
     // Put the fence in the lookup map so we know what fence to wait on for a
     // given command buffer.
-    assert(fences.find(command_buffer) == std::end(fences) &&
-           "command buffer already has fence entry!");
-    fences[command_buffer] = fence;
+    auto fence_entry = fences.try_emplace(command_buffer, fence);
+    if (!fence_entry) {
+      muxDestroyFence(device->mux_device, fence, device->mux_allocator);
+      return CL_OUT_OF_RESOURCES;
+    }
+    assert(fence_entry->second && "command buffer already has fence entry!");
 
     // Set all events as submitted.
     for (auto signal_event : dispatch.signal_events) {
@@ -898,9 +919,17 @@ _cl_command_queue::createCommandBuffer() {
     destroyCommandBuffer(command_buffer);
     return cargo::make_unexpected(semaphore.error());
   }
-  pending_dispatches[command_buffer].signal_semaphore = *semaphore;
-  pending_dispatches[command_buffer].is_user_command_buffer = false;
-  pending_dispatches[command_buffer].should_destroy_command_buffer = true;
+  auto found = pending_dispatches.try_emplace(command_buffer);
+  if (!found) {
+    pending_command_buffers.pop_back();
+    releaseSemaphore(*semaphore);
+    destroyCommandBuffer(command_buffer);
+    return cargo::make_unexpected(CL_OUT_OF_RESOURCES);
+  }
+  auto &dispatch = found->first->second;
+  dispatch.signal_semaphore = *semaphore;
+  dispatch.is_user_command_buffer = false;
+  dispatch.should_destroy_command_buffer = true;
 
   if (counter_queries) {
     if (auto mux_error =
@@ -1360,49 +1389,75 @@ CARGO_NODISCARD cl_int _cl_command_queue::enqueueCommandBuffer(
   // We need to acquire the lock on the command buffer since we will read and
   // modify its state throughout this function.
 
-  auto mux_command_buffer = command_buffer->mux_command_buffer;
-
-  // We need to check if the mux_command_buffer associated with the
-  // cl_command_buffer_khr object has already been enqueued to a command
-  // queue. If it has, then we need to clone the underlying mux_command_buffer_t
-  // since mux_command_buffer_ts are single use.
-  auto command_queue_should_destroy_command_buffer = false;
-  if (command_buffer->execution_refcount > 0) {
-    mux_command_buffer_t cloned_mux_command_buffer;
-    auto device = command_buffer->command_queue->device;
-    if (auto error = muxCloneCommandBuffer(
-            device->mux_device, device->mux_allocator, mux_command_buffer,
-            &cloned_mux_command_buffer)) {
-      return cl::getErrorFrom(error);
+  // mux_command_buffer_ts are single use, so if the command-buffer is already
+  // executing we need another instance of it. The command-buffer keeps the
+  // instances it clones for reuse. Once it holds as many as it will keep a
+  // transient instance is returned instead, which the command queue destroys
+  // on completion. Pending mutable-dispatch updates are applied to the
+  // instance before it is returned.
+  bool transient = false;
+  auto instance = command_buffer->acquireInstance(transient);
+  if (!instance) {
+    return instance.error();
+  }
+  auto mux_command_buffer = *instance;
+
+  // Undo the setup of the dispatch if it fails before the dispatch is pending.
+  // The signal event has already been returned to the caller so it is
+  // completed with the error. A transient instance is only destroyed by the
+  // command queue once its dispatch completes, so it must be destroyed here
+  // instead.
+  const auto abandonDispatch = [&](cl_int error) {
+    if (event) {
+      event->complete(error);
     }
-    mux_command_buffer = cloned_mux_command_buffer;
-    command_queue_should_destroy_command_buffer = true;
-  }
-
-#ifdef OCL_EXTENSION_cl_khr_command_buffer_mutable_dispatch
-  for (_cl_command_buffer_khr::UpdateInfo &update : command_buffer->updates) {
-    const unsigned num_args = update.indices.size();
-    auto mux_error =
-        muxUpdateDescriptors(mux_command_buffer, update.id, num_args,
-                             update.indices.data(), update.descriptors.data());
-    if (mux_error) {
-      return cl::getErrorFrom(mux_error);
+    if (!pending_command_buffers.empty() &&
+        pending_command_buffers.back() == mux_command_buffer) {
+      pending_command_buffers.pop_back();
     }
-  }
-  command_buffer->updates.clear();
-#endif
+    auto pending = pending_dispatches.find(mux_command_buffer);
+    if (pending != pending_dispatches.end()) {
+      auto &abandoned = pending->second;
+      if (abandoned.signal_semaphore) {
+        releaseSemaphore(abandoned.signal_semaphore);
+      }
+      for (auto wait_semaphore : abandoned.wait_semaphores) {
+        releaseSemaphore(wait_semaphore);
+      }
+      for (auto wait_event : abandoned.wait_events) {
+        cl::releaseInternal(wait_event);
+      }
+      for (auto signal_event : abandoned.signal_events) {
+        cl::releaseInternal(signal_event);
+      }
+      pending_dispatches.erase(mux_command_buffer);
+    }
+    if (transient) {
+      auto instance_device = command_buffer->command_queue->device;
+      muxDestroyCommandBuffer(instance_device->mux_device, mux_command_buffer,
+                              instance_device->mux_allocator);
+    }
+    return error;
+  };
 
   // Since we can't do any batching with user command buffers we can just wait
   // directly on the last pending dispatch (we need to do this anyway to enforce
   // an in order queue). Since the queue is in order, we know that any event
   // dependencies requested by the user will still be respected. This will not
   // work for cross queue event dependencies (see CA-3276).
+  auto found = pending_dispatches.try_emplace(mux_command_buffer);
+  if (!found) {
+    return abandonDispatch(CL_OUT_OF_RESOURCES);
+  }
+  auto &dispatch = found->first->second;
   if (!pending_command_buffers.empty()) {
-    auto &signal_semaphore =
-        pending_dispatches[pending_command_buffers.back()].signal_semaphore;
-    if (pending_dispatches[mux_command_buffer].wait_semaphores.push_back(
-            signal_semaphore)) {
-      return CL_OUT_OF_RESOURCES;
+    auto last = pending_dispatches.find(pending_command_buffers.back());
+    OCL_ASSERT(last != pending_dispatches.end(),
+               "The last pending command buffer has no entry in the "
+               "pending dispatches map.");
+    auto signal_semaphore = last->second.signal_semaphore;
+    if (dispatch.wait_semaphores.push_back(signal_semaphore)) {
+      return abandonDispatch(CL_OUT_OF_RESOURCES);
     } else {
       signal_semaphore->retain();
     }
@@ -1411,57 +1466,50 @@ CARGO_NODISCARD cl_int _cl_command_queue::enqueueCommandBuffer(
   // Add the underlying mux_command_buffer associated to the
   // cl_command_buffer_khr to the list of pending command buffers.
   if (pending_command_buffers.push_back(mux_command_buffer)) {
-    // We won't destroy the mux_command_buffer here since that is the
-    // responsibility of the command buffer.
-    return CL_OUT_OF_HOST_MEMORY;
+    // We won't destroy the mux_command_buffer here unless it is transient
+    // since that is the responsibility of the command buffer.
+    return abandonDispatch(CL_OUT_OF_HOST_MEMORY);
   }
 
   // Create a semaphore which future command buffers can wait for.
   auto semaphore = createSemaphore();
   if (!semaphore) {
-    return semaphore.error();
+    return abandonDispatch(semaphore.error());
   }
 
   // Add the signal semaphore and wait/signal events to the pending dispatch
   // object used to track this command buffer before it is dispatched.
-  auto &dispatch = pending_dispatches[mux_command_buffer];
   dispatch.signal_semaphore = *semaphore;
   dispatch.is_user_command_buffer = true;
-  dispatch.should_destroy_command_buffer =
-      command_queue_should_destroy_command_buffer;
+  dispatch.should_destroy_command_buffer = transient;
 
   if (auto error =
           dispatch.addWaitEvents({event_wait_list, num_events_in_wait_list})) {
-    if (event) {
-      event->complete(error);
-    }
-    return CL_OUT_OF_RESOURCES;
+    return abandonDispatch(error);
   }
   if (auto error = dispatch.addSignalEvent(event)) {
-    if (event) {
-      event->complete(error);
-    }
-    return CL_OUT_OF_RESOURCES;
+    return abandonDispatch(error);
   }
 
-  // Add callbacks to all the user events in the wait list.
+  // Add callbacks to all the user events in the wait list. If a later
+  // registration fails the callbacks already added find no wait event of this
+  // dispatch once it is abandoned, so they only flush the queue.
   for (unsigned i = 0; i < num_events_in_wait_list; ++i) {
     auto wait_event = event_wait_list[i];
     // Do not wait on completed commands.
     if (cl::isUserEvent(wait_event) &&
         wait_event->command_status != CL_COMPLETE) {
       if (!wait_event->addCallback(CL_COMPLETE, &userEventDispatch, this)) {
-        return CL_OUT_OF_RESOURCES;
+        return abandonDispatch(CL_OUT_OF_RESOURCES);
       }
     }
   }
 
   // We need to wait on all running commands to enforce ordering.
   for (auto &running_command_buffer : running_command_buffers) {
-    if (pending_dispatches[mux_command_buffer].wait_semaphores.push_back(
+    if (dispatch.wait_semaphores.push_back(
             running_command_buffer.signal_semaphore)) {
-      releaseSemaphore(*semaphore);
-      return CL_OUT_OF_HOST_MEMORY;
+      return abandonDispatch(CL_OUT_OF_HOST_MEMORY);
     } else {
       running_command_buffer.signal_semaphore->retain();
     }
@@ -1469,6 +1517,7 @@ CARGO_NODISCARD cl_int _cl_command_queue::enqueueCommandBuffer(
 
   // Increment refcount so that command-buffer state moves to Pending
   command_buffer->execution_refcount++;
+  command_buffer->beginInstance(mux_command_buffer);
 
   // Release the reference once the dispatch completes.
   guard.dismiss();
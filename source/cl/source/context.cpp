@@ -19,6 +19,7 @@
 #include <cl/binary/spirv.h>
 #include <cl/context.h>
 #include <cl/device.h>
+#include <cl/event.h>
 #include <cl/macros.h>
 #include <cl/platform.h>
 #include <compiler/loader.h>
@@ -28,6 +29,7 @@
 #include <array>
 #include <cstring>
 #include <mutex>
+#include <new>
 
 cargo::expected<cl_context, cl_int> _cl_context::create(
     cargo::array_view<const cl_device_id> devices,
@@ -59,6 +61,13 @@ cargo::expected<cl_context, cl_int> _cl_context::create(
     context->mux_callback.user_data = context.get();
   }
 
+#ifdef OCL_EXTENSION_cl_intel_unified_shared_memory
+  // One set of free lists per device, plus one for host allocations.
+  if (cargo::success != context->usm_pool.init(context->devices.size() + 1)) {
+    return cargo::make_unexpected(CL_OUT_OF_HOST_MEMORY);
+  }
+#endif
+
   // Create SPIR-V device infos.
 #if defined(OCL_EXTENSION_cl_khr_il_program) || defined(CL_VERSION_3_0)
   for (_cl_device_id *device : devices) {
@@ -72,6 +81,15 @@ cargo::expected<cl_context, cl_int> _cl_context::create(
 }
 
 _cl_context::~_cl_context() {
+  // Any events still in the pool have already been destroyed, only their
+  // storage remains.
+  for (void *storage : event_pool) {
+    ::operator delete(storage);
+  }
+#ifdef OCL_EXTENSION_cl_intel_unified_shared_memory
+  // Cached USM allocations hold Mux objects created on the devices.
+  usm_pool.trim(0);
+#endif
   // Clear our references to compiler targets, they must not outlive their
   // respective Contexts.
   compiler_targets.clear();
@@ -93,6 +111,31 @@ _cl_context::~_cl_context() {
 #endif
 }
 
+void *_cl_context::acquireEventStorage() {
+  {
+    std::lock_guard<std::mutex> lock(event_pool_mutex);
+    if (!event_pool.empty()) {
+      void *storage = event_pool.back();
+      event_pool.pop_back();
+      return storage;
+    }
+  }
+  return ::operator new(sizeof(_cl_event), std::nothrow);
+}
+
+void _cl_context::releaseEventStorage(void *storage) {
+  {
+    std::lock_guard<std::mutex> lock(event_pool_mutex);
+    // Only keep as many events as fit in the pool's inline storage, a burst of
+    // events should not permanently grow the context.
+    if (event_pool.size() < event_pool.capacity() &&
+        cargo::success == event_pool.push_back(storage)) {
+      return;
+    }
+  }
+  ::operator delete(storage);
+}
+
 bool _cl_context::hasDevice(const cl_device_id device) const {
   return std::find(devices.begin(), devices.end(), device) != devices.end();
 }
@@ -24,13 +24,44 @@
 #include <tracer/tracer.h>
 #include <utils/system.h>
 
+#include <algorithm>
+#include <climits>
+#include <new>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+/// @brief Number of times _cl_event::wait() polls the completion word before
+/// going to sleep.
+constexpr uint32_t event_wait_spin_count = 2048;
+
+#if defined(__linux__)
+/// @brief Sleep until @p word is woken, if it still holds @p expected.
+void futexWait(std::atomic<uint32_t> *word, uint32_t expected) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT_PRIVATE,
+          expected, nullptr, nullptr, 0);
+}
+
+/// @brief Wake all threads sleeping on @p word.
+void futexWakeAll(std::atomic<uint32_t> *word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE_PRIVATE,
+          INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+}  // namespace
+
 cargo::expected<cl_event, cl_int> _cl_event::create(
     cl_command_queue queue, const cl_command_type type) {
   OCL_ASSERT(queue != nullptr, "queue must not be null");
-  std::unique_ptr<_cl_event> event(new _cl_event(queue->context, queue, type));
-  if (!event) {
+  void *storage = queue->context->acquireEventStorage();
+  if (!storage) {
     return cargo::make_unexpected(CL_OUT_OF_HOST_MEMORY);
   }
+  cl_event event = new (storage) _cl_event(queue->context, queue, type);
   if (queue->properties & CL_QUEUE_PROFILING_ENABLE) {
     event->profiling.enabled = true;
     // The lifetime of mux queues is not controllable so this is safe
@@ -44,19 +75,30 @@ cargo::expected<cl_event, cl_int> _cl_event::create(
                      mux_error != mux_error_null_out_parameter,
                  "internal error calling muxCreateQueryPool");
       OCL_UNUSED(mux_error);
+      destroy(event);
       return cargo::make_unexpected(CL_OUT_OF_RESOURCES);
     }
   }
-  return event.release();
+  return event;
 }
 
 cargo::expected<cl_event, cl_int> _cl_event::create(cl_context context) {
-  std::unique_ptr<_cl_event> event(
-      new _cl_event(context, nullptr, CL_COMMAND_USER));
-  if (!event) {
+  void *storage = context->acquireEventStorage();
+  if (!storage) {
     return cargo::make_unexpected(CL_OUT_OF_HOST_MEMORY);
   }
-  return event.release();
+  return new (storage) _cl_event(context, nullptr, CL_COMMAND_USER);
+}
+
+void _cl_event::destroy(cl_event event) {
+  // The event holds an internal reference on its context which is released by
+  // its destructor, keep the context alive until the storage is back in the
+  // pool.
+  cl_context context = event->context;
+  cl::retainInternal(context);
+  event->~_cl_event();
+  context->releaseEventStorage(event);
+  cl::releaseInternal(context);
 }
 
 _cl_event::_cl_event(cl_context context, cl_command_queue queue,
@@ -65,7 +107,9 @@ _cl_event::_cl_event(cl_context context, cl_command_queue queue,
       context(context),
       queue(queue),
       command_type(type),
-      command_status(CL_QUEUED) {
+      command_status(CL_QUEUED),
+      signalled(0),
+      waiters(0) {
   if (queue) {
     cl::retainInternal(queue);
   }
@@ -118,22 +162,47 @@ void _cl_event::submitted() {
 void _cl_event::running() { command_status = CL_RUNNING; }
 
 void _cl_event::complete(const cl_int status) {
-  std::unique_lock<std::mutex> signal_lock(wait_complete_mutex);
-
   command_status = status;
 
-  // Trigger callbacks before notifying condition variable.
+  // Trigger callbacks before waking any waiters.
   // This is not mandated by the OpenCL 1.2 specs but seems the correct order.
   clear();
 
+  // Callers of complete() hold a reference on the event, so it is safe to
+  // touch the event after publishing completion even if a waiter immediately
+  // releases it.
+#if defined(__linux__)
+  signalled = 1;
+  if (waiters) {
+    futexWakeAll(&signalled);
+  }
+#else
+  {
+    std::lock_guard<std::mutex> signal_lock(wait_complete_mutex);
+    signalled = 1;
+  }
   wait_complete_condition.notify_all();
+#endif
 }
 
 void _cl_event::wait() {
-  std::unique_lock<std::mutex> signal_lock(wait_complete_mutex);
-  while (CL_COMPLETE < command_status) {
-    wait_complete_condition.wait(signal_lock);
+  // Most waits are on events which are about to complete, poll for a short
+  // while before paying for a sleep and wake-up.
+  for (uint32_t spin = 0; spin < event_wait_spin_count; spin++) {
+    if (signalled.load(std::memory_order_acquire)) {
+      return;
+    }
+  }
+#if defined(__linux__)
+  waiters++;
+  while (!signalled) {
+    futexWait(&signalled, 0);
   }
+  waiters--;
+#else
+  std::unique_lock<std::mutex> signal_lock(wait_complete_mutex);
+  wait_complete_condition.wait(signal_lock, [this] { return 0 != signalled; });
+#endif
 }
 
 void _cl_event::clear() {
@@ -156,7 +225,7 @@ void _cl_event::clear() {
   while (!callbacks.empty()) {
     // Work on batches of callbacks to minimize unlocking and locking.
     // Assuming that all callbacks have completed or failed.
-    cargo::small_vector<callback_state_t, 4> callbacks_to_execute =
+    cargo::small_vector<callback_state_t, 1> callbacks_to_execute =
         std::move(callbacks);
     // Ensure that callbacks are not called more than once.
     callbacks.clear();
@@ -209,9 +278,8 @@ CL_API_ENTRY cl_int CL_API_CALL cl::WaitForEvents(cl_uint num_events,
   OCL_CHECK(!event_list, return CL_INVALID_VALUE);
 
   _cl_context *previousContext = nullptr;
-  _cl_command_queue *previousQueue = nullptr;
-  bool moreThanOneQueue = false;
-  bool userEventInList = false;
+  // Distinct queues the events belong to, typically there is only one.
+  cargo::small_vector<_cl_command_queue *, 4> queues;
 
   for (cl_uint i = 0; i < num_events; i++) {
     OCL_CHECK(!(event_list[i]), return CL_INVALID_EVENT);
@@ -220,62 +288,40 @@ CL_API_ENTRY cl_int CL_API_CALL cl::WaitForEvents(cl_uint num_events,
     OCL_CHECK(previousContext && (previousContext != currentContext),
               return CL_INVALID_CONTEXT);
     previousContext = currentContext;
-    if (!moreThanOneQueue) {
-      if (nullptr == previousQueue) {
-        previousQueue = event_list[i]->queue;
-      } else if (nullptr != event_list[i]->queue) {
-        if (event_list[i]->queue != previousQueue) {
-          moreThanOneQueue = true;
-        }
+    _cl_command_queue *queue = event_list[i]->queue;
+    if (nullptr != queue &&
+        std::find(queues.begin(), queues.end(), queue) == queues.end()) {
+      if (cargo::success != queues.push_back(queue)) {
+        return CL_OUT_OF_HOST_MEMORY;
       }
     }
-
-    if (CL_COMMAND_USER == event_list[i]->command_type) {
-      userEventInList = true;
-    }
   }
 
-  // need to implicitly flush all the queues that the events belong to.
-  for (cl_uint i = 0; i < num_events; i++) {
-    // if the event belonged to a queue
-    if (nullptr != event_list[i]->queue) {
-      std::lock_guard<std::mutex> lock(
-          event_list[i]->queue->context->getCommandQueueMutex());
-      cl_int result = event_list[i]->queue->flush();
-
+  // need to implicitly flush all the queues that the events belong to. All
+  // queues in a context share the same mutex so only take it once.
+  if (!queues.empty()) {
+    std::lock_guard<std::mutex> lock(previousContext->getCommandQueueMutex());
+    for (auto queue : queues) {
+      cl_int result = queue->flush();
       if (CL_SUCCESS != result) {
         return result;
       }
-
-      if (!moreThanOneQueue) {
-        // if we had exactly one queue, we don't need to re-flush the same queue
-        // multiple times
-        break;
-      }
     }
   }
 
-  // if we are waiting on more than one queue we have to wait on each event
-  // separately
-  if (moreThanOneQueue || userEventInList) {
-    for (cl_uint i = 0; i < num_events; i++) {
-      // if the event did not belong to a queue
-      if (nullptr == event_list[i]->queue) {
-        event_list[i]->wait();
-      } else {
-        event_list[i]->queue->waitForEvents(1, &event_list[i]);
-      }
-    }
-  } else {
-    for (cl_uint i = 0; i < num_events; i++) {
-      if (nullptr == event_list[i]->queue) {
-        continue;
-      }
-
-      // if the event belonged to a queue, query the queue to wait for the event
-      event_list[i]->queue->waitForEvents(num_events, event_list);
+  // Waiting on the events themselves does not require any locks.
+  for (cl_uint i = 0; i < num_events; i++) {
+    event_list[i]->wait();
+  }
 
-      break;
+  // Now the events are complete clean up the command buffers they were part
+  // of, once per queue rather than once per event.
+  if (!queues.empty()) {
+    std::lock_guard<std::mutex> lock(previousContext->getCommandQueueMutex());
+    for (auto queue : queues) {
+      // Failures are reported through the event status checked below.
+      cl_int error = queue->cleanupCompletedCommandBuffers();
+      OCL_UNUSED(error);
     }
   }
 
@@ -417,8 +463,8 @@ CL_API_ENTRY cl_int CL_API_CALL cl::GetEventProfilingInfo(
 
   // OpenCL 1.2 specification says that profiling event information is not
   // queryable until an event's status is CL_COMPLETE.  This also means that if
-  // the status is CL_COMPLETE we can read the profiling values without locking
-  // 'wait_complete_mutex' because the profiling values get set before the
+  // the status is CL_COMPLETE we can read the profiling values without any
+  // further synchronization because the profiling values get set before the
   // status is set.
   OCL_CHECK(CL_COMPLETE != event->command_status,
             return CL_PROFILING_INFO_NOT_AVAILABLE);
@@ -27,7 +27,9 @@
 #include <cargo/small_vector.h>
 #include <extension/extension.h>
 #include <mux/mux.h>
+#include <mux/utils/allocation_pool.h>
 
+#include <memory>
 #include <mutex>
 
 namespace extension {
@@ -127,6 +129,15 @@ class allocation_info {
   const cl_context context;
   /// @brief Size in bytes of the requested device allocation.
   size_t size;
+  /// @brief Size in bytes of the memory backing the allocation. This is
+  /// `size` rounded up to the size class of the context's allocation pool.
+  size_t capacity;
+  /// @brief Alignment in bytes the memory was allocated with.
+  cl_uint alignment;
+  /// @brief Whether the allocation holds an internal reference to `context`.
+  /// It is dropped while the allocation is cached by the context's
+  /// `allocation_pool` so cached memory does not keep the context alive.
+  bool retains_context;
   /// @brief Pointer returned by USM allocation entry points
   void *base_ptr;
   /// @brief Properties set on allocation
@@ -254,6 +265,37 @@ class device_allocation_info final : public allocation_info {
   mux_buffer_t mux_buffer;
 };
 
+/// @brief Cache of freed USM allocations owned by a context.
+///
+/// Each device in the context has its own free lists, at the index of the
+/// device in the context, and host allocations use the lists after them.
+using allocation_pool = mux::allocation_pool<allocation_info>;
+
+/// @brief Take an allocation cached by a context able to satisfy a request.
+///
+/// On success the returned allocation has its `size` updated to the request
+/// and holds a reference to its context again.
+///
+/// @param[in] context Context whose pool to take the allocation from.
+/// @param[in] device Device of the request, or nullptr for host requests.
+/// @param[in] size Requested allocation size in bytes.
+/// @param[in] alignment Required alignment in bytes of the request.
+///
+/// @return The cached allocation, or nullptr if there is none.
+std::unique_ptr<allocation_info> acquireCachedAllocation(cl_context context,
+                                                         cl_device_id device,
+                                                         size_t size,
+                                                         cl_uint alignment);
+
+/// @brief Return a freed allocation to its context's pool.
+///
+/// The allocation is destroyed if it can't be cached. This must not be called
+/// with the context's mutex held, since caching can drop the last reference to
+/// the context.
+///
+/// @param[in] allocation Allocation which was freed by the user.
+void releaseAllocation(std::unique_ptr<allocation_info> allocation);
+
 /// @brief Validates properties passed to the USM allocation entry points for
 /// correctness, returning memory allocation flags so they can be stored for
 /// later user queries.
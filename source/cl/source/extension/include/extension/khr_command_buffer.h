@@ -241,7 +241,34 @@ struct _cl_command_buffer_khr final : public cl::base<_cl_command_buffer_khr> {
     // ID of mutable command
     cl_uint id;
   };
+  /// @brief Log of updates which have not yet been applied to every instance.
   cargo::small_vector<UpdateInfo, 1> updates;
+  /// @brief Position in the update log of the first entry in `updates`.
+  uint64_t updates_begin;
+
+  /// @brief A Mux command-buffer executing the commands of the command-buffer.
+  ///
+  /// The first instance is `mux_command_buffer`. Enqueuing the command-buffer
+  /// while every instance is executing clones a new instance from it, which is
+  /// kept for reuse by later enqueues. Clones share their commands with
+  /// `mux_command_buffer` until they are updated, so only the arguments of
+  /// updated mutable-dispatch commands are copied per instance.
+  struct Instance final {
+    /// @brief Mux command-buffer of the instance.
+    mux_command_buffer_t mux_command_buffer;
+    /// @brief Position in the update log up to which updates are applied.
+    uint64_t applied_updates;
+    /// @brief Whether the instance has been enqueued and not yet completed.
+    bool in_flight;
+  };
+  /// @brief Maximum number of instances kept for reuse.
+  ///
+  /// Enqueues beyond this many simultaneous executions clone a transient
+  /// instance which the command queue destroys on completion.
+  static constexpr size_t max_instances = 8;
+  /// @brief Instances of the command-buffer, must be accessed with `mutex`
+  /// held.
+  cargo::small_vector<Instance, 2> instances;
 
   /// @brief Mutex to protect the state of the command-buffer.
   std::mutex mutex;
@@ -259,6 +286,33 @@ struct _cl_command_buffer_khr final : public cl::base<_cl_command_buffer_khr> {
   /// @return CL_SUCCESS or appropriate error if finalization failed.
   cl_int finalize();
 
+  /// @brief Get an instance which is not executing to enqueue.
+  ///
+  /// Idle instances are first brought up to date with the update log. If every
+  /// instance is executing a new instance is cloned from `mux_command_buffer`.
+  /// The instance is not considered executing until `beginInstance` is called.
+  /// The caller must hold `mutex` between the two calls.
+  ///
+  /// @param[out] transient Set to true if the instance is not kept by the
+  /// command-buffer and must be destroyed by the caller once complete.
+  ///
+  /// @return Returns the Mux command-buffer of the instance or an error if
+  /// cloning or updating the instance failed.
+  cargo::expected<mux_command_buffer_t, cl_int> acquireInstance(
+      bool &transient);
+
+  /// @brief Mark an instance returned by `acquireInstance` as executing.
+  ///
+  /// The caller must hold `mutex`.
+  ///
+  /// @param[in] instance Mux command-buffer of the enqueued instance.
+  void beginInstance(mux_command_buffer_t instance);
+
+  /// @brief Mark an instance as complete so it may be reused.
+  ///
+  /// @param[in] instance Mux command-buffer of the completed instance.
+  void endInstance(mux_command_buffer_t instance);
+
   /// @brief Destructor.
   ///
   /// Because there may be multiple references to the given command-buffer
@@ -22,6 +22,8 @@
 #include <cl/program.h>
 #include <extension/intel_unified_shared_memory.h>
 
+#include <algorithm>
+
 namespace extension {
 #ifdef OCL_EXTENSION_cl_intel_unified_shared_memory
 namespace usm {
@@ -174,7 +176,13 @@ cl_int createBlockingEventForKernel(cl_command_queue queue, cl_kernel kernel,
 }
 
 allocation_info::allocation_info(const cl_context context, const size_t size)
-    : context(context), size(size), base_ptr(nullptr), alloc_flags(0) {
+    : context(context),
+      size(size),
+      capacity(size),
+      alignment(0),
+      retains_context(true),
+      base_ptr(nullptr),
+      alloc_flags(0) {
   cl::retainInternal(context);
 }
 
@@ -183,7 +191,9 @@ allocation_info::~allocation_info() {
     cl::releaseInternal(event);
   }
 
-  cl::releaseInternal(context);
+  if (retains_context) {
+    cl::releaseInternal(context);
+  }
 }
 
 mux_result_t allocation_info::record_event(cl_event event) {
@@ -250,14 +260,32 @@ host_allocation_info::create(cl_context context,
     return cargo::make_unexpected(alloc_properties.error());
   }
 
+  // Only host allocations are cached in the host free list of the pool.
   auto usm_alloc = std::unique_ptr<host_allocation_info>(
-      new (std::nothrow) host_allocation_info(context, size));
-
-  OCL_CHECK(nullptr == usm_alloc,
-            return cargo::make_unexpected(CL_OUT_OF_HOST_MEMORY));
+      static_cast<host_allocation_info*>(
+          acquireCachedAllocation(context, nullptr, size, alignment)
+              .release()));
+
+  if (!usm_alloc) {
+    usm_alloc.reset(new (std::nothrow) host_allocation_info(context, size));
+
+    OCL_CHECK(nullptr == usm_alloc,
+              return cargo::make_unexpected(CL_OUT_OF_HOST_MEMORY));
+
+    // Round the allocation up to its pool size class so it can be reused by
+    // later requests once freed, unless that would exceed a device limit.
+    const size_t pooled_size = allocation_pool::getPooledSize(size);
+    if (pooled_size &&
+        std::all_of(context->devices.begin(), context->devices.end(),
+                    [pooled_size](cl_device_id device) {
+                      return pooled_size <= device->max_mem_alloc_size;
+                    })) {
+      usm_alloc->capacity = pooled_size;
+    }
 
-  cl_int error = usm_alloc->allocate(alignment);
-  OCL_CHECK(error != CL_SUCCESS, return cargo::make_unexpected(error));
+    cl_int error = usm_alloc->allocate(alignment);
+    OCL_CHECK(error != CL_SUCCESS, return cargo::make_unexpected(error));
+  }
 
   usm_alloc->alloc_flags = alloc_properties.value();
 
@@ -271,7 +299,8 @@ host_allocation_info::create(cl_context context,
 }
 
 cl_int host_allocation_info::allocate(cl_uint alignment) {
-  base_ptr = cargo::alloc(size, alignment);
+  this->alignment = alignment;
+  base_ptr = cargo::alloc(capacity, alignment);
   if (base_ptr == nullptr) {
     return CL_OUT_OF_HOST_MEMORY;
   }
@@ -294,13 +323,13 @@ cl_int host_allocation_info::allocate(cl_uint alignment) {
     }
 
     // Initialize the Mux objects needed by each device
-    if (muxCreateBuffer(device->mux_device, size, device->mux_allocator,
+    if (muxCreateBuffer(device->mux_device, capacity, device->mux_allocator,
                         &mux_buffers[index])) {
       return CL_OUT_OF_HOST_MEMORY;
     }
 
     mux_result_t mux_error =
-        muxCreateMemoryFromHost(device->mux_device, size, base_ptr,
+        muxCreateMemoryFromHost(device->mux_device, capacity, base_ptr,
                                 device->mux_allocator, &mux_memories[index]);
     if (mux_error) {
       return CL_OUT_OF_RESOURCES;
@@ -372,11 +401,29 @@ device_allocation_info::create(cl_context context, cl_device_id device,
     alignment = device_align;
   }
 
+  // Only allocations made on `device` are cached in its free lists.
   auto usm_alloc = std::unique_ptr<device_allocation_info>(
-      new (std::nothrow) device_allocation_info(context, device, size));
+      static_cast<device_allocation_info*>(
+          acquireCachedAllocation(context, device, size, alignment)
+              .release()));
+
+  if (!usm_alloc) {
+    usm_alloc.reset(new (std::nothrow)
+                        device_allocation_info(context, device, size));
+
+    OCL_CHECK(nullptr == usm_alloc,
+              return cargo::make_unexpected(CL_OUT_OF_HOST_MEMORY));
+
+    // Round the allocation up to its pool size class so it can be reused by
+    // later requests once freed, unless that would exceed the device limit.
+    const size_t pooled_size = allocation_pool::getPooledSize(size);
+    if (pooled_size && pooled_size <= device->max_mem_alloc_size) {
+      usm_alloc->capacity = pooled_size;
+    }
 
-  cl_int error = usm_alloc->allocate(alignment);
-  OCL_CHECK(error != CL_SUCCESS, return cargo::make_unexpected(error));
+    cl_int error = usm_alloc->allocate(alignment);
+    OCL_CHECK(error != CL_SUCCESS, return cargo::make_unexpected(error));
+  }
 
   usm_alloc->alloc_flags = alloc_properties.value();
 
@@ -390,18 +437,20 @@ device_allocation_info::create(cl_context context, cl_device_id device,
 }
 
 cl_int device_allocation_info::allocate(cl_uint alignment) {
+  this->alignment = alignment;
+
   // Allocation device local memory
   uint32_t heap = 1;
   mux_result_t mux_error = muxAllocateMemory(
-      device->mux_device, size, heap, mux_memory_property_device_local,
+      device->mux_device, capacity, heap, mux_memory_property_device_local,
       mux_allocation_type_alloc_device, alignment, device->mux_allocator,
       &mux_memory);
   if (mux_error) {
     return CL_OUT_OF_RESOURCES;
   }
 
-  mux_error = muxCreateBuffer(device->mux_device, size, device->mux_allocator,
-                              &mux_buffer);
+  mux_error = muxCreateBuffer(device->mux_device, capacity,
+                              device->mux_allocator, &mux_buffer);
   if (mux_error) {
     return CL_OUT_OF_RESOURCES;
   }
@@ -426,6 +475,50 @@ cl_int device_allocation_info::allocate(cl_uint alignment) {
 
   return CL_SUCCESS;
 }
+
+namespace {
+/// @brief Get the index of the free lists a device's allocations are cached
+/// in. Host allocations use the lists after those of the devices.
+size_t getPoolListIndex(cl_context context, cl_device_id device) {
+  return device ? context->getDeviceIndex(device) : context->devices.size();
+}
+}  // namespace
+
+std::unique_ptr<allocation_info> acquireCachedAllocation(cl_context context,
+                                                         cl_device_id device,
+                                                         size_t size,
+                                                         cl_uint alignment) {
+  auto cached = context->usm_pool.acquire(
+      getPoolListIndex(context, device), size,
+      [alignment](const allocation_info &allocation) {
+        return allocation.alignment % alignment == 0;
+      });
+  if (cached) {
+    cl::retainInternal(cached->context);
+    cached->retains_context = true;
+    cached->size = size;
+  }
+  return cached;
+}
+
+void releaseAllocation(std::unique_ptr<allocation_info> allocation) {
+  // The user has freed the allocation, so there is no longer any need to
+  // track the commands which used it.
+  for (auto event : allocation->queued_commands) {
+    cl::releaseInternal(event);
+  }
+  allocation->queued_commands.clear();
+
+  // Cached allocations don't keep the context alive. The reference can only
+  // be dropped once the pool is no longer being accessed, since it may be the
+  // last one and the context owns the pool.
+  const cl_context context = allocation->context;
+  allocation->retains_context = false;
+  const size_t list_index = getPoolListIndex(context, allocation->getDevice());
+  // Destroys the allocation if it could not be cached.
+  context->usm_pool.release(list_index, std::move(allocation)).reset();
+  cl::releaseInternal(context);
+}
 }  // namespace usm
 #endif  // OCL_EXTENSION_cl_intel_unified_shared_memory
 
@@ -302,23 +302,32 @@ cl_int clMemFreeINTEL(cl_context context, void *ptr) {
   OCL_CHECK(!context, return CL_INVALID_CONTEXT);
   OCL_CHECK(ptr == NULL, return CL_SUCCESS);
 
-  // Lock context to ensure usm allocation iterators are valid
-  std::lock_guard<std::mutex> context_guard(context->mutex);
+  std::unique_ptr<extension::usm::allocation_info> usm_alloc;
+  {
+    // Lock context to ensure usm allocation iterators are valid
+    std::lock_guard<std::mutex> context_guard(context->mutex);
 
-  auto isUsmPtr =
-      [ptr](const std::unique_ptr<extension::usm::allocation_info> &usm_alloc) {
-        return usm_alloc->base_ptr == ptr;
-      };
+    auto isUsmPtr =
+        [ptr](
+            const std::unique_ptr<extension::usm::allocation_info> &usm_alloc) {
+          return usm_alloc->base_ptr == ptr;
+        };
 
-  auto usm_alloc_iterator =
-      std::find_if(context->usm_allocations.begin(),
-                   context->usm_allocations.end(), isUsmPtr);
+    auto usm_alloc_iterator =
+        std::find_if(context->usm_allocations.begin(),
+                     context->usm_allocations.end(), isUsmPtr);
 
-  OCL_CHECK(context->usm_allocations.end() == usm_alloc_iterator,
-            return CL_INVALID_VALUE);
+    OCL_CHECK(context->usm_allocations.end() == usm_alloc_iterator,
+              return CL_INVALID_VALUE);
 
-  // Remove now empty shared pointer from list
-  context->usm_allocations.erase(usm_alloc_iterator);
+    // Remove now empty unique pointer from list
+    usm_alloc = std::move(*usm_alloc_iterator);
+    context->usm_allocations.erase(usm_alloc_iterator);
+  }
+
+  // Return the allocation to the pool outside of the context lock. Caching it
+  // may drop the last reference to the context.
+  extension::usm::releaseAllocation(std::move(usm_alloc));
   return CL_SUCCESS;
 }
 
@@ -330,7 +339,7 @@ cl_int clMemBlockingFreeINTEL(cl_context context, void *ptr) {
   OCL_CHECK(ptr == NULL, return CL_SUCCESS);
 
   // Lock context to ensure usm allocation iterators are valid
-  std::lock_guard<std::mutex> context_guard(context->mutex);
+  std::unique_lock<std::mutex> context_guard(context->mutex);
 
   auto isUsmPtr =
       [ptr](const std::unique_ptr<extension::usm::allocation_info> &usm_alloc) {
@@ -381,7 +390,13 @@ cl_int clMemBlockingFreeINTEL(cl_context context, void *ptr) {
   }
 
   // Remove now empty unique pointer from list
+  auto usm_alloc = std::move(*usm_alloc_iterator);
   context->usm_allocations.erase(usm_alloc_iterator);
+
+  // Return the allocation to the pool outside of the context lock. Caching it
+  // may drop the last reference to the context.
+  context_guard.unlock();
+  extension::usm::releaseAllocation(std::move(usm_alloc));
   return CL_SUCCESS;
 }
 
@@ -160,7 +160,8 @@ _cl_command_buffer_khr::_cl_command_buffer_khr(cl_command_queue queue)
       flags(0),
       is_finalized(false),
       command_queue(queue),
-      execution_refcount(0u) {
+      execution_refcount(0u),
+      updates_begin(0) {
   cl::retainInternal(command_queue);
 }
 
@@ -192,6 +193,15 @@ _cl_command_buffer_khr::~_cl_command_buffer_khr() {
     cl::releaseInternal(kernel);
   }
 
+  // Destroy any instances cloned from the underlying command buffer.
+  for (const Instance &instance : instances) {
+    if (instance.mux_command_buffer != mux_command_buffer) {
+      muxDestroyCommandBuffer(mux_command_buffer->device,
+                              instance.mux_command_buffer,
+                              command_queue->device->mux_allocator);
+    }
+  }
+
   // Destroy and release the underlying command buffer.
   muxDestroyCommandBuffer(mux_command_buffer->device, mux_command_buffer,
                           command_queue->device->mux_allocator);
@@ -295,10 +305,114 @@ cl_int _cl_command_buffer_khr::finalize() {
   if (muxFinalizeCommandBuffer(mux_command_buffer)) {
     return CL_INVALID_COMMAND_BUFFER_KHR;
   }
+  if (instances.push_back(Instance{mux_command_buffer, 0, false})) {
+    return CL_OUT_OF_HOST_MEMORY;
+  }
   is_finalized = true;
   return CL_SUCCESS;
 }
 
+namespace {
+/// @brief Apply the entries of an update log an instance has not yet seen.
+///
+/// @param[in] instance Mux command-buffer of the instance to update.
+/// @param[in] updates Entries of the update log which are still held.
+/// @param[in] updates_begin Position in the update log of `updates[0]`.
+/// @param[in,out] applied_updates Position in the update log the instance is
+/// up to date with, set to the end of the log on success.
+///
+/// @return CL_SUCCESS or appropriate error if an update failed.
+cl_int applyUpdates(
+    mux_command_buffer_t instance,
+    cargo::small_vector<_cl_command_buffer_khr::UpdateInfo, 1> &updates,
+    uint64_t updates_begin, uint64_t &applied_updates) {
+  const uint64_t updates_end = updates_begin + updates.size();
+  for (; applied_updates < updates_end; applied_updates++) {
+    auto &update = updates[applied_updates - updates_begin];
+    if (auto mux_error = muxUpdateDescriptors(
+            instance, update.id, update.indices.size(), update.indices.data(),
+            update.descriptors.data())) {
+      return cl::getErrorFrom(mux_error);
+    }
+  }
+  return CL_SUCCESS;
+}
+}  // namespace
+
+cargo::expected<mux_command_buffer_t, cl_int>
+_cl_command_buffer_khr::acquireInstance(bool &transient) {
+  transient = false;
+
+  // Bring every idle instance up to date so that entries of the update log
+  // are only held while an instance which hasn't seen them is executing.
+  Instance *idle = nullptr;
+  for (Instance &instance : instances) {
+    if (instance.in_flight) {
+      continue;
+    }
+    if (auto error = applyUpdates(instance.mux_command_buffer, updates,
+                                  updates_begin, instance.applied_updates)) {
+      return cargo::make_unexpected(error);
+    }
+    if (!idle) {
+      idle = &instance;
+    }
+  }
+
+  // Every instance is executing, clone a new instance which starts from the
+  // same point in the update log as the command-buffer it was cloned from.
+  Instance clone{nullptr, instances[0].applied_updates, false};
+  if (!idle) {
+    auto device = command_queue->device;
+    if (auto mux_error = muxCloneCommandBuffer(
+            device->mux_device, device->mux_allocator, mux_command_buffer,
+            &clone.mux_command_buffer)) {
+      return cargo::make_unexpected(cl::getErrorFrom(mux_error));
+    }
+    if (auto error = applyUpdates(clone.mux_command_buffer, updates,
+                                  updates_begin, clone.applied_updates)) {
+      muxDestroyCommandBuffer(device->mux_device, clone.mux_command_buffer,
+                              device->mux_allocator);
+      return cargo::make_unexpected(error);
+    }
+    if (instances.size() < max_instances &&
+        !instances.push_back(clone)) {
+      idle = &instances.back();
+    } else {
+      transient = true;
+    }
+  }
+
+  // Discard entries of the update log every instance has applied.
+  uint64_t oldest = updates_begin + updates.size();
+  for (const Instance &instance : instances) {
+    oldest = std::min(oldest, instance.applied_updates);
+  }
+  updates.erase(updates.begin(), updates.begin() + (oldest - updates_begin));
+  updates_begin = oldest;
+
+  return idle ? idle->mux_command_buffer : clone.mux_command_buffer;
+}
+
+void _cl_command_buffer_khr::beginInstance(mux_command_buffer_t instance) {
+  for (Instance &candidate : instances) {
+    if (candidate.mux_command_buffer == instance) {
+      candidate.in_flight = true;
+      return;
+    }
+  }
+}
+
+void _cl_command_buffer_khr::endInstance(mux_command_buffer_t instance) {
+  std::lock_guard<std::mutex> guard(mutex);
+  for (Instance &candidate : instances) {
+    if (candidate.mux_command_buffer == instance) {
+      candidate.in_flight = false;
+      return;
+    }
+  }
+}
+
 cl_int _cl_command_buffer_khr::retain(cl_kernel kernel) {
   if (cargo::success != kernels.push_back(kernel)) {
     return CL_OUT_OF_HOST_MEMORY;
@@ -865,8 +979,10 @@ cl_int _cl_command_buffer_khr::commandNDRangeKernel(
   mux_kernel_t mux_kernel;
 
   if (kernel->device_kernel_map[device]->supportsDeferredCompilation()) {
+    // Recorded commands can have their arguments updated, so the kernel must
+    // not have their current values folded in.
     auto result = kernel->device_kernel_map[device]->createSpecializedKernel(
-        mux_execution_options);
+        mux_execution_options, /* for_enqueue */ false);
     if (!result.has_value()) {
       if (printf_buffer) {
         muxDestroyBuffer(device->mux_device, printf_buffer,
@@ -316,7 +316,7 @@ cl_int PushExecuteKernel(
   mux_kernel_t kernel_to_execute = nullptr;
   if (kernel->device_kernel_map[device]->supportsDeferredCompilation()) {
     auto result = kernel->device_kernel_map[device]->createSpecializedKernel(
-        mux_execution_options);
+        mux_execution_options, /* for_enqueue */ true);
     if (!result.has_value()) {
       if (printf_buffer) {
         muxDestroyBuffer(mux_device, printf_buffer, mux_allocator);
@@ -460,13 +460,16 @@ uint32_t MuxKernelWrapper::getDynamicWorkWidth(size_t local_size_x,
 
 cargo::expected<MuxKernelWrapper::SpecializedKernel, compiler::Result>
 MuxKernelWrapper::createSpecializedKernel(
-    const mux_ndrange_options_t &specialization_options) {
+    const mux_ndrange_options_t &specialization_options, bool for_enqueue) {
   if (!deferred_kernel) {
     return cargo::make_unexpected(compiler::Result::FAILURE);
   }
 
   auto specialized_kernel =
-      deferred_kernel->createSpecializedKernel(specialization_options);
+      for_enqueue ? deferred_kernel->createSpecializedKernelForEnqueue(
+                        specialization_options)
+                  : deferred_kernel->createSpecializedKernel(
+                        specialization_options);
   if (!specialized_kernel.has_value()) {
     return cargo::make_unexpected(specialized_kernel.error());
   }
@@ -848,6 +851,10 @@ CL_API_ENTRY cl_kernel CL_API_CALL cl::CreateKernel(cl_program program,
   tracer::TraceGuard<tracer::OpenCL> guard("clCreateKernel");
   OCL_CHECK(!program, OCL_SET_IF_NOT_NULL(errcode_ret, CL_INVALID_PROGRAM);
             return nullptr);
+  // A program which is still being built has no executable yet.
+  OCL_CHECK(program->isBuildInProgress(),
+            OCL_SET_IF_NOT_NULL(errcode_ret, CL_INVALID_PROGRAM_EXECUTABLE);
+            return nullptr);
 
   for (auto device : program->context->devices) {
     // if we don't have an finalized executable
@@ -1124,6 +1131,9 @@ cl::CreateKernelsInProgram(cl_program program, cl_uint num_kernels,
                            cl_kernel *kernels, cl_uint *num_kernels_ret) {
   tracer::TraceGuard<tracer::OpenCL> guard("clCreateKernelsInProgram");
   OCL_CHECK(!program, return CL_INVALID_PROGRAM);
+  // A program which is still being built has no executable yet.
+  OCL_CHECK(program->isBuildInProgress(),
+            return CL_INVALID_PROGRAM_EXECUTABLE);
 
   for (auto device : program->context->devices) {
     OCL_CHECK(!program->programs[device].isExecutable(),
@@ -472,6 +472,9 @@ cl::SetProgramSpecializationConstant(cl_program program, cl_uint spec_id,
       "clSetProgramSpecializationConstant");
 
   OCL_CHECK(!program, return CL_INVALID_PROGRAM);
+  // Specialization constants are read by the build so must not change while
+  // one is in progress.
+  program->waitForBuild();
 
   // SPIR-V is optional in 3.0 so if we have no compiler we just disable
   // it. Note that if supporting the with SPIR-V but without compiler
@@ -133,6 +133,9 @@ cargo::expected<cl_platform_id, cl_int> _cl_platform_id::getInstance() {
     // when atexit handlers are invoked, the advice given by Microsoft is not
     // to perform any tear down at all.
     atexit([]() {
+      // Background builds use the devices and the compiler library. Finish
+      // them before either is torn down.
+      platform.value()->build_pool.shutdown();
       for (auto device : platform.value()->devices) {
         cl::releaseInternal(device);
       }
@@ -22,6 +22,7 @@
 #include <cl/device.h>
 #include <cl/macros.h>
 #include <cl/mux.h>
+#include <cl/platform.h>
 #include <cl/program.h>
 #include <cl/validate.h>
 #include <tracer/tracer.h>
@@ -83,13 +84,16 @@ cl::mux_kernel_cache::getOrCreateKernel(cl_device_id device,
     return cargo::make_unexpected(result);
   }
 
-  {
-    std::lock_guard<std::mutex> guard{kernel_map_mutex};
-    kernel_map.emplace(
-        name, mux::unique_ptr<mux_kernel_t>(
-                  kernel, {device->mux_device, device->mux_allocator}));
+  mux::unique_ptr<mux_kernel_t> kernel_ptr(
+      kernel, {device->mux_device, device->mux_allocator});
+  std::lock_guard<std::mutex> guard{kernel_map_mutex};
+  auto entry = kernel_map.try_emplace(name, std::move(kernel_ptr));
+  if (!entry) {
+    return cargo::make_unexpected(mux_error_out_of_memory);
   }
-  return kernel;
+  // Another thread may have created the same kernel while the lock was not
+  // held, in which case ours is destroyed and the cached kernel is returned.
+  return entry->first->second.get();
 }
 
 cl::device_program::device_program()
@@ -844,8 +848,9 @@ cl_int _cl_program::compile(
         // We need to clear the device program as we're starting a new
         // compilation.
         device_program.compiler_module.clear();
+        // Every kernel in the program may be created, so compile them all.
         auto result = module.compileSPIRV(spirv.code, *spirv_device_info,
-                                          spirv.getSpecInfo());
+                                          spirv.getSpecInfo(), {});
         if (!result) {
           error = result.error();
         }
@@ -907,6 +912,108 @@ bool _cl_program::finalize(cargo::array_view<const cl_device_id> devices) {
   return true;
 }
 
+cl_int _cl_program::buildAsync(
+    cargo::array_view<const cl_device_id> devices,
+    cargo::array_view<const compiler::InputHeader> input_headers,
+    bool finalize_program, cl::pfn_notify_program_t pfn_notify,
+    void *user_data) {
+  // The build outlives the calling entry point so it takes copies of the
+  // device list and the input headers.
+  std::vector<cl_device_id> build_devices(devices.begin(), devices.end());
+  std::vector<std::pair<std::string, std::string>> headers;
+  for (const auto &header : input_headers) {
+    headers.emplace_back(cargo::as<std::string>(header.name),
+                         cargo::as<std::string>(header.source));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(build_mutex);
+    if (build_in_progress) {
+      return CL_INVALID_OPERATION;
+    }
+    build_in_progress = true;
+  }
+
+  // Keep the program alive until the build has completed, even if the
+  // application releases it first.
+  cl::retainInternal(this);
+  auto error = context->devices[0]->platform->build_pool.enqueue(
+      [this, build_devices, headers, finalize_program, pfn_notify,
+       user_data]() {
+        // Once the application has released the program nothing can observe
+        // the result of the build, so skip any steps which haven't started.
+        const auto isCancelled = [this]() { return 0 == refCountExternal(); };
+        bool cancelled = isCancelled();
+        cl_int result = CL_SUCCESS;
+        if (!cancelled) {
+          cargo::small_vector<compiler::InputHeader, 8> header_views;
+          for (const auto &header : headers) {
+            compiler::InputHeader header_view;
+            header_view.name = header.first;
+            header_view.source = header.second;
+            if (header_views.push_back(header_view)) {
+              result = CL_OUT_OF_HOST_MEMORY;
+              break;
+            }
+          }
+          if (!result) {
+            result = compile(build_devices, header_views);
+          }
+          if (!result && finalize_program) {
+            cancelled = isCancelled();
+            if (!cancelled && !finalize(build_devices)) {
+              result = CL_BUILD_PROGRAM_FAILURE;
+            }
+          }
+        }
+
+        // Make sure a failed build is reported as `CL_BUILD_ERROR` even when
+        // the compiler didn't record an error of its own.
+        if (result || cancelled) {
+          for (auto device : build_devices) {
+            auto &device_program = programs[device];
+            if (cancelled) {
+              device_program.reportError(
+                  "Build cancelled because the program was released.");
+            } else if (0 == device_program.num_errors) {
+              device_program.num_errors++;
+            }
+          }
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(build_mutex);
+          build_in_progress = false;
+        }
+        build_completed.notify_all();
+
+        if (pfn_notify) {
+          pfn_notify(this, user_data);
+        }
+        cl::releaseInternal(this);
+      });
+  if (error) {
+    {
+      std::lock_guard<std::mutex> lock(build_mutex);
+      build_in_progress = false;
+    }
+    build_completed.notify_all();
+    cl::releaseInternal(this);
+    return error;
+  }
+  return CL_SUCCESS;
+}
+
+bool _cl_program::isBuildInProgress() {
+  std::lock_guard<std::mutex> lock(build_mutex);
+  return build_in_progress;
+}
+
+void _cl_program::waitForBuild() {
+  std::unique_lock<std::mutex> lock(build_mutex);
+  build_completed.wait(lock, [this]() { return !build_in_progress; });
+}
+
 cargo::optional<const cl::binary::KernelInfo *> _cl_program::getKernelInfo(
     cargo::string_view name) const {
   for (auto device : context->devices) {
@@ -1209,6 +1316,7 @@ CL_API_ENTRY cl_int CL_API_CALL cl::CompileProgram(
 
   OCL_CHECK(!program, return CL_INVALID_PROGRAM);
   OCL_CHECK(program->num_external_kernels > 0, return CL_INVALID_OPERATION);
+  OCL_CHECK(program->isBuildInProgress(), return CL_INVALID_OPERATION);
   OCL_CHECK(!device_list && (0 < num_devices), return CL_INVALID_VALUE);
   OCL_CHECK(device_list && (0 == num_devices), return CL_INVALID_VALUE);
 
@@ -1259,6 +1367,15 @@ CL_API_ENTRY cl_int CL_API_CALL cl::CompileProgram(
                                        compiler::Options::Mode::COMPILE)) {
     return error;
   }
+  if (pfn_notify) {
+    // Compile on a build thread which invokes the callback on completion.
+    if (auto error = program->buildAsync(devices, inputHeaders, false,
+                                         pfn_notify, user_data)) {
+      return error;
+    }
+    callback.pfn_notify = nullptr;
+    return CL_SUCCESS;
+  }
   if (auto error = program->compile(devices, inputHeaders)) {
     return error;
   }
@@ -1313,6 +1430,9 @@ CL_API_ENTRY cl_program CL_API_CALL cl::LinkProgram(
     OCL_CHECK(!input_programs[i],
               OCL_SET_IF_NOT_NULL(errcode_ret, CL_INVALID_PROGRAM);
               return nullptr);
+    OCL_CHECK(input_programs[i]->isBuildInProgress(),
+              OCL_SET_IF_NOT_NULL(errcode_ret, CL_INVALID_OPERATION);
+              return nullptr);
 
     for (cl_uint k = 0; k < num_devices; k++) {
       const auto &device_program = input_programs[i]->programs[device_list[k]];
@@ -1356,6 +1476,7 @@ CL_API_ENTRY cl_int CL_API_CALL cl::BuildProgram(
   _cl_program::callback callback(program, pfn_notify, user_data);
 
   OCL_CHECK(program->num_external_kernels > 0, return CL_INVALID_OPERATION);
+  OCL_CHECK(program->isBuildInProgress(), return CL_INVALID_OPERATION);
   OCL_CHECK(device_list && num_devices == 0, return CL_INVALID_VALUE);
   OCL_CHECK(!device_list && num_devices > 0, return CL_INVALID_VALUE);
   // A builtin program is not required to be built so return
@@ -1390,6 +1511,16 @@ CL_API_ENTRY cl_int CL_API_CALL cl::BuildProgram(
                                          compiler::Options::Mode::BUILD)) {
       return error;
     }
+    if (pfn_notify) {
+      // Compile and finalize on a build thread which invokes the callback on
+      // completion.
+      if (auto error =
+              program->buildAsync(devices, {}, true, pfn_notify, user_data)) {
+        return error;
+      }
+      callback.pfn_notify = nullptr;
+      return CL_SUCCESS;
+    }
     if (auto error = program->compile(devices, {})) {
       return error == CL_COMPILE_PROGRAM_FAILURE ? CL_BUILD_PROGRAM_FAILURE
                                                  : error;
@@ -1408,6 +1539,7 @@ CL_API_ENTRY cl_int CL_API_CALL cl::GetProgramInfo(
   tracer::TraceGuard<tracer::OpenCL> guard("clGetProgramInfo");
   OCL_CHECK(!program, return CL_INVALID_PROGRAM);
   OCL_CHECK(!param_value && !param_value_size_ret, return CL_INVALID_VALUE);
+  program->waitForBuild();
 
 #define PROGRAM_INFO_CASE(ENUM, VALUE)                                        \
   case ENUM: {                                                                \
@@ -1608,6 +1740,10 @@ CL_API_ENTRY cl_int CL_API_CALL cl::GetProgramBuildInfo(
   OCL_CHECK(!device_id, return CL_INVALID_DEVICE);
   OCL_CHECK(!program->context->hasDevice(device_id), return CL_INVALID_DEVICE);
   OCL_CHECK(!param_value && !param_value_size_ret, return CL_INVALID_VALUE);
+  // Only the build status can be queried while a build is in progress.
+  if (param_name != CL_PROGRAM_BUILD_STATUS) {
+    program->waitForBuild();
+  }
 
   switch (param_name) {
     case CL_PROGRAM_BUILD_STATUS:
@@ -1616,7 +1752,10 @@ CL_API_ENTRY cl_int CL_API_CALL cl::GetProgramBuildInfo(
         OCL_CHECK(param_value_size < sizeof(cl_build_status),
                   return CL_INVALID_VALUE);
 
-        if (program->programs[device_id].num_errors > 0) {
+        if (program->isBuildInProgress()) {
+          *reinterpret_cast<cl_build_status *>(param_value) =
+              CL_BUILD_IN_PROGRESS;
+        } else if (program->programs[device_id].num_errors > 0) {
           *reinterpret_cast<cl_build_status *>(param_value) = CL_BUILD_ERROR;
         } else {
           if (program->programs[device_id].type ==
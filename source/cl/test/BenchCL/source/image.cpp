@@ -0,0 +1,172 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <BenchCL/error.h>
+#include <BenchCL/environment.h>
+#include <CL/cl.h>
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+enum ImageFormat : int64_t { RGBA_UNORM_INT8, RGBA_FLOAT };
+enum SamplerKind : int64_t { SAMPLER_RUNTIME, SAMPLER_LITERAL };
+}  // namespace
+
+// Measures the throughput of read_imagef on a 2D image, for each combination
+// of image format, filter mode, and whether the sampler is a sampler literal
+// (whose value the compiler can specialize on) or a kernel argument.
+void ImageReadSampled2D(benchmark::State& state) {
+  const auto format = static_cast<ImageFormat>(state.range(0));
+  const cl_filter_mode filter_mode =
+      state.range(1) ? CL_FILTER_LINEAR : CL_FILTER_NEAREST;
+  const auto sampler_kind = static_cast<SamplerKind>(state.range(2));
+
+  auto device = benchcl::env::get()->device;
+
+  cl_bool image_support = CL_FALSE;
+  ASSERT_EQ_ERRCODE(CL_SUCCESS,
+                    clGetDeviceInfo(device, CL_DEVICE_IMAGE_SUPPORT,
+                                    sizeof(image_support), &image_support,
+                                    nullptr));
+  if (!image_support) {
+    state.SkipWithError("Device does not support images");
+    return;
+  }
+
+  const std::string sampler =
+      sampler_kind == SAMPLER_LITERAL
+          ? std::string("CLK_NORMALIZED_COORDS_TRUE | "
+                        "CLK_ADDRESS_CLAMP_TO_EDGE | ") +
+                (filter_mode == CL_FILTER_LINEAR ? "CLK_FILTER_LINEAR"
+                                                 : "CLK_FILTER_NEAREST")
+          : std::string("runtime_sampler");
+
+  const std::string source = R"CL(
+    kernel void sample(read_only image2d_t src, sampler_t runtime_sampler,
+                       global float4 *dst) {
+      const size_t x = get_global_id(0);
+      const size_t y = get_global_id(1);
+      const size_t width = get_global_size(0);
+      const float2 coord =
+          (float2)((x + 0.25f) / width, (y + 0.75f) / get_global_size(1));
+      dst[(y * width) + x] = read_imagef(src, )CL" +
+                             sampler + R"CL(, coord);
+    }
+  )CL";
+
+  auto status = CL_SUCCESS;
+
+  auto ctx = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &status);
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+  auto qu = clCreateCommandQueue(ctx, device, 0, &status);
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+  const char* str = source.c_str();
+  auto program = clCreateProgramWithSource(ctx, 1, &str, nullptr, &status);
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, clBuildProgram(program, 0, nullptr, nullptr,
+                                               nullptr, nullptr));
+
+  auto kernel = clCreateKernel(program, "sample", &status);
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+  constexpr size_t width = 1024;
+  constexpr size_t height = 1024;
+
+  const cl_image_format image_format = {
+      CL_RGBA, static_cast<cl_channel_type>(format == RGBA_FLOAT
+                                                ? CL_FLOAT
+                                                : CL_UNORM_INT8)};
+  const size_t pixel_size =
+      format == RGBA_FLOAT ? 4 * sizeof(cl_float) : 4 * sizeof(cl_uchar);
+
+  cl_image_desc image_desc = {};
+  image_desc.image_type = CL_MEM_OBJECT_IMAGE2D;
+  image_desc.image_width = width;
+  image_desc.image_height = height;
+
+  std::vector<cl_uchar> pixels(width * height * pixel_size);
+  if (format == RGBA_FLOAT) {
+    auto* channels = reinterpret_cast<cl_float*>(pixels.data());
+    for (size_t i = 0; i < width * height * 4; i++) {
+      channels[i] = static_cast<cl_float>(i % 251) / 250.0f;
+    }
+  } else {
+    for (size_t i = 0; i < pixels.size(); i++) {
+      pixels[i] = static_cast<cl_uchar>(i % 251);
+    }
+  }
+
+  auto image = clCreateImage(ctx, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                             &image_format, &image_desc, pixels.data(),
+                             &status);
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+  auto sampler_object = clCreateSampler(ctx, CL_TRUE, CL_ADDRESS_CLAMP_TO_EDGE,
+                                        filter_mode, &status);
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+  auto dst = clCreateBuffer(ctx, CL_MEM_WRITE_ONLY,
+                            width * height * sizeof(cl_float4), nullptr,
+                            &status);
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, status);
+
+  ASSERT_EQ_ERRCODE(CL_SUCCESS,
+                    clSetKernelArg(kernel, 0, sizeof(image), &image));
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, clSetKernelArg(kernel, 1,
+                                               sizeof(sampler_object),
+                                               &sampler_object));
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, clSetKernelArg(kernel, 2, sizeof(dst), &dst));
+
+  const size_t global_size[2] = {width, height};
+
+  // Run once outside of the timed loop so that the kernel is finalized.
+  ASSERT_EQ_ERRCODE(CL_SUCCESS,
+                    clEnqueueNDRangeKernel(qu, kernel, 2, nullptr, global_size,
+                                           nullptr, 0, nullptr, nullptr));
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, clFinish(qu));
+
+  for (auto _ : state) {
+    (void)_;
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clEnqueueNDRangeKernel(
+                                      qu, kernel, 2, nullptr, global_size,
+                                      nullptr, 0, nullptr, nullptr));
+    ASSERT_EQ_ERRCODE(CL_SUCCESS, clFinish(qu));
+  }
+
+  state.SetItemsProcessed(state.iterations() * width * height);
+
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseMemObject(dst));
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseSampler(sampler_object));
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseMemObject(image));
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseKernel(kernel));
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseProgram(program));
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseCommandQueue(qu));
+  ASSERT_EQ_ERRCODE(CL_SUCCESS, clReleaseContext(ctx));
+}
+// Args are {format, linear filter, sampler literal}.
+BENCHMARK(ImageReadSampled2D)
+    ->Args({RGBA_UNORM_INT8, 0, SAMPLER_RUNTIME})
+    ->Args({RGBA_UNORM_INT8, 0, SAMPLER_LITERAL})
+    ->Args({RGBA_UNORM_INT8, 1, SAMPLER_RUNTIME})
+    ->Args({RGBA_UNORM_INT8, 1, SAMPLER_LITERAL})
+    ->Args({RGBA_FLOAT, 0, SAMPLER_RUNTIME})
+    ->Args({RGBA_FLOAT, 0, SAMPLER_LITERAL})
+    ->Args({RGBA_FLOAT, 1, SAMPLER_RUNTIME})
+    ->Args({RGBA_FLOAT, 1, SAMPLER_LITERAL});
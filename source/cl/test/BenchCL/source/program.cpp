@@ -268,6 +268,58 @@ static void BuildSingleStringProgram(benchmark::State& state) {
   clReleaseProgram(program);
 }
 
+// Create and build a new tiny program every iteration, as applications which
+// compile a kernel per operation do. The kernel itself is trivial so this
+// measures the fixed per-build cost, e.g. loading the builtins PCH and linking
+// in builtins.
+template <InputType::Type TYPE>
+static void BuildTinyProgram(benchmark::State& state) {
+  CreateProgramData cpd;
+
+  std::vector<const char*> data(cpd.generate<TYPE>(1));
+
+  for (auto _ : state) {
+    cl_program program = clCreateProgramWithSource(
+        cpd.context, data.size(), data.data(), nullptr, nullptr);
+
+    clBuildProgram(program, 0, nullptr, nullptr, nullptr, nullptr);
+
+    clReleaseProgram(program);
+  }
+}
+
+// As BuildTinyProgram but also create a new context every iteration, so the
+// compiler target and its builtins module are set up for every build.
+template <InputType::Type TYPE>
+static void BuildTinyProgramNewContext(benchmark::State& state) {
+  CreateProgramData cpd;
+
+  std::vector<const char*> data(cpd.generate<TYPE>(1));
+
+  for (auto _ : state) {
+    cl_int status = CL_SUCCESS;
+    cl_context context =
+        clCreateContext(nullptr, 1, &cpd.device, nullptr, nullptr, &status);
+    if (CL_SUCCESS != status) {
+      state.SkipWithError("Failed to create context");
+      break;
+    }
+
+    cl_program program = clCreateProgramWithSource(
+        context, data.size(), data.data(), nullptr, nullptr);
+
+    clBuildProgram(program, 0, nullptr, nullptr, nullptr, nullptr);
+
+    clReleaseProgram(program);
+    clReleaseContext(context);
+  }
+}
+
+BENCHMARK_TEMPLATE(BuildTinyProgram, InputType::NOBUILTINS);
+BENCHMARK_TEMPLATE(BuildTinyProgram, InputType::MATHBUILTINS);
+BENCHMARK_TEMPLATE(BuildTinyProgramNewContext, InputType::NOBUILTINS);
+BENCHMARK_TEMPLATE(BuildTinyProgramNewContext, InputType::MATHBUILTINS);
+
 #define TEMPLATE_ARGS() Arg(1)->Arg(1024)->Arg(8192)
 
 #define TEMPLATE_FOREACH(type)                                           \
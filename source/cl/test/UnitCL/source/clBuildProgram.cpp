@@ -15,6 +15,8 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <atomic>
+#include <cstdio>
+#include <cstdlib>
 #include <thread>
 
 #include "Common.h"
@@ -140,7 +142,7 @@ TEST_F(clBuildProgramGoodTest, Callback) {
     int data;
     cl_event event;
     cl_program program;
-    cl_int status;
+    std::atomic<cl_int> status;
     bool programMatches;
   };
 
@@ -148,9 +150,12 @@ TEST_F(clBuildProgramGoodTest, Callback) {
     static void CL_CALLBACK callback(cl_program program, void *user_data) {
       UserData *const actualUserData = static_cast<UserData *>(user_data);
       actualUserData->data = 42;
+      actualUserData->programMatches = (actualUserData->program == program);
+      // The callback may be invoked from another thread so the event must be
+      // completed last. Otherwise the test could observe stale user data.
+      // The status is stored after that and the test waits for it separately.
       actualUserData->status =
           clSetUserEventStatus(actualUserData->event, CL_COMPLETE);
-      actualUserData->programMatches = (actualUserData->program == program);
     }
   };
 
@@ -173,11 +178,154 @@ TEST_F(clBuildProgramGoodTest, Callback) {
 
   ASSERT_EQ(42, userData.data);
 
+  // Completing the event wakes the test before the callback can store the
+  // status of the call that completed it.
+  while (userData.status == !CL_SUCCESS) {
+    std::this_thread::yield();
+  }
   ASSERT_SUCCESS(userData.status);
 
+  ASSERT_TRUE(userData.programMatches);
+
+  ASSERT_SUCCESS(clReleaseEvent(event));
+}
+
+TEST_F(clBuildProgramGoodTest, CallbackBuildStatus) {
+  if (!getDeviceCompilerAvailable()) {
+    GTEST_SKIP();
+  }
+  struct Helper {
+    static void CL_CALLBACK callback(cl_program, void *user_data) {
+      clSetUserEventStatus(static_cast<cl_event>(user_data), CL_COMPLETE);
+    }
+  };
+
+  cl_int errorcode = !CL_SUCCESS;
+  cl_event event = clCreateUserEvent(context, &errorcode);
+  EXPECT_TRUE(event);
+  ASSERT_SUCCESS(errorcode);
+
+  ASSERT_SUCCESS(
+      clBuildProgram(program, 0, nullptr, nullptr, Helper::callback, event));
+
+  // The build may or may not have completed by now.
+  cl_build_status status = CL_BUILD_NONE;
+  ASSERT_SUCCESS(clGetProgramBuildInfo(program, device,
+                                       CL_PROGRAM_BUILD_STATUS,
+                                       sizeof(status), &status, nullptr));
+  ASSERT_TRUE(CL_BUILD_IN_PROGRESS == status || CL_BUILD_SUCCESS == status);
+
+  ASSERT_SUCCESS(clWaitForEvents(1, &event));
+
+  ASSERT_SUCCESS(clGetProgramBuildInfo(program, device,
+                                       CL_PROGRAM_BUILD_STATUS,
+                                       sizeof(status), &status, nullptr));
+  ASSERT_EQ(CL_BUILD_SUCCESS, status);
+
+  cl_kernel kernel = clCreateKernel(program, "foo", &errorcode);
+  EXPECT_TRUE(kernel);
+  ASSERT_SUCCESS(errorcode);
+
+  ASSERT_SUCCESS(clReleaseKernel(kernel));
+  ASSERT_SUCCESS(clReleaseEvent(event));
+}
+
+TEST_F(clBuildProgramGoodTest, CallbackSecondBuild) {
+  if (!getDeviceCompilerAvailable()) {
+    GTEST_SKIP();
+  }
+  struct Helper {
+    static void CL_CALLBACK callback(cl_program, void *user_data) {
+      clSetUserEventStatus(static_cast<cl_event>(user_data), CL_COMPLETE);
+    }
+  };
+
+  cl_int errorcode = !CL_SUCCESS;
+  cl_event event = clCreateUserEvent(context, &errorcode);
+  EXPECT_TRUE(event);
+  ASSERT_SUCCESS(errorcode);
+
+  ASSERT_SUCCESS(
+      clBuildProgram(program, 0, nullptr, nullptr, Helper::callback, event));
+
+  // Building again is only invalid while the first build is in progress.
+  errorcode = clBuildProgram(program, 0, nullptr, nullptr, nullptr, nullptr);
+  ASSERT_TRUE(CL_INVALID_OPERATION == errorcode || CL_SUCCESS == errorcode);
+
+  ASSERT_SUCCESS(clWaitForEvents(1, &event));
+  ASSERT_SUCCESS(
+      clBuildProgram(program, 0, nullptr, nullptr, nullptr, nullptr));
+
   ASSERT_SUCCESS(clReleaseEvent(event));
 }
 
+TEST_F(clBuildProgramGoodTest, CallbackReleaseProgram) {
+  if (!getDeviceCompilerAvailable()) {
+    GTEST_SKIP();
+  }
+  struct Helper {
+    static void CL_CALLBACK callback(cl_program, void *user_data) {
+      clSetUserEventStatus(static_cast<cl_event>(user_data), CL_COMPLETE);
+    }
+  };
+
+  cl_int errorcode = !CL_SUCCESS;
+  cl_event event = clCreateUserEvent(context, &errorcode);
+  EXPECT_TRUE(event);
+  ASSERT_SUCCESS(errorcode);
+
+  ASSERT_SUCCESS(
+      clBuildProgram(program, 0, nullptr, nullptr, Helper::callback, event));
+
+  // Releasing the program cancels the build but the callback must still be
+  // invoked.
+  ASSERT_SUCCESS(clReleaseProgram(program));
+  program = nullptr;
+
+  ASSERT_SUCCESS(clWaitForEvents(1, &event));
+  ASSERT_SUCCESS(clReleaseEvent(event));
+}
+
+TEST_F(clBuildProgramGoodTest, CallbackExitWithBuildQueued) {
+  if (!getDeviceCompilerAvailable()) {
+    GTEST_SKIP();
+  }
+  if (UCL::isInterceptLayerPresent()) {
+    GTEST_SKIP();  // Injection creates programs from binaries, can't compile.
+  }
+  // Run the test body in a new process rather than a fork. Earlier tests may
+  // have started the build threads, which a forked child would not have.
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+  // Queue more builds than the pool has threads then exit without waiting.
+  // Tearing down the platform must complete every build, and invoke every
+  // callback, before the compiler library is unloaded.
+  static constexpr int numBuilds = 16;
+  EXPECT_EXIT(
+      {
+        struct Helper {
+          static void CL_CALLBACK callback(cl_program, void *) {
+            static std::atomic<int> notified{0};
+            if (++notified == numBuilds) {
+              std::fprintf(stderr, "all builds notified\n");
+            }
+          }
+        };
+        const char *source = "void kernel foo(global int *a) { *a = 42; }";
+        for (int i = 0; i < numBuilds; i++) {
+          cl_program queued_program =
+              clCreateProgramWithSource(context, 1, &source, nullptr, nullptr);
+          if (!queued_program ||
+              clBuildProgram(queued_program, 0, nullptr, nullptr,
+                             Helper::callback, nullptr)) {
+            std::exit(1);
+          }
+        }
+        std::exit(0);
+      },
+      ::testing::ExitedWithCode(0), "all builds notified");
+}
+
 TEST_F(clBuildProgramGoodTest, DefaultUseProgram) {
   if (!getDeviceCompilerAvailable()) {
     GTEST_SKIP();
@@ -120,7 +120,7 @@ TEST_F(clCompileProgramGoodTest, Callback) {
     int data;
     cl_event event;
     cl_program program;
-    cl_int status;
+    std::atomic<cl_int> status;
     bool programMatches;
   };
 
@@ -128,9 +128,12 @@ TEST_F(clCompileProgramGoodTest, Callback) {
     static void CL_CALLBACK callback(cl_program program, void *user_data) {
       UserData *const actualUserData = static_cast<UserData *>(user_data);
       actualUserData->data = 42;
+      actualUserData->programMatches = (actualUserData->program == program);
+      // The callback may be invoked from another thread so the event must be
+      // completed last. Otherwise the test could observe stale user data.
+      // The status is stored after that and the test waits for it separately.
       actualUserData->status =
           clSetUserEventStatus(actualUserData->event, CL_COMPLETE);
-      actualUserData->programMatches = (actualUserData->program == program);
     }
   };
 
@@ -153,8 +156,15 @@ TEST_F(clCompileProgramGoodTest, Callback) {
 
   ASSERT_EQ(42, userData.data);
 
+  // Completing the event wakes the test before the callback can store the
+  // status of the call that completed it.
+  while (userData.status == !CL_SUCCESS) {
+    std::this_thread::yield();
+  }
   ASSERT_SUCCESS(userData.status);
 
+  ASSERT_TRUE(userData.programMatches);
+
   ASSERT_SUCCESS(clReleaseEvent(event));
 }
 
@@ -125,6 +125,44 @@ TEST_F(clEnqueueCopyBufferToImageTest, Default) {
   }
 }
 
+TEST_F(clEnqueueCopyBufferToImageTest, Origin) {
+  size_t origin[3] = {0, 0, 0};
+  size_t region[3] = {IMAGE_WIDTH, IMAGE_HEIGHT, 1};
+  ASSERT_SUCCESS(clEnqueueCopyBufferToImage(command_queue, buffer, image, 0,
+                                            origin, region, 0, nullptr,
+                                            nullptr));
+
+  // Copy a sub-region from an offset into the buffer over the middle of the
+  // image; the copied pixels are tightly packed in the buffer.
+  const size_t offset = 7;
+  size_t subOrigin[3] = {3, 5, 0};
+  size_t subRegion[3] = {8, 4, 1};
+  ASSERT_SUCCESS(clEnqueueCopyBufferToImage(
+      command_queue, buffer, image, offset * sizeof(cl_float4), subOrigin,
+      subRegion, 0, nullptr, nullptr));
+
+  UCL::vector<cl_float4> result(BUFFER_ELEMENT_COUNT);
+  ASSERT_SUCCESS(clEnqueueReadImage(command_queue, image, CL_TRUE, origin,
+                                    region, 0, 0, result.data(), 0, nullptr,
+                                    nullptr));
+
+  for (size_t y = 0; y < IMAGE_HEIGHT; y++) {
+    for (size_t x = 0; x < IMAGE_WIDTH; x++) {
+      size_t expected = y * IMAGE_WIDTH + x;
+      if (x >= subOrigin[0] && x < subOrigin[0] + subRegion[0] &&
+          y >= subOrigin[1] && y < subOrigin[1] + subRegion[1]) {
+        expected = offset + (y - subOrigin[1]) * subRegion[0] +
+                   (x - subOrigin[0]);
+      }
+      const size_t index = y * IMAGE_WIDTH + x;
+      for (int element = 0; element < 4; element++) {
+        ASSERT_EQ(data[expected].s[element], result[index].s[element])
+            << "at (" << x << ", " << y << ")";
+      }
+    }
+  }
+}
+
 TEST_F(clEnqueueCopyBufferToImageTest, InvalidCommandQueue) {
   size_t origin[3] = {0, 0, 0};
   size_t region[3] = {IMAGE_WIDTH, IMAGE_HEIGHT, 1};
@@ -14,6 +14,9 @@
 //
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <chrono>
+#include <thread>
+
 #include "Common.h"
 
 class clWaitForEventsTest : public ucl::CommandQueueTest {
@@ -107,4 +110,47 @@ TEST_F(clWaitForEventsTest, DependentEventFailed) {
   ASSERT_SUCCESS(clReleaseEvent(userEvent));
 }
 
+TEST_F(clWaitForEventsTest, UserEventSetOnAnotherThread) {
+  cl_int errorcode = !CL_SUCCESS;
+  cl_event userEvent = clCreateUserEvent(context, &errorcode);
+  EXPECT_TRUE(userEvent);
+  ASSERT_SUCCESS(errorcode);
+
+  // Give the waiting thread a chance to go to sleep before completing the
+  // event.
+  std::thread signaller([userEvent]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_SUCCESS(clSetUserEventStatus(userEvent, CL_COMPLETE));
+  });
+
+  EXPECT_SUCCESS(clWaitForEvents(1, &userEvent));
+  signaller.join();
+
+  ASSERT_SUCCESS(clReleaseEvent(userEvent));
+}
+
+TEST_F(clWaitForEventsTest, RecycledUserEvents) {
+  // Released events have their storage recycled by the context, check that
+  // each new event starts out in a fresh state.
+  for (int i = 0; i < 256; i++) {
+    cl_int errorcode = !CL_SUCCESS;
+    cl_event userEvent = clCreateUserEvent(context, &errorcode);
+    EXPECT_TRUE(userEvent);
+    ASSERT_SUCCESS(errorcode);
+
+    cl_int status = 0;
+    ASSERT_SUCCESS(clGetEventInfo(userEvent, CL_EVENT_COMMAND_EXECUTION_STATUS,
+                                  sizeof(status), &status, nullptr));
+    ASSERT_EQ(CL_SUBMITTED, status);
+    cl_uint refCount = 0;
+    ASSERT_SUCCESS(clGetEventInfo(userEvent, CL_EVENT_REFERENCE_COUNT,
+                                  sizeof(refCount), &refCount, nullptr));
+    ASSERT_EQ(1u, refCount);
+
+    ASSERT_SUCCESS(clSetUserEventStatus(userEvent, CL_COMPLETE));
+    ASSERT_SUCCESS(clWaitForEvents(1, &userEvent));
+    ASSERT_SUCCESS(clReleaseEvent(userEvent));
+  }
+}
+
 // Redmine #5147: test contexts are the same
@@ -16,6 +16,7 @@
 
 #include <Common.h>
 
+#include <atomic>
 #include <thread>
 
 #include "cl_intel_unified_shared_memory.h"
@@ -89,6 +90,65 @@ TEST_F(USMTests, MemFree_ValidUsage) {
   EXPECT_SUCCESS(err);
 }
 
+// Freed allocations are cached by the context, so an allocation in the same
+// size class is expected to reuse the memory while still reporting the size
+// which was requested.
+TEST_F(USMTests, MemFree_ReuseAllocation) {
+  const cl_uint align = 4;
+
+  cl_int err;
+  void *device_ptr =
+      clDeviceMemAllocINTEL(context, device, nullptr, 100, align, &err);
+  ASSERT_SUCCESS(err);
+  ASSERT_TRUE(device_ptr != nullptr);
+  ASSERT_SUCCESS(clMemFreeINTEL(context, device_ptr));
+
+  void *reused_ptr =
+      clDeviceMemAllocINTEL(context, device, nullptr, 128, align, &err);
+  ASSERT_SUCCESS(err);
+  EXPECT_EQ(device_ptr, reused_ptr);
+
+  size_t alloc_size = 0;
+  ASSERT_SUCCESS(clGetMemAllocInfoINTEL(context, reused_ptr,
+                                        CL_MEM_ALLOC_SIZE_INTEL,
+                                        sizeof(alloc_size), &alloc_size,
+                                        nullptr));
+  EXPECT_EQ(128, alloc_size);
+
+  ASSERT_SUCCESS(clMemBlockingFreeINTEL(context, reused_ptr));
+}
+
+namespace {
+void CL_CALLBACK setDestroyed(cl_context, void *user_data) {
+  static_cast<std::atomic<bool> *>(user_data)->store(true);
+}
+}  // namespace
+
+// Allocations cached after being freed must not keep their context alive.
+TEST_F(USMTests, MemFree_CachedAllocationReleasesContext) {
+  if (!UCL::isDeviceVersionAtLeast({3, 0})) {
+    GTEST_SKIP();
+  }
+
+  cl_int err;
+  cl_context other_context =
+      clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+  ASSERT_SUCCESS(err);
+
+  std::atomic<bool> destroyed{false};
+  ASSERT_SUCCESS(
+      clSetContextDestructorCallback(other_context, setDestroyed, &destroyed));
+
+  void *device_ptr = clDeviceMemAllocINTEL(other_context, device, nullptr,
+                                           256, sizeof(cl_uint), &err);
+  ASSERT_SUCCESS(err);
+  ASSERT_TRUE(device_ptr != nullptr);
+
+  ASSERT_SUCCESS(clMemFreeINTEL(other_context, device_ptr));
+  ASSERT_SUCCESS(clReleaseContext(other_context));
+  EXPECT_TRUE(destroyed);
+}
+
 namespace {
 // Fixture to help testing of clMemBlockingFreeINTEL
 struct USMBlockingFreeTest : public cl_intel_unified_shared_memory_Test {
@@ -819,6 +819,107 @@ TEST_F(CommandBufferMutableBufferArgTest, CheckUpdatePersists) {
   EXPECT_SUCCESS(clReleaseMemObject(updated_dst_buffer));
 }
 
+// Checks that an update made while a simultaneous-use command-buffer is
+// executing is seen by every later enqueue, whichever instance of the
+// command-buffer executes it.
+TEST_F(CommandBufferMutableBufferArgTest, SimultaneousUseUpdatePersists) {
+  if (!(capabilities & CL_COMMAND_BUFFER_CAPABILITY_SIMULTANEOUS_USE_KHR)) {
+    GTEST_SKIP();
+  }
+
+  // Replace the command-buffer with one supporting simultaneous use.
+  EXPECT_SUCCESS(clReleaseCommandBufferKHR(command_buffer));
+  cl_command_buffer_properties_khr properties[3] = {
+      CL_COMMAND_BUFFER_FLAGS_KHR,
+      CL_COMMAND_BUFFER_MUTABLE_KHR | CL_COMMAND_BUFFER_SIMULTANEOUS_USE_KHR,
+      0};
+  cl_int error = CL_SUCCESS;
+  command_buffer =
+      clCreateCommandBufferKHR(1, &command_queue, properties, &error);
+  ASSERT_SUCCESS(error);
+
+  cl_ndrange_kernel_command_properties_khr mutable_properties[3] = {
+      CL_MUTABLE_DISPATCH_UPDATABLE_FIELDS_KHR,
+      CL_MUTABLE_DISPATCH_ARGUMENTS_KHR, 0};
+  EXPECT_SUCCESS(clCommandNDRangeKernelKHR(
+      command_buffer, nullptr, mutable_properties, parallel_copy_kernel, 1,
+      nullptr, &global_size, nullptr, 0, nullptr, nullptr, &command_handle));
+  EXPECT_SUCCESS(clFinalizeCommandBufferKHR(command_buffer));
+
+  cl_mem updated_dst_buffer = clCreateBuffer(
+      context, CL_MEM_READ_WRITE, data_size_in_bytes, nullptr, &error);
+  EXPECT_SUCCESS(error);
+
+  // Hold the first enqueue with a user event so the second enqueue happens
+  // while the command-buffer is executing.
+  cl_event user_event = clCreateUserEvent(context, &error);
+  EXPECT_SUCCESS(error);
+  EXPECT_SUCCESS(clEnqueueCommandBufferKHR(0, nullptr, command_buffer, 1,
+                                           &user_event, nullptr));
+
+  cl_mutable_dispatch_arg_khr arg{1, sizeof(cl_mem), &updated_dst_buffer};
+  cl_mutable_dispatch_config_khr dispatch_config{
+      CL_STRUCTURE_TYPE_MUTABLE_DISPATCH_CONFIG_KHR,
+      nullptr,
+      command_handle,
+      1,
+      0,
+      0,
+      0,
+      &arg,
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr};
+  cl_mutable_base_config_khr mutable_config{
+      CL_STRUCTURE_TYPE_MUTABLE_BASE_CONFIG_KHR, nullptr, 1, &dispatch_config};
+  EXPECT_SUCCESS(clUpdateMutableCommandsKHR(command_buffer, &mutable_config));
+  EXPECT_SUCCESS(clEnqueueCommandBufferKHR(0, nullptr, command_buffer, 0,
+                                           nullptr, nullptr));
+
+  EXPECT_SUCCESS(clSetUserEventStatus(user_event, CL_COMPLETE));
+  EXPECT_SUCCESS(clFinish(command_queue));
+
+  // The first enqueue was made before the update.
+  EXPECT_SUCCESS(clEnqueueReadBuffer(command_queue, dst_buffer, CL_TRUE, 0,
+                                     data_size_in_bytes, output_data.data(), 0,
+                                     nullptr, nullptr));
+  EXPECT_EQ(input_data, output_data);
+
+  // Enqueue twice more while the first of the two enqueues is held by a
+  // user event. This keeps the first instance executing, so the second
+  // enqueue runs the instance cloned from it. The update must be seen by
+  // both instances. The output is zeroed before each enqueue and read back
+  // after it so the results of the two instances can be told apart.
+  cl_event second_user_event = clCreateUserEvent(context, &error);
+  EXPECT_SUCCESS(error);
+  std::vector<std::vector<cl_int>> updated_output_data(
+      2, std::vector<cl_int>(global_size));
+  for (unsigned i = 0; i < 2; i++) {
+    constexpr cl_int zero = 0x0;
+    EXPECT_SUCCESS(clEnqueueFillBuffer(command_queue, updated_dst_buffer,
+                                       &zero, sizeof(cl_int), 0,
+                                       data_size_in_bytes, 0, nullptr,
+                                       nullptr));
+    EXPECT_SUCCESS(clEnqueueCommandBufferKHR(
+        0, nullptr, command_buffer, i == 0 ? 1 : 0,
+        i == 0 ? &second_user_event : nullptr, nullptr));
+    EXPECT_SUCCESS(clEnqueueReadBuffer(
+        command_queue, updated_dst_buffer, CL_FALSE, 0, data_size_in_bytes,
+        updated_output_data[i].data(), 0, nullptr, nullptr));
+  }
+  EXPECT_SUCCESS(clSetUserEventStatus(second_user_event, CL_COMPLETE));
+  EXPECT_SUCCESS(clFinish(command_queue));
+  EXPECT_EQ(input_data, updated_output_data[0]);
+  EXPECT_EQ(input_data, updated_output_data[1]);
+
+  // Cleanup.
+  EXPECT_SUCCESS(clReleaseEvent(second_user_event));
+  EXPECT_SUCCESS(clReleaseEvent(user_event));
+  EXPECT_SUCCESS(clReleaseMemObject(updated_dst_buffer));
+}
+
 TEST_F(CommandBufferMutableBufferArgTest, FillThenNDRange) {
   // Create a new buffer to fill.
   cl_int error = CL_SUCCESS;
@@ -656,7 +656,7 @@ result driver::buildProgram() {
       auto spv_device_info = cl::binary::getSPIRVDeviceInfo(
           compiler_info->device_info, device_profile);
       auto result = module->compileSPIRV(source_as_spirv, *spv_device_info,
-                                         cargo::nullopt);
+                                         cargo::nullopt, {});
       if (!result) {
         errcode = result.error();
       }
@@ -0,0 +1,181 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+
+/// @file
+///
+/// @brief BenchUR, micro-benchmarks of kernel launch rate through the unified
+/// runtime.
+
+#include <benchmark/benchmark.h>
+#include <ur_api.h>
+#include <uur/kernels.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+using uur::fill_42_source;
+
+/// @brief Objects shared by all benchmarks.
+struct Environment {
+  ur_device_handle_t device = nullptr;
+  ur_context_handle_t context = nullptr;
+  ur_queue_handle_t queue = nullptr;
+  ur_program_handle_t program = nullptr;
+  ur_kernel_handle_t kernel = nullptr;
+  ur_mem_handle_t buffers[2] = {nullptr, nullptr};
+
+  /// @brief Number of work-items in each launch.
+  static constexpr size_t count = 64;
+
+  bool init() {
+    uint32_t num_platforms = 0;
+    ur_platform_handle_t platform = nullptr;
+    if (urInit(0) || urPlatformGet(1, &platform, &num_platforms) ||
+        num_platforms == 0) {
+      std::fprintf(stderr, "error: no unified runtime platform found\n");
+      return false;
+    }
+    uint32_t num_devices = 0;
+    if (urDeviceGet(platform, UR_DEVICE_TYPE_ALL, 1, &device, &num_devices) ||
+        num_devices == 0) {
+      std::fprintf(stderr, "error: no unified runtime device found\n");
+      return false;
+    }
+    if (urContextCreate(1, &device, nullptr, &context) ||
+        urQueueCreate(context, device, nullptr, &queue) ||
+        urProgramCreateWithIL(context, fill_42_source, sizeof(fill_42_source),
+                              nullptr, &program) ||
+        urProgramBuild(context, program, nullptr) ||
+        urKernelCreate(program, "foo", &kernel)) {
+      std::fprintf(stderr, "error: unable to create benchmark kernel\n");
+      return false;
+    }
+    for (auto &buffer : buffers) {
+      if (urMemBufferCreate(context, UR_MEM_FLAG_READ_WRITE,
+                            sizeof(uint32_t) * count, nullptr, &buffer)) {
+        std::fprintf(stderr, "error: unable to create benchmark buffer\n");
+        return false;
+      }
+    }
+    return true;
+  }
+
+  ~Environment() {
+    for (auto buffer : buffers) {
+      if (buffer) {
+        urMemRelease(buffer);
+      }
+    }
+    if (kernel) {
+      urKernelRelease(kernel);
+    }
+    if (program) {
+      urProgramRelease(program);
+    }
+    if (queue) {
+      urQueueRelease(queue);
+    }
+    if (context) {
+      urContextRelease(context);
+    }
+  }
+};
+
+Environment *environment = nullptr;
+
+/// @brief Benchmark arguments for the number of launches between each wait on
+/// the queue.
+void launchArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->Arg(1)->Arg(64)->Arg(1024);
+}
+
+/// @brief Enqueue `state.range(0)` launches of a small kernel then wait for
+/// the queue to finish.
+///
+/// @param with_event Request an event for every launch, the event is released
+/// immediately.
+/// @param set_arg Set the kernel's argument before every launch, alternating
+/// between two buffers.
+void launch(benchmark::State &state, bool with_event, bool set_arg) {
+  const size_t offsets[]{0, 0, 0};
+  const size_t global_size[]{Environment::count};
+  const size_t local_size[]{1};
+  if (urKernelSetArgMemObj(environment->kernel, 0, environment->buffers[0])) {
+    state.SkipWithError("urKernelSetArgMemObj failed");
+    return;
+  }
+
+  for (auto _ : state) {
+    (void)_;
+    for (int64_t i = 0; i < state.range(0); i++) {
+      if (set_arg && urKernelSetArgMemObj(environment->kernel, 0,
+                                          environment->buffers[i & 1])) {
+        state.SkipWithError("urKernelSetArgMemObj failed");
+        return;
+      }
+      ur_event_handle_t event = nullptr;
+      if (urEnqueueKernelLaunch(environment->queue, environment->kernel, 1,
+                                offsets, global_size, local_size, 0, nullptr,
+                                with_event ? &event : nullptr)) {
+        state.SkipWithError("urEnqueueKernelLaunch failed");
+        return;
+      }
+      if (event) {
+        urEventRelease(event);
+      }
+    }
+    if (urQueueFinish(environment->queue)) {
+      state.SkipWithError("urQueueFinish failed");
+      return;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void KernelLaunch(benchmark::State &state) { launch(state, false, false); }
+BENCHMARK(KernelLaunch)->Apply(launchArguments);
+
+void KernelLaunchWithEvent(benchmark::State &state) {
+  launch(state, true, false);
+}
+BENCHMARK(KernelLaunchWithEvent)->Apply(launchArguments);
+
+void KernelLaunchSetArg(benchmark::State &state) {
+  launch(state, false, true);
+}
+BENCHMARK(KernelLaunchSetArg)->Apply(launchArguments);
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  benchmark::Initialize(&argc, argv);
+  int result = -1;
+  {
+    Environment env;
+    if (env.init()) {
+      environment = &env;
+      benchmark::RunSpecifiedBenchmarks();
+      environment = nullptr;
+      result = 0;
+    }
+  }
+  ur_tear_down_params_t tear_down_params{};
+  urTearDown(&tear_down_params);
+  return result;
+}
@@ -48,10 +48,12 @@ struct allocation_info {
       : context(context),
         flags(USMFlag),
         size(size),
+        capacity(size),
         align(alignment),
         base_ptr(nullptr) {
     if (context) {
       (void)ur::retain(context);
+      retains_context = true;
     }
   }
 
@@ -71,20 +73,34 @@ struct allocation_info {
   virtual mux_buffer_t getMuxBufferForDevice(
       ur_device_handle_t query_device) const = 0;
 
+  /// @brief Pure virtual function which returns the device associated with the
+  /// allocation, or nullptr for host allocations.
+  virtual ur_device_handle_t getDevice() const = 0;
+
   /// @brief Context associated with allocation
   ur_context_handle_t context{nullptr};
   /// @brief Flags guiding allocation
   ur_usm_mem_flags_t flags;
   /// @brief Size in bytes of the requested device allocation.
   size_t size;
+  /// @brief Size in bytes of the memory backing the allocation. This may be
+  /// larger than `size` when the allocation is made by a USM pool.
+  size_t capacity;
   /// @brief Alignment requirements for the allocation
   uint32_t align;
   /// @brief Pointer returned by USM allocation entry points
   void *base_ptr{nullptr};
+  /// @brief USM pool which made the allocation and which it is returned to
+  /// when freed.
+  ur_usm_pool_handle_t pool{nullptr};
+  /// @brief Whether the allocation holds a reference to `context`, this is
+  /// dropped while the allocation is cached in a USM pool so that cached
+  /// memory does not keep the context alive.
+  bool retains_context{false};
 
   /// @brief Destructor.
   virtual ~allocation_info() {
-    if (context) {
+    if (retains_context) {
       (void)ur::release(context);
     }
   }
@@ -119,6 +135,11 @@ struct host_allocation_info final : public allocation_info {
   mux_buffer_t getMuxBufferForDevice(
       ur_device_handle_t query_device) const override;
 
+  /// @brief Host allocations are not associated with a device.
+  ///
+  /// @return nullptr
+  ur_device_handle_t getDevice() const override { return nullptr; }
+
   /// @brief Destructor.
   ~host_allocation_info();
 
@@ -160,6 +181,11 @@ struct device_allocation_info final : public allocation_info {
     return query_device == device ? mux_buffer : nullptr;
   };
 
+  /// @brief Function which returns the device the memory was allocated on.
+  ///
+  /// @return UR device associated with the allocation.
+  ur_device_handle_t getDevice() const override { return device; }
+
   /// @brief Destructor.
   ~device_allocation_info();
 
@@ -181,6 +207,7 @@ struct ur_context_handle_t_ : ur::base {
   ur_context_handle_t_(ur_platform_handle_t platform) : platform{platform} {}
   ur_context_handle_t_(const ur_context_handle_t_ &) = delete;
   ur_context_handle_t_ &operator=(const ur_context_handle_t_ &) = delete;
+  ~ur_context_handle_t_();
 
   /// @brief Factory method for creating contexts.
   ///
@@ -212,6 +239,8 @@ struct ur_context_handle_t_ : ur::base {
   cargo::small_vector<ur_device_handle_t, 4> devices;
   /// @brief List of allocations made through the USM extension entry points.
   cargo::small_vector<std::unique_ptr<ur::allocation_info>, 1> usm_allocations;
+  /// @brief Default pool used by USM allocations which don't specify one.
+  ur_usm_pool_handle_t usm_pool = nullptr;
   /// @brief Mutex to lock when pushing to queued_commands
   std::mutex mutex;
 };
@@ -21,6 +21,8 @@
 #ifndef UR_KERNEL_H_INCLUDED
 #define UR_KERNEL_H_INCLUDED
 
+#include <cstdint>
+#include <mutex>
 #include <unordered_map>
 
 #include "cargo/expected.h"
@@ -61,10 +63,15 @@ struct kernel_data_t {
 struct ur_kernel_handle_t_ : ur::base {
   struct argument_data_t {
     struct {
-      char *data;
-      size_t size;
+      char *data = nullptr;
+      size_t size = 0;
     } value;
-    ur_mem_handle_t mem_handle;
+    ur_mem_handle_t mem_handle = nullptr;
+    /// @brief The kind of the argument, cached from the kernel's metadata.
+    compiler::ArgumentKind kind = compiler::ArgumentKind::UNKNOWN;
+    /// @brief Set when the argument has changed since `descriptors` were last
+    /// packed.
+    bool dirty = true;
   };
 
   /// @brief Constructor to construct kernel.
@@ -96,6 +103,29 @@ struct ur_kernel_handle_t_ : ur::base {
   /// @brief Device specific kernel map, one for each device in the context
   /// increasing in the order of the devices in the context.
   std::unordered_map<ur_device_handle_t, mux_kernel_t> device_kernel_map;
+
+  /// @brief Update `descriptors` to reflect the current arguments.
+  ///
+  /// Only arguments which have changed since the last call are re-packed,
+  /// unless the descriptors were last packed for a different device in which
+  /// case all buffer arguments are.
+  ///
+  /// @note This member function is not thread-safe, callers **must** hold a
+  /// lock on `mutex` when calling it.
+  ///
+  /// @param[in] device_idx Index of the device in the context the kernel is
+  /// being launched on.
+  void packDescriptors(uint32_t device_idx);
+
+  /// @brief Mux descriptors for the arguments, reused between launches.
+  cargo::dynamic_array<mux_descriptor_info_t> descriptors;
+  /// @brief Index of the device `descriptors` were last packed for.
+  uint32_t descriptors_device_idx = UINT32_MAX;
+  /// @brief Set when any argument has changed since `descriptors` were last
+  /// packed, so launches with unchanged arguments can skip scanning them.
+  bool descriptors_dirty = true;
+  /// @brief Mutex to lock when setting arguments or launching the kernel.
+  std::mutex mutex;
 };
 
 #endif  // UR_KERNEL_H_INCLUDED
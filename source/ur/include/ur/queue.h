@@ -25,6 +25,7 @@
 #include <mutex>
 
 #include "cargo/expected.h"
+#include "cargo/optional.h"
 #include "cargo/ring_buffer.h"
 #include "cargo/small_vector.h"
 #include "mux/mux.hpp"
@@ -115,6 +116,22 @@ struct ur_queue_handle_t_ : ur::base {
                    uint32_t num_wait_events,
                    const ur_event_handle_t *wait_events);
 
+  /// @brief Get the command buffer of the last pending dispatch, if further
+  /// commands may be appended to it.
+  ///
+  /// Commands which don't wait on any events and don't return an event to the
+  /// caller can be recorded into the last pending dispatch rather than creating
+  /// an event and command buffer of their own. This is only possible while the
+  /// dispatch's signal event is referenced solely by this queue, otherwise the
+  /// appended command would delay an event the application is observing.
+  ///
+  /// @note This member function is not thread-safe, callers **must** hold a
+  /// lock on `mutex` when calling it.
+  ///
+  /// @return Returns the command buffer, or `cargo::nullopt` if there is no
+  /// pending dispatch which can be appended to.
+  cargo::optional<mux_command_buffer_t> getPendingCommandBuffer();
+
   /// @brief Resets the given mux command buffer and then returns it to the
   /// cache if there's room, or destroys it if there isn't.
   void destroyCommandBuffer(mux_command_buffer_t command_buffer);
@@ -0,0 +1,100 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+/// @file
+///
+/// @brief Caching allocator backing the USM allocation entry points.
+
+#ifndef UR_USM_POOL_H_INCLUDED
+#define UR_USM_POOL_H_INCLUDED
+
+#include <memory>
+
+#include "cargo/expected.h"
+#include "mux/utils/allocation_pool.h"
+#include "ur/base.h"
+#include "ur/context.h"
+
+/// @brief Compute Mux specific implementation of the opaque
+/// ur_usm_pool_handle_t_ API object.
+///
+/// Freed USM allocations are returned to the pool rather than torn down, and
+/// are handed back out by later allocations of the same size class, device
+/// and flags. This avoids going through `muxAllocateMemory`,
+/// `muxCreateBuffer` and `muxBindBufferMemory` every time an application
+/// allocates and frees a temporary. The caching itself is implemented by
+/// `mux::allocation_pool`, see its documentation for the size classes and
+/// retention limit.
+struct ur_usm_pool_handle_t_ : ur::base {
+  /// @brief Constructor, use the `create()` factory instead.
+  ///
+  /// @param[in] context Context the pool allocates from.
+  ur_usm_pool_handle_t_(ur_context_handle_t context) : context{context} {}
+  ur_usm_pool_handle_t_(const ur_usm_pool_handle_t_ &) = delete;
+  ur_usm_pool_handle_t_ &operator=(const ur_usm_pool_handle_t_ &) = delete;
+
+  /// @brief Factory method for creating USM pools.
+  ///
+  /// The pool does not retain the context. The context owns its default pool
+  /// and cached allocations must not keep the context alive.
+  ///
+  /// @param[in] context Context the pool allocates from.
+  ///
+  /// @return A pool object or an error code if something went wrong.
+  static cargo::expected<ur_usm_pool_handle_t, ur_result_t> create(
+      ur_context_handle_t context);
+
+  /// @brief Allocate USM memory, reusing a cached allocation if possible.
+  ///
+  /// @param[in] device Device to allocate on, or nullptr for a host
+  /// allocation.
+  /// @param[in] flags Flags to guide allocation behavior.
+  /// @param[in] size Bytes to allocate.
+  /// @param[in] align Minimum alignment of allocation, or 0 for the default.
+  ///
+  /// @return The allocation or an error code if something went wrong.
+  cargo::expected<std::unique_ptr<ur::allocation_info>, ur_result_t> allocate(
+      ur_device_handle_t device, ur_usm_mem_flags_t flags, size_t size,
+      uint32_t align);
+
+  /// @brief Return a freed allocation to the pool.
+  ///
+  /// The allocation is cached if its capacity is a pooled size class,
+  /// otherwise it is destroyed.
+  ///
+  /// @param[in] allocation Allocation made by this pool which was freed.
+  void release(std::unique_ptr<ur::allocation_info> allocation);
+
+  /// @brief Destroy cached allocations until at most `target` bytes remain.
+  ///
+  /// @param[in] target Number of bytes the pool may keep retaining.
+  void trim(size_t target);
+
+  /// @brief Context the pool allocates from, not retained.
+  ur_context_handle_t context;
+
+ private:
+  /// @brief Get the index of the free list for allocations on a device.
+  ///
+  /// @param[in] device Device of the allocation, or nullptr for host
+  /// allocations which use the list after the last device.
+  size_t getListIndex(ur_device_handle_t device) const;
+
+  /// @brief Cache of freed allocations.
+  mux::allocation_pool<ur::allocation_info> cache;
+};
+
+#endif  // UR_USM_POOL_H_INCLUDED
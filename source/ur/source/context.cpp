@@ -21,6 +21,7 @@
 
 #include "ur/device.h"
 #include "ur/platform.h"
+#include "ur/usm_pool.h"
 
 ur::host_allocation_info::host_allocation_info(ur_context_handle_t context,
                                                const ur_usm_mem_flags_t USMFlag,
@@ -38,7 +39,7 @@ ur::host_allocation_info::host_allocation_info(ur_context_handle_t context,
 }
 
 ur_result_t ur::host_allocation_info::allocate() {
-  base_ptr = cargo::alloc(size, align);
+  base_ptr = cargo::alloc(capacity, align);
   if (!base_ptr) {
     return UR_RESULT_ERROR_OUT_OF_HOST_MEMORY;
   }
@@ -59,14 +60,14 @@ ur_result_t ur::host_allocation_info::allocate() {
       continue;
     }
 
-    if (auto error = muxCreateBuffer(device->mux_device, size,
+    if (auto error = muxCreateBuffer(device->mux_device, capacity,
                                      device->platform->mux_allocator_info,
                                      &mux_buffers[i])) {
       return ur::resultFromMux(error);
     }
 
     if (auto error = muxCreateMemoryFromHost(
-            device->mux_device, size, base_ptr,
+            device->mux_device, capacity, base_ptr,
             device->platform->mux_allocator_info, &mux_memories[i])) {
       return ur::resultFromMux(error);
     }
@@ -131,20 +132,20 @@ ur_result_t ur::device_allocation_info::allocate() {
   }
 
   const auto max_alloc_size = device->mux_device->info->allocation_size;
-  if (size > max_alloc_size) {
+  if (capacity > max_alloc_size) {
     return UR_RESULT_ERROR_INVALID_USM_SIZE;
   }
 
   constexpr uint32_t heap = 1;
   if (auto error = muxAllocateMemory(
-          device->mux_device, size, heap, mux_memory_property_device_local,
+          device->mux_device, capacity, heap, mux_memory_property_device_local,
           mux_allocation_type_alloc_device, align,
           device->platform->mux_allocator_info, &mux_memory)) {
     return ur::resultFromMux(error);
   }
 
   if (auto error =
-          muxCreateBuffer(device->mux_device, size,
+          muxCreateBuffer(device->mux_device, capacity,
                           device->platform->mux_allocator_info, &mux_buffer)) {
     return ur::resultFromMux(error);
   }
@@ -194,9 +195,22 @@ cargo::expected<ur_context_handle_t, ur_result_t> ur_context_handle_t_::create(
   if (context->devices.assign(devices.begin(), devices.end())) {
     return cargo::make_unexpected(UR_RESULT_ERROR_OUT_OF_HOST_MEMORY);
   }
+  auto usm_pool = ur_usm_pool_handle_t_::create(context.get());
+  if (!usm_pool) {
+    return cargo::make_unexpected(usm_pool.error());
+  }
+  context->usm_pool = *usm_pool;
   return context.release();
 }
 
+ur_context_handle_t_::~ur_context_handle_t_() {
+  // Cached allocations in the default pool use the devices of the context on
+  // destruction, so the pool must be destroyed first.
+  if (usm_pool) {
+    (void)ur::release(usm_pool);
+  }
+}
+
 ur::allocation_info *ur_context_handle_t_::findUSMAllocation(
     const void *base_ptr) {
   if (!base_ptr) {
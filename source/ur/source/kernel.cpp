@@ -20,6 +20,7 @@
 
 #include "ur/context.h"
 #include "ur/device.h"
+#include "ur/memory.h"
 #include "ur/platform.h"
 #include "ur/program.h"
 
@@ -71,10 +72,52 @@ cargo::expected<ur_kernel_handle_t, ur_result_t> ur_kernel_handle_t_::create(
       kernel->arguments.alloc(kernel_data.value().num_arguments)) {
     return cargo::make_unexpected(UR_RESULT_ERROR_OUT_OF_HOST_MEMORY);
   }
+  if (cargo::success !=
+      kernel->descriptors.alloc(kernel_data.value().num_arguments)) {
+    return cargo::make_unexpected(UR_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+  }
+  for (size_t arg_idx = 0; arg_idx < kernel->arguments.size(); arg_idx++) {
+    kernel->arguments[arg_idx].kind =
+        kernel_data.value().argument_types[arg_idx].kind;
+  }
 
   return kernel.release();
 }
 
+void ur_kernel_handle_t_::packDescriptors(uint32_t device_idx) {
+  const bool device_changed = device_idx != descriptors_device_idx;
+  if (!descriptors_dirty && !device_changed) {
+    return;
+  }
+
+  for (size_t arg_idx = 0; arg_idx < arguments.size(); ++arg_idx) {
+    auto &argument = arguments[arg_idx];
+    auto &descriptor = descriptors[arg_idx];
+    if (argument.mem_handle) {
+      // Buffer descriptors refer to the device specific mux buffer, so must be
+      // re-packed when launching on a different device.
+      if (!argument.dirty && !device_changed) {
+        continue;
+      }
+      descriptor.type = mux_descriptor_info_type_buffer;
+      descriptor.buffer_descriptor.buffer =
+          argument.mem_handle->buffers[device_idx].mux_buffer;
+      descriptor.buffer_descriptor.offset = 0;
+    } else {
+      if (!argument.dirty) {
+        continue;
+      }
+      descriptor.type = mux_descriptor_info_type_plain_old_data;
+      descriptor.plain_old_data_descriptor.data = argument.value.data;
+      descriptor.plain_old_data_descriptor.length = argument.value.size;
+    }
+    argument.dirty = false;
+  }
+
+  descriptors_device_idx = device_idx;
+  descriptors_dirty = false;
+}
+
 UR_APIEXPORT ur_result_t UR_APICALL
 urKernelCreate(ur_program_handle_t hProgram, const char *pKernelName,
                ur_kernel_handle_t *phKernel) {
@@ -124,7 +167,10 @@ UR_APIEXPORT ur_result_t UR_APICALL urKernelSetArgMemObj(
     return UR_RESULT_ERROR_INVALID_VALUE;
   }
 
+  std::lock_guard<std::mutex> lock(hKernel->mutex);
   hKernel->arguments[argIndex].mem_handle = hArgValue;
+  hKernel->arguments[argIndex].dirty = true;
+  hKernel->descriptors_dirty = true;
 
   return UR_RESULT_SUCCESS;
 }
@@ -144,35 +190,27 @@ urKernelSetArgValue(ur_kernel_handle_t hKernel, uint32_t argIndex,
     return UR_RESULT_ERROR_UNINITIALIZED;
   }
 
-  uint64_t num_devices;
-  const auto device_info_result = ur::resultFromMux(
-      muxGetDeviceInfos(mux_device_type_all, 0, nullptr, &num_devices));
-  if (device_info_result != UR_RESULT_SUCCESS) {
-    return device_info_result;
-  }
-
   if (argIndex >= hKernel->arguments.size()) {
     return UR_RESULT_ERROR_INVALID_KERNEL_ARGUMENT_INDEX;
   }
 
-  const auto kernel_data =
-      hKernel->program->getKernelData(hKernel->kernel_name);
-
-  if (!kernel_data) {
-    return kernel_data.error();
-  }
-
-  const auto argument_kind = kernel_data.value().argument_types[argIndex].kind;
-
-  switch (argument_kind) {
-#define CASE_VALUE_TYPE(arg_type, type)                                       \
-  case arg_type: {                                                            \
-    if (sizeof(type) != argSize) {                                            \
-      return UR_RESULT_ERROR_INVALID_KERNEL_ARGUMENT_SIZE;                    \
-    }                                                                         \
-    hKernel->arguments[argIndex].value.size = argSize;                        \
-    hKernel->arguments[argIndex].value.data = new char[argSize];              \
-    std::memcpy(hKernel->arguments[argIndex].value.data, pArgValue, argSize); \
+  std::lock_guard<std::mutex> lock(hKernel->mutex);
+  auto &argument = hKernel->arguments[argIndex];
+
+  // Argument storage is reused when the size doesn't change, which is always
+  // the case for a given argument index once its size has been validated.
+  switch (argument.kind) {
+#define CASE_VALUE_TYPE(arg_type, type)                    \
+  case arg_type: {                                         \
+    if (sizeof(type) != argSize) {                         \
+      return UR_RESULT_ERROR_INVALID_KERNEL_ARGUMENT_SIZE; \
+    }                                                      \
+    if (argument.value.size != argSize) {                  \
+      delete[] argument.value.data;                        \
+      argument.value.data = new char[argSize];             \
+      argument.value.size = argSize;                       \
+    }                                                      \
+    std::memcpy(argument.value.data, pArgValue, argSize);  \
   } break
 
 #define CASES_VALUE_VECTOR_TYPE(arg_type, type) \
@@ -198,5 +236,8 @@ urKernelSetArgValue(ur_kernel_handle_t hKernel, uint32_t argIndex,
       return UR_RESULT_ERROR_INVALID_KERNEL;
   }
 
+  argument.dirty = true;
+  hKernel->descriptors_dirty = true;
+
   return UR_RESULT_SUCCESS;
 }
@@ -24,6 +24,7 @@
 #include "ur/context.h"
 #include "ur/mux.h"
 #include "ur/platform.h"
+#include "ur/usm_pool.h"
 
 ur_mem_handle_t_::~ur_mem_handle_t_() {
   switch (type) {
@@ -217,8 +218,6 @@ UR_APIEXPORT ur_result_t UR_APICALL urUSMHostAlloc(ur_context_handle_t hContext,
                                                    ur_usm_pool_handle_t pool,
                                                    size_t size, uint32_t align,
                                                    void **pptr) {
-  // TODO: handle pool
-  (void)pool;
   if (!hContext) {
     return UR_RESULT_ERROR_INVALID_NULL_HANDLE;
   }
@@ -244,13 +243,16 @@ UR_APIEXPORT ur_result_t UR_APICALL urUSMHostAlloc(ur_context_handle_t hContext,
     flags = pUSMDesc->flags;
   }
 
+  if (!pool) {
+    pool = hContext->usm_pool;
+  }
+
   std::lock_guard<std::mutex> lock_guard(hContext->mutex);
-  auto host_allocation =
-      std::make_unique<ur::host_allocation_info>(hContext, flags, size, align);
-  if (host_allocation->allocate()) {
+  auto host_allocation = pool->allocate(nullptr, flags, size, align);
+  if (!host_allocation) {
     return UR_RESULT_ERROR_OUT_OF_HOST_MEMORY;
   }
-  if (hContext->usm_allocations.push_back(std::move(host_allocation))) {
+  if (hContext->usm_allocations.push_back(std::move(*host_allocation))) {
     return UR_RESULT_ERROR_OUT_OF_HOST_MEMORY;
   }
   *pptr = hContext->usm_allocations.back()->base_ptr;
@@ -272,15 +274,24 @@ UR_APIEXPORT ur_result_t UR_APICALL urUSMFree(ur_context_handle_t hContext,
     return usm_alloc->base_ptr == ptr;
   };
 
-  std::lock_guard<std::mutex> lock_guard(hContext->mutex);
-  auto usm_alloc_iterator =
-      std::find_if(hContext->usm_allocations.begin(),
-                   hContext->usm_allocations.end(), is_usm_ptr);
-  if (usm_alloc_iterator == hContext->usm_allocations.end()) {
-    return UR_RESULT_ERROR_INVALID_MEM_OBJECT;
+  std::unique_ptr<ur::allocation_info> usm_alloc;
+  {
+    std::lock_guard<std::mutex> lock_guard(hContext->mutex);
+    auto usm_alloc_iterator =
+        std::find_if(hContext->usm_allocations.begin(),
+                     hContext->usm_allocations.end(), is_usm_ptr);
+    if (usm_alloc_iterator == hContext->usm_allocations.end()) {
+      return UR_RESULT_ERROR_INVALID_MEM_OBJECT;
+    }
+
+    usm_alloc = std::move(*usm_alloc_iterator);
+    hContext->usm_allocations.erase(usm_alloc_iterator);
   }
 
-  hContext->usm_allocations.erase(usm_alloc_iterator);
+  // Return the allocation to its pool outside of the context lock, caching it
+  // may drop the last reference to the context.
+  auto usm_pool = usm_alloc->pool;
+  usm_pool->release(std::move(usm_alloc));
 
   return UR_RESULT_SUCCESS;
 }
@@ -289,8 +300,6 @@ UR_APIEXPORT ur_result_t UR_APICALL
 urUSMDeviceAlloc(ur_context_handle_t hContext, ur_device_handle_t device,
                  ur_usm_desc_t *pUSMDesc, ur_usm_pool_handle_t pool,
                  size_t size, uint32_t align, void **pptr) {
-  // TODO: handle pool
-  (void)pool;
   if (!hContext) {
     return UR_RESULT_ERROR_INVALID_NULL_HANDLE;
   }
@@ -325,14 +334,17 @@ urUSMDeviceAlloc(ur_context_handle_t hContext, ur_device_handle_t device,
     flags = pUSMDesc->flags;
   }
 
+  if (!pool) {
+    pool = hContext->usm_pool;
+  }
+
   std::lock_guard<std::mutex> lock_guard(hContext->mutex);
-  auto device_allocation = std::make_unique<ur::device_allocation_info>(
-      hContext, device, flags, size, align);
-  if (device_allocation->allocate()) {
+  auto device_allocation = pool->allocate(device, flags, size, align);
+  if (!device_allocation) {
     return UR_RESULT_ERROR_OUT_OF_HOST_MEMORY;
   }
 
-  if (hContext->usm_allocations.push_back(std::move(device_allocation))) {
+  if (hContext->usm_allocations.push_back(std::move(*device_allocation))) {
     return UR_RESULT_ERROR_OUT_OF_HOST_MEMORY;
   }
   *pptr = hContext->usm_allocations.back()->base_ptr;
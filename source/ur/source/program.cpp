@@ -133,7 +133,7 @@ ur_result_t ur_program_handle_t_::compile() {
   for (auto &device_program_iter : device_program_map) {
     // TODO: Support specialization constants.
     if (!device_program_iter.second.module->compileSPIRV(
-            source, device_program_iter.first->spv_device_info, {})) {
+            source, device_program_iter.first->spv_device_info, {}, {})) {
       return UR_RESULT_ERROR_PROGRAM_BUILD_FAILURE;
     }
   }
@@ -141,6 +141,18 @@ ur_queue_handle_t_::getCommandBuffer(const ur_event_handle_t signal_event,
   return command_buffer;
 }
 
+cargo::optional<mux_command_buffer_t>
+ur_queue_handle_t_::getPendingCommandBuffer() {
+  if (pending_dispatches.empty()) {
+    return cargo::nullopt;
+  }
+  auto &dispatch = pending_dispatches.back();
+  if (dispatch.signal_event->count.load() != 1) {
+    return cargo::nullopt;
+  }
+  return dispatch.command_buffer;
+}
+
 ur_result_t ur_queue_handle_t_::wait() {
   auto error = flush();
   if (error != UR_RESULT_SUCCESS) {
@@ -501,38 +513,27 @@ UR_APIEXPORT ur_result_t UR_APICALL urEnqueueKernelLaunch(
     return UR_RESULT_ERROR_INVALID_NULL_HANDLE;
   }
 
-  const auto num_args = hKernel->arguments.size();
-  mux_ndrange_options_t options;
-  cargo::dynamic_array<mux_descriptor_info_t> descriptors;
-  if (descriptors.alloc(num_args)) {
-    return UR_RESULT_ERROR_OUT_OF_HOST_MEMORY;
-  }
-
   const auto device_idx = hQueue->getDeviceIdx();
 
-  for (unsigned arg_idx = 0; arg_idx < num_args; ++arg_idx) {
-    const auto buffer = hKernel->arguments[arg_idx].mem_handle;
-    if (buffer) {
-      // Synchronize the state of the memory buffer across devices in the
-      // context.
-      if (const auto error = buffer->sync(hQueue)) {
-        return error;
-      }
+  std::lock_guard<std::mutex> kernel_lock(hKernel->mutex);
 
-      descriptors[arg_idx].type = mux_descriptor_info_type_buffer;
-      descriptors[arg_idx].buffer_descriptor.buffer =
-          buffer->buffers[device_idx].mux_buffer;
-      descriptors[arg_idx].buffer_descriptor.offset = 0;
-    } else {
-      descriptors[arg_idx].type = mux_descriptor_info_type_plain_old_data;
-      descriptors[arg_idx].plain_old_data_descriptor.data =
-          hKernel->arguments[arg_idx].value.data;
-      descriptors[arg_idx].plain_old_data_descriptor.length =
-          hKernel->arguments[arg_idx].value.size;
+  // Synchronize the state of the memory buffers across devices in the context,
+  // only necessary when the context has more than one device.
+  if (hQueue->context->devices.size() > 1) {
+    for (const auto &argument : hKernel->arguments) {
+      if (argument.mem_handle) {
+        if (const auto error = argument.mem_handle->sync(hQueue)) {
+          return error;
+        }
+      }
     }
   }
-  options.descriptors = descriptors.data();
-  options.descriptors_length = num_args;
+
+  hKernel->packDescriptors(device_idx);
+
+  mux_ndrange_options_t options;
+  options.descriptors = hKernel->descriptors.data();
+  options.descriptors_length = hKernel->descriptors.size();
   std::fill_n(std::begin(options.local_size),
               sizeof(options.local_size) / sizeof(options.local_size[0]), 1);
   std::copy_n(localWorkSize, workDim, std::begin(options.local_size));
@@ -540,6 +541,21 @@ UR_APIEXPORT ur_result_t UR_APICALL urEnqueueKernelLaunch(
   options.global_size = globalWorkSize;
   options.dimensions = workDim;
 
+  const auto mux_kernel = hKernel->device_kernel_map[hQueue->device];
+
+  // When the caller neither waits on events nor wants one back there is no
+  // need for an event of our own, append to the last pending dispatch.
+  if (!pEvent && numEventsInWaitList == 0) {
+    std::lock_guard<std::mutex> lock(hQueue->mutex);
+    if (auto command_buffer = hQueue->getPendingCommandBuffer()) {
+      if (auto error = muxCommandNDRange(*command_buffer, mux_kernel, options,
+                                         0, nullptr, nullptr)) {
+        return ur::resultFromMux(error);
+      }
+      return UR_RESULT_SUCCESS;
+    }
+  }
+
   auto event = ur_event_handle_t_::create(hQueue);
 
   if (!event) {
@@ -553,9 +569,8 @@ UR_APIEXPORT ur_result_t UR_APICALL urEnqueueKernelLaunch(
     if (!command_buffer_or_err) {
       return command_buffer_or_err.error();
     }
-    if (auto error = muxCommandNDRange(
-            *command_buffer_or_err, hKernel->device_kernel_map[hQueue->device],
-            options, 0, nullptr, nullptr)) {
+    if (auto error = muxCommandNDRange(*command_buffer_or_err, mux_kernel,
+                                       options, 0, nullptr, nullptr)) {
       return ur::resultFromMux(error);
     }
   }
@@ -0,0 +1,107 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "ur/usm_pool.h"
+
+#include <algorithm>
+
+#include "ur/device.h"
+#include "ur/platform.h"
+
+cargo::expected<ur_usm_pool_handle_t, ur_result_t>
+ur_usm_pool_handle_t_::create(ur_context_handle_t context) {
+  auto pool = std::make_unique<ur_usm_pool_handle_t_>(context);
+  // One set of free lists per device, plus one for host allocations.
+  if (pool->cache.init(context->devices.size() + 1)) {
+    return cargo::make_unexpected(UR_RESULT_ERROR_OUT_OF_HOST_MEMORY);
+  }
+  return pool.release();
+}
+
+cargo::expected<std::unique_ptr<ur::allocation_info>, ur_result_t>
+ur_usm_pool_handle_t_::allocate(ur_device_handle_t device,
+                                ur_usm_mem_flags_t flags, size_t size,
+                                uint32_t align) {
+  size_t capacity = mux::allocation_pool<ur::allocation_info>::getPooledSize(
+      size);
+  // Rounding up must not make a request fail which would otherwise succeed,
+  // so fall back to an exact sized allocation near the device limit.
+  if (0 == capacity ||
+      (device && capacity > device->mux_device->info->allocation_size)) {
+    capacity = size;
+  } else {
+    uint32_t required_align = align;
+    if (required_align == 0) {
+      // Match the default alignment the allocation_info would pick.
+      if (device) {
+        required_align = device->mux_device->info->buffer_alignment;
+      } else {
+        for (auto context_device : context->devices) {
+          required_align =
+              std::max(context_device->mux_device->info->buffer_alignment,
+                       required_align);
+        }
+      }
+    }
+
+    auto cached = cache.acquire(
+        getListIndex(device), size,
+        [&](const ur::allocation_info &allocation) {
+          return allocation.flags == flags &&
+                 allocation.align % required_align == 0;
+        });
+    if (cached) {
+      (void)ur::retain(context);
+      cached->retains_context = true;
+      cached->size = size;
+      return {std::move(cached)};
+    }
+  }
+
+  std::unique_ptr<ur::allocation_info> allocation;
+  if (device) {
+    allocation = std::make_unique<ur::device_allocation_info>(
+        context, device, flags, size, align);
+  } else {
+    allocation =
+        std::make_unique<ur::host_allocation_info>(context, flags, size, align);
+  }
+  allocation->capacity = capacity;
+  if (auto error = allocation->allocate()) {
+    return cargo::make_unexpected(error);
+  }
+  allocation->pool = this;
+  return {std::move(allocation)};
+}
+
+void ur_usm_pool_handle_t_::release(
+    std::unique_ptr<ur::allocation_info> allocation) {
+  // Cached allocations don't keep the context alive, but the reference can
+  // only be dropped once the pool is no longer being accessed. It may be the
+  // last one and the context owns its default pool.
+  auto context = allocation->context;
+  allocation->retains_context = false;
+  const size_t list_index = getListIndex(allocation->getDevice());
+  // Destroys the allocation if it could not be cached.
+  cache.release(list_index, std::move(allocation)).reset();
+  (void)ur::release(context);
+}
+
+void ur_usm_pool_handle_t_::trim(size_t target) { cache.trim(target); }
+
+size_t ur_usm_pool_handle_t_::getListIndex(ur_device_handle_t device) const {
+  return device ? context->getDeviceIdx(device) : context->devices.size();
+}
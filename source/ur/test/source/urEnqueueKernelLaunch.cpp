@@ -16,6 +16,9 @@
 
 #include "uur/checks.h"
 #include "uur/fixtures.h"
+#include "uur/kernels.h"
+
+using uur::fill_42_source;
 
 using urEnqueueKernelLaunchTest = uur::KernelTest;
 
@@ -96,64 +99,9 @@ TEST_P(urEnqueueMultiKernelLaunchTest, Success) {
 using urEnqueueKernelLaunchMultiDeviceTest = uur::MultiDeviceMemBufferQueueTest;
 
 TEST_F(urEnqueueKernelLaunchMultiDeviceTest, KernelReadDifferentQueues) {
-  // Enqueue a kernel that writes the value 42 into each element in the buffer.
-  // Generated from the following OpenCL C:
-  // kernel void foo(global uint *in) { in[get_global_id(0)] = 42; }
-  const uint8_t source[]{
-      0x03, 0x02, 0x23, 0x07, 0x00, 0x00, 0x01, 0x00, 0x0e, 0x00, 0x06, 0x00,
-      0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0x00, 0x02, 0x00,
-      0x04, 0x00, 0x00, 0x00, 0x11, 0x00, 0x02, 0x00, 0x05, 0x00, 0x00, 0x00,
-      0x11, 0x00, 0x02, 0x00, 0x06, 0x00, 0x00, 0x00, 0x11, 0x00, 0x02, 0x00,
-      0x0b, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00, 0x00,
-      0x4f, 0x70, 0x65, 0x6e, 0x43, 0x4c, 0x2e, 0x73, 0x74, 0x64, 0x00, 0x00,
-      0x0e, 0x00, 0x03, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
-      0x0f, 0x00, 0x05, 0x00, 0x06, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00,
-      0x66, 0x6f, 0x6f, 0x00, 0x05, 0x00, 0x00, 0x00, 0x07, 0x00, 0x09, 0x00,
-      0x11, 0x00, 0x00, 0x00, 0x6b, 0x65, 0x72, 0x6e, 0x65, 0x6c, 0x5f, 0x61,
-      0x72, 0x67, 0x5f, 0x74, 0x79, 0x70, 0x65, 0x2e, 0x66, 0x6f, 0x6f, 0x2e,
-      0x75, 0x69, 0x6e, 0x74, 0x2a, 0x2c, 0x00, 0x00, 0x03, 0x00, 0x03, 0x00,
-      0x03, 0x00, 0x00, 0x00, 0xa0, 0x86, 0x01, 0x00, 0x05, 0x00, 0x0b, 0x00,
-      0x05, 0x00, 0x00, 0x00, 0x5f, 0x5f, 0x73, 0x70, 0x69, 0x72, 0x76, 0x5f,
-      0x42, 0x75, 0x69, 0x6c, 0x74, 0x49, 0x6e, 0x47, 0x6c, 0x6f, 0x62, 0x61,
-      0x6c, 0x49, 0x6e, 0x76, 0x6f, 0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x49,
-      0x64, 0x00, 0x00, 0x00, 0x05, 0x00, 0x03, 0x00, 0x0b, 0x00, 0x00, 0x00,
-      0x69, 0x6e, 0x00, 0x00, 0x05, 0x00, 0x04, 0x00, 0x0c, 0x00, 0x00, 0x00,
-      0x65, 0x6e, 0x74, 0x72, 0x79, 0x00, 0x00, 0x00, 0x05, 0x00, 0x04, 0x00,
-      0x0e, 0x00, 0x00, 0x00, 0x63, 0x61, 0x6c, 0x6c, 0x00, 0x00, 0x00, 0x00,
-      0x05, 0x00, 0x05, 0x00, 0x0f, 0x00, 0x00, 0x00, 0x61, 0x72, 0x72, 0x61,
-      0x79, 0x69, 0x64, 0x78, 0x00, 0x00, 0x00, 0x00, 0x47, 0x00, 0x04, 0x00,
-      0x05, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00,
-      0x47, 0x00, 0x03, 0x00, 0x05, 0x00, 0x00, 0x00, 0x16, 0x00, 0x00, 0x00,
-      0x47, 0x00, 0x04, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x26, 0x00, 0x00, 0x00,
-      0x05, 0x00, 0x00, 0x00, 0x47, 0x00, 0x0d, 0x00, 0x05, 0x00, 0x00, 0x00,
-      0x29, 0x00, 0x00, 0x00, 0x5f, 0x5f, 0x73, 0x70, 0x69, 0x72, 0x76, 0x5f,
-      0x42, 0x75, 0x69, 0x6c, 0x74, 0x49, 0x6e, 0x47, 0x6c, 0x6f, 0x62, 0x61,
-      0x6c, 0x49, 0x6e, 0x76, 0x6f, 0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x49,
-      0x64, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x15, 0x00, 0x04, 0x00,
-      0x02, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x15, 0x00, 0x04, 0x00, 0x07, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x2b, 0x00, 0x04, 0x00, 0x07, 0x00, 0x00, 0x00,
-      0x10, 0x00, 0x00, 0x00, 0x2a, 0x00, 0x00, 0x00, 0x17, 0x00, 0x04, 0x00,
-      0x03, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
-      0x20, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
-      0x03, 0x00, 0x00, 0x00, 0x13, 0x00, 0x02, 0x00, 0x06, 0x00, 0x00, 0x00,
-      0x20, 0x00, 0x04, 0x00, 0x08, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
-      0x07, 0x00, 0x00, 0x00, 0x21, 0x00, 0x04, 0x00, 0x09, 0x00, 0x00, 0x00,
-      0x06, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x3b, 0x00, 0x04, 0x00,
-      0x04, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
-      0x36, 0x00, 0x05, 0x00, 0x06, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x37, 0x00, 0x03, 0x00,
-      0x08, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0xf8, 0x00, 0x02, 0x00,
-      0x0c, 0x00, 0x00, 0x00, 0x3d, 0x00, 0x04, 0x00, 0x03, 0x00, 0x00, 0x00,
-      0x0d, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x51, 0x00, 0x05, 0x00,
-      0x02, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x46, 0x00, 0x05, 0x00, 0x08, 0x00, 0x00, 0x00,
-      0x0f, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x00,
-      0x3e, 0x00, 0x05, 0x00, 0x0f, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00,
-      0x02, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0xfd, 0x00, 0x01, 0x00,
-      0x38, 0x00, 0x01, 0x00};
   ur_program_handle_t program = nullptr;
-  EXPECT_SUCCESS(urProgramCreateWithIL(context, source, sizeof(source), nullptr,
+  EXPECT_SUCCESS(urProgramCreateWithIL(context, fill_42_source,
+                                       sizeof(fill_42_source), nullptr,
                                        &program));
   EXPECT_SUCCESS(urProgramBuild(context, program, nullptr));
 
@@ -186,3 +134,98 @@ TEST_F(urEnqueueKernelLaunchMultiDeviceTest, KernelReadDifferentQueues) {
   EXPECT_SUCCESS(urKernelRelease(kernel));
   EXPECT_SUCCESS(urProgramRelease(program));
 }
+
+struct urEnqueueKernelLaunchArgsTest : uur::MemBufferQueueTest {
+  void SetUp() override {
+    UUR_RETURN_ON_FATAL_FAILURE(uur::MemBufferQueueTest::SetUp());
+    ASSERT_SUCCESS(urMemBufferCreate(context, UR_MEM_FLAG_READ_WRITE, size,
+                                     nullptr, &other_buffer));
+    ASSERT_SUCCESS(urProgramCreateWithIL(context, fill_42_source,
+                                         sizeof(fill_42_source), nullptr,
+                                         &program));
+    ASSERT_SUCCESS(urProgramBuild(context, program, nullptr));
+    ASSERT_SUCCESS(urKernelCreate(program, "foo", &kernel));
+
+    const std::vector<uint32_t> zeros(count, 0);
+    ASSERT_SUCCESS(urEnqueueMemBufferWrite(queue, buffer, true, 0, size,
+                                           zeros.data(), 0, nullptr, nullptr));
+    ASSERT_SUCCESS(urEnqueueMemBufferWrite(queue, other_buffer, true, 0, size,
+                                           zeros.data(), 0, nullptr, nullptr));
+  }
+
+  void TearDown() override {
+    if (kernel) {
+      EXPECT_SUCCESS(urKernelRelease(kernel));
+    }
+    if (program) {
+      EXPECT_SUCCESS(urProgramRelease(program));
+    }
+    if (other_buffer) {
+      EXPECT_SUCCESS(urMemRelease(other_buffer));
+    }
+    uur::MemBufferQueueTest::TearDown();
+  }
+
+  void checkBuffer(ur_mem_handle_t mem, uint32_t expected) {
+    std::vector<uint32_t> output(count, 0);
+    ASSERT_SUCCESS(urEnqueueMemBufferRead(queue, mem, true, 0, size,
+                                          output.data(), 0, nullptr, nullptr));
+    for (unsigned i = 0; i < count; ++i) {
+      EXPECT_EQ(expected, output[i]) << "Result at index " << i;
+    }
+  }
+
+  ur_mem_handle_t other_buffer = nullptr;
+  ur_program_handle_t program = nullptr;
+  ur_kernel_handle_t kernel = nullptr;
+};
+
+UUR_INSTANTIATE_DEVICE_TEST_SUITE_P(urEnqueueKernelLaunchArgsTest);
+
+TEST_P(urEnqueueKernelLaunchArgsTest, ChangeArgumentBetweenLaunches) {
+  const size_t offsets[]{0, 0, 0};
+  const size_t global_size[]{count};
+  const size_t local_size[]{1};
+
+  ASSERT_SUCCESS(urKernelSetArgMemObj(kernel, 0, buffer));
+  ASSERT_SUCCESS(urEnqueueKernelLaunch(queue, kernel, 1, offsets, global_size,
+                                       local_size, 0, nullptr, nullptr));
+  ASSERT_SUCCESS(urQueueFinish(queue));
+  checkBuffer(buffer, 42);
+  checkBuffer(other_buffer, 0);
+
+  // The cached descriptors must pick up the new argument.
+  ASSERT_SUCCESS(urKernelSetArgMemObj(kernel, 0, other_buffer));
+  ASSERT_SUCCESS(urEnqueueKernelLaunch(queue, kernel, 1, offsets, global_size,
+                                       local_size, 0, nullptr, nullptr));
+  ASSERT_SUCCESS(urQueueFinish(queue));
+  checkBuffer(other_buffer, 42);
+}
+
+TEST_P(urEnqueueKernelLaunchArgsTest, LaunchesWithoutEvents) {
+  const size_t offsets[]{0, 0, 0};
+  const size_t global_size[]{count};
+  const size_t local_size[]{1};
+
+  // Launches which neither wait on nor return events are batched together,
+  // interleave them with a launch returning an event to check both paths.
+  ASSERT_SUCCESS(urKernelSetArgMemObj(kernel, 0, buffer));
+  for (int i = 0; i < 4; i++) {
+    ASSERT_SUCCESS(urEnqueueKernelLaunch(queue, kernel, 1, offsets,
+                                         global_size, local_size, 0, nullptr,
+                                         nullptr));
+  }
+  ur_event_handle_t event = nullptr;
+  ASSERT_SUCCESS(urKernelSetArgMemObj(kernel, 0, other_buffer));
+  ASSERT_SUCCESS(urEnqueueKernelLaunch(queue, kernel, 1, offsets, global_size,
+                                       local_size, 0, nullptr, &event));
+  ASSERT_SUCCESS(urEnqueueKernelLaunch(queue, kernel, 1, offsets, global_size,
+                                       local_size, 0, nullptr, nullptr));
+  ASSERT_SUCCESS(urQueueFlush(queue));
+  ASSERT_SUCCESS(urEventWait(1, &event));
+  EXPECT_SUCCESS(urEventRelease(event));
+  ASSERT_SUCCESS(urQueueFinish(queue));
+
+  checkBuffer(buffer, 42);
+  checkBuffer(other_buffer, 42);
+}
@@ -29,6 +29,52 @@ TEST_P(urUSMFreeTest, Success) {
   ASSERT_SUCCESS(urUSMFree(context, ptr));
 }
 
+TEST_P(urUSMFreeTest, ReuseDeviceAllocation) {
+  // Freed allocations are cached by the context's default pool, so a request
+  // in the same size class is expected to be handed the same memory back.
+  void *ptr{nullptr};
+  ASSERT_SUCCESS(
+      urUSMDeviceAlloc(context, device, nullptr, nullptr, 100, 0, &ptr));
+  ASSERT_NE(ptr, nullptr);
+  ASSERT_SUCCESS(urUSMFree(context, ptr));
+
+  void *reused_ptr{nullptr};
+  ASSERT_SUCCESS(urUSMDeviceAlloc(context, device, nullptr, nullptr, 128, 0,
+                                  &reused_ptr));
+  ASSERT_EQ(reused_ptr, ptr);
+  ASSERT_SUCCESS(urUSMFree(context, reused_ptr));
+}
+
+TEST_P(urUSMFreeTest, ReuseHostAllocation) {
+  bool host_usm{false};
+  ASSERT_SUCCESS(urDeviceGetInfo(device, UR_DEVICE_INFO_HOST_UNIFIED_MEMORY,
+                                 sizeof(bool), &host_usm, nullptr));
+  if (!host_usm) {  // Skip this test if device does not support Host USM
+    GTEST_SKIP();
+  }
+
+  void *ptr{nullptr};
+  ASSERT_SUCCESS(urUSMHostAlloc(context, nullptr, nullptr, 100, 0, &ptr));
+  ASSERT_NE(ptr, nullptr);
+  ASSERT_SUCCESS(urUSMFree(context, ptr));
+
+  void *reused_ptr{nullptr};
+  ASSERT_SUCCESS(
+      urUSMHostAlloc(context, nullptr, nullptr, 128, 0, &reused_ptr));
+  ASSERT_EQ(reused_ptr, ptr);
+  ASSERT_SUCCESS(urUSMFree(context, reused_ptr));
+}
+
+TEST_P(urUSMFreeTest, DoubleFree) {
+  // Cached allocations must not be found by a second free.
+  void *ptr{nullptr};
+  ASSERT_SUCCESS(urUSMDeviceAlloc(context, device, nullptr, nullptr,
+                                  sizeof(int), 0, &ptr));
+  ASSERT_SUCCESS(urUSMFree(context, ptr));
+  ASSERT_EQ_RESULT(UR_RESULT_ERROR_INVALID_MEM_OBJECT,
+                   urUSMFree(context, ptr));
+}
+
 TEST_P(urUSMFreeTest, InvalidContext) {
   ASSERT_EQ_RESULT(UR_RESULT_ERROR_INVALID_NULL_HANDLE,
                    urUSMFree(nullptr, nullptr));
@@ -0,0 +1,128 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+
+#ifndef VK_COMPILE_POOL_H_INCLUDED
+#define VK_COMPILE_POOL_H_INCLUDED
+
+#include <compiler/info.h>
+#include <compiler/target.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vk {
+/// @brief Pool of threads compiling pipelines on behalf of a device.
+///
+/// Compiler contexts serialize compilation, so each thread owns a compiler
+/// context and target of its own. Creating and initializing a target is
+/// expensive, so the threads and their targets are created once, on the
+/// first call to `run` with more than one job, and live as long as the
+/// device. Compiler modules created by a thread's target may outlive the job
+/// that created them but not the pool.
+class compile_pool_t {
+ public:
+  /// @brief Type of the jobs run by the pool.
+  ///
+  /// Called with the index of the job and the target to compile it with.
+  using job_t = std::function<void(uint32_t, compiler::Target &)>;
+
+  /// @brief Constructor.
+  ///
+  /// @param compiler_info Compiler info used to create the threads' targets.
+  /// @param compiler_caps Capabilities to initialize the targets with.
+  compile_pool_t(const compiler::Info *compiler_info, uint32_t compiler_caps);
+
+  compile_pool_t(const compile_pool_t &) = delete;
+  compile_pool_t &operator=(const compile_pool_t &) = delete;
+
+  /// @brief Destructor, calls `stop`.
+  ~compile_pool_t();
+
+  /// @brief Run a batch of jobs and wait for all of them to complete.
+  ///
+  /// The calling thread also runs jobs from the batch, using
+  /// `caller_target`. Batches from several threads may run concurrently.
+  ///
+  /// @param num_jobs Number of jobs in the batch.
+  /// @param caller_target Target the calling thread compiles its jobs with.
+  /// @param job Function called once for each job index.
+  void run(uint32_t num_jobs, compiler::Target &caller_target,
+           const job_t &job);
+
+  /// @brief Join the pool's threads, destroying their targets.
+  ///
+  /// Must not be called while `run` is in progress.
+  void stop();
+
+  /// @brief Maximum number of threads in a pool.
+  static constexpr uint32_t max_num_threads = 7;
+
+ private:
+  /// @brief A batch of jobs passed to `run`.
+  struct batch_t {
+    /// @brief Function running the jobs.
+    const job_t &job;
+    /// @brief Number of jobs in the batch.
+    const uint32_t num_jobs;
+    /// @brief Index of the next job to start.
+    uint32_t next_job;
+    /// @brief Number of completed jobs.
+    uint32_t num_completed;
+  };
+
+  /// @brief Entry point of the pool's threads.
+  void threadMain();
+
+  /// @brief Take the next job of the oldest batch with jobs left to start.
+  ///
+  /// Must be called with `mutex` held and `batches` not empty.
+  ///
+  /// @param[out] job_index Set to the index of the taken job.
+  ///
+  /// @return Returns the batch the job belongs to.
+  batch_t *takeJob(uint32_t &job_index);
+
+  /// @brief Compiler info used to create the threads' targets.
+  const compiler::Info *compiler_info;
+  /// @brief Capabilities to initialize the targets with.
+  const uint32_t compiler_caps;
+  /// @brief Number of threads started by the first batch. One less than the
+  /// number of hardware threads, as the calling thread also compiles, up to
+  /// `max_num_threads`.
+  const uint32_t num_threads;
+
+  /// @brief Mutex protecting the members below.
+  std::mutex mutex;
+  /// @brief Signalled when a batch is added or the pool stops.
+  std::condition_variable work_available;
+  /// @brief Signalled when a job completes.
+  std::condition_variable job_completed;
+  /// @brief Batches with jobs which haven't been started yet.
+  std::deque<batch_t *> batches;
+  /// @brief The pool's threads, empty until the first batch is run.
+  std::vector<std::thread> threads;
+  /// @brief Set when the pool is being stopped.
+  bool stopping = false;
+};
+}  // namespace vk
+
+#endif  // VK_COMPILE_POOL_H_INCLUDED
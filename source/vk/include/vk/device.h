@@ -22,10 +22,12 @@
 #include <compiler/target.h>
 #include <mux/mux.hpp>
 #include <vk/allocator.h>
+#include <vk/compile_pool.h>
 #include <vk/error.h>
 #include <vk/icd.h>
 
 #include <array>
+#include <memory>
 
 namespace vk {
 /// @copydoc ::vk::physical_device_t
@@ -52,12 +54,15 @@ typedef struct device_t final : icd_t<device_t> {
   /// device
   /// @param compiler_context Compiler context that was created alongside the
   /// device
+  /// @param compiler_info Compiler info used to create `compiler_target`
+  /// @param compiler_caps Capabilities `compiler_target` was initialized with
   /// @param spv_device_info SPIR-V device info to pass to compiler
   device_t(vk::allocator allocator, mux::unique_ptr<mux_device_t> mux_device,
            VkPhysicalDeviceMemoryProperties *memory_properties,
            VkPhysicalDeviceProperties *physical_device_properties,
            std::unique_ptr<compiler::Target> compiler_target,
            std::unique_ptr<compiler::Context> compiler_context,
+           const compiler::Info *compiler_info, uint32_t compiler_caps,
            compiler::spirv::DeviceInfo spv_device_info);
 
   /// @brief Destructor
@@ -85,8 +90,19 @@ typedef struct device_t final : icd_t<device_t> {
   /// @brief the compiler context that will be used as part of kernel creation.
   std::unique_ptr<compiler::Context> compiler_context;
 
+  /// @brief Compiler info used to create additional compiler targets.
+  const compiler::Info *compiler_info;
+
+  /// @brief Capabilities compiler targets are initialized with.
+  const uint32_t compiler_caps;
+
   /// @brief Information about the device used during SPIR-V consumption.
   const compiler::spirv::DeviceInfo spv_device_info;
+
+  /// @brief Threads compiling the pipelines passed to
+  /// `vkCreateComputePipelines` alongside the calling thread, which uses
+  /// `compiler_target`.
+  compile_pool_t compile_pool;
 } * device;
 
 /// @brief The master list of device extensions this implementation implements
@@ -0,0 +1,81 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+
+#ifndef VK_HASH_H_INCLUDED
+#define VK_HASH_H_INCLUDED
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace vk {
+/// @brief 128-bit digest produced by `vk::hasher`.
+typedef std::array<uint64_t, 2> digest;
+
+/// @brief Incremental 128-bit hasher, an implementation of the MurmurHash3
+/// x64 128-bit variant.
+///
+/// The digest depends only on the bytes passed to `update`, not on how they
+/// were split across calls, so digests are stable between application runs
+/// and can be serialized.
+class hasher {
+ public:
+  /// @brief Constructor.
+  ///
+  /// @param seed Value to seed both halves of the hash state with.
+  explicit hasher(uint64_t seed = 0)
+      : state{{seed, seed}}, buffer(), buffer_size(0), length(0) {}
+
+  /// @brief Add a range of bytes to the hash.
+  ///
+  /// @param data Pointer to the bytes to add.
+  /// @param size Number of bytes to add.
+  void update(const void *data, size_t size);
+
+  /// @brief Add the object representation of a trivially copyable value.
+  ///
+  /// @tparam T Type of the value.
+  /// @param value Value to add.
+  template <class T>
+  void update(const T &value) {
+    update(&value, sizeof(T));
+  }
+
+  /// @brief Get the digest of all bytes added so far.
+  ///
+  /// @return Returns the 128-bit digest.
+  vk::digest finalize() const;
+
+ private:
+  /// @brief Mix a full 16 byte block into the hash state.
+  ///
+  /// @param block Pointer to the 16 byte block.
+  void mixBlock(const uint8_t *block);
+
+  /// @brief The two 64-bit halves of the hash state.
+  std::array<uint64_t, 2> state;
+  /// @brief Bytes not yet mixed in because they don't fill a block.
+  std::array<uint8_t, 16> buffer;
+  /// @brief Number of valid bytes in `buffer`.
+  size_t buffer_size;
+  /// @brief Total number of bytes added.
+  uint64_t length;
+};
+}  // namespace vk
+
+#endif  // VK_HASH_H_INCLUDED
@@ -19,6 +19,7 @@
 
 #include <mux/mux.h>
 #include <vk/allocator.h>
+#include <vk/hash.h>
 #include <vk/icd.h>
 #include <vk/small_vector.h>
 #include <vulkan/vulkan.h>
@@ -32,12 +33,33 @@ namespace vk {
 /// @copydoc ::vk::device_t
 typedef struct device_t* device;
 
+/// @copydoc ::vk::shader_module_t
+typedef struct shader_module_t* shader_module;
+
+/// @brief Key identifying a pipeline cache entry.
+///
+/// A digest of everything that affects the finalized binary: the device and
+/// compiler (through `pipelineCacheUUID`), the SPIR-V module, the entry point
+/// and the specialization constants. The shader's workgroup size is fixed by
+/// the module and its specialization constants so it is covered too.
+typedef vk::digest pipeline_cache_key;
+
+/// @brief Compute the pipeline cache key of a shader stage.
+///
+/// @param device Device the pipeline is being created on.
+/// @param stage Shader stage the pipeline is being created from.
+///
+/// @return Returns the key of the stage's cache entry.
+pipeline_cache_key getPipelineCacheKey(
+    vk::device device, const VkPipelineShaderStageCreateInfo& stage);
+
 /// @brief Struct representing pipeline cache entry
 struct cached_shader {
   /// @brief Default constructor.
   cached_shader(const VkAllocationCallbacks *pAllocator,
                 VkSystemAllocationScope allocationScope)
-      : source_checksum(),
+      : data_size(),
+        key(),
         workgroup_size(),
         binary(cargo_allocator<uint8_t>(pAllocator, allocationScope)),
         descriptor_bindings(cargo_allocator<compiler::spirv::DescriptorBinding>(
@@ -48,7 +70,7 @@ struct cached_shader {
   /// @param other Other cached shader to move from.
   cached_shader(cached_shader&& other)
       : data_size(other.data_size),
-        source_checksum(other.source_checksum),
+        key(other.key),
         workgroup_size(std::move(other.workgroup_size)),
         binary(std::move(other.binary)),
         descriptor_bindings(std::move(other.descriptor_bindings)) {}
@@ -70,23 +92,19 @@ struct cached_shader {
   ///
   /// @param other Cache shader to compare.
   ///
-  /// @return Returns true if checksum's match, false otherwise.
+  /// @return Returns true if keys match, false otherwise.
   bool operator==(const cached_shader& other) const;
 
-  /// @brief Check for equality with a checksum.
-  ///
-  /// @param checksum Checksum value to compare.
-  ///
-  /// @return Returns true if checksum's match, false, otherwise.
-  bool operator==(const uint32_t& checksum) const;
+  /// @brief Set `data_size` from the current contents of the entry.
+  void updateDataSize();
 
   /// @brief Total size in bytes of all the data encoded in this cache entry
   size_t data_size;
-  /// @brief Source SPIR-V binary's checksum
-  uint32_t source_checksum;
+  /// @brief Key the entry was created with, see getPipelineCacheKey
+  pipeline_cache_key key;
   /// @brief Local workgroup size defined by the shader, cached at translation
   std::array<uint32_t, 3> workgroup_size;
-  /// @brief Cached llvm bitcode.
+  /// @brief Finalized executable, loadable with `muxCreateExecutable`.
   vk::small_vector<uint8_t, 128> binary;
   /// @brief Descriptor slots used by the cached shader
   vk::small_vector<compiler::spirv::DescriptorBinding, 2> descriptor_bindings;
@@ -102,9 +120,34 @@ typedef struct pipeline_cache_t final : icd_t<pipeline_cache_t> {
   /// @brief Destructor
   ~pipeline_cache_t() {}
 
-  /// @brief Data cached from pipeline creation
+  /// @brief Find the entry with the given key.
+  ///
+  /// Must be called with `mutex` held, the returned pointer is invalidated by
+  /// `insert`.
+  ///
+  /// @param key Key of the entry to find.
+  ///
+  /// @return Returns a pointer to the entry, or null if there isn't one.
+  cached_shader* find(const pipeline_cache_key& key);
+
+  /// @brief Add an entry unless one with the same key is already present.
+  ///
+  /// Must be called with `mutex` held.
+  ///
+  /// @param shader Entry to add.
+  ///
+  /// @return Returns `VK_SUCCESS`, or `VK_ERROR_OUT_OF_HOST_MEMORY` if an
+  /// allocation failed.
+  VkResult insert(cached_shader&& shader);
+
+  /// @brief Data cached from pipeline creation, in insertion order
   vk::small_vector<cached_shader, 2> cache_entries;
 
+  /// @brief Open addressed hash table of `cache_entries` indices plus one, a
+  /// zero slot is empty. Its size is zero or a power of two at least twice the
+  /// number of entries.
+  vk::small_vector<uint32_t, 8> cache_index;
+
   /// @brief Mutex used for locking during access to `cache_entries`
   std::mutex mutex;
 } * pipeline_cache;
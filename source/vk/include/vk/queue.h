@@ -86,6 +86,27 @@ typedef struct queue_t final : icd_t<queue_t> {
   /// @brief Destructor
   ~queue_t();
 
+  /// @brief Get callback data for a dispatch, reusing a released one if there
+  /// is one.
+  ///
+  /// Must be called with `mutex` held.
+  ///
+  /// @param commandBuffer `command_buffer` handle to be stored inside the data
+  /// @param semaphore Semaphore the dispatched mux command buffer signals
+  /// @param stage_flags Stage flags the dispatched mux command buffer runs in
+  ///
+  /// @return Returns the callback data, or null if allocation failed.
+  dispatch_callback_data acquireCallbackData(vk::command_buffer commandBuffer,
+                                             mux_semaphore_t semaphore,
+                                             VkPipelineStageFlags stage_flags);
+
+  /// @brief Return callback data to the queue once its dispatch completes.
+  ///
+  /// Must be called with `mutex` held.
+  ///
+  /// @param data Callback data returned by `acquireCallbackData`.
+  void releaseCallbackData(dispatch_callback_data data);
+
   /// @brief Instance of mux_queue_t that this object was created with
   mux_queue_t mux_queue;
 
@@ -96,6 +117,10 @@ typedef struct queue_t final : icd_t<queue_t> {
   /// @brief Mutex used for locking during the submit callback
   std::mutex mutex;
 
+  /// @brief Callback data released by completed dispatches, reused by later
+  /// submissions so that submitting doesn't allocate once this is warm
+  vk::small_vector<dispatch_callback_data, 8> callback_data_pool;
+
   /// @brief List of semaphores that will be signaled by executing command
   /// groups with compute work enqueued to them
   std::unordered_set<mux_semaphore_t> compute_waits;
@@ -18,6 +18,7 @@
 #define VK_SHADER_MODULE_H_INCLUDED
 
 #include <vk/allocator.h>
+#include <vk/hash.h>
 #include <vk/small_vector.h>
 
 #include <array>
@@ -33,9 +34,9 @@ typedef struct shader_module_t {
   ///
   /// @param code Vector contianing module binary code.
   /// @param code_size Size, in bytes, of the module binary.
-  /// @param checksum Checksum of the module binary.
+  /// @param digest Digest of the module binary.
   shader_module_t(vk::small_vector<uint32_t, 4> code, size_t code_size,
-                  uint32_t checksum);
+                  vk::digest digest);
 
   /// @brief destructor
   ~shader_module_t();
@@ -46,8 +47,9 @@ typedef struct shader_module_t {
   /// @brief size in bytes of the module binary
   const size_t code_size;
 
-  /// @brief Checksum of the module binary, used to find pipeline cache entries
-  const uint32_t module_checksum;
+  /// @brief Digest of the module binary, part of the key of pipeline cache
+  /// entries created from this module
+  const vk::digest module_digest;
 } * shader_module;
 
 /// @brief internal implementation of vkCreateShaderModule
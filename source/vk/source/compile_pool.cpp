@@ -0,0 +1,123 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+
+#include <compiler/context.h>
+#include <compiler/library.h>
+#include <vk/compile_pool.h>
+
+#include <algorithm>
+#include <memory>
+
+namespace vk {
+compile_pool_t::compile_pool_t(const compiler::Info *compiler_info,
+                               uint32_t compiler_caps)
+    : compiler_info(compiler_info),
+      compiler_caps(compiler_caps),
+      num_threads(std::min(
+          std::max(std::thread::hardware_concurrency(), 1u) - 1,
+          max_num_threads)) {}
+
+compile_pool_t::~compile_pool_t() { stop(); }
+
+void compile_pool_t::run(uint32_t num_jobs, compiler::Target &caller_target,
+                         const job_t &job) {
+  if (0 == num_jobs) {
+    return;
+  }
+  batch_t batch{job, num_jobs, 0, 0};
+  std::unique_lock<std::mutex> lock(mutex);
+  if (num_jobs > 1) {
+    // A single job is compiled by the calling thread alone, so threads are
+    // only started once there is something to share.
+    if (threads.empty() && !stopping) {
+      for (uint32_t index = 0; index < num_threads; index++) {
+        threads.emplace_back(&compile_pool_t::threadMain, this);
+      }
+    }
+    batches.push_back(&batch);
+    work_available.notify_all();
+  }
+
+  // The calling thread only takes jobs from its own batch so that it is not
+  // held up by other callers' jobs.
+  while (batch.next_job < num_jobs) {
+    const uint32_t job_index = batch.next_job++;
+    if (batch.next_job == num_jobs && num_jobs > 1) {
+      batches.erase(std::find(batches.begin(), batches.end(), &batch));
+    }
+    lock.unlock();
+    job(job_index, caller_target);
+    lock.lock();
+    batch.num_completed++;
+  }
+  job_completed.wait(
+      lock, [&batch] { return batch.num_completed == batch.num_jobs; });
+}
+
+void compile_pool_t::stop() {
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  work_available.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+}
+
+compile_pool_t::batch_t *compile_pool_t::takeJob(uint32_t &job_index) {
+  batch_t *batch = batches.front();
+  job_index = batch->next_job++;
+  if (batch->next_job == batch->num_jobs) {
+    batches.pop_front();
+  }
+  return batch;
+}
+
+void compile_pool_t::threadMain() {
+  // The context must outlive the target and the compiler modules it creates,
+  // which are released along with their pipelines before the device.
+  std::unique_ptr<compiler::Context> context = compiler::createContext();
+  if (!context) {
+    return;
+  }
+  std::unique_ptr<compiler::Target> target =
+      compiler_info->createTarget(context.get(), nullptr);
+  if (!target || target->init(compiler_caps) != compiler::Result::SUCCESS) {
+    // The remaining threads and the callers of `run` still complete every
+    // job, with less parallelism.
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  for (;;) {
+    work_available.wait(lock, [this] { return stopping || !batches.empty(); });
+    if (batches.empty()) {
+      return;
+    }
+    uint32_t job_index;
+    batch_t *batch = takeJob(job_index);
+    lock.unlock();
+    batch->job(job_index, *target);
+    lock.lock();
+    if (++batch->num_completed == batch->num_jobs) {
+      job_completed.notify_all();
+    }
+  }
+}
+}  // namespace vk
@@ -40,6 +40,7 @@ device_t::device_t(vk::allocator allocator,
                    VkPhysicalDeviceProperties *physical_device_properties,
                    std::unique_ptr<compiler::Target> compiler_target,
                    std::unique_ptr<compiler::Context> compiler_context,
+                   const compiler::Info *compiler_info, uint32_t compiler_caps,
                    compiler::spirv::DeviceInfo spv_device_info)
     : allocator(allocator),
       mux_device(mux_device.release()),
@@ -47,11 +48,15 @@ device_t::device_t(vk::allocator allocator,
       physical_device_properties(*physical_device_properties),
       compiler_target(std::move(compiler_target)),
       compiler_context(std::move(compiler_context)),
-      spv_device_info(std::move(spv_device_info)) {}
+      compiler_info(compiler_info),
+      compiler_caps(compiler_caps),
+      spv_device_info(std::move(spv_device_info)),
+      compile_pool(compiler_info, compiler_caps) {}
 
 device_t::~device_t() {
   // In accordance with the spec, queues are created and destroyed along with
   // their devices
+  compile_pool.stop();
   compiler_target.reset();
   if (queue) {
     allocator.destroy(queue);
@@ -498,7 +503,7 @@ VkResult CreateDevice(vk::physical_device physicalDevice,
       VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE, allocator, std::move(mux_device_ptr),
       &physicalDevice->memory_properties, &physicalDevice->properties,
       std::move(compiler_target), std::move(compiler_context),
-      std::move(spvDeviceInfo));
+      physicalDevice->compiler_info, caps, std::move(spvDeviceInfo));
 
   if (!device) {
     return VK_ERROR_OUT_OF_HOST_MEMORY;
@@ -0,0 +1,126 @@
+// Copyright (C) Codeplay Software Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License") with LLVM
+// Exceptions; you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://github.com/codeplaysoftware/oneapi-construction-kit/blob/main/LICENSE.txt
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+
+#include <vk/hash.h>
+
+#include <algorithm>
+
+namespace {
+const uint64_t c1 = 0x87c37b91114253d5ULL;
+const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t fmix(uint64_t k) {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+/// @brief Read a little endian 64-bit value from an unaligned pointer.
+inline uint64_t load(const uint8_t *bytes) {
+  uint64_t value = 0;
+  for (int byte = 7; byte >= 0; byte--) {
+    value = (value << 8) | bytes[byte];
+  }
+  return value;
+}
+}  // namespace
+
+namespace vk {
+void hasher::mixBlock(const uint8_t *block) {
+  uint64_t k1 = load(block);
+  uint64_t k2 = load(block + 8);
+
+  k1 *= c1;
+  k1 = rotl(k1, 31);
+  k1 *= c2;
+  state[0] ^= k1;
+  state[0] = rotl(state[0], 27);
+  state[0] += state[1];
+  state[0] = state[0] * 5 + 0x52dce729;
+
+  k2 *= c2;
+  k2 = rotl(k2, 33);
+  k2 *= c1;
+  state[1] ^= k2;
+  state[1] = rotl(state[1], 31);
+  state[1] += state[0];
+  state[1] = state[1] * 5 + 0x38495ab5;
+}
+
+void hasher::update(const void *data, size_t size) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  length += size;
+
+  if (buffer_size) {
+    const size_t fill = std::min(size, buffer.size() - buffer_size);
+    std::memcpy(buffer.data() + buffer_size, bytes, fill);
+    buffer_size += fill;
+    bytes += fill;
+    size -= fill;
+    if (buffer_size < buffer.size()) {
+      return;
+    }
+    mixBlock(buffer.data());
+    buffer_size = 0;
+  }
+
+  for (; size >= buffer.size(); bytes += buffer.size(), size -= buffer.size()) {
+    mixBlock(bytes);
+  }
+
+  std::memcpy(buffer.data(), bytes, size);
+  buffer_size = size;
+}
+
+vk::digest hasher::finalize() const {
+  uint64_t h1 = state[0];
+  uint64_t h2 = state[1];
+
+  uint8_t tail[16] = {};
+  std::memcpy(tail, buffer.data(), buffer_size);
+  if (buffer_size > 8) {
+    uint64_t k2 = load(tail + 8);
+    k2 *= c2;
+    k2 = rotl(k2, 33);
+    k2 *= c1;
+    h2 ^= k2;
+  }
+  if (buffer_size > 0) {
+    uint64_t k1 = load(tail);
+    k1 *= c1;
+    k1 = rotl(k1, 31);
+    k1 *= c2;
+    h1 ^= k1;
+  }
+
+  h1 ^= length;
+  h2 ^= length;
+  h1 += h2;
+  h2 += h1;
+  h1 = fmix(h1);
+  h2 = fmix(h2);
+  h1 += h2;
+  h2 += h1;
+
+  return {{h1, h2}};
+}
+}  // namespace vk
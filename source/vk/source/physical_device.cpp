@@ -14,7 +14,9 @@
 //
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <compiler/library.h>
 #include <vk/error.h>
+#include <vk/hash.h>
 #include <vk/instance.h>
 #include <vk/physical_device.h>
 
@@ -63,6 +65,21 @@ physical_device_t::physical_device_t(
   std::strncpy(properties.deviceName, device_info->device_name,
                VK_MAX_PHYSICAL_DEVICE_NAME_SIZE);
 
+  // Pipeline cache data holds binaries finalized by the compiler for this
+  // device, so it is only compatible with the same device, driver and compiler.
+  vk::hasher cache_uuid_hasher;
+  cache_uuid_hasher.update(properties.deviceName,
+                           std::strlen(properties.deviceName));
+  cache_uuid_hasher.update(properties.driverVersion);
+  cache_uuid_hasher.update(properties.vendorID);
+  cache_uuid_hasher.update(properties.deviceID);
+  const char *llvm_version = compiler::llvmVersion();
+  cache_uuid_hasher.update(llvm_version, std::strlen(llvm_version));
+  const vk::digest cache_uuid = cache_uuid_hasher.finalize();
+  static_assert(sizeof(cache_uuid) == VK_UUID_SIZE,
+                "Pipeline cache UUID must be filled by the digest");
+  std::memcpy(properties.pipelineCacheUUID, cache_uuid.data(), VK_UUID_SIZE);
+
   properties.limits = {};
   properties.limits.maxImageDimension1D = device_info->max_image_dimension_1d;
   properties.limits.maxImageDimension2D = device_info->max_image_dimension_2d;
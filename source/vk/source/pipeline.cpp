@@ -27,6 +27,8 @@
 #include <vk/shader_module.h>
 #include <vk/type_traits.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <map>
 #include <utility>
@@ -80,280 +82,362 @@ pipeline_t::pipeline_t(pipeline_t *base_pipeline, vk::allocator allocator)
 
 pipeline_t::~pipeline_t() {}
 
-VkResult CreateComputePipelines(vk::device device,
-                                vk::pipeline_cache pipelineCache,
-                                uint32_t createInfoCount,
-                                const VkComputePipelineCreateInfo *pCreateInfos,
-                                vk::allocator allocator,
-                                VkPipeline *pPipelines) {
-  VkResult res = VK_SUCCESS;
+namespace {
+/// @brief Create a compute pipeline that is not a derivative of another.
+///
+/// Safe to call concurrently for different create infos. Callers passing
+/// targets created in the same compiler context are serialized by it.
+///
+/// @param device Device to create the pipeline on.
+/// @param pipelineCache Pipeline cache to look up and store binaries in, may
+/// be null.
+/// @param create_info Description of the pipeline to create.
+/// @param compiler_target Compiler target to compile the shader with. It must
+/// outlive the pipeline.
+/// @param allocator Allocator.
+/// @param pPipeline Return the created pipeline.
+///
+/// @return Return Vulkan result code.
+VkResult createComputePipeline(vk::device device,
+                               vk::pipeline_cache pipelineCache,
+                               const VkComputePipelineCreateInfo &create_info,
+                               compiler::Target &compiler_target,
+                               vk::allocator allocator,
+                               vk::pipeline *pPipeline) {
+  vk::shader_module shader_module =
+      vk::cast<vk::shader_module>(create_info.stage.module);
+
+  const VkSpecializationInfo *spec_info = create_info.stage.pSpecializationInfo;
+
+  // Map constant ID to its corresponding offset into spec_data.
+  compiler::spirv::SpecializationInfo spvSpecInfo;
+  if (spec_info) {
+    uint32_t map_entry_count = spec_info->mapEntryCount;
+    size_t dataSize = 0;
+    for (uint32_t map_entry_index = 0; map_entry_index < map_entry_count;
+         map_entry_index++) {
+      uint32_t id = spec_info->pMapEntries[map_entry_index].constantID;
+      uint32_t offset = spec_info->pMapEntries[map_entry_index].offset;
+      size_t size = spec_info->pMapEntries[map_entry_index].size;
+
+      spvSpecInfo.entries.insert(std::make_pair(
+          id, compiler::spirv::SpecializationInfo::Entry{offset, size}));
+      dataSize = (offset + size) > dataSize ? (offset + size) : dataSize;
+    }
+    spvSpecInfo.data = spec_info->pData;
+  }
 
-  for (uint32_t pipelineIndex = 0; pipelineIndex < createInfoCount;
-       pipelineIndex++) {
-    vk::shader_module shader_module =
-        vk::cast<vk::shader_module>(pCreateInfos[pipelineIndex].stage.module);
-
-    vk::pipeline pipeline;
-
-    if (pCreateInfos[pipelineIndex].flags & VK_PIPELINE_CREATE_DERIVATIVE_BIT) {
-      // TODO: when providing local workgroup sizes is possible store and reuse
-      // the kernel instead of the scheduled_kernel, making this a fast way to
-      // switch out local workgroup sizes
-      vk::pipeline base_pipeline(nullptr);
-      if (pCreateInfos[pipelineIndex].basePipelineHandle != VK_NULL_HANDLE) {
-        base_pipeline = vk::cast<vk::pipeline>(
-            pCreateInfos[pipelineIndex].basePipelineHandle);
-      } else if (pCreateInfos[pipelineIndex].basePipelineIndex >= 0) {
-        base_pipeline = vk::cast<vk::pipeline>(
-            pPipelines[pCreateInfos[pipelineIndex].basePipelineIndex]);
-      }
-      VK_ASSERT(nullptr != base_pipeline, "Invalid pipeline state");
-
-      pipeline = allocator.create<vk::pipeline_t>(
-          VK_SYSTEM_ALLOCATION_SCOPE_DEVICE, base_pipeline, allocator);
-      if (!pipeline) {
-        pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-        res = VK_ERROR_OUT_OF_HOST_MEMORY;
-        continue;
+  mux::unique_ptr<mux_executable_t> mux_binary_executable_ptr(
+      nullptr, {nullptr, {nullptr, nullptr, nullptr}});
+  mux::unique_ptr<mux_kernel_t> mux_binary_kernel_ptr(
+      nullptr, {nullptr, {nullptr, nullptr, nullptr}});
+
+  std::unique_ptr<compiler::Module> compiler_module;
+  compiler::Kernel *compiler_kernel;
+
+  std::array<uint32_t, 3> workgroup_size;
+  cargo::small_vector<compiler::spirv::DescriptorBinding, 2>
+      descriptor_bindings;
+
+  cargo::string_view stageName(create_info.stage.pName);
+
+  vk::pipeline pipeline = nullptr;
+  bool cache_hit = false;
+
+  pipeline_cache_key cache_key = {};
+
+  if (pipelineCache) {
+    cache_key = getPipelineCacheKey(device, create_info.stage);
+
+    // Pipeline cache isn't externally synchronized according to the spec, and
+    // other threads may be appending to it, so the entry is only used while
+    // the lock is held.
+    std::lock_guard<std::mutex> lock(pipelineCache->mutex);
+    const cached_shader *cache_entry = pipelineCache->find(cache_key);
+
+    if (cache_entry) {
+      // If the pipeline is cached, create a Mux executable from the cached
+      // binary.
+      cache_hit = true;
+      workgroup_size = cache_entry->workgroup_size;
+      if (descriptor_bindings.assign(
+              cache_entry->descriptor_bindings.begin(),
+              cache_entry->descriptor_bindings.end())) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
       }
-    } else {
-      const VkSpecializationInfo *spec_info =
-          pCreateInfos[pipelineIndex].stage.pSpecializationInfo;
-
-      // Map constant ID to its corresponding offset into spec_data.
-      compiler::spirv::SpecializationInfo spvSpecInfo;
-      if (spec_info) {
-        uint32_t map_entry_count = spec_info->mapEntryCount;
-        size_t dataSize = 0;
-        for (uint32_t map_entry_index = 0; map_entry_index < map_entry_count;
-             map_entry_index++) {
-          uint32_t id = spec_info->pMapEntries[map_entry_index].constantID;
-          uint32_t offset = spec_info->pMapEntries[map_entry_index].offset;
-          size_t size = spec_info->pMapEntries[map_entry_index].size;
-
-          spvSpecInfo.entries.insert(std::make_pair(
-              id, compiler::spirv::SpecializationInfo::Entry{offset, size}));
-          dataSize = (offset + size) > dataSize ? (offset + size) : dataSize;
-        }
-        spvSpecInfo.data = spec_info->pData;
+
+      mux_executable_t mux_binary_executable;
+      mux_result_t error = muxCreateExecutable(
+          device->mux_device, cache_entry->binary.data(),
+          cache_entry->binary.size(), allocator.getMuxAllocator(),
+          &mux_binary_executable);
+      if (mux_success != error) {
+        return vk::getVkResult(error);
       }
+      mux_binary_executable_ptr = {
+          mux_binary_executable,
+          {device->mux_device, allocator.getMuxAllocator()}};
+    }
+  }
 
-      mux::unique_ptr<mux_executable_t> mux_binary_executable_ptr(
-          nullptr, {nullptr, {nullptr, nullptr, nullptr}});
-      mux::unique_ptr<mux_kernel_t> mux_binary_kernel_ptr(
-          nullptr, {nullptr, {nullptr, nullptr, nullptr}});
+  if (cache_hit) {
+    mux_kernel_t mux_binary_kernel;
+    mux_result_t error = muxCreateKernel(
+        device->mux_device, mux_binary_executable_ptr.get(), stageName.data(),
+        stageName.size(), allocator.getMuxAllocator(), &mux_binary_kernel);
+    if (mux_success != error) {
+      return vk::getVkResult(error);
+    }
+    mux_binary_kernel_ptr = {mux_binary_kernel,
+                             {device->mux_device, allocator.getMuxAllocator()}};
 
-      std::unique_ptr<compiler::Module> compiler_module;
-      compiler::Kernel *compiler_kernel;
+    pipeline = allocator.create<vk::pipeline_t>(
+        VK_SYSTEM_ALLOCATION_SCOPE_DEVICE, std::move(mux_binary_executable_ptr),
+        std::move(mux_binary_kernel_ptr), allocator);
+  } else {
+    uint32_t num_errors = 0;
+    std::string error_log;
+    compiler_module = compiler_target.createModule(num_errors, error_log);
+    if (!compiler_module) {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
 
-      std::array<uint32_t, 3> workgroup_size;
-      cargo::small_vector<compiler::spirv::DescriptorBinding, 2>
-          descriptor_bindings;
+    auto compile_result = compiler_module->compileSPIRV(
+        {shader_module->code_buffer.data(), shader_module->code_size / 4},
+        device->spv_device_info, spvSpecInfo, {&stageName, 1});
+    if (!compile_result) {
+      return getVkResult(compile_result.error());
+    }
 
-      cached_shader *cache_entry_iter = nullptr;
+    std::vector<builtins::printf::descriptor> printf_calls;
+    auto finalize_result = compiler_module->finalize({}, printf_calls);
+    if (finalize_result != compiler::Result::SUCCESS) {
+      return getVkResult(finalize_result);
+    }
 
-      if (pipelineCache) {
-        // Pipeline cache isn't externally synchronized according to the spec.
-        {
-          std::lock_guard<std::mutex> lock(pipelineCache->mutex);
-          cache_entry_iter = std::find(pipelineCache->cache_entries.begin(),
-                                       pipelineCache->cache_entries.end(),
-                                       shader_module->module_checksum);
-        }
+    const auto &spirv_module_info = *compile_result;
+    if (descriptor_bindings.assign(
+            spirv_module_info.used_descriptor_bindings.begin(),
+            spirv_module_info.used_descriptor_bindings.end())) {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    std::sort(descriptor_bindings.begin(), descriptor_bindings.end());
+    workgroup_size = spirv_module_info.workgroup_size;
+
+    if (pipelineCache) {
+      // we can't use the allocator provided to create the pipeline because
+      // this object may outlive the pipeline
+      cached_shader shader(device->allocator.getCallbacks(),
+                           VK_SYSTEM_ALLOCATION_SCOPE_CACHE);
+
+      shader.key = cache_key;
+      shader.workgroup_size = workgroup_size;
+      if (shader.descriptor_bindings.assign(descriptor_bindings.begin(),
+                                            descriptor_bindings.end())) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+      }
+
+      cargo::array_view<uint8_t> binary;
+      auto binary_result = compiler_module->createBinary(binary);
+      if (binary_result != compiler::Result::SUCCESS) {
+        return getVkResult(binary_result);
       }
 
-      cargo::string_view stageName(pCreateInfos[pipelineIndex].stage.pName);
-
-      if (cache_entry_iter &&
-          cache_entry_iter != pipelineCache->cache_entries.end()) {
-        // If the pipeline is cached, create a Mux executable and kernel from
-        // the cached binary.
-        workgroup_size = cache_entry_iter->workgroup_size;
-        if (descriptor_bindings.assign(
-                cache_entry_iter->descriptor_bindings.begin(),
-                cache_entry_iter->descriptor_bindings.end())) {
-          pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-          res = VK_ERROR_OUT_OF_HOST_MEMORY;
-          continue;
+      // Only finalized executables are cached, so a later hit never needs to
+      // compile or finalize. Targets that can't produce one aren't cached.
+      if (binary.size() > 0) {
+        if (cargo::success != shader.binary.resize(binary.size())) {
+          return VK_ERROR_OUT_OF_HOST_MEMORY;
         }
 
-        mux_executable_t mux_binary_executable;
-        mux_result_t error = muxCreateExecutable(
-            device->mux_device, cache_entry_iter->binary.data(),
-            cache_entry_iter->binary.size(), allocator.getMuxAllocator(),
-            &mux_binary_executable);
+        std::memcpy(shader.binary.data(), binary.data(), shader.binary.size());
 
-        if (mux_success != error) {
-          pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-          res = vk::getVkResult(error);
-          continue;
-        }
-        mux_binary_executable_ptr = {
-            mux_binary_executable,
-            {device->mux_device, allocator.getMuxAllocator()}};
-
-        mux_kernel_t mux_binary_kernel;
-        error = muxCreateKernel(
-            device->mux_device, mux_binary_executable, stageName.data(),
-            stageName.size(), allocator.getMuxAllocator(), &mux_binary_kernel);
-        if (mux_success != error) {
-          pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-          res = vk::getVkResult(error);
-          continue;
-        }
-        mux_binary_kernel_ptr = {
-            mux_binary_kernel,
-            {device->mux_device, allocator.getMuxAllocator()}};
-
-        pipeline = allocator.create<vk::pipeline_t>(
-            VK_SYSTEM_ALLOCATION_SCOPE_DEVICE,
-            std::move(mux_binary_executable_ptr),
-            std::move(mux_binary_kernel_ptr), allocator);
-      } else {
-        uint32_t num_errors = 0;
-        std::string error_log;
-        compiler_module =
-            device->compiler_target->createModule(num_errors, error_log);
-        if (!compiler_module) {
-          pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-          res = VK_ERROR_OUT_OF_HOST_MEMORY;
-          continue;
-        }
+        // set data size to the combined size of everything that will be
+        // copied in the event of a vkGetPipelineCacheData call for later
+        // convenience
+        shader.updateDataSize();
 
-        auto compile_result = compiler_module->compileSPIRV(
-            {shader_module->code_buffer.data(), shader_module->code_size / 4},
-            device->spv_device_info, spvSpecInfo);
-        if (!compile_result) {
-          pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-          res = getVkResult(compile_result.error());
-          continue;
+        // Another worker may have compiled the same shader while we were, in
+        // which case its entry is kept.
+        std::lock_guard<std::mutex> lock(pipelineCache->mutex);
+        if (VK_SUCCESS != pipelineCache->insert(std::move(shader))) {
+          return VK_ERROR_OUT_OF_HOST_MEMORY;
         }
+      }
+    }
 
-        std::vector<builtins::printf::descriptor> printf_calls;
-        auto finalize_result = compiler_module->finalize({}, printf_calls);
-        if (finalize_result != compiler::Result::SUCCESS) {
-          pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-          res = getVkResult(finalize_result);
-          continue;
-        }
+    compiler_kernel = compiler_module->getKernel(
+        std::string(stageName.data(), stageName.size()));
+    if (!compiler_kernel) {
+      return VK_ERROR_INITIALIZATION_FAILED;
+    }
 
-        const auto &spirv_module_info = *compile_result;
-        if (descriptor_bindings.assign(
-                spirv_module_info.used_descriptor_bindings.begin(),
-                spirv_module_info.used_descriptor_bindings.end())) {
-          pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-          res = VK_ERROR_OUT_OF_HOST_MEMORY;
-          continue;
-        }
-        std::sort(descriptor_bindings.begin(), descriptor_bindings.end());
-        workgroup_size = spirv_module_info.workgroup_size;
-
-        if (pipelineCache) {
-          // we can't use the allocator provided to create the pipeline because
-          // this object may outlive the pipeline
-          cached_shader shader(device->allocator.getCallbacks(),
-                               VK_SYSTEM_ALLOCATION_SCOPE_CACHE);
-
-          shader.source_checksum = shader_module->module_checksum;
-          shader.workgroup_size = workgroup_size;
-          if (shader.descriptor_bindings.assign(descriptor_bindings.begin(),
-                                                descriptor_bindings.end())) {
-            pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-            res = VK_ERROR_OUT_OF_HOST_MEMORY;
-            continue;
-          }
-
-          cargo::array_view<uint8_t> binary;
-          auto binary_result = compiler_module->createBinary(binary);
-          if (binary_result != compiler::Result::SUCCESS) {
-            pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-            res = getVkResult(binary_result);
-            continue;
-          }
-
-          if (binary.size() > 0) {
-            if (cargo::success != shader.binary.resize(binary.size())) {
-              pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-              res = VK_ERROR_OUT_OF_HOST_MEMORY;
-              continue;
-            }
-
-            std::memcpy(shader.binary.data(), binary.data(),
-                        shader.binary.size());
-          }
-
-          // set data size to the combined size of everything that will be
-          // copied in the event of a vkGetPipelineCacheData call for later
-          // convenience
-          shader.data_size =
-              sizeof(shader.data_size) + sizeof(shader.source_checksum) +
-              // we copy the size into the cache data as well
-              sizeof(shader.descriptor_bindings.size()) +
-              sizeof(spirv_ll::DescriptorBinding) *
-                  shader.descriptor_bindings.size() +
-              sizeof(shader.workgroup_size) + sizeof(shader.binary.size()) +
-              shader.binary.size();
-
-          {
-            std::lock_guard<std::mutex> lock(pipelineCache->mutex);
-
-            if (std::find(pipelineCache->cache_entries.begin(),
-                          pipelineCache->cache_entries.end(),
-                          shader) == pipelineCache->cache_entries.end()) {
-              if (pipelineCache->cache_entries.push_back(std::move(shader))) {
-                pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-                res = VK_ERROR_OUT_OF_HOST_MEMORY;
-                continue;
-              }
-            }
-          }
-        }
+    // Optimize the kernel for the workgroup size.
+    compiler_kernel->precacheLocalSize(workgroup_size[0], workgroup_size[1],
+                                       workgroup_size[2]);
 
-        compiler_kernel = compiler_module->getKernel(
-            std::string(stageName.data(), stageName.size()));
-        if (!compiler_kernel) {
-          pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-          res = VK_ERROR_INITIALIZATION_FAILED;
-          continue;
-        }
+    pipeline = allocator.create<vk::pipeline_t>(
+        VK_SYSTEM_ALLOCATION_SCOPE_DEVICE, std::move(compiler_module),
+        compiler_kernel, allocator);
+  }
 
-        // Optimize the kernel for the workgroup size.
-        compiler_kernel->precacheLocalSize(workgroup_size[0], workgroup_size[1],
-                                           workgroup_size[2]);
+  if (!pipeline) {
+    return VK_ERROR_OUT_OF_HOST_MEMORY;
+  }
 
-        pipeline = allocator.create<vk::pipeline_t>(
-            VK_SYSTEM_ALLOCATION_SCOPE_DEVICE, std::move(compiler_module),
-            compiler_kernel, allocator);
-      }
+  pipeline->wgs = workgroup_size;
 
-      if (!pipeline) {
-        pPipelines[pipelineIndex] = VK_NULL_HANDLE;
-        res = VK_ERROR_OUT_OF_HOST_MEMORY;
-        continue;
-      }
+  auto iter = pipeline->descriptor_bindings.insert(
+      pipeline->descriptor_bindings.begin(), descriptor_bindings.begin(),
+      descriptor_bindings.end());
 
-      pipeline->wgs = workgroup_size;
+  if (!iter) {
+    allocator.destroy(pipeline);
+    return VK_ERROR_OUT_OF_HOST_MEMORY;
+  }
 
-      auto iter = pipeline->descriptor_bindings.insert(
-          pipeline->descriptor_bindings.begin(), descriptor_bindings.begin(),
-          descriptor_bindings.end());
+  vk::pipeline_layout pipeline_layout =
+      vk::cast<vk::pipeline_layout>(create_info.layout);
+
+  pipeline->total_push_constant_size =
+      pipeline_layout->total_push_constant_size;
+
+  *pPipeline = pipeline;
+  return VK_SUCCESS;
+}
+
+/// @brief Create a compute pipeline derived from a previously created one.
+///
+/// @param create_info Description of the pipeline to create.
+/// @param pPipelines Pipelines created so far by the same call, used to look
+/// up the base pipeline by index.
+/// @param allocator Allocator.
+/// @param pPipeline Return the created pipeline.
+///
+/// @return Return Vulkan result code.
+VkResult createDerivativeComputePipeline(
+    const VkComputePipelineCreateInfo &create_info,
+    const VkPipeline *pPipelines, vk::allocator allocator,
+    vk::pipeline *pPipeline) {
+  // TODO: when providing local workgroup sizes is possible store and reuse
+  // the kernel instead of the scheduled_kernel, making this a fast way to
+  // switch out local workgroup sizes
+  vk::pipeline base_pipeline(nullptr);
+  if (create_info.basePipelineHandle != VK_NULL_HANDLE) {
+    base_pipeline = vk::cast<vk::pipeline>(create_info.basePipelineHandle);
+  } else if (create_info.basePipelineIndex >= 0) {
+    base_pipeline =
+        vk::cast<vk::pipeline>(pPipelines[create_info.basePipelineIndex]);
+  }
+  VK_ASSERT(nullptr != base_pipeline, "Invalid pipeline state");
 
-      if (!iter) {
-        res = VK_ERROR_OUT_OF_HOST_MEMORY;
-        continue;
+  vk::pipeline pipeline = allocator.create<vk::pipeline_t>(
+      VK_SYSTEM_ALLOCATION_SCOPE_DEVICE, base_pipeline, allocator);
+  if (!pipeline) {
+    return VK_ERROR_OUT_OF_HOST_MEMORY;
+  }
+
+  vk::pipeline_layout pipeline_layout =
+      vk::cast<vk::pipeline_layout>(create_info.layout);
+
+  pipeline->total_push_constant_size =
+      pipeline_layout->total_push_constant_size;
+
+  *pPipeline = pipeline;
+  return VK_SUCCESS;
+}
+}  // namespace
+
+VkResult CreateComputePipelines(vk::device device,
+                                vk::pipeline_cache pipelineCache,
+                                uint32_t createInfoCount,
+                                const VkComputePipelineCreateInfo *pCreateInfos,
+                                vk::allocator allocator,
+                                VkPipeline *pPipelines) {
+  cargo::small_vector<VkResult, 8> results;
+  if (results.assign(createInfoCount, VK_SUCCESS)) {
+    return VK_ERROR_OUT_OF_HOST_MEMORY;
+  }
+
+  // Derivative pipelines may refer to other pipelines in this call, so only
+  // the independent ones are compiled concurrently.
+  cargo::small_vector<uint32_t, 8> independent;
+  for (uint32_t pipelineIndex = 0; pipelineIndex < createInfoCount;
+       pipelineIndex++) {
+    pPipelines[pipelineIndex] = VK_NULL_HANDLE;
+    if (!(pCreateInfos[pipelineIndex].flags &
+          VK_PIPELINE_CREATE_DERIVATIVE_BIT)) {
+      if (independent.push_back(pipelineIndex)) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
       }
     }
+  }
 
-    vk::pipeline_layout pipeline_layout =
-        vk::cast<vk::pipeline_layout>(pCreateInfos[pipelineIndex].layout);
-
-    pipeline->total_push_constant_size =
-        pipeline_layout->total_push_constant_size;
+  // Index of the first failed pipeline created with
+  // VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT, pipelines after it
+  // are not created.
+  std::atomic<uint32_t> early_return_index(createInfoCount);
+  auto recordResult = [&](uint32_t pipelineIndex, VkResult result) {
+    results[pipelineIndex] = result;
+    if (VK_SUCCESS != result &&
+        (pCreateInfos[pipelineIndex].flags &
+         VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT)) {
+      uint32_t current = early_return_index.load();
+      while (pipelineIndex < current &&
+             !early_return_index.compare_exchange_weak(current,
+                                                       pipelineIndex)) {
+      }
+    }
+  };
+
+  // The calling thread compiles alongside the device's compile pool, using
+  // the device's own compiler target.
+  device->compile_pool.run(
+      static_cast<uint32_t>(independent.size()), *device->compiler_target,
+      [&](uint32_t next, compiler::Target &compiler_target) {
+        const uint32_t pipelineIndex = independent[next];
+        if (pipelineIndex > early_return_index.load()) {
+          return;
+        }
+        vk::pipeline pipeline = nullptr;
+        recordResult(pipelineIndex,
+                     createComputePipeline(device, pipelineCache,
+                                           pCreateInfos[pipelineIndex],
+                                           compiler_target, allocator,
+                                           &pipeline));
+        pPipelines[pipelineIndex] = reinterpret_cast<VkPipeline>(pipeline);
+      });
 
+  for (uint32_t pipelineIndex = 0; pipelineIndex < createInfoCount;
+       pipelineIndex++) {
+    if (!(pCreateInfos[pipelineIndex].flags &
+          VK_PIPELINE_CREATE_DERIVATIVE_BIT) ||
+        pipelineIndex > early_return_index.load()) {
+      continue;
+    }
+    vk::pipeline pipeline = nullptr;
+    recordResult(pipelineIndex, createDerivativeComputePipeline(
+                                    pCreateInfos[pipelineIndex], pPipelines,
+                                    allocator, &pipeline));
     pPipelines[pipelineIndex] = reinterpret_cast<VkPipeline>(pipeline);
   }
 
-  return res;
+  // Workers may have finished pipelines beyond an early return failure before
+  // it was recorded. These must not be returned.
+  for (uint32_t pipelineIndex = early_return_index.load() + 1;
+       pipelineIndex < createInfoCount; pipelineIndex++) {
+    DestroyPipeline(device, vk::cast<vk::pipeline>(pPipelines[pipelineIndex]),
+                    allocator);
+    pPipelines[pipelineIndex] = VK_NULL_HANDLE;
+  }
+
+  for (uint32_t pipelineIndex = 0; pipelineIndex < createInfoCount;
+       pipelineIndex++) {
+    if (VK_SUCCESS != results[pipelineIndex]) {
+      return results[pipelineIndex];
+    }
+  }
+  return VK_SUCCESS;
 }
 
 void DestroyPipeline(vk::device, vk::pipeline pipeline,
@@ -16,13 +16,59 @@
 
 #include <vk/device.h>
 #include <vk/pipeline_cache.h>
+#include <vk/shader_module.h>
 #include <vk/type_traits.h>
+#include <vk/unique_ptr.h>
+
+#include <algorithm>
 
 namespace vk {
+pipeline_cache_key getPipelineCacheKey(
+    vk::device device, const VkPipelineShaderStageCreateInfo& stage) {
+  vk::hasher hasher;
+  hasher.update(device->physical_device_properties.pipelineCacheUUID,
+                VK_UUID_SIZE);
+  hasher.update(vk::cast<vk::shader_module>(stage.module)->module_digest);
+
+  // Include the terminator so the name can't run into the data that follows.
+  hasher.update(stage.pName, std::strlen(stage.pName) + 1);
+
+  if (const VkSpecializationInfo* spec_info = stage.pSpecializationInfo) {
+    // The map entries may be given in any order, hash them by constant ID so
+    // equivalent specializations share an entry. If the order can't be
+    // allocated the key is still correct, only less likely to be shared.
+    vk::small_vector<uint32_t, 16> order(
+        {device->allocator.getCallbacks(), VK_SYSTEM_ALLOCATION_SCOPE_COMMAND});
+    if (cargo::success == order.resize(spec_info->mapEntryCount)) {
+      for (uint32_t index = 0; index < spec_info->mapEntryCount; index++) {
+        order[index] = index;
+      }
+      std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return spec_info->pMapEntries[lhs].constantID <
+               spec_info->pMapEntries[rhs].constantID;
+      });
+    }
+
+    hasher.update(spec_info->mapEntryCount);
+    for (uint32_t index = 0; index < spec_info->mapEntryCount; index++) {
+      const VkSpecializationMapEntry& entry =
+          spec_info->pMapEntries[order.empty() ? index : order[index]];
+      hasher.update(entry.constantID);
+      hasher.update(static_cast<uint64_t>(entry.size));
+      hasher.update(static_cast<const uint8_t*>(spec_info->pData) +
+                        entry.offset,
+                    entry.size);
+    }
+  }
+
+  return hasher.finalize();
+}
+
 cached_shader& cached_shader::operator=(cached_shader&& other) {
   binary = std::move(other.binary);
-  source_checksum = other.source_checksum;
-  other.source_checksum = 0;
+  data_size = other.data_size;
+  key = other.key;
+  other.key = {};
   workgroup_size = std::move(other.workgroup_size);
   descriptor_bindings = std::move(other.descriptor_bindings);
   return *this;
@@ -37,7 +83,8 @@ cargo::error_or<cached_shader> cached_shader::clone() const {
   } else {
     return clone_binary.error();
   }
-  clone.source_checksum = source_checksum;
+  clone.data_size = data_size;
+  clone.key = key;
   clone.workgroup_size = workgroup_size;
   if (auto clone_descriptor_bindings = descriptor_bindings.clone()) {
     clone.descriptor_bindings = std::move(*clone_descriptor_bindings);
@@ -54,17 +101,76 @@ cargo::error_or<cached_shader> cached_shader::clone() const {
 }
 
 bool cached_shader::operator==(const cached_shader& other) const {
-  return source_checksum == other.source_checksum;
+  return key == other.key;
 }
 
-bool cached_shader::operator==(const uint32_t& checksum) const {
-  return source_checksum == checksum;
+void cached_shader::updateDataSize() {
+  // This is the size of the serialized form written by GetPipelineCacheData,
+  // where each vector is preceded by its size in bytes.
+  data_size = sizeof(data_size) + sizeof(key) + sizeof(workgroup_size) +
+              sizeof(size_t) + binary.size() + sizeof(size_t) +
+              sizeof(compiler::spirv::DescriptorBinding) *
+                  descriptor_bindings.size();
 }
 
 pipeline_cache_t::pipeline_cache_t(vk::allocator allocator)
     : cache_entries(
+          {allocator.getCallbacks(), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT}),
+      cache_index(
           {allocator.getCallbacks(), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT}) {}
 
+cached_shader* pipeline_cache_t::find(const pipeline_cache_key& key) {
+  if (cache_index.empty()) {
+    return nullptr;
+  }
+  // The key is already a digest, so its bits are used directly as the hash.
+  const size_t mask = cache_index.size() - 1;
+  for (size_t slot = key[0] & mask; cache_index[slot];
+       slot = (slot + 1) & mask) {
+    cached_shader& entry = cache_entries[cache_index[slot] - 1];
+    if (entry.key == key) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+VkResult pipeline_cache_t::insert(cached_shader&& shader) {
+  if (find(shader.key)) {
+    return VK_SUCCESS;
+  }
+
+  if (cache_entries.push_back(std::move(shader))) {
+    return VK_ERROR_OUT_OF_HOST_MEMORY;
+  }
+
+  // Keep the table at most half full so probe sequences stay short.
+  if (cache_index.size() < cache_entries.size() * 2) {
+    const size_t index_size = std::max<size_t>(16, cache_index.size() * 2);
+    if (cache_index.assign(index_size, 0)) {
+      cache_entries.pop_back();
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    const size_t mask = index_size - 1;
+    for (uint32_t entry = 0; entry < cache_entries.size(); entry++) {
+      size_t slot = cache_entries[entry].key[0] & mask;
+      while (cache_index[slot]) {
+        slot = (slot + 1) & mask;
+      }
+      cache_index[slot] = entry + 1;
+    }
+  } else {
+    const size_t mask = cache_index.size() - 1;
+    size_t slot = cache_entries.back().key[0] & mask;
+    while (cache_index[slot]) {
+      slot = (slot + 1) & mask;
+    }
+    cache_index[slot] = static_cast<uint32_t>(cache_entries.size());
+  }
+
+  return VK_SUCCESS;
+}
+
 VkResult CreatePipelineCache(vk::device device,
                              const VkPipelineCacheCreateInfo* pCreateInfo,
                              vk::allocator allocator,
@@ -76,59 +182,84 @@ VkResult CreatePipelineCache(vk::device device,
     return VK_ERROR_OUT_OF_HOST_MEMORY;
   }
 
-  if (pCreateInfo->initialDataSize) {
-    size_t header_size =
-        static_cast<const uint32_t*>(pCreateInfo->pInitialData)[0];
+  vk::unique_ptr<vk::pipeline_cache> pipeline_cache_ptr(pipeline_cache,
+                                                        allocator);
 
+  // Initial data that is too small or was created by an incompatible device or
+  // compiler is ignored, as permitted by the spec.
+  const size_t min_header_size = 16 + VK_UUID_SIZE;
+  if (pCreateInfo->initialDataSize >= min_header_size) {
     const uint32_t* cache_header =
         static_cast<const uint32_t*>(pCreateInfo->pInitialData);
 
-    enum { HEADER_VERSION = 1, HEADER_VENDOR_ID = 2, HEADER_DEVICE_ID = 3 };
+    enum {
+      HEADER_SIZE = 0,
+      HEADER_VERSION = 1,
+      HEADER_VENDOR_ID = 2,
+      HEADER_DEVICE_ID = 3,
+      HEADER_UUID = 4
+    };
+
+    const size_t header_size = cache_header[HEADER_SIZE];
 
-    if (cache_header[HEADER_VERSION] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+    if (header_size >= min_header_size &&
+        header_size <= pCreateInfo->initialDataSize &&
+        cache_header[HEADER_VERSION] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
         cache_header[HEADER_VENDOR_ID] ==
             device->physical_device_properties.vendorID &&
         cache_header[HEADER_DEVICE_ID] ==
-            device->physical_device_properties.deviceID) {
+            device->physical_device_properties.deviceID &&
+        0 == std::memcmp(cache_header + HEADER_UUID,
+                         device->physical_device_properties.pipelineCacheUUID,
+                         VK_UUID_SIZE)) {
       const uint8_t* initialData =
           static_cast<const uint8_t*>(pCreateInfo->pInitialData) + header_size;
+      const size_t initialDataSize =
+          pCreateInfo->initialDataSize - header_size;
       size_t bytes_read = 0;
 
-      const size_t shader_count = *reinterpret_cast<const size_t*>(initialData);
-      bytes_read += sizeof(size_t);
+      // Copy the next `size` bytes of initial data, failing if there aren't
+      // that many left.
+      auto read = [&](void* dst, size_t size) {
+        if (initialDataSize - bytes_read < size) {
+          return false;
+        }
+        std::memcpy(dst, initialData + bytes_read, size);
+        bytes_read += size;
+        return true;
+      };
+
+      size_t shader_count = 0;
+      if (!read(&shader_count, sizeof(shader_count))) {
+        shader_count = 0;
+      }
 
       for (size_t shader_index = 0; shader_index < shader_count;
            shader_index++) {
         cached_shader shader(allocator.getCallbacks(),
                              VK_SYSTEM_ALLOCATION_SCOPE_CACHE);
 
-        std::memcpy(&shader.data_size, initialData + bytes_read,
-                    sizeof(shader.data_size));
-        bytes_read += sizeof(shader.data_size);
-
-        std::memcpy(&shader.source_checksum, initialData + bytes_read,
-                    sizeof(shader.source_checksum));
-        bytes_read += sizeof(shader.source_checksum);
-
-        std::memcpy(shader.workgroup_size.data(), initialData + bytes_read,
-                    sizeof(shader.workgroup_size));
-        bytes_read += sizeof(shader.workgroup_size);
-
         size_t binary_size = 0;
-        std::memcpy(&binary_size, initialData + bytes_read, sizeof(size_t));
-        bytes_read += sizeof(size_t);
+        if (!read(&shader.data_size, sizeof(shader.data_size)) ||
+            !read(shader.key.data(), sizeof(shader.key)) ||
+            !read(shader.workgroup_size.data(),
+                  sizeof(shader.workgroup_size)) ||
+            !read(&binary_size, sizeof(binary_size)) ||
+            binary_size > initialDataSize - bytes_read) {
+          break;
+        }
 
         if (cargo::success != shader.binary.resize(binary_size)) {
           return VK_ERROR_OUT_OF_HOST_MEMORY;
         }
-
-        std::memcpy(shader.binary.data(), initialData + bytes_read,
-                    binary_size);
-        bytes_read += binary_size;
+        read(shader.binary.data(), binary_size);
 
         size_t bindings_size = 0;
-        std::memcpy(&bindings_size, initialData + bytes_read, sizeof(size_t));
-        bytes_read += sizeof(size_t);
+        if (!read(&bindings_size, sizeof(bindings_size)) ||
+            bindings_size > initialDataSize - bytes_read ||
+            bindings_size % sizeof(compiler::spirv::DescriptorBinding)) {
+          break;
+        }
 
         if (bindings_size) {
           if (cargo::success !=
@@ -136,20 +267,18 @@ VkResult CreatePipelineCache(vk::device device,
                   bindings_size / sizeof(compiler::spirv::DescriptorBinding))) {
             return VK_ERROR_OUT_OF_HOST_MEMORY;
           }
-
-          std::memcpy(shader.descriptor_bindings.data(),
-                      initialData + bytes_read, bindings_size);
-          bytes_read += bindings_size;
+          read(shader.descriptor_bindings.data(), bindings_size);
         }
 
-        if (pipeline_cache->cache_entries.push_back(std::move(shader))) {
+        shader.updateDataSize();
+        if (VK_SUCCESS != pipeline_cache->insert(std::move(shader))) {
           return VK_ERROR_OUT_OF_HOST_MEMORY;
         }
       }
     }
   }
 
-  *pPipelineCache = pipeline_cache;
+  *pPipelineCache = pipeline_cache_ptr.release();
 
   return VK_SUCCESS;
 }
@@ -157,29 +286,25 @@ VkResult CreatePipelineCache(vk::device device,
 VkResult MergePipelineCaches(vk::device device, vk::pipeline_cache dstCache,
                              uint32_t srcCacheCount,
                              const VkPipelineCache* pSrcCaches) {
-  vk::small_vector<vk::pipeline_cache, 2> src_caches(
-      {device->allocator.getCallbacks(), VK_SYSTEM_ALLOCATION_SCOPE_COMMAND});
+  (void)device;
 
-  for (uint32_t cacheIndex = 0; cacheIndex < srcCacheCount; cacheIndex++) {
-    if (src_caches.push_back(
-            vk::cast<vk::pipeline_cache>(pSrcCaches[cacheIndex]))) {
-      return VK_ERROR_OUT_OF_HOST_MEMORY;
-    }
-  }
+  std::lock_guard<std::mutex> dstLock(dstCache->mutex);
 
   for (uint32_t cacheIndex = 0; cacheIndex < srcCacheCount; cacheIndex++) {
-    for (cached_shader& cachedShader : src_caches[cacheIndex]->cache_entries) {
-      if (std::find(dstCache->cache_entries.begin(),
-                    dstCache->cache_entries.end(),
-                    cachedShader) == dstCache->cache_entries.end()) {
-        if (auto clonedCachedShader = cachedShader.clone()) {
-          if (dstCache->cache_entries.push_back(
-                  std::move(*clonedCachedShader))) {
-            return VK_ERROR_OUT_OF_HOST_MEMORY;
-          }
-        } else {
+    vk::pipeline_cache srcCache =
+        vk::cast<vk::pipeline_cache>(pSrcCaches[cacheIndex]);
+    std::lock_guard<std::mutex> srcLock(srcCache->mutex);
+
+    for (cached_shader& cachedShader : srcCache->cache_entries) {
+      if (dstCache->find(cachedShader.key)) {
+        continue;
+      }
+      if (auto clonedCachedShader = cachedShader.clone()) {
+        if (VK_SUCCESS != dstCache->insert(std::move(*clonedCachedShader))) {
           return VK_ERROR_OUT_OF_HOST_MEMORY;
         }
+      } else {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
       }
     }
   }
@@ -192,6 +317,8 @@ VkResult GetPipelineCacheData(vk::device device,
                               size_t* pDataSize, void* pData) {
   uint32_t header_size = 16 + VK_UUID_SIZE;
 
+  std::lock_guard<std::mutex> lock(pipelineCache->mutex);
+
   if (!pData) {
     size_t data_size = header_size;
 
@@ -206,6 +333,12 @@ VkResult GetPipelineCacheData(vk::device device,
     return VK_SUCCESS;
   }
 
+  // nothing useful can be written if the header and shader count don't fit
+  if (*pDataSize < header_size + sizeof(size_t)) {
+    *pDataSize = 0;
+    return VK_INCOMPLETE;
+  }
+
   uint8_t* cache_buffer = reinterpret_cast<uint8_t*>(pData);
 
   uint32_t header[4] = {header_size, VK_PIPELINE_CACHE_HEADER_VERSION_ONE,
@@ -220,17 +353,19 @@ VkResult GetPipelineCacheData(vk::device device,
 
   size_t bytes_written = header_size;
 
-  size_t* shaders_written =
-      reinterpret_cast<size_t*>(cache_buffer + bytes_written);
-  *shaders_written = 0;
+  size_t shaders_written = 0;
+  const size_t shaders_written_offset = bytes_written;
   bytes_written += sizeof(size_t);
 
+  VkResult result = VK_SUCCESS;
+
   for (cached_shader& cachedShader : pipelineCache->cache_entries) {
     // make sure we don't go over the allocation we've been given, only run this
     // check at the top of each iteration because the way they're implemented
     // means it would be pointless to copy half of a cached shader
     if ((*pDataSize - bytes_written) < cachedShader.data_size) {
-      return VK_INCOMPLETE;
+      result = VK_INCOMPLETE;
+      break;
     }
 
     // Now copy all the data from the cached shader into the buffer in a form
@@ -243,9 +378,9 @@ VkResult GetPipelineCacheData(vk::device device,
                 sizeof(cachedShader.data_size));
     bytes_written += sizeof(cachedShader.data_size);
 
-    std::memcpy(cache_buffer + bytes_written, &cachedShader.source_checksum,
-                sizeof(cachedShader.source_checksum));
-    bytes_written += sizeof(cachedShader.source_checksum);
+    std::memcpy(cache_buffer + bytes_written, cachedShader.key.data(),
+                sizeof(cachedShader.key));
+    bytes_written += sizeof(cachedShader.key);
 
     std::memcpy(cache_buffer + bytes_written,
                 cachedShader.workgroup_size.data(),
@@ -273,10 +408,15 @@ VkResult GetPipelineCacheData(vk::device device,
       bytes_written += bindings_size;
     }
 
-    (*shaders_written)++;
+    shaders_written++;
   }
 
-  return bytes_written < *pDataSize ? VK_INCOMPLETE : VK_SUCCESS;
+  std::memcpy(cache_buffer + shaders_written_offset, &shaders_written,
+              sizeof(shaders_written));
+
+  *pDataSize = bytes_written;
+
+  return result;
 }
 
 void DestroyPipelineCache(vk::device device, vk::pipeline_cache pipelineCache,
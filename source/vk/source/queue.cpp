@@ -27,11 +27,16 @@ queue_t::queue_t(mux_queue_t mux_queue, vk::allocator allocator)
     : mux_queue(mux_queue),
       allocator(allocator),
       fence_command_buffer(nullptr),
+      callback_data_pool(
+          {allocator.getCallbacks(), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT}),
       fence_command_buffers(
           {allocator.getCallbacks(), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT}),
       fence_submitted(false) {}
 
 queue_t::~queue_t() {
+  for (auto data : callback_data_pool) {
+    allocator.destroy(data);
+  }
   if (fence_command_buffer) {
     mux_device_t mux_device = fence_command_buffer->device;
 
@@ -44,6 +49,28 @@ queue_t::~queue_t() {
   }
 }
 
+dispatch_callback_data queue_t::acquireCallbackData(
+    vk::command_buffer commandBuffer, mux_semaphore_t semaphore,
+    VkPipelineStageFlags stage_flags) {
+  if (callback_data_pool.empty()) {
+    return allocator.create<vk::dispatch_callback_data_s>(
+        VK_SYSTEM_ALLOCATION_SCOPE_OBJECT, this, commandBuffer, semaphore,
+        stage_flags);
+  }
+  dispatch_callback_data data = callback_data_pool.back();
+  callback_data_pool.pop_back();
+  data->commandBuffer = commandBuffer;
+  data->semaphore = semaphore;
+  data->stage_flags = stage_flags;
+  return data;
+}
+
+void queue_t::releaseCallbackData(dispatch_callback_data data) {
+  if (callback_data_pool.push_back(data)) {
+    allocator.destroy(data);
+  }
+}
+
 void GetDeviceQueue(vk::device device, uint32_t queueFamilyIndex,
                     uint32_t queueIndex, vk::queue* pQueue) {
   if (queueFamilyIndex == 0 && queueIndex == 0) {
@@ -139,10 +166,54 @@ static void cmd_group_complete_callback(mux_command_buffer_t, mux_result_t,
 
         cb_data->queue->user_transfer_waits.erase(cb_data->semaphore);
       }
+
+      cb_data->queue->releaseCallbackData(cb_data);
     }
+  }
+}
 
-    cb_data->queue->allocator.destroy(cb_data);
+// Finds a command buffer/semaphore/fence set in `list`, other than the one
+// using `in_flight_fence`, whose work has completed and resets it so that it
+// can be recorded and dispatched again. Returns null if every set is still in
+// flight, in which case a new set must be created.
+template <class Tuple>
+static Tuple* recycleCompleted(mux_queue_t mux_queue,
+                               vk::small_vector<Tuple, 2>& list,
+                               mux_fence_t in_flight_fence) {
+  for (auto& tuple : list) {
+    if (tuple.fence == in_flight_fence ||
+        mux_success != muxTryWait(mux_queue, 0, tuple.fence)) {
+      continue;
+    }
+    if (muxResetCommandBuffer(tuple.command_buffer) ||
+        muxResetSemaphore(tuple.semaphore) || muxResetFence(tuple.fence)) {
+      return nullptr;
+    }
+    return &tuple;
   }
+  return nullptr;
+}
+
+// Creates a new command buffer/semaphore/fence set, on failure nothing is
+// leaked.
+static VkResult createTuple(mux_device_t mux_device,
+                            mux_allocator_info_t allocator,
+                            mux_command_buffer_t* command_buffer,
+                            mux_semaphore_t* semaphore, mux_fence_t* fence) {
+  if (auto error = muxCreateCommandBuffer(mux_device, nullptr, allocator,
+                                          command_buffer)) {
+    return vk::getVkResult(error);
+  }
+  if (auto error = muxCreateSemaphore(mux_device, allocator, semaphore)) {
+    muxDestroyCommandBuffer(mux_device, *command_buffer, allocator);
+    return vk::getVkResult(error);
+  }
+  if (auto error = muxCreateFence(mux_device, allocator, fence)) {
+    muxDestroySemaphore(mux_device, *semaphore, allocator);
+    muxDestroyCommandBuffer(mux_device, *command_buffer, allocator);
+    return vk::getVkResult(error);
+  }
+  return VK_SUCCESS;
 }
 
 // Processes a single submit info
@@ -167,34 +238,33 @@ static VkResult ProcessSubmitInfo(const VkSubmitInfo& submitInfo,
     if (wait_semaphore->has_dispatched &&
         mux_fence_not_ready ==
             muxTryWait(queue->mux_queue, 0, wait_semaphore->mux_fence)) {
-      mux_semaphore_t new_semaphore;
-      if (auto error = muxCreateSemaphore(
-              wait_semaphore->command_buffer->device,
-              queue->allocator.getMuxAllocator(), &new_semaphore)) {
-        return vk::getVkResult(error);
-      }
-
-      mux_command_buffer_t new_command_buffer;
-      if (auto error = muxCreateCommandBuffer(
-              wait_semaphore->command_buffer->device, nullptr,
-              queue->allocator.getMuxAllocator(), &new_command_buffer)) {
-        return vk::getVkResult(error);
-      }
-
-      mux_fence_t new_fence;
-      if (auto error =
-              muxCreateFence(wait_semaphore->command_buffer->device,
-                             queue->allocator.getMuxAllocator(), &new_fence)) {
-        return vk::getVkResult(error);
-      }
+      // Reuse an earlier set whose signal has already happened before
+      // creating another one.
+      if (auto* recycled = recycleCompleted(queue->mux_queue,
+                                            wait_semaphore->semaphore_tuples,
+                                            wait_semaphore->mux_fence)) {
+        wait_semaphore->mux_semaphore = recycled->semaphore;
+        wait_semaphore->command_buffer = recycled->command_buffer;
+        wait_semaphore->mux_fence = recycled->fence;
+      } else {
+        mux_semaphore_t new_semaphore;
+        mux_command_buffer_t new_command_buffer;
+        mux_fence_t new_fence;
+        if (auto error = createTuple(wait_semaphore->command_buffer->device,
+                                     queue->allocator.getMuxAllocator(),
+                                     &new_command_buffer, &new_semaphore,
+                                     &new_fence)) {
+          return error;
+        }
 
-      wait_semaphore->mux_semaphore = new_semaphore;
-      wait_semaphore->command_buffer = new_command_buffer;
-      wait_semaphore->mux_fence = new_fence;
+        wait_semaphore->mux_semaphore = new_semaphore;
+        wait_semaphore->command_buffer = new_command_buffer;
+        wait_semaphore->mux_fence = new_fence;
 
-      if (wait_semaphore->semaphore_tuples.push_back(
-              {new_semaphore, new_command_buffer, new_fence})) {
-        return VK_ERROR_OUT_OF_HOST_MEMORY;
+        if (wait_semaphore->semaphore_tuples.push_back(
+                {new_semaphore, new_command_buffer, new_fence})) {
+          return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
       }
     } else if (wait_semaphore->has_dispatched) {
       // make sure this is reset if we are re-using a semaphore
@@ -257,36 +327,34 @@ static VkResult ProcessSubmitInfo(const VkSubmitInfo& submitInfo,
       if (commandBuffer->main_dispatched &&
           mux_fence_not_ready ==
               muxTryWait(queue->mux_queue, 0, commandBuffer->main_fence)) {
-        // create new mux command buffer/semaphore
+        // swap in a previous copy that has finished executing, or create a
+        // new mux command buffer/semaphore/fence if they are all still busy
+        const command_buffer_semaphore_fence_tuple in_flight = {
+            commandBuffer->main_command_buffer, commandBuffer->main_semaphore,
+            commandBuffer->main_fence};
         mux_command_buffer_t new_command_buffer;
-
-        if (auto error = muxCreateCommandBuffer(
-                commandBuffer->mux_device, nullptr,
-                commandBuffer->allocator.getMuxAllocator(),
-                &new_command_buffer)) {
-          return getVkResult(error);
-        }
-
-        mux_fence_t new_fence;
-
-        if (auto error = muxCreateFence(
-                commandBuffer->mux_device,
-                commandBuffer->allocator.getMuxAllocator(), &new_fence)) {
-          return getVkResult(error);
-        }
-
         mux_semaphore_t new_semaphore;
+        mux_fence_t new_fence;
 
-        if (auto error = muxCreateSemaphore(
-                commandBuffer->mux_device,
-                commandBuffer->allocator.getMuxAllocator(), &new_semaphore)) {
-          return getVkResult(error);
-        }
+        if (auto* recycled =
+                recycleCompleted(queue->mux_queue,
+                                 commandBuffer->simultaneous_use_list,
+                                 commandBuffer->main_fence)) {
+          new_command_buffer = recycled->command_buffer;
+          new_semaphore = recycled->semaphore;
+          new_fence = recycled->fence;
+          *recycled = in_flight;
+        } else {
+          if (auto error = createTuple(
+                  commandBuffer->mux_device,
+                  commandBuffer->allocator.getMuxAllocator(),
+                  &new_command_buffer, &new_semaphore, &new_fence)) {
+            return error;
+          }
 
-        if (commandBuffer->simultaneous_use_list.push_back(
-                {commandBuffer->main_command_buffer,
-                 commandBuffer->main_semaphore, commandBuffer->main_fence})) {
-          return VK_ERROR_OUT_OF_HOST_MEMORY;
+          if (commandBuffer->simultaneous_use_list.push_back(in_flight)) {
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+          }
         }
 
         if (commandBuffer->transfer_command_buffer ==
@@ -322,33 +390,34 @@ static VkResult ProcessSubmitInfo(const VkSubmitInfo& submitInfo,
         if (barrier_info->dispatched &&
             mux_fence_not_ready ==
                 muxTryWait(queue->mux_queue, 0, barrier_info->fence)) {
-          // create new group/semaphore, discard old one
+          // swap in a previous copy that has finished executing, or create
+          // a new group/semaphore/fence if they are all still busy
+          const command_buffer_semaphore_fence_tuple in_flight = {
+              barrier_info->command_buffer, barrier_info->semaphore,
+              barrier_info->fence};
           mux_command_buffer_t new_command_buffer;
-          if (auto error = muxCreateCommandBuffer(
-                  commandBuffer->mux_device, nullptr,
-                  commandBuffer->allocator.getMuxAllocator(),
-                  &new_command_buffer)) {
-            return getVkResult(error);
-          }
-
+          mux_semaphore_t new_semaphore;
           mux_fence_t new_fence;
-          if (auto error = muxCreateFence(
-                  commandBuffer->mux_device,
-                  commandBuffer->allocator.getMuxAllocator(), &new_fence)) {
-            return getVkResult(error);
-          }
 
-          mux_semaphore_t new_semaphore;
-          if (auto error = muxCreateSemaphore(
-                  commandBuffer->mux_device,
-                  commandBuffer->allocator.getMuxAllocator(), &new_semaphore)) {
-            return getVkResult(error);
-          }
+          if (auto* recycled =
+                  recycleCompleted(queue->mux_queue,
+                                   commandBuffer->simultaneous_use_list,
+                                   barrier_info->fence)) {
+            new_command_buffer = recycled->command_buffer;
+            new_semaphore = recycled->semaphore;
+            new_fence = recycled->fence;
+            *recycled = in_flight;
+          } else {
+            if (auto error = createTuple(
+                    commandBuffer->mux_device,
+                    commandBuffer->allocator.getMuxAllocator(),
+                    &new_command_buffer, &new_semaphore, &new_fence)) {
+              return error;
+            }
 
-          if (commandBuffer->simultaneous_use_list.push_back(
-                  {barrier_info->command_buffer, barrier_info->semaphore,
-                   barrier_info->fence})) {
-            return VK_ERROR_OUT_OF_HOST_MEMORY;
+            if (commandBuffer->simultaneous_use_list.push_back(in_flight)) {
+              return VK_ERROR_OUT_OF_HOST_MEMORY;
+            }
           }
 
           if (commandBuffer->transfer_command_buffer ==
@@ -394,11 +463,13 @@ static VkResult ProcessSubmitInfo(const VkSubmitInfo& submitInfo,
       commandBuffer->commands.clear();
     }
 
-    vk::dispatch_callback_data_s* dispatch_callback_data =
-        queue->allocator.create<vk::dispatch_callback_data_s>(
-            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT, queue, commandBuffer,
-            commandBuffer->main_semaphore,
+    vk::dispatch_callback_data dispatch_callback_data =
+        queue->acquireCallbackData(
+            commandBuffer, commandBuffer->main_semaphore,
             commandBuffer->main_command_buffer_stage_flags);
+    if (!dispatch_callback_data) {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
 
     // figure out if main needs to wait on any user semaphores
     vk::small_vector<mux_semaphore_t, 2> main_wait_semaphores(
@@ -622,10 +693,12 @@ static VkResult ProcessSubmitInfo(const VkSubmitInfo& submitInfo,
         }
       }
 
-      vk::dispatch_callback_data_s* dispatch_callback_data =
-          queue->allocator.create<vk::dispatch_callback_data_s>(
-              VK_SYSTEM_ALLOCATION_SCOPE_OBJECT, queue, commandBuffer,
-              barrier_info->semaphore, barrier_info->stage_flags);
+      vk::dispatch_callback_data dispatch_callback_data =
+          queue->acquireCallbackData(commandBuffer, barrier_info->semaphore,
+                                     barrier_info->stage_flags);
+      if (!dispatch_callback_data) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+      }
 
       mux_semaphore_t* wait_semaphores = barrier_wait_semaphores.empty()
                                              ? nullptr
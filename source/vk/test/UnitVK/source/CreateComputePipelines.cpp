@@ -16,6 +16,8 @@
 
 #include <UnitVK.h>
 
+#include <vector>
+
 // https://www.khronos.org/registry/vulkan/specs/1.0/xhtml/vkspec.html#vkCreateComputePipelines
 
 class CreateComputePipelines : public uvk::PipelineLayoutTest {
@@ -193,6 +195,171 @@ TEST_F(CreateComputePipelines, DefaultPipelineCache) {
   vkDestroyPipelineCache(device, pipelineCache, nullptr);
 }
 
+TEST_F(CreateComputePipelines, DefaultBatch) {
+  // Pipelines passed to a single call are compiled concurrently.
+  const uint32_t pipelineCount = 16;
+  std::vector<VkComputePipelineCreateInfo> createInfos(pipelineCount,
+                                                       pipelineCreateInfo);
+  std::vector<VkPipeline> pipelines(pipelineCount, VK_NULL_HANDLE);
+
+  ASSERT_EQ_RESULT(VK_SUCCESS,
+                   vkCreateComputePipelines(device, VK_NULL_HANDLE,
+                                            pipelineCount, createInfos.data(),
+                                            nullptr, pipelines.data()));
+
+  for (auto batchPipeline : pipelines) {
+    EXPECT_NE(VK_NULL_HANDLE, batchPipeline);
+    vkDestroyPipeline(device, batchPipeline, nullptr);
+  }
+}
+
+TEST_F(CreateComputePipelines, FailureWithoutEarlyReturn) {
+  // Naming an entry point the shader module doesn't have fails creation of
+  // that pipeline, but without VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT
+  // the remaining pipelines are still created.
+  const uint32_t pipelineCount = 8;
+  const uint32_t failingIndex = 3;
+  std::vector<VkComputePipelineCreateInfo> createInfos(pipelineCount,
+                                                       pipelineCreateInfo);
+  createInfos[failingIndex].stage.pName = "not_main";
+  std::vector<VkPipeline> pipelines(pipelineCount, VK_NULL_HANDLE);
+
+  EXPECT_EQ_RESULT(VK_ERROR_INITIALIZATION_FAILED,
+                   vkCreateComputePipelines(device, VK_NULL_HANDLE,
+                                            pipelineCount, createInfos.data(),
+                                            nullptr, pipelines.data()));
+
+  for (uint32_t index = 0; index < pipelineCount; index++) {
+    if (index == failingIndex) {
+      EXPECT_EQ(VK_NULL_HANDLE, pipelines[index]);
+    } else {
+      EXPECT_NE(VK_NULL_HANDLE, pipelines[index]) << "index " << index;
+    }
+    vkDestroyPipeline(device, pipelines[index], nullptr);
+  }
+}
+
+TEST_F(CreateComputePipelines, FailureEarlyReturn) {
+  // Pipelines after one which fails with
+  // VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT must be returned as
+  // VK_NULL_HANDLE, even if a compilation worker had already created them.
+  const uint32_t pipelineCount = 8;
+  const uint32_t failingIndex = 3;
+  std::vector<VkComputePipelineCreateInfo> createInfos(pipelineCount,
+                                                       pipelineCreateInfo);
+  createInfos[failingIndex].flags =
+      VK_PIPELINE_CREATE_EARLY_RETURN_ON_FAILURE_BIT_EXT;
+  createInfos[failingIndex].stage.pName = "not_main";
+  std::vector<VkPipeline> pipelines(pipelineCount, VK_NULL_HANDLE);
+
+  EXPECT_EQ_RESULT(VK_ERROR_INITIALIZATION_FAILED,
+                   vkCreateComputePipelines(device, VK_NULL_HANDLE,
+                                            pipelineCount, createInfos.data(),
+                                            nullptr, pipelines.data()));
+
+  for (uint32_t index = 0; index < pipelineCount; index++) {
+    if (index < failingIndex) {
+      EXPECT_NE(VK_NULL_HANDLE, pipelines[index]) << "index " << index;
+    } else {
+      EXPECT_EQ(VK_NULL_HANDLE, pipelines[index]) << "index " << index;
+    }
+    vkDestroyPipeline(device, pipelines[index], nullptr);
+  }
+}
+
+TEST_F(CreateComputePipelines, DefaultPipelineCacheSpecialization) {
+  // Specialization constants change the compiled shader, so each set of values
+  // must get its own pipeline cache entry.
+  uvk::ShaderCode shaderCode = uvk::getShader(uvk::Shader::spec_const);
+
+  VkShaderModuleCreateInfo sModuleCreateInf = {};
+  sModuleCreateInf.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  sModuleCreateInf.pCode = reinterpret_cast<const uint32_t *>(shaderCode.code);
+  sModuleCreateInf.codeSize = shaderCode.size;
+
+  VkShaderModule specConstantSModule;
+  ASSERT_EQ_RESULT(VK_SUCCESS,
+                   vkCreateShaderModule(device, &sModuleCreateInf, nullptr,
+                                        &specConstantSModule));
+
+  uint32_t specData = 42;
+
+  VkSpecializationMapEntry specMapEntry = {};
+  specMapEntry.constantID = 0;
+  specMapEntry.offset = 0;
+  specMapEntry.size = sizeof(specData);
+
+  VkSpecializationInfo specInfo = {};
+  specInfo.dataSize = sizeof(specData);
+  specInfo.mapEntryCount = 1;
+  specInfo.pData = reinterpret_cast<void *>(&specData);
+  specInfo.pMapEntries = &specMapEntry;
+
+  VkPipelineShaderStageCreateInfo specConstantStage = {};
+  specConstantStage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  specConstantStage.pName = "main";
+  specConstantStage.module = specConstantSModule;
+  specConstantStage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+  specConstantStage.pSpecializationInfo = &specInfo;
+
+  pipelineCreateInfo.stage = specConstantStage;
+
+  VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
+  pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+  VkPipelineCache pipelineCache;
+  ASSERT_EQ_RESULT(VK_SUCCESS,
+                   vkCreatePipelineCache(device, &pipelineCacheCreateInfo,
+                                         nullptr, &pipelineCache));
+
+  size_t emptySize;
+  ASSERT_EQ_RESULT(VK_SUCCESS, vkGetPipelineCacheData(device, pipelineCache,
+                                                      &emptySize, nullptr));
+
+  ASSERT_EQ_RESULT(VK_SUCCESS, vkCreateComputePipelines(device, pipelineCache,
+                                                        1, &pipelineCreateInfo,
+                                                        nullptr, &pipeline));
+
+  size_t oneEntrySize;
+  ASSERT_EQ_RESULT(VK_SUCCESS, vkGetPipelineCacheData(device, pipelineCache,
+                                                      &oneEntrySize, nullptr));
+
+  // The same values hit the existing entry.
+  VkPipeline samePipeline;
+  ASSERT_EQ_RESULT(VK_SUCCESS,
+                   vkCreateComputePipelines(device, pipelineCache, 1,
+                                            &pipelineCreateInfo, nullptr,
+                                            &samePipeline));
+  vkDestroyPipeline(device, samePipeline, nullptr);
+
+  size_t sameEntrySize;
+  ASSERT_EQ_RESULT(VK_SUCCESS, vkGetPipelineCacheData(device, pipelineCache,
+                                                      &sameEntrySize, nullptr));
+  EXPECT_EQ(oneEntrySize, sameEntrySize);
+
+  specData = 7;
+
+  VkPipeline otherPipeline;
+  ASSERT_EQ_RESULT(VK_SUCCESS,
+                   vkCreateComputePipelines(device, pipelineCache, 1,
+                                            &pipelineCreateInfo, nullptr,
+                                            &otherPipeline));
+  vkDestroyPipeline(device, otherPipeline, nullptr);
+
+  size_t otherEntrySize;
+  ASSERT_EQ_RESULT(VK_SUCCESS,
+                   vkGetPipelineCacheData(device, pipelineCache,
+                                          &otherEntrySize, nullptr));
+
+  // Targets that can't create binaries leave the cache empty.
+  if (emptySize < oneEntrySize) {
+    EXPECT_LT(oneEntrySize, otherEntrySize);
+  }
+
+  vkDestroyPipelineCache(device, pipelineCache, nullptr);
+  vkDestroyShaderModule(device, specConstantSModule, nullptr);
+}
+
 TEST_F(CreateComputePipelines, ErrorOutOfHostMemory) {
   ASSERT_EQ_RESULT(VK_ERROR_OUT_OF_HOST_MEMORY,
                    vkCreateComputePipelines(device, VK_NULL_HANDLE, 1,
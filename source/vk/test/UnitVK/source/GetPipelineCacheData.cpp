@@ -120,3 +120,39 @@ TEST_F(GetPipelineCacheData, SaveDataBetweenRuns) {
   GetPipelineCacheData::pipelineCacheCreateInfo.pInitialData = data.data();
   RETURN_ON_FATAL_FAILURE(GetPipelineCacheData::SetUp());
 }
+
+TEST_F(GetPipelineCacheData, RoundTrip) {
+  size_t dataSize;
+
+  ASSERT_EQ_RESULT(VK_SUCCESS, vkGetPipelineCacheData(device, pipelineCache,
+                                                      &dataSize, nullptr));
+
+  std::vector<char> data(dataSize);
+
+  ASSERT_EQ_RESULT(VK_SUCCESS, vkGetPipelineCacheData(device, pipelineCache,
+                                                      &dataSize, data.data()));
+
+  VkPipelineCacheCreateInfo loadedCreateInfo = pipelineCacheCreateInfo;
+  loadedCreateInfo.initialDataSize = dataSize;
+  loadedCreateInfo.pInitialData = data.data();
+
+  VkPipelineCache loadedPipelineCache;
+  ASSERT_EQ_RESULT(VK_SUCCESS,
+                   vkCreatePipelineCache(device, &loadedCreateInfo, nullptr,
+                                         &loadedPipelineCache));
+
+  // Every entry, including its finalized binary, must survive being loaded.
+  size_t loadedDataSize;
+  ASSERT_EQ_RESULT(VK_SUCCESS,
+                   vkGetPipelineCacheData(device, loadedPipelineCache,
+                                          &loadedDataSize, nullptr));
+  ASSERT_EQ(dataSize, loadedDataSize);
+
+  std::vector<char> loadedData(loadedDataSize);
+  ASSERT_EQ_RESULT(VK_SUCCESS,
+                   vkGetPipelineCacheData(device, loadedPipelineCache,
+                                          &loadedDataSize, loadedData.data()));
+  EXPECT_EQ(data, loadedData);
+
+  vkDestroyPipelineCache(device, loadedPipelineCache, nullptr);
+}
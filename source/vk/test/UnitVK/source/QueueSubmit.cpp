@@ -16,6 +16,8 @@
 
 #include <UnitVK.h>
 
+#include <chrono>
+
 // https://www.khronos.org/registry/vulkan/specs/1.0/xhtml/vkspec.html#vkQueueSubmit
 
 class QueueSubmit : public uvk::RecordCommandBufferTest,
@@ -69,6 +71,36 @@ TEST_F(QueueSubmit, Default) {
   ASSERT_EQ_RESULT(VK_SUCCESS, vkQueueWaitIdle(queue));
 }
 
+TEST_F(QueueSubmit, SubmitLatency) {
+  // Measures the time spent in vkQueueSubmit when the same command buffer is
+  // submitted over and over, as an application's frame loop would. Once warm,
+  // submission reuses its per dispatch state instead of allocating it.
+  VkFenceCreateInfo fenceCreateInfo = {};
+  fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+  VkFence fence;
+  ASSERT_EQ_RESULT(VK_SUCCESS,
+                   vkCreateFence(device, &fenceCreateInfo, nullptr, &fence));
+
+  const uint32_t submissions = 1000;
+  std::chrono::nanoseconds submitTime(0);
+
+  for (uint32_t submission = 0; submission < submissions; submission++) {
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ_RESULT(VK_SUCCESS, vkQueueSubmit(queue, 1, &submitInfo, fence));
+    submitTime += std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ_RESULT(VK_SUCCESS,
+                     vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX));
+    ASSERT_EQ_RESULT(VK_SUCCESS, vkResetFences(device, 1, &fence));
+  }
+
+  RecordProperty("mean_submit_ns",
+                 static_cast<int>(submitTime.count() / submissions));
+
+  vkDestroyFence(device, fence, nullptr);
+}
+
 TEST_F(QueueSubmit, DefaultSignalSemaphore) {
   VkSemaphore semaphore;
 
@@ -16,6 +16,8 @@
 
 #include <UnitVK.h>
 
+#include <algorithm>
+
 #if defined(__has_feature)
 #if __has_feature(thread_sanitizer)
 #define TSAN_BUILD
@@ -325,3 +327,57 @@ TEST_F(SimultaneousUse, SecondaryCommandBuffer) {
 }
 
 #undef TSAN_BUILD
+
+class SimultaneousUseDispatch : public uvk::SimpleKernelTest {
+ public:
+  SimultaneousUseDispatch()
+      : SimpleKernelTest(false, uvk::Shader::mov,
+                         bufferElements * sizeof(int32_t)) {}
+
+  static const uint32_t bufferElements = 128;
+};
+
+// Simultaneously running submissions write the same values to the output
+// buffer. This may be reported as a data race so the test is disabled for TSAN
+// builds.
+#ifdef TSAN_BUILD
+TEST_F(SimultaneousUseDispatch, DISABLED_CmdDispatchRepeated) {
+#else
+TEST_F(SimultaneousUseDispatch, CmdDispatchRepeated) {
+#endif
+  // Each submission while a previous one is still running needs its own copy
+  // of the mux command buffer. Copies that have finished are reused.
+  commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+  ASSERT_EQ_RESULT(
+      VK_SUCCESS, vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo));
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                          pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+  // The shader copies the element indexed by the global Z id.
+  vkCmdDispatch(commandBuffer, 1, 1, bufferElements);
+  ASSERT_EQ_RESULT(VK_SUCCESS, vkEndCommandBuffer(commandBuffer));
+
+  int32_t *input = static_cast<int32_t *>(PtrTo1stBufferData());
+  int32_t *output = static_cast<int32_t *>(PtrTo2ndBufferData());
+  for (uint32_t i = 0; i < bufferElements; i++) {
+    input[i] = static_cast<int32_t>(i);
+  }
+
+  for (int round = 0; round < 4; round++) {
+    // Clear the output so that every round has to write all of it again.
+    std::fill(output, output + bufferElements, -1);
+    FlushToDevice();
+
+    for (int submission = 0; submission < 8; submission++) {
+      ASSERT_EQ_RESULT(VK_SUCCESS,
+                       vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE));
+    }
+    ASSERT_EQ_RESULT(VK_SUCCESS, vkQueueWaitIdle(queue));
+
+    FlushFromDevice();
+    for (uint32_t i = 0; i < bufferElements; i++) {
+      ASSERT_EQ(static_cast<int32_t>(i), output[i]);
+    }
+  }
+}